@@ -0,0 +1,28 @@
+// C++ driver for application to answer queries from other processes.
+
+#include "geomodelgrids/apps/Server.hh" // USES Server
+
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+
+int
+main(int argc,
+     char* argv[]) {
+    geomodelgrids::apps::Server server;
+
+    int err = 0;
+    try {
+      err = server.run(argc, argv);
+    } catch (const std::exception& ex) {
+	std::cerr << ex.what() << std::endl;
+	err = 1;
+    } catch (...) {
+      std::cerr << "Caught unknown exception." << std::endl;
+      err = 2;
+    } // try/catch
+
+    return err;
+} // main
+
+
+// End of file
@@ -1,3 +1,3 @@
 """Initialization of geomodelgrids."""
 
-from ._geomodelgrids import (Model, ModelInfo, Query, ErrorHandler)
+from ._geomodelgrids import (Model, ModelInfo, Query, QueryClient, ErrorHandler)
@@ -5,10 +5,15 @@ import sys
 import argparse
 import logging
 import configparser
+import collections
+import copy
+import itertools
+import multiprocessing
 from importlib import import_module
 
 import geomodelgrids.create.core as core
 from geomodelgrids.create.utils import config
+from geomodelgrids.create.utils.batch import Checkpoint
 
 
 class App():
@@ -22,6 +27,8 @@ class App():
         """Constructor."""
         self.config = None
         self.model = None
+        self.resume = False
+        self.incremental = False
         self.show_progress = show_progress
         log_level = logging.DEBUG if debug else logging.INFO
         logging.basicConfig(level=log_level, filename=log_filename)
@@ -33,7 +40,11 @@ class App():
              import_surfaces: bool = False,
              import_blocks: bool = False,
              update_metadata: bool = False,
-             all_steps: bool = False):
+             import_pyramids: bool = False,
+             all_steps: bool = False,
+             workers: int = None,
+             resume: bool = False,
+             incremental: bool = False):
         """Main entry point.
 
         Arguments:
@@ -49,8 +60,20 @@ class App():
                 If True, write block information to model.
             update_metadata
                 If True, update all metadata in model.
+            import_pyramids
+                If True, write multi-resolution pyramids of surfaces and blocks to model (pyramids are also
+                written for surfaces and blocks that are imported).
             all
-                If True, equivalent to import_domain=True, import_surfaces=True, import_blocks=True
+                If True, equivalent to import_domain=True, import_surfaces=True, import_blocks=True,
+                import_pyramids=True
+            workers
+                Number of processes for generating batches (overrides `workers` in domain configuration).
+            resume
+                If True, skip surfaces and blocks that are complete and continue partially generated ones after
+                the last completed batch.
+            incremental
+                If True, skip surfaces and blocks that are complete and whose configuration has not changed;
+                regenerate the others from the beginning.
             show_progress
                 If False, print progress to stdout.
             log_filename
@@ -59,61 +82,164 @@ class App():
                 Print additional debugging information to log file.
         """
         self.initialize(config_filenames.split(","))
+        self.resume = resume
+        self.incremental = incremental
 
         if show_parameters:
             self.show_parameters()
             return
 
         if import_domain or import_surfaces or import_blocks or all_steps:
-            data_path = self.config["geomodelgrids"]["data_source"].split(".")
-            data_obj = getattr(import_module(".".join(data_path[:-1])), data_path[-1])
-            datasrc = data_obj(self.config)
-            datasrc.initialize()
+            datasrc = _create_datasrc(self.config)
         model = core.model.Model(self.config)
 
-        if import_domain or all_steps:
-            model.save_domain()
-
-        if import_surfaces or all_steps:
-            batch_size = int(self.config["domain"]["batch_size"]) if "batch_size" in self.config["domain"] else None
-            if model.top_surface:
-                model.init_top_surface()
-                if batch_size:
-                    for batch in model.top_surface.get_batches(batch_size):
-                        points = model.top_surface.generate_points(batch)
-                        elevation = datasrc.get_top_surface(points)
-                        model.save_top_surface(elevation, batch)
-                else:
-                    points = model.top_surface.generate_points()
-                    elevation = datasrc.get_top_surface()
-                    model.save_top_surface(elevation)
-            if model.topo_bathy:
-                model.init_topography_bathymetry()
-                if batch_size:
-                    for batch in model.topo_bathy.get_batches(batch_size):
-                        points = model.topo_bathy.generate_points(batch)
-                        elevation = datasrc.get_topography_bathymetry(points)
-                        model.save_topography_bathymetry(elevation, batch)
+        if workers is None:
+            workers = int(self.config["domain"].get("workers", 1))
+        batch_size = int(self.config["domain"]["batch_size"]) if "batch_size" in self.config["domain"] else None
+        if workers > 1 and (import_surfaces or import_blocks or all_steps):
+            logger = logging.getLogger(__name__)
+            if not batch_size:
+                logger.warning("Ignoring workers=%d; generating a model in parallel requires batch_size.", workers)
+                workers = 1
+            elif not datasrc.is_concurrent():
+                logger.warning("Ignoring workers=%d; data source %s does not support concurrent batches.",
+                               workers, type(datasrc).__name__)
+                workers = 1
+
+        # Keep the model file open and overlap writing each batch with generating the next one.
+        model.open_storage()
+        try:
+            if import_domain or all_steps:
+                model.save_domain()
+
+            if import_surfaces or all_steps:
+                if workers > 1:
+                    self._import_surfaces_parallel(model, batch_size, workers)
                 else:
-                    points = model.topo_bathy.generate_points()
-                    elevation = datasrc.get_topography_bathymetry(points)
-                    model.save_topography_bathymetry(elevation)
-
-        if import_blocks or all_steps:
-            batch_size = int(self.config["domain"]["batch_size"]) if "batch_size" in self.config["domain"] else None
-            topo_depth = model.topo_bathy if model.topo_bathy else model.top_surface
-            for block in model.blocks:
-                model.init_block(block)
-                if batch_size:
-                    for batch in block.get_batches(batch_size):
-                        values = datasrc.get_values(block, model.top_surface, topo_depth, batch)
-                        model.save_block(block, values, batch)
+                    self._import_surfaces(model, datasrc, batch_size)
+
+            if import_blocks or all_steps:
+                if workers > 1:
+                    self._import_blocks_parallel(model, batch_size, workers)
                 else:
-                    values = datasrc.get_values(block, model.top_surface, topo_depth)
-                    model.save_block(block, values)
+                    self._import_blocks(model, datasrc, batch_size)
+
+            if import_pyramids or import_surfaces or import_blocks or all_steps:
+                model.save_pyramids(surfaces=import_pyramids or import_surfaces or all_steps,
+                                    blocks=import_pyramids or import_blocks or all_steps)
+
+            if update_metadata:
+                model.update_metadata()
+        finally:
+            model.close_storage()
+
+    def _import_surfaces(self, model, datasrc, batch_size):
+        """Generate surfaces one batch at a time.
+        """
+        steps = (
+            (model.top_surface, model.init_top_surface, datasrc.get_top_surface, model.save_top_surface),
+            (model.topo_bathy, model.init_topography_bathymetry, datasrc.get_topography_bathymetry,
+             model.save_topography_bathymetry),
+        )
+        for surface, init_fn, get_fn, save_fn in steps:
+            if not surface:
+                continue
+            batches, save_fn = self._start_dataset(model, surface, batch_size, init_fn, save_fn)
+            for batch in batches:
+                points = surface.generate_points(batch)
+                save_fn(get_fn(points), batch)
+
+    def _import_blocks(self, model, datasrc, batch_size):
+        """Generate blocks one batch at a time.
+        """
+        topo_depth = model.topo_bathy if model.topo_bathy else model.top_surface
+        for block in model.blocks:
+            batches, save_fn = self._start_dataset(
+                model, block, batch_size, lambda block=block: model.init_block(block),
+                lambda values, batch, block=block: model.save_block(block, values, batch))
+            for batch in batches:
+                save_fn(datasrc.get_values(block, model.top_surface, topo_depth, batch), batch)
+
+    def _import_surfaces_parallel(self, model, batch_size, workers):
+        """Generate surface batches in a pool of worker processes and write them in order.
+        """
+        logger = logging.getLogger(__name__)
+        logger.info("Generating surfaces using %d worker processes.", workers)
+        steps = (
+            (model.top_surface, model.init_top_surface, _worker_get_top_surface, model.save_top_surface),
+            (model.topo_bathy, model.init_topography_bathymetry, _worker_get_topography_bathymetry,
+             model.save_topography_bathymetry),
+        )
+        with multiprocessing.Pool(workers, _worker_initialize, (self.config, None)) as pool:
+            for surface, init_fn, worker_fn, save_fn in steps:
+                if not surface:
+                    continue
+                batches, save_fn = self._start_dataset(model, surface, batch_size, init_fn, save_fn)
+                tasks = ((worker_fn, (copy.copy(batch),)) for batch in batches)
+                _run_ordered(pool, workers, tasks, save_fn)
 
-        if update_metadata:
-            model.update_metadata()
+    def _import_blocks_parallel(self, model, batch_size, workers):
+        """Generate block batches in a pool of worker processes and write them in order.
+
+        Workers get a copy of the surfaces in memory, so they never read the model file while it is being written.
+        """
+        logger = logging.getLogger(__name__)
+        logger.info("Generating blocks using %d worker processes.", workers)
+        surfaces = {}
+        for surface in (model.top_surface, model.topo_bathy):
+            if surface:
+                surfaces[surface.name] = surface.storage.load_surface(surface)
+        with multiprocessing.Pool(workers, _worker_initialize, (self.config, surfaces)) as pool:
+            for iblock, block in enumerate(model.blocks):
+                batches, save_fn = self._start_dataset(
+                    model, block, batch_size, lambda block=block: model.init_block(block),
+                    lambda values, batch, block=block: model.save_block(block, values, batch))
+                tasks = ((_worker_get_values, (iblock, copy.copy(batch))) for batch in batches)
+                _run_ordered(pool, workers, tasks, save_fn)
+
+    def _start_dataset(self, model, item, batch_size, init_fn, save_fn):
+        """Get batches remaining to be generated for a surface or block.
+
+        Creates the dataset unless generation resumes from a checkpoint, and wraps `save_fn` so that the
+        checkpoint is updated after each batch is written.
+
+        Args:
+            model (Model)
+                Model containing surface or block.
+            item (Surface or Block)
+                Surface or block.
+            batch_size (int)
+                Maximum number of points in a batch (None for a single batch without a batch generator).
+            init_fn (function)
+                Function that creates the dataset.
+            save_fn (function)
+                Function called with (values, batch) to write a batch.
+
+        Returns:
+            Tuple of remaining batches (iterable) and function to write a batch and update the checkpoint.
+        """
+        logger = logging.getLogger(__name__)
+        batches = item.get_batches(batch_size) if batch_size else [None]
+        checkpoint = Checkpoint(model.get_signature(item), batch_size or 0, len(batches))
+
+        previous = model.load_checkpoint(item) if self.resume or self.incremental else None
+        if previous and previous.signature == checkpoint.signature and previous.is_complete():
+            logger.info("Skipping '%s'; it is complete and its configuration has not changed.", item.name)
+            return ([], save_fn)
+        if previous and self.resume and checkpoint.can_resume(previous):
+            checkpoint.num_done = previous.num_done
+            logger.info("Resuming '%s' after batch %d of %d.", item.name, checkpoint.num_done, checkpoint.num_batches)
+        else:
+            if previous:
+                logger.info("Regenerating '%s'; its configuration or batch size has changed.", item.name)
+            init_fn()
+
+        def _save(values, batch):
+            save_fn(values, batch)
+            checkpoint.num_done += 1
+            model.save_checkpoint(item, checkpoint)
+
+        return (itertools.islice(batches, checkpoint.num_done, None), _save)
 
     def initialize(self, config_filenames):
         """Set parameters from config file and DEFAULTS.
@@ -132,6 +258,91 @@ class App():
         parser.write(sys.stdout)
 
 
+def _create_datasrc(config):
+    """Create and initialize data source specified in configuration.
+    """
+    data_path = config["geomodelgrids"]["data_source"].split(".")
+    data_obj = getattr(import_module(".".join(data_path[:-1])), data_path[-1])
+    datasrc = data_obj(config)
+    datasrc.initialize()
+    return datasrc
+
+
+def _run_ordered(pool, workers, tasks, save_fn):
+    """Run tasks in pool and pass results to `save_fn` in the order the tasks were submitted.
+
+    The number of pending tasks is limited to twice the number of workers to bound memory use when
+    the workers produce values faster than they can be written.
+
+    Args:
+        pool (multiprocessing.Pool)
+            Pool of worker processes.
+        workers (int)
+            Number of worker processes.
+        tasks (iterable)
+            Tuples of (function, args) where the last argument is the batch.
+        save_fn (function)
+            Function called with (result, batch) to write a result.
+    """
+    pending = collections.deque()
+    for fn, args in tasks:
+        pending.append((pool.apply_async(fn, args), args[-1]))
+        if len(pending) >= 2 * workers:
+            result, batch = pending.popleft()
+            save_fn(result.get(), batch)
+    while pending:
+        result, batch = pending.popleft()
+        save_fn(result.get(), batch)
+
+
+class _SurfaceSnapshot():
+    """In-memory copy of surfaces with the storage interface used by Block.get_surface().
+    """
+
+    def __init__(self, surfaces):
+        self.surfaces = surfaces
+
+    def load_surface(self, surface, batch=None):
+        elevation = self.surfaces[surface.name]
+        if batch:
+            x_start, x_end = batch.x_range
+            y_start, y_end = batch.y_range
+            elevation = elevation[x_start:x_end, y_start:y_end]
+        return elevation
+
+
+_worker = {}
+
+
+def _worker_initialize(config, surfaces):
+    """Create data source and model in worker process.
+    """
+    model = core.model.Model(config)
+    if surfaces:
+        storage = _SurfaceSnapshot(surfaces)
+        for surface in (model.top_surface, model.topo_bathy):
+            if surface:
+                surface.storage = storage
+    _worker["model"] = model
+    _worker["datasrc"] = _create_datasrc(config)
+
+
+def _worker_get_top_surface(batch):
+    points = _worker["model"].top_surface.generate_points(batch)
+    return _worker["datasrc"].get_top_surface(points)
+
+
+def _worker_get_topography_bathymetry(batch):
+    points = _worker["model"].topo_bathy.generate_points(batch)
+    return _worker["datasrc"].get_topography_bathymetry(points)
+
+
+def _worker_get_values(iblock, batch):
+    model = _worker["model"]
+    topo_depth = model.topo_bathy if model.topo_bathy else model.top_surface
+    return _worker["datasrc"].get_values(model.blocks[iblock], model.top_surface, topo_depth, batch)
+
+
 def cli():
     """Parse command line arguments.
     """
@@ -146,8 +357,12 @@ def cli():
     parser.add_argument("--import-surfaces", action="store_true", dest="import_surfaces")
     parser.add_argument("--import-blocks", action="store_true", dest="import_blocks")
     parser.add_argument("--update-metadata", action="store_true", dest="update_metadata")
+    parser.add_argument("--import-pyramids", action="store_true", dest="import_pyramids")
 
     parser.add_argument("--all", action="store_true", dest="all")
+    parser.add_argument("--workers", action="store", dest="workers", type=int, default=None)
+    parser.add_argument("--resume", action="store_true", dest="resume")
+    parser.add_argument("--incremental", action="store_true", dest="incremental")
     parser.add_argument("--quiet", action="store_false", dest="show_progress", default=True)
     parser.add_argument("--log", action="store", dest="log_filename", default="create_model.log")
     parser.add_argument("--debug", action="store_true", dest="debug")
@@ -155,11 +370,17 @@ def cli():
 
     app = App(show_progress=True, debug=args.debug, log_filename=args.log_filename)
     kwargs = {
+        "config_filenames": args.config,
         "show_parameters": args.show_parameters,
         "import_domain": args.import_domain,
         "import_surfaces": args.import_surfaces,
         "import_blocks": args.import_blocks,
         "update_metadata": args.update_metadata,
+        "import_pyramids": args.import_pyramids,
+        "all_steps": args.all,
+        "workers": args.workers,
+        "resume": args.resume,
+        "incremental": args.incremental,
     }
     app.main(**kwargs)
 
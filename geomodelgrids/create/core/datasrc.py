@@ -25,6 +25,16 @@ class DataSrc(ABC):
         """
         return {}
 
+    def is_concurrent(self):
+        """Check whether the data source can generate values in multiple processes at the same time.
+
+        Each process creates and initializes its own copy of the data source from the model configuration,
+        so data sources that share files or other resources across processes should return False.
+
+        @returns True if batches can be generated concurrently, False otherwise.
+        """
+        return False
+
     @abstractmethod
     def get_top_surface(self, points):
         """Query model for elevation of top surface at points.
@@ -3,6 +3,8 @@
 
 import logging
 import math
+import json
+import hashlib
 from dataclasses import dataclass, field
 from typing import List, Dict
 
@@ -530,6 +532,20 @@ class Model():
 
         self._initialize(config)
 
+    def open_storage(self, queue_size=2):
+        """Keep storage open and write batches in the background until close_storage() is called.
+
+        Args:
+            queue_size (int)
+                Maximum number of batches waiting to be written.
+        """
+        self.storage.open(queue_size)
+
+    def close_storage(self):
+        """Write pending batches and close storage.
+        """
+        self.storage.close()
+
     def save_domain(self):
         """Write domain information to storage."""
         self.storage.save_domain(self)
@@ -588,6 +604,86 @@ class Model():
         """
         self.storage.save_block(block, values, batch)
 
+    def save_pyramids(self, surfaces=True, blocks=True):
+        """Write multi-resolution pyramids of surfaces and/or blocks to storage.
+
+        The number of levels is given by 'pyramid_levels' in the 'domain' section (default is 0, no pyramids).
+
+        Args:
+            surfaces (bool)
+                If True, write pyramids of surfaces.
+            blocks (bool)
+                If True, write pyramids of blocks.
+        """
+        num_levels = int(self.config["domain"].get("pyramid_levels", 0))
+        if num_levels <= 0:
+            return
+        items = []
+        if surfaces:
+            items += [surface for surface in (self.top_surface, self.topo_bathy) if surface]
+        if blocks:
+            items += self.blocks
+        logger = logging.getLogger(__name__)
+        for item in items:
+            num_written = self.storage.save_pyramid(self._get_group(item), item.name, num_levels)
+            logger.info("Wrote %d pyramid levels for '%s'.", num_written, item.name)
+
+    def get_signature(self, item):
+        """Get signature of the configuration that determines the values of a surface or block.
+
+        The signature covers the parameters of the surface or block, the surfaces (for blocks), the data
+        source, and the shared sections (coordinate system, data, domain, and data source parameters). It omits
+        descriptive metadata and parameters that do not change the values, such as the batch size.
+
+        Args:
+            item (Surface or Block)
+                Surface or block.
+
+        Returns:
+            Signature as hexadecimal string.
+        """
+        surface_names = [surface.name for surface in (self.top_surface, self.topo_bathy) if surface]
+        block_names = [block.name for block in self.blocks]
+        IGNORE_DOMAIN = ("blocks", "batch_size", "workers", "pyramid_levels")
+
+        sections = {}
+        for name, section in self.config.items():
+            if name in surface_names or name in block_names:
+                continue
+            if name == "geomodelgrids":
+                section = {"data_source": section.get("data_source")}
+            elif name == "domain":
+                section = {key: value for key, value in section.items() if key not in IGNORE_DOMAIN}
+            sections[name] = section
+        sections[item.name] = self.config[item.name]
+        if isinstance(item, Block):
+            for name in surface_names:
+                sections[name] = self.config[name]
+        return hashlib.sha256(json.dumps(sections, sort_keys=True).encode("utf-8")).hexdigest()
+
+    def save_checkpoint(self, item, checkpoint):
+        """Write progress generating surface or block to storage.
+
+        Args:
+            item (Surface or Block)
+                Surface or block.
+            checkpoint (utils.batch.Checkpoint)
+                Progress generating surface or block.
+        """
+        self.storage.save_checkpoint(self._get_group(item), item.name, checkpoint)
+
+    def load_checkpoint(self, item):
+        """Load progress generating surface or block from storage.
+
+        Args:
+            item (Surface or Block)
+                Surface or block.
+
+        Returns:
+            Checkpoint or None if the surface or block has not been started.
+        """
+        return self.storage.load_checkpoint(self._get_group(item), item.name)
+
     def update_metadata(self):
         """Update all metadata for model using current model configuration.
         """
@@ -606,6 +702,7 @@ class Model():
             config (dict)
                 Model configuration.
         """
+        self.config = config
         self.metadata = ModelMetadata(config)
 
         for name in string_to_list(config["domain"]["blocks"]):
@@ -623,6 +720,10 @@ class Model():
         else:
             self.topo_bathy = None
 
+    @staticmethod
+    def _get_group(item):
+        return "blocks" if isinstance(item, Block) else "surfaces"
+
     @staticmethod
     def get_attributes():
         """Get attributes for model.
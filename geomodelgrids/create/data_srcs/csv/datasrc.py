@@ -1,7 +1,12 @@
 """CSV data source.
 """
 
-from importlib import import_module
+import itertools
+import os
+import shutil
+import tempfile
+import warnings
+import weakref
 
 import numpy
 
@@ -10,6 +15,10 @@ from geomodelgrids.create.utils.config import string_to_list
 from geomodelgrids.create.core import NODATA_VALUE
 
 
+# Default number of rows in each chunk read from CSV file.
+DEFAULT_CHUNK_SIZE = 1000000
+
+
 class CSVFile(DataSrc):
     """CSV file data source.
     """
@@ -23,6 +32,11 @@ class CSVFile(DataSrc):
         """
         super().__init__()
         self.config = config
+        self.transformer = None
+        self._spill_dir = None
+        self._rows_filename = None
+        self._batch_dir = None
+        self._routed_key = None
 
     def initialize(self):
         """Initialize model.
@@ -44,6 +58,11 @@ class CSVFile(DataSrc):
     def get_values(self, block, top_surface, topo_bathy, batch=None):
         """Get values at points.
 
+        The CSV file is parsed only once. The first call converts the rows to model coordinates and spills them
+        to a binary file; the first call for a block routes the rows in that block to one spill file per batch.
+        Each call then reads only the spill file for its batch. Memory use is bounded by `csv.chunk_size` and the
+        batch size rather than the size of the CSV file.
+
         Args:
             block (Block)
                 Block information.
@@ -54,58 +73,236 @@ class CSVFile(DataSrc):
             batch (BatchGenerator3D)
                 Current batch of points in block.
         """
-        def _varxy_index_fn(coordinates):
-            x_grid = numpy.array(coordinates)
-            x_grid.sort()
-            x_round = -int(numpy.log10(numpy.min(numpy.diff(x_grid))))
-            return x_grid.searchsorted(round(x, x_round))
-
+        value_names = string_to_list(self.config["data"]["values"])
+        nx, ny, nz = block.get_dims()
         if batch:
-            raise NotImplementedError("Batches with CSV files are not implemented.")
+            x_range, y_range, z_range = batch.x_range, batch.y_range, batch.z_range
+            batch_dims = (batch.bnum_x, batch.bnum_y, batch.bnum_z)
+        else:
+            x_range, y_range, z_range = (0, nx), (0, ny), (0, nz)
+            batch_dims = (nx, ny, nz)
+        start = numpy.array([x_range[0], y_range[0], z_range[0]])
+        end = numpy.array([x_range[1], y_range[1], z_range[1]])
 
-        comment_flag = self.config["csv"].get("comment_flag", "#")
-        csv_data = numpy.loadtxt(self.config["csv"]["filename"], comments=comment_flag)
-        model_x, model_y, model_z = self._to_model_xyz(csv_data)
+        self._route_rows(block, batch_dims, len(value_names))
+        values = NODATA_VALUE * numpy.ones(tuple(end - start) + (len(value_names),), dtype=numpy.float32)
+        filename = self._batch_filename(start // numpy.array(batch_dims))
+        if os.path.exists(filename):
+            rows = numpy.fromfile(filename, dtype=self._batch_dtype(len(value_names)))
+            ix, iy, iz = (rows["index"] - start).transpose()
+            values[ix, iy, iz, :] = rows["values"]
+        return values
+
+    def _route_rows(self, block, batch_dims, num_values):
+        """Write rows in block to one spill file per batch, unless already done for this block and batch size.
+
+        Args:
+            block (Block)
+                Block information.
+            batch_dims (tuple)
+                Number of points in a batch along x, y, and z axes.
+            num_values (int)
+                Number of values in each row.
+        """
+        key = (block.name, batch_dims)
+        if self._routed_key == key:
+            return
+        self._spill_rows(num_values)
+        shutil.rmtree(self._batch_dir, ignore_errors=True)
+        os.makedirs(self._batch_dir)
+        self._routed_key = None
+
+        if not os.path.getsize(self._rows_filename):
+            self._routed_key = key
+            return
+        chunk_size = int(self.config["csv"].get("chunk_size", DEFAULT_CHUNK_SIZE))
+        rows = numpy.memmap(self._rows_filename, dtype=numpy.float64, mode="r").reshape((-1, 3 + num_values))
+        batch_dtype = self._batch_dtype(num_values)
+        dims = numpy.array(block.get_dims())
+        for row_start in range(0, rows.shape[0], chunk_size):
+            chunk = rows[row_start:row_start+chunk_size]
+            indices = self._get_indices(block, chunk[:, 0], chunk[:, 1], chunk[:, 2])
+            mask = numpy.all((indices >= 0) & (indices < dims), axis=1)
+            indices = indices[mask]
+            batch_ids = indices // numpy.array(batch_dims)
+            order = numpy.lexsort(batch_ids.transpose()[::-1])
+            batch_ids, counts = numpy.unique(batch_ids[order], axis=0, return_counts=True)
+            batch_rows = numpy.empty(indices.shape[0], dtype=batch_dtype)
+            batch_rows["index"] = indices[order]
+            batch_rows["values"] = chunk[mask][order, 3:]
+            offset = 0
+            for batch_id, count in zip(batch_ids, counts):
+                with open(self._batch_filename(batch_id), "ab") as fout:
+                    batch_rows[offset:offset+count].tofile(fout)
+                offset += count
+        del rows
+        self._routed_key = key
+
+    def _spill_rows(self, num_values):
+        """Parse CSV file and write coordinates and values to binary file, unless already done.
+
+        Each row of the binary file has the model x, y, and z coordinates and the values as float64.
+
+        Args:
+            num_values (int)
+                Number of values in each row.
+        """
+        if self._spill_dir:
+            return
+        self._spill_dir = tempfile.mkdtemp(prefix="geomodelgrids-csv-", dir=self.config["csv"].get("spill_dir"))
+        weakref.finalize(self, shutil.rmtree, self._spill_dir, ignore_errors=True)
+        self._rows_filename = os.path.join(self._spill_dir, "rows.bin")
+        self._batch_dir = os.path.join(self._spill_dir, "batches")
 
         value_names = string_to_list(self.config["data"]["values"])
-        value_columns = [int(self.config["csv.columns"][value]) for value in value_names]
+        with open(self._rows_filename, "wb") as fout:
+            for model_x, model_y, model_z, chunk_values in self._read_chunks(value_names):
+                chunk = numpy.empty((model_x.size, 3 + num_values), dtype=numpy.float64)
+                chunk[:, 0] = model_x
+                chunk[:, 1] = model_y
+                chunk[:, 2] = model_z
+                chunk[:, 3:] = chunk_values
+                chunk.tofile(fout)
+
+    def _batch_filename(self, batch_id):
+        """Get name of spill file for batch.
+
+        Args:
+            batch_id (numpy.array [3])
+                Index of batch along x, y, and z axes.
+        Returns:
+            Name of file.
+        """
+        return os.path.join(self._batch_dir, "batch-{}-{}-{}.bin".format(*batch_id))
+
+    @staticmethod
+    def _batch_dtype(num_values):
+        """Get data type of rows in batch spill files.
+
+        Args:
+            num_values (int)
+                Number of values in each row.
+        Returns:
+            Numpy structured data type with grid indices and values.
+        """
+        return numpy.dtype([("index", numpy.int64, (3,)), ("values", numpy.float32, (num_values,))])
+
+    def _read_chunks(self, value_names):
+        """Read CSV file in chunks.
+
+        Only the columns with coordinates and values are parsed. Uses pandas if available and numpy.loadtxt
+        otherwise.
+
+        Args:
+            value_names (list)
+                Names of values.
+        Returns:
+            Generator of tuples (model_x, model_y, model_z, values) for each chunk.
+        """
+        comment_flag = self.config["csv"].get("comment_flag", "#")
+        chunk_size = int(self.config["csv"].get("chunk_size", DEFAULT_CHUNK_SIZE))
+        columns = [int(self.config["csv.columns"][name]) for name in ["x", "y", "z"] + value_names]
+
+        try:
+            import pandas
+        except ImportError:
+            pandas = None
+        if pandas:
+            reader = pandas.read_csv(self.config["csv"]["filename"], sep=r"\s+", header=None,
+                                     comment=comment_flag, usecols=sorted(set(columns)), dtype=numpy.float64,
+                                     chunksize=chunk_size)
+            chunks = (frame[columns].to_numpy() for frame in reader)
+        else:
+            chunks = self._loadtxt_chunks(comment_flag, columns, chunk_size)
+        for csv_data in chunks:
+            if not csv_data.shape[0]:
+                continue
+            model_x, model_y, model_z = self._to_model_xyz(csv_data[:, 0], csv_data[:, 1], csv_data[:, 2])
+            yield (model_x, model_y, model_z, csv_data[:, 3:])
+
+    def _loadtxt_chunks(self, comment_flag, columns, chunk_size):
+        """Parse CSV file in chunks using numpy.loadtxt.
+
+        Args:
+            comment_flag (str)
+                Character marking comments.
+            columns (list)
+                Indices of columns to parse.
+            chunk_size (int)
+                Number of lines in each chunk.
+        Returns:
+            Generator of numpy arrays [N, len(columns)] for each chunk.
+        """
+        with open(self.config["csv"]["filename"], "r") as fin:
+            while True:
+                lines = list(itertools.islice(fin, chunk_size))
+                if not lines:
+                    break
+                with warnings.catch_warnings():
+                    warnings.simplefilter("ignore")  # Chunks with only comments
+                    yield numpy.loadtxt(lines, comments=comment_flag, usecols=columns, ndmin=2)
+
+    @staticmethod
+    def _get_indices(block, model_x, model_y, model_z):
+        """Get indices of grid points in block.
+
+        Args:
+            block (Block)
+                Block information.
+            model_x (numpy.array [N])
+                Model x coordinate of points.
+            model_y (numpy.array [N])
+                Model y coordinate of points.
+            model_z (numpy.array [N])
+                Elevation of points.
+        Returns:
+            Numpy array [N, 3] with indices of points along x, y, and z axes.
+        """
+        def _varxyz_index_fn(coordinates, values):
+            """Get index of nearest coordinate in ascending order; -1 if not within half of the grid spacing."""
+            grid = numpy.sort(coordinates)
+            tolerance = 0.5 * numpy.min(numpy.diff(grid))
+            index = numpy.clip(grid.searchsorted(values), 1, grid.size - 1)
+            index -= (values - grid[index-1]) < (grid[index] - values)
+            return numpy.where(numpy.abs(grid[index] - values) < tolerance, index, -1)
 
         if block.x_resolution:
-            def get_xindex(x, block): return round(x / block.x_resolution)
+            ix = numpy.rint(model_x / block.x_resolution)
         else:
-            def get_xindex(x, block): return _varxy_index_fn(block.x_coordinates)
+            ix = _varxyz_index_fn(block.x_coordinates, model_x)
         if block.y_resolution:
-            def get_yindex(y, block): return round(y / block.y_resolution)
+            iy = numpy.rint(model_y / block.y_resolution)
         else:
-            def get_yindex(y, block): return _varxy_index_fn(block.y_coordinates)
+            iy = _varxyz_index_fn(block.y_coordinates, model_y)
         if block.z_resolution:
-            def get_zindex(z, block): return round(z / block.z_resolution)
+            iz = numpy.rint((block.z_top - model_z) / block.z_resolution)
         else:
-            z_grid = numpy.array(block.z_coordinates)
-            z_grid.sort()
-            z_round = -int(numpy.log10(numpy.min(numpy.diff(z_grid))))
-            def get_zindex(z, block): return len(z_grid) - 1 - z_grid.searchsorted(round(z, z_round))
+            iz = _varxyz_index_fn(block.z_coordinates, model_z)
+            iz = numpy.where(iz >= 0, len(block.z_coordinates) - 1 - iz, -1)
+        return numpy.stack((ix, iy, iz), axis=1).astype(numpy.int64)
 
-        nx, ny, nz = block.get_dims()
-        values = NODATA_VALUE * numpy.ones((nx, ny, nz, len(value_names)), dtype=numpy.float32)
-        for row, x, y, z in zip(csv_data, model_x, model_y, model_z):
-            ix = get_xindex(x, block)
-            iy = get_yindex(y, block)
-            iz = get_zindex(z, block)
-            row_values = row[value_columns]
-            values[ix, iy, iz, :] = row_values
-        return values
-
-    def _to_model_xyz(self, csv_data):
-        import pyproj
+    def _to_model_xyz(self, x, y, z):
+        """Transform coordinates from CSV CRS to model coordinate system.
 
-        transformer = pyproj.Transformer.from_crs(
-            crs_to=self.config["coordsys"]["crs"], crs_from=self.config["csv"]["crs"], always_xy=True)
+        Args:
+            x (numpy.array [N])
+                X coordinate of points in CSV CRS.
+            y (numpy.array [N])
+                Y coordinate of points in CSV CRS.
+            z (numpy.array [N])
+                Z coordinate of points in CSV CRS.
+        Returns:
+            Tuple of model x, y, and z coordinates.
+        """
+        if self.config["csv"]["crs"] == self.config["coordsys"]["crs"]:
+            (tmp_x, tmp_y, model_z) = (x, y, z)
+        else:
+            if self.transformer is None:
+                import pyproj
 
-        ix = int(self.config["csv.columns"]["x"])
-        iy = int(self.config["csv.columns"]["y"])
-        iz = int(self.config["csv.columns"]["z"])
-        (tmp_x, tmp_y, model_z) = transformer.transform(csv_data[:, ix], csv_data[:, iy], csv_data[:, iz])
+                self.transformer = pyproj.Transformer.from_crs(
+                    crs_to=self.config["coordsys"]["crs"], crs_from=self.config["csv"]["crs"], always_xy=True)
+            (tmp_x, tmp_y, model_z) = self.transformer.transform(x, y, z)
 
         origin_x = float(self.config["coordsys"]["origin_x"])
         origin_y = float(self.config["coordsys"]["origin_y"])
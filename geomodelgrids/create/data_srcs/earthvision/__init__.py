@@ -2,3 +2,4 @@
 
 from . import api
 from . import datasrc
+from . import rules
@@ -3,20 +3,73 @@
 
 import os
 import subprocess
+import threading
 import logging
 
 import numpy
 
 
+# Number of points formatted per write when writing points files.
+WRITE_BLOCK_SIZE = 65536
+
+
+def write_points(fout, points):
+    """Write points to an EarthVision points file.
+
+    Points are formatted in blocks rather than line by line as in numpy.savetxt.
+
+    Args:
+        fout (file)
+            File object opened for writing text.
+        points (numpy.array [N, D])
+            Coordinates of points.
+    """
+    npts, ndims = points.shape
+    line = " ".join(["%16.8e"] * ndims) + "\n"
+    for start in range(0, npts, WRITE_BLOCK_SIZE):
+        block = points[start:start+WRITE_BLOCK_SIZE]
+        fout.write((line * block.shape[0]) % tuple(block.ravel()))
+
+
+def read_labels(fin, dtype):
+    """Read output of ev_label.
+
+    Columns are tab delimited and names are enclosed in double quotes. The columns are parsed in a single pass
+    without per-field converters, and the quotes are stripped from string columns afterwards.
+
+    Args:
+        fin (str or file)
+            Name of file or file object with output of ev_label.
+        dtype (dict)
+            Names and numpy types of columns.
+    Returns:
+        Numpy structured array with values.
+    """
+    data = numpy.atleast_1d(numpy.loadtxt(fin, delimiter="\t", dtype=dtype))
+    for name, fmt in zip(dtype["names"], dtype["formats"]):
+        if numpy.dtype(fmt).kind == "U":
+            data[name] = numpy.char.strip(data[name], '"')
+    return data
+
+
 class EarthVisionAPI():
     """API to EarthVision programs.
     """
 
-    def __init__(self, model_dir, env):
-        """
+    def __init__(self, model_dir, env, use_fifo=False):
+        """Constructor.
+
+        Args:
+            model_dir (str)
+                Directory containing EarthVision model.
+            env (dict)
+                Environment variables for EarthVision programs.
+            use_fifo (bool)
+                Stream points to and values from ev_label using named pipes instead of files.
         """
         self.model_dir = model_dir
         self.env = env
+        self.use_fifo = use_fifo
 
     def ev_facedump(self, filename_faces):
         """Run 'ev_facedump {filename_faces}'.
@@ -32,29 +85,40 @@ class EarthVisionAPI():
         result = subprocess.run(cmd.split(), cwd=self.model_dir, env=self.env, stdout=subprocess.PIPE, check=True)
         return result.stdout.decode().split("\n")
 
-    def ev_label(self, filename_values, filename_points, filename_model, dtype, converters):
+    def ev_label(self, filename_values, filename_points, filename_model, points, dtype):
         """Run 'ev_label -m FILENAME_MODEL -o FILENAME_VALUES FILE'.
 
         Args:
             filename_values (str)
                 Name of file for output values.
             filename_points (str)
-                Name of file with input points.
+                Name of file for input points.
             filename_model (str)
                 Name of EarthVision model (.seq) file.
+            points (numpy.array [N, 3])
+                Coordinates of points in EarthVision units.
             dtype (dict)
-                Dictionary containing types for output.
-            converters (dict)
-                Dictionary for converting output to dtype.
+                Names and numpy types of output columns.
+        Returns:
+            Numpy structured array with output.
         """
         cmd = "ev_label -m {ev_model} -o {filename_out} -suppress VolumeIndex {filename_in}".format(
             filename_in=filename_points, filename_out=filename_values, ev_model=filename_model)
         logger = logging.getLogger(__name__)
         logger.info("Running EarthVision command '%s' in directory '%s' and environment %s.",
                     cmd, self.model_dir, self.env)
-        subprocess.run(cmd.split(), cwd=self.model_dir, env=self.env, check=True)
+        points_abspath = os.path.join(self.model_dir, filename_points)
         values_abspath = os.path.join(self.model_dir, filename_values)
-        return numpy.loadtxt(values_abspath, delimiter="\t", dtype=dtype, converters=converters)
+        if self.use_fifo:
+            return self._ev_label_fifo(cmd, points_abspath, values_abspath, points, dtype)
+
+        with open(points_abspath, "w") as fout:
+            write_points(fout, points)
+        subprocess.run(cmd.split(), cwd=self.model_dir, env=self.env, check=True)
+        data = read_labels(values_abspath, dtype)
+        os.remove(points_abspath)
+        os.remove(values_abspath)
+        return data
 
     def ev_fp(self, formula, filename_out=None):
         """Run 'ev_fp < {formula}'.
@@ -72,5 +136,35 @@ class EarthVisionAPI():
             "utf-8"), cwd=self.model_dir, env=self.env, stdout=subprocess.PIPE, check=True)
         return numpy.loadtxt(filename_out) if filename_out else result.stdout
 
+    def _ev_label_fifo(self, cmd, points_abspath, values_abspath, points, dtype):
+        """Run ev_label with named pipes for the points and values.
+
+        Points are written from a separate thread while the values are parsed as ev_label writes them, so
+        neither is stored on disk.
+        """
+        for path in (points_abspath, values_abspath):
+            if os.path.exists(path):
+                os.remove(path)
+            os.mkfifo(path)
+
+        def _write():
+            with open(points_abspath, "w") as fout:
+                write_points(fout, points)
+
+        try:
+            process = subprocess.Popen(cmd.split(), cwd=self.model_dir, env=self.env)
+            writer = threading.Thread(target=_write, daemon=True)
+            writer.start()
+            with open(values_abspath, "r") as fin:
+                data = read_labels(fin, dtype)
+            writer.join()
+            returncode = process.wait()
+            if returncode:
+                raise subprocess.CalledProcessError(returncode, cmd)
+        finally:
+            os.remove(points_abspath)
+            os.remove(values_abspath)
+        return data
+
 
 # End of file
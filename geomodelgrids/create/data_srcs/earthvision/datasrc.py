@@ -12,6 +12,7 @@ from geomodelgrids.create.core.datasrc import DataSrc
 from geomodelgrids.create.utils import units
 from geomodelgrids.create.utils.config import string_to_list
 from geomodelgrids.create.data_srcs.earthvision import api
+from geomodelgrids.create.data_srcs.earthvision import rules
 from geomodelgrids.create.core import NODATA_VALUE
 
 
@@ -19,16 +20,19 @@ class RulesDataSrc(DataSrc):
     """EarthVision model constructed from rules applies to fault blocks and zones.
     """
     @staticmethod
-    def query_rule(rules_fn, data, depth):
-        return rules_fn(data[3], data[4])(data[0], data[1], depth)
+    def map_ids(ids, names):
+        """Map names to ids, looking up each unique name once.
 
-    @staticmethod
-    def set_faultblock_id(faultblock_ids, name):
-        return faultblock_ids[name]
-
-    @staticmethod
-    def set_zone_id(zone_ids, name):
-        return zone_ids[name]
+        Args:
+            ids (dict)
+                Mapping of names to ids.
+            names (numpy.array)
+                Names to map.
+        Returns:
+            Numpy array of ids.
+        """
+        unique_names, index = numpy.unique(names, return_inverse=True)
+        return numpy.array([ids[name] for name in unique_names], dtype=numpy.float64)[index]
 
     def __init__(self, config):
         """Constructor.
@@ -49,7 +53,8 @@ class RulesDataSrc(DataSrc):
         """
         self.model_dir = os.path.expanduser(self.config["earthvision"]["model_dir"])
         ev_env = self.config["earthvision.environment"]
-        self.api = api.EarthVisionAPI(self.model_dir, ev_env)
+        use_fifo = self.config["earthvision"].get("exchange", "file") == "fifo"
+        self.api = api.EarthVisionAPI(self.model_dir, ev_env, use_fifo)
         self._get_faultblocks_zones()
         self.config["auxiliary"] = {
             "fault_block_ids": self.faultblock_ids,
@@ -72,7 +77,8 @@ class RulesDataSrc(DataSrc):
         elev_abspath = os.path.join(self.model_dir, ELEV_FILENAME)
         scale = units.length_scale(self.config["earthvision"]["xy_units"])
 
-        numpy.savetxt(points_abspath, points.reshape((-1, points.shape[2])) / scale, fmt="%16.8e")
+        with open(points_abspath, "w") as fout:
+            api.write_points(fout, points.reshape((-1, points.shape[2])) / scale)
 
         elev = -1.0e+20 * numpy.ones(points.shape[0:2])
         for grd_filename in string_to_list(self.config["earthvision"]["top_surface_2grd"]):
@@ -102,7 +108,8 @@ class RulesDataSrc(DataSrc):
         elev_abspath = os.path.join(self.model_dir, ELEV_FILENAME)
         scale = units.length_scale(self.config["earthvision"]["xy_units"])
 
-        numpy.savetxt(points_abspath, points.reshape((-1, points.shape[2])) / scale, fmt="%16.8e")
+        with open(points_abspath, "w") as fout:
+            api.write_points(fout, points.reshape((-1, points.shape[2])) / scale)
 
         elev = -1.0e+20 * numpy.ones(points.shape[0:2])
         for grd_filename in string_to_list(self.config["earthvision"]["topography_bathymetry_2grd"]):
@@ -137,25 +144,15 @@ class RulesDataSrc(DataSrc):
         }
         hscale = units.length_scale(self.config["earthvision"]["xy_units"])
         vscale = units.length_scale(self.config["earthvision"]["elev_units"])
-        converters = {
-            0: lambda s: hscale*float(s),
-            1: lambda s: hscale*float(s),
-            2: lambda s: vscale*float(s),
-            3: lambda s: s.decode("utf-8").strip('"'),
-            4: lambda s: s.decode("utf-8").strip('"'),
-        }
 
-        points_abspath = os.path.join(self.model_dir, POINTS_FILENAME)
         points = block.generate_points(top_surface, batch)
 
         ev_points = points.reshape((-1, points.shape[3])).copy()
         ev_points[:, 0:2] /= hscale
         ev_points[:, 2] /= vscale
-        numpy.savetxt(points_abspath, ev_points, fmt="%16.8e")
-        del ev_points
-
         ev_model = self.config["earthvision"]["geologic_model"]
-        data = self.api.ev_label(VALUES_FILENAME, POINTS_FILENAME, ev_model, DTYPE, converters)
+        data = self.api.ev_label(VALUES_FILENAME, POINTS_FILENAME, ev_model, ev_points, DTYPE)
+        del ev_points
 
         topo_bathy_elev = block.get_surface(topo_bathy, batch)
         depth = numpy.zeros(points.shape[:-1])
@@ -169,20 +166,17 @@ class RulesDataSrc(DataSrc):
             if not path in sys.path:
                 sys.path.append(path)
         rules_fn = getattr(import_module(".".join(fn_path[:-1])), fn_path[-1])
-        rules_values = numpy.vectorize(self.query_rule)(rules_fn, data, depth.ravel())
+        x = hscale * data["x"].astype(numpy.float64)
+        y = hscale * data["y"].astype(numpy.float64)
+        rules_values = rules.apply_rules(rules_fn, data["fault_block"], data["zone"], x, y, depth.ravel())
         del depth
 
         # Append fault block and zone id to values
         # :KLUDGE: Fault block and zone id are converted from int to float
-        faultblock_id = numpy.vectorize(self.set_faultblock_id)(self.faultblock_ids, data["fault_block"])
-        zone_id = numpy.vectorize(self.set_zone_id)(self.zone_ids, data["zone"])
-        values = numpy.vstack([v for v in rules_values] + [faultblock_id.reshape((1, -1)),
-                                                           zone_id.reshape((1, -1))]).transpose()
+        faultblock_id = self.map_ids(self.faultblock_ids, data["fault_block"])
+        zone_id = self.map_ids(self.zone_ids, data["zone"])
+        values = numpy.vstack([rules_values, faultblock_id.reshape((1, -1)), zone_id.reshape((1, -1))]).transpose()
         values = values.reshape((points.shape[0], points.shape[1], points.shape[2], -1))
-
-        data_abspath = os.path.join(self.model_dir, VALUES_FILENAME)
-        os.remove(points_abspath)
-        os.remove(data_abspath)
         return values
 
     def _get_faultblocks_zones(self):
@@ -0,0 +1,134 @@
+"""Evaluation of rules assigning values to points based on fault block and zone.
+
+A rules function `rules_fn(fault_block, zone)` returns the rule for a fault block and zone. A rule computes
+the values at a point, `rule(x, y, depth)`, and returns a tuple of values. A rule marked with the `vectorized`
+decorator accepts numpy arrays of x, y, and depth and returns a tuple of arrays (or scalars, for values that
+are uniform).
+
+The points are grouped by fault block and zone, so the rules function is called once per group rather than
+once per point. Vectorized rules are evaluated once per group; other (per-point) rules are wrapped by
+`as_vectorized` and evaluated point by point.
+"""
+
+import numpy
+
+
+def vectorized(rule):
+    """Decorator marking rule as accepting numpy arrays of x, y, and depth.
+
+    Args:
+        rule (function)
+            Rule computing values from x, y, depth.
+    Returns:
+        Rule.
+    """
+    rule.vectorized = True
+    return rule
+
+
+def is_vectorized(rule):
+    """Check whether rule accepts numpy arrays of x, y, and depth.
+
+    Args:
+        rule (function)
+            Rule computing values from x, y, depth.
+    Returns:
+        True if rule is vectorized, False otherwise.
+    """
+    return getattr(rule, "vectorized", False)
+
+
+def as_vectorized(rule):
+    """Adapt rule to accept numpy arrays of x, y, and depth.
+
+    Vectorized rules are returned as is. Per-point rules are wrapped so they are evaluated point by point.
+
+    Args:
+        rule (function)
+            Rule computing values from x, y, depth.
+    Returns:
+        Vectorized rule.
+    """
+    if is_vectorized(rule):
+        return rule
+
+    @vectorized
+    def _pointwise(x, y, depth):
+        values = [rule(xp, yp, dp) for xp, yp, dp in zip(x, y, depth)]
+        return tuple(numpy.array(values, dtype=numpy.float64).reshape((len(values), -1)).transpose())
+    return _pointwise
+
+
+def where(condition, values_true, values_false):
+    """Select values from two rules on a point by point basis.
+
+    Args:
+        condition (numpy.array)
+            Condition at each point.
+        values_true (tuple)
+            Values at points where condition is True.
+        values_false (tuple)
+            Values at points where condition is False.
+    Returns:
+        Tuple of values.
+    """
+    return tuple(numpy.where(condition, vt, vf) for vt, vf in zip(values_true, values_false))
+
+
+def group_points(fault_block, zone):
+    """Group points by fault block and zone.
+
+    Args:
+        fault_block (numpy.array [N])
+            Name of fault block at each point.
+        zone (numpy.array [N])
+            Name of zone at each point.
+    Returns:
+        List of tuples (fault block, zone, indices of points).
+    """
+    faultblock_names, faultblock_index = numpy.unique(fault_block, return_inverse=True)
+    zone_names, zone_index = numpy.unique(zone, return_inverse=True)
+    group_index = faultblock_index * zone_names.size + zone_index
+    order = numpy.argsort(group_index, kind="stable")
+    groups, starts = numpy.unique(group_index[order], return_index=True)
+    ends = numpy.append(starts[1:], order.size)
+
+    grouped = []
+    for group, start, end in zip(groups, starts, ends):
+        name_faultblock = faultblock_names[group // zone_names.size]
+        name_zone = zone_names[group % zone_names.size]
+        grouped.append((str(name_faultblock), str(name_zone), order[start:end]))
+    return grouped
+
+
+def apply_rules(rules_fn, fault_block, zone, x, y, depth):
+    """Compute values at points using rules for fault blocks and zones.
+
+    Args:
+        rules_fn (function)
+            Function returning rule given fault block and zone names.
+        fault_block (numpy.array [N])
+            Name of fault block at each point.
+        zone (numpy.array [N])
+            Name of zone at each point.
+        x (numpy.array [N])
+            Model x coordinate of points.
+        y (numpy.array [N])
+            Model y coordinate of points.
+        depth (numpy.array [N])
+            Depth of points.
+    Returns:
+        Numpy array [num_values, N] of values at points.
+    """
+    values = None
+    for name_faultblock, name_zone, indices in group_points(fault_block, zone):
+        rule = as_vectorized(rules_fn(name_faultblock, name_zone))
+        group_values = rule(x[indices], y[indices], depth[indices])
+        group_values = numpy.array([numpy.broadcast_to(v, indices.shape) for v in group_values])
+        if values is None:
+            values = numpy.empty((group_values.shape[0], x.size), dtype=numpy.float64)
+        values[:, indices] = group_values
+    return values if values is not None else numpy.empty((0, x.size))
+
+
+# End of file
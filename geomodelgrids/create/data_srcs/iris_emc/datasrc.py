@@ -41,6 +41,11 @@ class EMCNetCDF(DataSrc):
         self._read_values_metadata()
         self._read_block_metadata()
 
+    def is_concurrent(self):
+        """Each process reads the NetCDF file independently, so batches can be generated concurrently.
+        """
+        return True
+
     def _read_model_metadata(self):
         def list_from_attr(nc, name):
             return [getattr(nc, name)] if hasattr(nc, name) else []
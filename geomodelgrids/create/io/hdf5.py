@@ -1,11 +1,22 @@
 """Model storage in a HDF5 file.
 """
+import contextlib
+import os
+import queue
+import threading
+
 import h5py
 import numpy
 
+from geomodelgrids.create.utils.batch import Checkpoint
+
 
 class HDF5Storage():
     """HDF5 file for storing gridded model.
+
+    By default, each method opens and closes the file. Between `open()` and `close()` the file stays open for
+    the session and batches of values are written by a background thread, so the next batch can be generated
+    while the current one is written.
     """
 
     def __init__(self, filename):
@@ -16,6 +27,39 @@ class HDF5Storage():
                 Name for HDF5 file
         """
         self.filename = filename
+        self.h5 = None
+        self.writer = None
+
+    def open(self, queue_size=2):
+        """Open HDF5 file for a session of writes.
+
+        Args:
+            queue_size (int)
+                Maximum number of batches waiting to be written.
+        """
+        if self.h5:
+            return
+        self.h5 = h5py.File(self.filename, "a")
+        self.writer = _BatchWriter(queue_size)
+
+    def flush(self):
+        """Wait for pending batches to be written and flush HDF5 file.
+        """
+        if self.h5:
+            self.writer.join()
+            self.h5.flush()
+
+    def close(self):
+        """Write pending batches and close HDF5 file.
+        """
+        if not self.h5:
+            return
+        try:
+            self.writer.close()
+        finally:
+            self.h5.close()
+            self.h5 = None
+            self.writer = None
 
     def save_domain(self, domain):
         """Write domain attributes to HDF5 file.
@@ -24,12 +68,11 @@ class HDF5Storage():
             domain (Model):
                 Model domain.
         """
-        h5 = h5py.File(self.filename, "a")
-        attrs = h5.attrs
-        for attr_info in domain.get_attributes():
-            attr_name = attr_info[0]
-            attrs[attr_name] = self._get_attribute(domain.metadata, attr_info)
-        h5.close()
+        with self._file() as h5:
+            attrs = h5.attrs
+            for attr_info in domain.get_attributes():
+                attr_name = attr_info[0]
+                attrs[attr_name] = self._get_attribute(domain.metadata, attr_info)
 
     def create_surface(self, surface):
         """Create surface in HDF5 file.
@@ -38,15 +81,14 @@ class HDF5Storage():
             surface (Surface)
                 Model surface.
         """
-        h5 = h5py.File(self.filename, "a")
-        if not "surfaces" in h5:
-            h5.create_group("surfaces")
-        surfaces_group = h5["surfaces"]
-        if surface.name in surfaces_group:
-            del surfaces_group[surface.name]
-        surf_dataset = surfaces_group.create_dataset(surface.name, shape=surface.get_dims(),
-                                                     chunks=surface.chunk_size, compression="gzip")
-        h5.close()
+        with self._file() as h5:
+            if not "surfaces" in h5:
+                h5.create_group("surfaces")
+            surfaces_group = h5["surfaces"]
+            if surface.name in surfaces_group:
+                del surfaces_group[surface.name]
+            surfaces_group.create_dataset(surface.name, shape=surface.get_dims(),
+                                          chunks=surface.chunk_size, compression="gzip")
         self.save_surface_metadata(surface)
 
     def save_surface_metadata(self, surface):
@@ -56,16 +98,17 @@ class HDF5Storage():
             surface (Surface)
                 Model surface
         """
-        h5 = h5py.File(self.filename, "a")
-        attrs = h5["surfaces"][surface.name].attrs
-        for attr_info in surface.get_attributes():
-            attr_name = attr_info[0]
-            attrs[attr_name] = self._get_attribute(surface, attr_info)
-        h5.close()
+        with self._file() as h5:
+            attrs = h5["surfaces"][surface.name].attrs
+            for attr_info in surface.get_attributes():
+                attr_name = attr_info[0]
+                attrs[attr_name] = self._get_attribute(surface, attr_info)
 
     def save_surface(self, surface, elevation, batch=None):
         """Write surface to HDF5 file.
 
+        Within a session, the write is queued and `elevation` must not be modified after the call.
+
         Args:
             surface (Surface)
                 Model surface
@@ -74,17 +117,11 @@ class HDF5Storage():
             batch (utils.BatchGenerator2D)
                 Current batch of points in domain corresponding to elevation data.
         """
-        h5 = h5py.File(self.filename, "a")
-        surfaces_group = h5["surfaces"]
-        assert surface.name in surfaces_group
-        surf_dataset = surfaces_group[surface.name]
         if batch:
-            x_start, x_end = batch.x_range
-            y_start, y_end = batch.y_range
-            surf_dataset[x_start:x_end, y_start:y_end, :] = elevation
+            region = (slice(*batch.x_range), slice(*batch.y_range), slice(None))
         else:
-            surf_dataset[:] = elevation
-        h5.close()
+            region = slice(None)
+        self._write_dataset("surfaces", surface.name, region, elevation)
 
     def load_surface(self, surface, batch=None):
         """Load surface from HDF5 file.
@@ -95,34 +132,33 @@ class HDF5Storage():
             batch (utils.BatchGenerator2D)
                 Current batch of points in domain corresponding to elevation data.
         """
-        h5 = h5py.File(self.filename, "r")
-        surf_dataset = h5["surfaces"][surface.name]
-        attrs = surf_dataset.attrs
-        for attr_info in surface.get_attributes():
-            attr_name = attr_info[0]
-            attr_type = attr_info[1]
-            if attr_type == list or attr_type == tuple:
-                config_attr = getattr(surface, attr_name)
-                h5_attr = attrs[attr_name]
-                if len(config_attr) != len(h5_attr):
-                    raise ValueError(
-                        f"Inconsistency in surface '{surface.name}' attribute '{attr_name}': config value: {config_attr}, value from model: {h5_attr}")
-                for config_value, h5_value in zip(config_attr, h5_attr):
-                    if config_value != h5_value:
+        with self._file("r") as h5:
+            surf_dataset = h5["surfaces"][surface.name]
+            attrs = surf_dataset.attrs
+            for attr_info in surface.get_attributes():
+                attr_name = attr_info[0]
+                attr_type = attr_info[1]
+                if attr_type == list or attr_type == tuple:
+                    config_attr = getattr(surface, attr_name)
+                    h5_attr = attrs[attr_name]
+                    if len(config_attr) != len(h5_attr):
+                        raise ValueError(
+                            f"Inconsistency in surface '{surface.name}' attribute '{attr_name}': config value: {config_attr}, value from model: {h5_attr}")
+                    for config_value, h5_value in zip(config_attr, h5_attr):
+                        if config_value != h5_value:
+                            raise ValueError(
+                                f"Inconsistency in surface '{surface.name}' attribute '{attr_name}': config value: {config_attr}, value from model: {h5_attr}")
+                else:
+                    if getattr(surface, attr_name) != attrs[attr_name]:
                         raise ValueError(
                             f"Inconsistency in surface '{surface.name}' attribute '{attr_name}': config value: {config_attr}, value from model: {h5_attr}")
-            else:
-                if getattr(surface, attr_name) != attrs[attr_name]:
-                    raise ValueError(
-                        f"Inconsistency in surface '{surface.name}' attribute '{attr_name}': config value: {config_attr}, value from model: {h5_attr}")
 
-        if batch:
-            x_start, x_end = batch.x_range
-            y_start, y_end = batch.y_range
-            elevation = surf_dataset[x_start:x_end, y_start:y_end]
-        else:
-            elevation = surf_dataset[:]
-        h5.close()
+            if batch:
+                x_start, x_end = batch.x_range
+                y_start, y_end = batch.y_range
+                elevation = surf_dataset[x_start:x_end, y_start:y_end]
+            else:
+                elevation = surf_dataset[:]
 
         return elevation
 
@@ -133,16 +169,14 @@ class HDF5Storage():
             block (Block)
                 Block associated with gridded data.
         """
-        h5 = h5py.File(self.filename, "a")
-        if not "blocks" in h5:
-            h5.create_group("blocks")
-        blocks_group = h5["blocks"]
-        if block.name in blocks_group:
-            del blocks_group[block.name]
-        shape = list(block.get_dims()) + [len(block.model_metadata.data_values)]
-        block_dataset = blocks_group.create_dataset(
-            block.name, shape=shape, chunks=block.chunk_size, compression="gzip")
-        h5.close()
+        with self._file() as h5:
+            if not "blocks" in h5:
+                h5.create_group("blocks")
+            blocks_group = h5["blocks"]
+            if block.name in blocks_group:
+                del blocks_group[block.name]
+            shape = list(block.get_dims()) + [len(block.model_metadata.data_values)]
+            blocks_group.create_dataset(block.name, shape=shape, chunks=block.chunk_size, compression="gzip")
         self.save_block_metadata(block)
 
     def save_block_metadata(self, block):
@@ -152,16 +186,17 @@ class HDF5Storage():
             block (Block)
                 Block associated with gridded data.
         """
-        h5 = h5py.File(self.filename, "a")
-        attrs = h5["blocks"][block.name].attrs
-        for attr_info in block.get_attributes():
-            attr_name = attr_info[0]
-            attrs[attr_name] = self._get_attribute(block, attr_info)
-        h5.close()
+        with self._file() as h5:
+            attrs = h5["blocks"][block.name].attrs
+            for attr_info in block.get_attributes():
+                attr_name = attr_info[0]
+                attrs[attr_name] = self._get_attribute(block, attr_info)
 
     def save_block(self, block, data, batch=None):
         """Write block data to HDF5 file.
 
+        Within a session, the write is queued and `data` must not be modified after the call.
+
         Args:
             block (Block)
                 Block associated with gridded data.
@@ -170,19 +205,152 @@ class HDF5Storage():
             batch (BatchGenerator3D)
                 Current batch of points in block.
         """
-        h5 = h5py.File(self.filename, "a")
-        assert "blocks" in h5
-        blocks_group = h5["blocks"]
-        assert block.name in blocks_group
-        block_dataset = blocks_group[block.name]
         if batch:
-            x_start, x_end = batch.x_range
-            y_start, y_end = batch.y_range
-            z_start, z_end = batch.z_range
-            block_dataset[x_start:x_end, y_start:y_end, z_start:z_end, :] = data
+            region = (slice(*batch.x_range), slice(*batch.y_range), slice(*batch.z_range), slice(None))
         else:
-            block_dataset[:] = data
-        h5.close()
+            region = slice(None)
+        self._write_dataset("blocks", block.name, region, data)
+
+    def save_pyramid(self, group, name, num_levels):
+        """Write multi-resolution pyramid of surface or block to HDF5 file.
+
+        Level k keeps every other point along the x and y axes of level k-1 (always including the last point),
+        so values at the remaining points are exact, including values that are categories. Level k is stored
+        at 'pyramid/level_<k>/<group>/<name>' with the attributes of the full resolution dataset adjusted for
+        the coarser grid. Decimation stops once a level has at most 2 points along the x and y axes.
+
+        Args:
+            group (str)
+                Name of group containing dataset ('surfaces' or 'blocks').
+            name (str)
+                Name of dataset.
+            num_levels (int)
+                Maximum number of levels below the full resolution dataset.
+
+        Returns:
+            Number of levels written.
+        """
+        with self._file() as h5:
+            if "pyramid" in h5:
+                for level_group in h5["pyramid"].values():
+                    if group in level_group and name in level_group[group]:
+                        del level_group[group][name]
+
+            src = h5[group][name]
+            level = 0
+            while level < num_levels and (src.shape[0] > 2 or src.shape[1] > 2):
+                level += 1
+                x_indices = _decimate_indices(src.shape[0])
+                y_indices = _decimate_indices(src.shape[1])
+                shape = (x_indices.size, y_indices.size) + src.shape[2:]
+                chunks = tuple(min(c, n) for c, n in zip(src.chunks, shape)) if src.chunks else None
+                level_group = h5.require_group(f"pyramid/level_{level}/{group}")
+                dest = level_group.create_dataset(name, shape=shape, dtype=src.dtype, chunks=chunks,
+                                                  compression="gzip")
+                x_step = chunks[0] if chunks else 1
+                for x_start in range(0, x_indices.size, x_step):
+                    x_slab = x_indices[x_start:x_start + x_step]
+                    dest[x_start:x_start + x_slab.size] = src[list(x_slab)][:, y_indices]
+                for attr_name, value in src.attrs.items():
+                    if not attr_name.startswith("checkpoint_"):
+                        dest.attrs[attr_name] = value
+                _decimate_axis_attributes(dest.attrs, "x", x_indices, src.shape[0])
+                _decimate_axis_attributes(dest.attrs, "y", y_indices, src.shape[1])
+                src = dest
+        return level
+
+    def save_checkpoint(self, group, name, checkpoint):
+        """Write checkpoint as attributes of dataset.
+
+        Within a session, the write is queued after pending batches and the file is flushed, so the checkpoint
+        never gets ahead of the data.
+
+        Args:
+            group (str)
+                Name of group containing dataset ('surfaces' or 'blocks').
+            name (str)
+                Name of dataset.
+            checkpoint (Checkpoint)
+                Progress generating dataset.
+        """
+        attrs = {
+            "checkpoint_signature": numpy.string_(checkpoint.signature),
+            "checkpoint_batch_size": checkpoint.batch_size,
+            "checkpoint_num_batches": checkpoint.num_batches,
+            "checkpoint_num_done": checkpoint.num_done,
+        }
+
+        def _write(h5):
+            dataset_attrs = h5[group][name].attrs
+            for attr_name, value in attrs.items():
+                dataset_attrs[attr_name] = value
+            if self.h5:
+                h5.flush()
+
+        self._submit(_write)
+
+    def load_checkpoint(self, group, name):
+        """Load checkpoint from attributes of dataset.
+
+        Args:
+            group (str)
+                Name of group containing dataset ('surfaces' or 'blocks').
+            name (str)
+                Name of dataset.
+
+        Returns:
+            Checkpoint or None if the dataset does not exist or does not have a checkpoint.
+        """
+        if not self.h5 and not os.path.isfile(self.filename):
+            return None
+        with self._file("r") as h5:
+            if group not in h5 or name not in h5[group]:
+                return None
+            attrs = h5[group][name].attrs
+            if "checkpoint_signature" not in attrs:
+                return None
+            signature = attrs["checkpoint_signature"]
+            return Checkpoint(
+                signature=signature.decode("utf-8") if isinstance(signature, bytes) else str(signature),
+                batch_size=int(attrs["checkpoint_batch_size"]),
+                num_batches=int(attrs["checkpoint_num_batches"]),
+                num_done=int(attrs["checkpoint_num_done"]),
+            )
+
+    @contextlib.contextmanager
+    def _file(self, mode="a"):
+        """Get HDF5 file, waiting for pending batches within a session.
+        """
+        if self.h5:
+            self.writer.join()
+            yield self.h5
+        else:
+            h5 = h5py.File(self.filename, mode)
+            try:
+                yield h5
+            finally:
+                h5.close()
+
+    def _write_dataset(self, group, name, region, data):
+        """Write data to region of dataset, queueing the write within a session.
+
+        The region is computed by the caller, because batch generators are updated in place.
+        """
+        def _write(h5):
+            assert group in h5
+            assert name in h5[group]
+            h5[group][name][region] = data
+
+        self._submit(_write)
+
+    def _submit(self, write_fn):
+        """Call `write_fn(h5)`, queueing the call within a session.
+        """
+        if self.writer:
+            self.writer.submit(write_fn, self.h5)
+        else:
+            with self._file() as h5:
+                write_fn(h5)
 
     @staticmethod
     def _get_attribute(metadata, attr_info):
@@ -216,4 +384,104 @@ class HDF5Storage():
                 raise NotImplementedError(f"Unexpected type '{attr_type}' for attribute '{attr_name}'.")
         return result
 
+
+def _decimate_indices(num_points):
+    """Get indices of points kept when decimating axis by a factor of 2.
+
+    Args:
+        num_points (int)
+            Number of points along axis.
+
+    Returns:
+        Numpy array of indices, always including the first and last points.
+    """
+    indices = numpy.arange(0, num_points, 2)
+    if indices[-1] != num_points - 1:
+        indices = numpy.append(indices, num_points - 1)
+    return indices
+
+
+def _decimate_axis_attributes(attrs, axis, indices, num_points):
+    """Update grid spacing attributes for decimated axis.
+
+    Uniform spacing is doubled if the kept points remain uniformly spaced; otherwise, the coordinates of the
+    kept points are given.
+
+    Args:
+        attrs (h5py.AttributeManager)
+            Attributes of decimated dataset.
+        axis (str)
+            Name of axis ('x' or 'y').
+        indices (numpy.array)
+            Indices of points kept along axis.
+        num_points (int)
+            Number of points along axis before decimation.
+    """
+    name_resolution = f"{axis}_resolution"
+    name_coordinates = f"{axis}_coordinates"
+    if indices.size == num_points:
+        return
+    if name_resolution in attrs:
+        resolution = float(attrs[name_resolution])
+        if (num_points - 1) % 2 == 0:
+            attrs[name_resolution] = 2 * resolution
+        else:
+            del attrs[name_resolution]
+            attrs[name_coordinates] = resolution * indices.astype(numpy.float64)
+    else:
+        attrs[name_coordinates] = numpy.asarray(attrs[name_coordinates], dtype=numpy.float64)[indices]
+
+
+class _BatchWriter():
+    """Background thread writing batches from a bounded queue.
+
+    Errors raised while writing are reported by the next call to submit(), join(), or close().
+    """
+
+    def __init__(self, queue_size):
+        self.queue = queue.Queue(maxsize=queue_size)
+        self.error = None
+        self.thread = threading.Thread(target=self._run, daemon=True)
+        self.thread.start()
+
+    def submit(self, fn, *args):
+        """Queue call to `fn(*args)`, blocking if the queue is full.
+        """
+        self._check()
+        self.queue.put((fn, args))
+
+    def join(self):
+        """Wait for queued calls to finish.
+        """
+        self.queue.join()
+        self._check()
+
+    def close(self):
+        """Finish queued calls and stop thread.
+        """
+        self.queue.put(None)
+        self.thread.join()
+        self._check()
+
+    def _run(self):
+        while True:
+            item = self.queue.get()
+            try:
+                if item is None:
+                    return
+                if not self.error:
+                    fn, args = item
+                    fn(*args)
+            except Exception as err:
+                self.error = err
+            finally:
+                self.queue.task_done()
+
+    def _check(self):
+        if self.error:
+            error = self.error
+            self.error = None
+            raise error
+
+
 # End of file
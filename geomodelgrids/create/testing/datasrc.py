@@ -23,6 +23,11 @@ class AnalyticDataSrc(DataSrc):
         super().__init__()
         self.config = config
 
+    def is_concurrent(self):
+        """Values are computed independently for each batch, so batches can be generated concurrently.
+        """
+        return True
+
     def initialize(self):
         """Initialize model.
         """
@@ -0,0 +1,531 @@
+"""Synthetic models of arbitrary size for scale testing.
+
+The top surface and topography/bathymetry are planes and the values are linear functions of the
+logical model coordinates, so bilinear and trilinear interpolation reproduce them exactly. Query
+results can be verified to roundoff with `SyntheticDataSrc.compute_values()` for models of any
+size, number of blocks, and uniform or variable resolution.
+
+Usage:
+    python3 -m geomodelgrids.create.testing.synthetic --filename=synthetic.h5 --size=4GB --num-blocks=10
+"""
+
+import argparse
+import logging
+import math
+import os
+
+import numpy
+
+from geomodelgrids.create.core.datasrc import DataSrc
+from geomodelgrids.create.core.model import Model
+
+
+class SyntheticDataSrc(DataSrc):
+    """Model with planar surfaces and values that vary linearly with the logical model coordinates.
+    """
+
+    # Elevation of top surface: TOP[0] + TOP[1] * x + TOP[2] * y (local model coordinates).
+    TOP = (200.0, 1.0e-3, -0.5e-3)
+
+    # Water depth at x=0 for topography/bathymetry; decreases linearly to zero at x=dim_x.
+    WATER_DEPTH = 50.0
+
+    # Values: coefs[0] + coefs[1] * x + coefs[2] * y + coefs[3] * z (logical model coordinates).
+    VALUES = {
+        "one": (2.0e+3, 0.3, 0.4, -4.0),
+        "two": (-1.2e+3, 0.1, -0.2, -4.8),
+    }
+    UNITS = {
+        "one": "m",
+        "two": "m/s",
+    }
+
+    def __init__(self, config=None):
+        """Constructor.
+
+        Args:
+            config (dict)
+                Configuration parameters.
+        """
+        super().__init__()
+        self.config = config
+
+    def is_concurrent(self):
+        """Values are computed independently for each batch, so batches can be generated concurrently.
+        """
+        return True
+
+    def get_top_surface(self, points):
+        """Get elevation of top surface.
+
+        Args:
+            points (numpy.array [Nx,Ny,3])
+                Numpy array with coordinates of points in model coordinates.
+        Returns:
+            Numpy array [Nx,Ny,1] of elevation of top surface at points.
+        """
+        x, y = self._crs_to_local(points[:, :, 0], points[:, :, 1])
+        elev = self.compute_top_elevation(x, y)
+        return elev.reshape((elev.shape[0], elev.shape[1], 1))
+
+    def get_topography_bathymetry(self, points):
+        """Get elevation of topography/bathymetry.
+
+        Args:
+            points (numpy.array [Nx,Ny,3])
+                Numpy array with coordinates of points in model coordinates.
+        Returns:
+            Numpy array [Nx,Ny,1] of elevation of ground surface or ocean bottom at points.
+        """
+        x, y = self._crs_to_local(points[:, :, 0], points[:, :, 1])
+        dim_x = float(self.config["domain"]["dim_x"])
+        elev = self.compute_top_elevation(x, y) - self.WATER_DEPTH * (1.0 - x / dim_x)
+        return elev.reshape((elev.shape[0], elev.shape[1], 1))
+
+    def get_values(self, block, top_surface, topo_bathy, batch=None):
+        """Get block values.
+
+        The values depend on the logical coordinates of the grid points, so the surfaces are not used.
+
+        Args:
+            block (Block)
+                Block information.
+            top_surface (Surface)
+                Elevation of ground surface (top of model).
+            topo_bathy (Surface)
+                Elevation of topography or bathymetry used to define depth.
+            batch (BatchGenerator3D)
+                Current batch of points in block.
+        Returns:
+            Numpy array [Nx,Ny,Nz,Nv] of values.
+        """
+        x1, y1, z1 = self.get_block_coordinates(block, batch)
+        x, y, z = numpy.meshgrid(x1, y1, z1, indexing="ij")
+        names = block.model_metadata.data_values
+        values = numpy.zeros(x.shape + (len(names),), dtype=numpy.float32)
+        for i_value, name in enumerate(names):
+            coefs = self.VALUES[name]
+            values[:, :, :, i_value] = coefs[0] + coefs[1] * x + coefs[2] * y + coefs[3] * z
+        return values
+
+    @staticmethod
+    def get_block_coordinates(block, batch=None):
+        """Get logical coordinates of grid points in block.
+
+        Args:
+            block (Block)
+                Block information.
+            batch (BatchGenerator3D)
+                Current batch of points in block.
+        Returns:
+            Tuple of numpy arrays with x, y, and z coordinates.
+        """
+        num_x, num_y, num_z = block.get_dims()
+        x_range = batch.x_range if batch else (0, num_x)
+        y_range = batch.y_range if batch else (0, num_y)
+        z_range = batch.z_range if batch else (0, num_z)
+
+        if block.x_resolution:
+            x1 = block.x_resolution * numpy.arange(num_x, dtype=numpy.float64)
+        else:
+            x1 = numpy.array(block.x_coordinates)
+        if block.y_resolution:
+            y1 = block.y_resolution * numpy.arange(num_y, dtype=numpy.float64)
+        else:
+            y1 = numpy.array(block.y_coordinates)
+        if block.z_resolution:
+            z1 = block.z_top - block.z_resolution * numpy.arange(num_z, dtype=numpy.float64)
+        else:
+            z1 = numpy.array(block.z_coordinates)
+        return (x1[x_range[0]:x_range[1]], y1[y_range[0]:y_range[1]], z1[z_range[0]:z_range[1]])
+
+    @classmethod
+    def compute_top_elevation(cls, x, y):
+        """Compute elevation of top surface.
+
+        Args:
+            x (numpy.array)
+                x coordinates of points in local model coordinates.
+            y (numpy.array)
+                y coordinates of points in local model coordinates.
+        Returns:
+            Numpy array with elevation of top surface.
+        """
+        return cls.TOP[0] + cls.TOP[1] * x + cls.TOP[2] * y
+
+    @classmethod
+    def compute_values(cls, points, value_names, dim_z, topography=True):
+        """Compute expected values at points as returned by a query.
+
+        Args:
+            points (numpy.array [N,3])
+                Coordinates of points in local model coordinates (x, y, elevation).
+            value_names (list)
+                Names of values.
+            dim_z (float)
+                Vertical dimension of model.
+            topography (bool)
+                True if model has a top surface.
+        Returns:
+            Numpy array [N,Nv] of values.
+        """
+        x = points[:, 0]
+        y = points[:, 1]
+        z = points[:, 2]
+        if topography:
+            z_top = cls.compute_top_elevation(x, y)
+            z = -dim_z * (z_top - z) / (z_top + dim_z)
+        values = numpy.zeros((points.shape[0], len(value_names)))
+        for i_value, name in enumerate(value_names):
+            coefs = cls.VALUES[name]
+            values[:, i_value] = coefs[0] + coefs[1] * x + coefs[2] * y + coefs[3] * z
+        return values
+
+    def local_to_crs(self, x, y):
+        """Convert local model coordinates to model CRS.
+
+        Args:
+            x (numpy.array)
+                x coordinates in local model coordinates.
+            y (numpy.array)
+                y coordinates in local model coordinates.
+        Returns:
+            Tuple of numpy arrays with x and y coordinates in model CRS.
+        """
+        origin_x, origin_y, az_rad = self._get_coordsys()
+        x_crs = origin_x + x * math.cos(az_rad) + y * math.sin(az_rad)
+        y_crs = origin_y - x * math.sin(az_rad) + y * math.cos(az_rad)
+        return (x_crs, y_crs)
+
+    def _crs_to_local(self, x, y):
+        """Convert model CRS to local model coordinates.
+        """
+        origin_x, origin_y, az_rad = self._get_coordsys()
+        x_local = (x - origin_x) * math.cos(az_rad) - (y - origin_y) * math.sin(az_rad)
+        y_local = (x - origin_x) * math.sin(az_rad) + (y - origin_y) * math.cos(az_rad)
+        return (x_local, y_local)
+
+    def _get_coordsys(self):
+        """Get origin and azimuth (radians) of model coordinate system.
+        """
+        coordsys = self.config["coordsys"]
+        az_rad = float(coordsys["y_azimuth"]) * math.pi / 180.0
+        return (float(coordsys["origin_x"]), float(coordsys["origin_y"]), az_rad)
+
+
+class SyntheticModel():
+    """Configuration for a synthetic model with blocks stacked vertically.
+
+    The second block is 2x coarser than the top block and the remaining blocks are 4x coarser. With
+    variable resolution, the grid spacing alternates between 0.5 and 1.5 times the nominal resolution.
+    """
+
+    BYTES_PER_VALUE = 4
+
+    def __init__(self, filename, num_cells=64, num_cells_z=32, num_blocks=1, resolution=1.0e+3, dim_z=40.0e+3,
+                 variable=False, topography=False, crs="EPSG:26911", origin=(500.0e+3, 3800.0e+3), y_azimuth=0.0,
+                 chunk_size=32, batch_size=2**22):
+        """Constructor.
+
+        Args:
+            filename (str)
+                Name of model file.
+            num_cells (int)
+                Number of cells along each horizontal direction in the top block (rounded up to a multiple of 8).
+            num_cells_z (int)
+                Number of cells in the vertical direction in the top block (rounded up to a multiple of 8).
+            num_blocks (int)
+                Number of blocks.
+            resolution (float)
+                Nominal horizontal resolution (m) of the top block.
+            dim_z (float)
+                Vertical dimension (m) of the model.
+            variable (bool)
+                Use variable resolution if True, otherwise uniform resolution.
+            topography (bool)
+                Include top surface and topography/bathymetry if True.
+            crs (str)
+                Coordinate reference system of model.
+            origin (tuple)
+                Coordinates of model origin in CRS.
+            y_azimuth (float)
+                Azimuth (degrees) of model y axis.
+            chunk_size (int)
+                Number of points along each dimension of dataset chunks.
+            batch_size (int)
+                Maximum number of points in a batch.
+        """
+        if num_blocks < 1:
+            raise ValueError(f"Number of blocks ({num_blocks}) must be positive.")
+        self.filename = filename
+        self.num_cells = self._round_cells(num_cells)
+        self.num_cells_z = self._round_cells(num_cells_z)
+        self.num_blocks = num_blocks
+        self.resolution = resolution
+        self.dim_z = dim_z
+        self.variable = variable
+        self.topography = topography
+        self.crs = crs
+        self.origin = origin
+        self.y_azimuth = y_azimuth
+        self.chunk_size = chunk_size
+        self.batch_size = batch_size
+
+    @classmethod
+    def from_size(cls, filename, size, **kwargs):
+        """Create synthetic model with the number of cells set so the values occupy at least `size` bytes.
+
+        Args:
+            filename (str)
+                Name of model file.
+            size (int)
+                Target size (bytes) of values in the model (uncompressed).
+        Returns:
+            SyntheticModel
+        """
+        model = cls(filename, **kwargs)
+        nbytes = model.get_nbytes()
+        if nbytes < size:
+            # Number of bytes scales with the square of the number of horizontal cells.
+            model.num_cells = model._round_cells(math.ceil(model.num_cells * math.sqrt(size / nbytes)))
+            while model.get_nbytes() < size:
+                model.num_cells += 8
+        return model
+
+    @property
+    def dim_x(self):
+        """Horizontal dimension (m) of the model."""
+        return self.num_cells * self.resolution
+
+    @property
+    def dim_y(self):
+        """Horizontal dimension (m) of the model."""
+        return self.num_cells * self.resolution
+
+    def get_nbytes(self):
+        """Get number of bytes for values in the model (uncompressed).
+        """
+        nvalues = len(SyntheticDataSrc.VALUES)
+        nbytes = 0
+        for i_block in range(self.num_blocks):
+            coarsen = self._coarsen_factor(i_block)
+            num_xy = self.num_cells // coarsen + 1
+            num_z = self.num_cells_z // coarsen + 1
+            nbytes += num_xy * num_xy * num_z * nvalues * self.BYTES_PER_VALUE
+        return nbytes
+
+    def get_config(self):
+        """Get model configuration in the form used by `create_model`.
+
+        Returns:
+            Dictionary with model configuration.
+        """
+        value_names = list(SyntheticDataSrc.VALUES.keys())
+        config = {
+            "geomodelgrids": {
+                "title": "Synthetic model",
+                "id": "synthetic",
+                "description": "Synthetic model with planar surfaces and linear values for scale testing.",
+                "keywords": ["synthetic", "scale testing"],
+                "history": "Generated by geomodelgrids.create.testing.synthetic",
+                "comment": f"{self.num_blocks} blocks, {'variable' if self.variable else 'uniform'} resolution, "
+                f"{'topography' if self.topography else 'flat'}",
+                "creator_name": "GeoModelGrids",
+                "creator_email": "none",
+                "creator_institution": "none",
+                "acknowledgement": "none",
+                "authors": ["GeoModelGrids"],
+                "references": ["none"],
+                "repository_name": "none",
+                "repository_url": "none",
+                "repository_doi": "none",
+                "license": "CC0",
+                "version": "1.0.0",
+                "filename": self.filename,
+            },
+            "data": {
+                "values": value_names,
+                "units": [SyntheticDataSrc.UNITS[name] for name in value_names],
+                "layout": "vertex",
+            },
+            "coordsys": {
+                "crs": self.crs,
+                "origin_x": self.origin[0],
+                "origin_y": self.origin[1],
+                "y_azimuth": self.y_azimuth,
+            },
+            "domain": {
+                "dim_x": self.dim_x,
+                "dim_y": self.dim_y,
+                "dim_z": self.dim_z,
+                "blocks": [f"block{i_block:02d}" for i_block in range(self.num_blocks)],
+                "batch_size": self.batch_size,
+            },
+        }
+        if self.topography:
+            surface = self._get_horiz_config(1)
+            chunk_xy = min(self.chunk_size, self.num_cells + 1)
+            surface["chunk_size"] = [chunk_xy, chunk_xy, 1]
+            config["top_surface"] = surface
+            config["topography_bathymetry"] = dict(surface)
+
+        thickness = self.dim_z / self.num_blocks
+        for i_block, name in enumerate(config["domain"]["blocks"]):
+            coarsen = self._coarsen_factor(i_block)
+            block = self._get_horiz_config(coarsen)
+            num_z = self.num_cells_z // coarsen
+            z_top = -i_block * thickness
+            if self.variable:
+                block["z_coordinates"] = list(self._coordinates(num_z, thickness / num_z, z_top, -1.0))
+            else:
+                block["z_resolution"] = thickness / num_z
+                block["z_top"] = z_top
+                # z_bot is only used to size the block; pad by a fraction of a cell to avoid truncation from roundoff.
+                block["z_bot"] = z_top - (num_z + 0.1) * thickness / num_z
+            block["z_top_offset"] = 0.0
+            chunk_xy = min(self.chunk_size, self.num_cells // coarsen + 1)
+            chunk_z = min(self.chunk_size, num_z + 1)
+            block["chunk_size"] = [chunk_xy, chunk_xy, chunk_z, len(value_names)]
+            config[name] = block
+        return config
+
+    def generate(self):
+        """Write model to file in batches.
+
+        Returns:
+            SyntheticDataSrc for computing expected values.
+        """
+        logger = logging.getLogger(__name__)
+        config = self.get_config()
+        datasrc = SyntheticDataSrc(config)
+        datasrc.initialize()
+
+        # Storage appends to existing files, so remove any surfaces or blocks from a previous model.
+        if os.path.exists(self.filename):
+            os.remove(self.filename)
+        model = Model(config)
+        model.open_storage()
+        try:
+            model.save_domain()
+            if model.top_surface:
+                logger.info("Generating top surface...")
+                model.init_top_surface()
+                for batch in model.top_surface.get_batches(self.batch_size):
+                    points = model.top_surface.generate_points(batch)
+                    model.save_top_surface(datasrc.get_top_surface(points), batch)
+            if model.topo_bathy:
+                logger.info("Generating topography/bathymetry...")
+                model.init_topography_bathymetry()
+                for batch in model.topo_bathy.get_batches(self.batch_size):
+                    points = model.topo_bathy.generate_points(batch)
+                    model.save_topography_bathymetry(datasrc.get_topography_bathymetry(points), batch)
+            for block in model.blocks:
+                logger.info("Generating block '%s' with dims %s...", block.name, block.get_dims())
+                model.init_block(block)
+                for batch in block.get_batches(self.batch_size):
+                    values = datasrc.get_values(block, model.top_surface, model.topo_bathy, batch)
+                    model.save_block(block, values, batch)
+        finally:
+            model.close_storage()
+        return datasrc
+
+    def _get_horiz_config(self, coarsen):
+        """Get horizontal discretization for block or surface.
+        """
+        num_cells = self.num_cells // coarsen
+        resolution = self.resolution * coarsen
+        if self.variable:
+            coordinates = list(self._coordinates(num_cells, resolution, 0.0, 1.0))
+            config = {
+                "x_coordinates": coordinates,
+                "y_coordinates": coordinates,
+            }
+        else:
+            config = {
+                "x_resolution": resolution,
+                "y_resolution": resolution,
+            }
+        return config
+
+    @staticmethod
+    def _coordinates(num_cells, resolution, start, direction):
+        """Get coordinates of grid points with spacing alternating between 0.5 and 1.5 times the resolution.
+        """
+        spacing = resolution * numpy.tile((0.5, 1.5), num_cells // 2)
+        return start + direction * numpy.concatenate(((0.0,), numpy.cumsum(spacing)))
+
+    @staticmethod
+    def _coarsen_factor(i_block):
+        return 1 if i_block == 0 else 2 if i_block == 1 else 4
+
+    @staticmethod
+    def _round_cells(num_cells):
+        return 8 * max(1, math.ceil(num_cells / 8))
+
+
+def _parse_size(value):
+    """Parse size with optional suffix (KB, MB, GB, TB).
+    """
+    SUFFIXES = {"KB": 2**10, "MB": 2**20, "GB": 2**30, "TB": 2**40}
+    value = value.strip().upper()
+    for suffix, scale in SUFFIXES.items():
+        if value.endswith(suffix):
+            return int(float(value[:-len(suffix)]) * scale)
+    return int(value)
+
+
+def cli():
+    """Command line interface for generating synthetic models.
+    """
+    parser = argparse.ArgumentParser(description="Generate synthetic GeoModelGrids model for scale testing.")
+    parser.add_argument("--filename", action="store", dest="filename", required=True, help="Name of model file.")
+    parser.add_argument("--size", action="store", dest="size", type=_parse_size,
+                        help="Target size of values, e.g., 4GB (overrides --num-cells).")
+    parser.add_argument("--num-cells", action="store", dest="num_cells", type=int, default=64,
+                        help="Number of cells along each horizontal direction in the top block.")
+    parser.add_argument("--num-cells-z", action="store", dest="num_cells_z", type=int, default=32,
+                        help="Number of cells in the vertical direction in the top block.")
+    parser.add_argument("--num-blocks", action="store", dest="num_blocks", type=int, default=1,
+                        help="Number of blocks.")
+    parser.add_argument("--resolution", action="store", dest="resolution", type=float, default=1.0e+3,
+                        help="Horizontal resolution (m) of the top block.")
+    parser.add_argument("--dim-z", action="store", dest="dim_z", type=float, default=40.0e+3,
+                        help="Vertical dimension (m) of model.")
+    parser.add_argument("--variable", action="store_true", dest="variable", help="Use variable resolution.")
+    parser.add_argument("--topography", action="store_true", dest="topography",
+                        help="Include top surface and topography/bathymetry.")
+    parser.add_argument("--chunk-size", action="store", dest="chunk_size", type=int, default=32,
+                        help="Number of points along each dimension of dataset chunks.")
+    parser.add_argument("--batch-size", action="store", dest="batch_size", type=int, default=2**22,
+                        help="Maximum number of points in a batch.")
+    parser.add_argument("--log", action="store", dest="log_filename", default="synthetic.log",
+                        help="Name of log file.")
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.INFO, filename=args.log_filename)
+
+    kwargs = {
+        "num_cells": args.num_cells,
+        "num_cells_z": args.num_cells_z,
+        "num_blocks": args.num_blocks,
+        "resolution": args.resolution,
+        "dim_z": args.dim_z,
+        "variable": args.variable,
+        "topography": args.topography,
+        "chunk_size": args.chunk_size,
+        "batch_size": args.batch_size,
+    }
+    if args.size:
+        model = SyntheticModel.from_size(args.filename, args.size, **kwargs)
+    else:
+        model = SyntheticModel(args.filename, **kwargs)
+    print(f"Generating '{args.filename}' with {model.num_blocks} blocks, {model.num_cells} horizontal cells, "
+          f"{model.get_nbytes()} bytes of values...")
+    model.generate()
+
+
+if __name__ == "__main__":
+    cli()
+
+
+# End of file
@@ -3,6 +3,7 @@
 
 import logging
 import math
+from dataclasses import dataclass
 
 
 class BatchGenerator2D():
@@ -55,6 +56,11 @@ class BatchGenerator2D():
         logger.info("2D batches -- size: x=%d, y=%d; number: x=%d, y=%d",
                     self.bnum_x, self.bnum_x, self.nbatch_x, self.nbatch_y)
 
+    def __len__(self):
+        """Get number of batches.
+        """
+        return self.nbatch_x * self.nbatch_y
+
     def __str__(self):
         return "Batch2D [{x0}:{x1}, {y0}:{y1}]".format(
             x0=self.x_range[0], x1=self.x_range[1],
@@ -171,6 +177,11 @@ class BatchGenerator3D():
         logger.info("3D batches -- size: x=%d, y=%d, z=%d; number: x=%d, y=%d, z=%d",
                     self.bnum_x, self.bnum_y, self.bnum_z, self.nbatch_x, self.nbatch_y, self.nbatch_z)
 
+    def __len__(self):
+        """Get number of batches.
+        """
+        return self.nbatch_x * self.nbatch_y * self.nbatch_z
+
     def __str__(self):
         return "Batch3D [{x0}:{x1}, {y0}:{y1}, {z0}:{z1}]".format(
             x0=self.x_range[0], x1=self.x_range[1],
@@ -214,4 +225,32 @@ class BatchGenerator3D():
         return self
 
 
+@dataclass
+class Checkpoint():
+    """Progress generating a surface or block one batch at a time.
+
+    Batches are written in the order of the batch generator, so the completed batches are always the first
+    `num_done` batches.
+    """
+    signature: str
+    batch_size: int
+    num_batches: int
+    num_done: int = 0
+
+    def is_complete(self):
+        """Check whether all batches have been written.
+        """
+        return self.num_done >= self.num_batches
+
+    def can_resume(self, other):
+        """Check whether generation can resume from checkpoint `other`.
+
+        Args:
+            other (Checkpoint)
+                Checkpoint from previous run.
+        """
+        return other.signature == self.signature and other.batch_size == self.batch_size \
+            and other.num_batches == self.num_batches
+
+
 # End of file
@@ -3,6 +3,7 @@
 #include "Borehole.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
@@ -29,6 +30,7 @@ geomodelgrids::apps::Borehole::Borehole() :
     _logFilename(""),
     _maxDepth(5000.0),
     _dz(10.0),
+    _showStats(false),
     _showHelp(false) {
     _location[0] = geomodelgrids::NODATA_VALUE;
     _location[1] = geomodelgrids::NODATA_VALUE;
@@ -58,6 +60,7 @@ geomodelgrids::apps::Borehole::run(int argc,
         errorHandler->setLogFilename(_logFilename.c_str());
         errorHandler->setLoggingOn(true);
     } // if
+    query.setStatsOn(_showStats);
     query.initialize(_modelFilenames, _valueNames, _pointsCRS);
 
     const double groundOffset = -1.0e-6;
@@ -95,6 +98,9 @@ geomodelgrids::apps::Borehole::run(int argc,
     } // while
 
     query.finalize();
+    if (_showStats) {
+        query.getStats()->write(std::cout);
+    } // if
 
     return 0;
 } // run
@@ -115,12 +121,13 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
+        {"stats", no_argument, nullptr, 't'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:d:o:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:d:o:r:p:c:o:l:m:t", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -173,6 +180,10 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
             } // while
             break;
         } // 'm'
+        case 't': {
+            _showStats = true;
+            break;
+        } // 't'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -220,7 +231,7 @@ void
 geomodelgrids::apps::Borehole::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_borehole "
               << "[--help] [--log=FILE_LOG] --location=X,Y --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
-              << "--output=FILE_OUTPUT [--max-depth=Z] [--dz=RESOLUTION] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "--output=FILE_OUTPUT [--max-depth=Z] [--dz=RESOLUTION] [--points-coordsys=PROJ|EPSG|WKT] [--stats]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --location=X,Y                   Location of virtual borehole in point coordinate system.\n"
@@ -231,7 +242,8 @@ geomodelgrids::apps::Borehole::_printHelp(void) {
               << "vertical units (default=5000m).\n"
               << "    --dz=RESOLUTION                  Vertical resolution of query points in virtual borehole "
               << "in point coordinate system vertical units (default=10m).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --stats                          Print query statistics to stdout when done."
               << std::endl;
 } // _printHelp
 
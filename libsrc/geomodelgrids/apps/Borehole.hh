@@ -73,6 +73,7 @@ private:
     double _maxDepth;
     double _location[2];
     double _dz;
+    bool _showStats;
     bool _showHelp;
 
     // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,7 @@
 #include "Isosurface.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 #include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
 #include "geomodelgrids/utils/GeoTiff.hh" // USES GeoTiff
@@ -17,10 +18,17 @@
 #include <sstream> // USES std::ostringstream, std::istringstream
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
+#include <memory> // USES std::unique_ptr
+#include <thread> // USES std::thread
+#include <atomic> // USES std::atomic
+#include <mutex> // USES std::mutex
+#include <exception> // USES std::exception_ptr
 
 namespace geomodelgrids {
     namespace apps {
         // ----------------------------------------------------------------------------------------
+        class LineSearch;
+
         class Isosurfacer {
 public:
 
@@ -41,10 +49,18 @@ public:
 
 private:
 
+            void _searchColumn(double* values,
+                               const double x,
+                               const double y,
+                               const double topElev);
+
             const Isosurface& _app;
             geomodelgrids::serial::Query* _query;
+            LineSearch* _lineSearch;
             size_t _numLevels;
             std::vector<double> _vbuffer;
+            std::vector<double> _columnElevations;
+            std::vector<double> _columnValues;
 
         }; // Isosurfacer
 
@@ -54,14 +70,14 @@ public:
 
             LineSearch(geomodelgrids::serial::Query* query,
                        std::vector<double>& vbuffer,
-                       const size_t numSeachPoints,
-                       const double x,
-                       const double y);
+                       const size_t numSeachPoints);
 
             virtual ~LineSearch(void);
 
             virtual
-            size_t search(const double zTop,
+            size_t search(const double x,
+                          const double y,
+                          const double zTop,
                           const double zBot,
                           const double dz,
                           const double vTarget,
@@ -72,8 +88,6 @@ protected:
             geomodelgrids::serial::Query* _query;
             std::vector<double>& _vbuffer;
             const size_t _numSearchPoints;
-            const double _x;
-            const double _y;
 
         }; // LineSearch
 
@@ -82,11 +96,11 @@ public:
 
             LineSearchDown(geomodelgrids::serial::Query* query,
                            std::vector<double>& vbuffer,
-                           const size_t numSeachPoints,
-                           const double x,
-                           const double y);
+                           const size_t numSeachPoints);
 
-            size_t search(const double zTop,
+            size_t search(const double x,
+                          const double y,
+                          const double zTop,
                           const double zBot,
                           const double dz,
                           const double vTarget,
@@ -99,11 +113,11 @@ public:
 
             LineSearchUp(geomodelgrids::serial::Query* query,
                          std::vector<double>& vbuffer,
-                         const size_t numSeachPoints,
-                         const double x,
-                         const double y);
+                         const size_t numSeachPoints);
 
-            size_t search(const double zTop,
+            size_t search(const double x,
+                          const double y,
+                          const double zTop,
                           const double zBot,
                           const double dz,
                           const double vTarget,
@@ -127,8 +141,12 @@ geomodelgrids::apps::Isosurface::Isosurface(void) :
     _vertRes(10.0),
     _maxDepth(0.0),
     _numSearchPoints(10),
+    _numThreads(1),
     _depthSurface(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY),
     _preferShallow(true),
+    _columnSearch(false),
+    _prefetch(false),
+    _showStats(false),
     _showHelp(false) {
     _isosurfaces.resize(2);
     _isosurfaces[0] = Isosurfacer::isosurface_t("Vs", 1.0e+3);
@@ -157,72 +175,114 @@ geomodelgrids::apps::Isosurface::run(int argc,
         return 0;
     } // if
 
-    geomodelgrids::utils::CRSTransformer* toXYOrder =
-        geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str());
+    std::unique_ptr<geomodelgrids::utils::CRSTransformer> toXYOrder(
+        geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str()));
     assert(toXYOrder);
     toXYOrder->transform(&_minX, &_minY, nullptr, _minX, _minY, 0.0);
     toXYOrder->transform(&_maxX, &_maxY, nullptr, _maxX, _maxY, 0.0);
 
-    try {
-        Isosurfacer isosurfacer(*this);
-        isosurfacer.initialize();
-        if (!_logFilename.empty()) {
-            geomodelgrids::serial::Query* query = isosurfacer.getQuery();assert(query);
+    const size_t numX = size_t((_maxX + 0.5*_horizRes - _minX) / _horizRes);
+    const size_t numY = size_t((_maxY + 0.5*_horizRes - _minY) / _horizRes);
+    const size_t numIsosurfaces = _isosurfaces.size();
+
+    // Each thread gets its own query and coordinate transformation (neither is safe to share across threads).
+    // They are created here, one after the other, so only the queries run concurrently. Only the query of the
+    // main thread logs, so the worker threads never write to the log file.
+    const size_t numThreads = std::max(std::min(size_t(_numThreads), numY), size_t(1));
+    std::vector<std::unique_ptr<Isosurfacer> > isosurfacers(numThreads);
+    std::vector<std::unique_ptr<geomodelgrids::utils::CRSTransformer> > transformers(numThreads);
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        isosurfacers[iThread].reset(new Isosurfacer(*this));
+        isosurfacers[iThread]->initialize();
+        if (!_logFilename.empty() && (0 == iThread)) {
+            geomodelgrids::serial::Query* query = isosurfacers[iThread]->getQuery();assert(query);
             std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
             errorHandler->setLogFilename(_logFilename.c_str());
             errorHandler->setLoggingOn(true);
         } // if
+        transformers[iThread].reset(iThread ?
+                                    geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str()) :
+                                    toXYOrder.release());
+    } // for
 
-        const size_t numX = size_t((_maxX + 0.5*_horizRes - _minX) / _horizRes);
-        const size_t numY = size_t((_maxY + 0.5*_horizRes - _minY) / _horizRes);
-        const size_t numIsosurfaces = _isosurfaces.size();
-
-        std::vector<std::string> bandLabels(numIsosurfaces);
-        for (size_t i = 0; i < numIsosurfaces; ++i) {
-            std::ostringstream label;
-            label << _isosurfaces[i].first << "=" << _isosurfaces[i].second;
-            bandLabels[i] = label.str();
-        } // for
+    std::vector<std::string> bandLabels(numIsosurfaces);
+    for (size_t i = 0; i < numIsosurfaces; ++i) {
+        std::ostringstream label;
+        label << _isosurfaces[i].first << "=" << _isosurfaces[i].second;
+        bandLabels[i] = label.str();
+    } // for
 
-        geomodelgrids::utils::GeoTiff writer;
-        writer.setNumCols(numX);
-        writer.setNumRows(numY);
-        writer.setNumBands(numIsosurfaces);
-        writer.setBandLabels(bandLabels);
-        writer.setCRS(_bboxCRS.c_str());
-        writer.setBBox(_minX, _maxX, _minY, _maxY);
-        writer.setNoDataValue(geomodelgrids::NODATA_VALUE);
-        writer.create(_outputFilename.c_str());
-
-        std::vector<double> values(numIsosurfaces);
-        float* buffer = writer.getBands();
-        for (size_t iY = 0, iPt = 0; iY < numY; ++iY) {
-            const size_t row = numY - iY - 1;
-            const double y = _minY + (iY + 0.5) * _horizRes;
-            double xCRS, yCRS;
-
-            for (size_t iX = 0; iX < numX; ++iX, ++iPt) {
-                const size_t col = iX;
-                const double x = _minX + (iX + 0.5) * _horizRes;
-
-                toXYOrder->inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
-                isosurfacer.query(&values[0], xCRS, yCRS);
-                for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
-                    buffer[iValue*numY*numX + row*numX + col] = values[iValue];
+    geomodelgrids::utils::GeoTiff writer;
+    writer.setNumCols(numX);
+    writer.setNumRows(numY);
+    writer.setNumBands(numIsosurfaces);
+    writer.setBandLabels(bandLabels);
+    writer.setCRS(_bboxCRS.c_str());
+    writer.setBBox(_minX, _maxX, _minY, _maxY);
+    writer.setNoDataValue(geomodelgrids::NODATA_VALUE);
+    writer.create(_outputFilename.c_str());
+
+    // Threads take rows in order and write only the pixels in their rows of the bands.
+    float* buffer = writer.getBands();
+    std::atomic<size_t> nextRow(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error = nullptr;
+    std::mutex errorMutex;
+    auto computeRows = [&](const size_t iThread) {
+        try {
+            Isosurfacer& isosurfacer = *isosurfacers[iThread];
+            geomodelgrids::utils::CRSTransformer& transformer = *transformers[iThread];
+            std::vector<double> values(numIsosurfaces);
+            for (size_t iY = nextRow++; iY < numY && !failed; iY = nextRow++) {
+                const size_t row = numY - iY - 1;
+                const double y = _minY + (iY + 0.5) * _horizRes;
+                double xCRS, yCRS;
+
+                for (size_t iX = 0; iX < numX; ++iX) {
+                    const size_t col = iX;
+                    const double x = _minX + (iX + 0.5) * _horizRes;
+
+                    transformer.inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
+                    isosurfacer.query(&values[0], xCRS, yCRS);
+                    for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
+                        buffer[iValue*numY*numX + row*numX + col] = values[iValue];
+                    } // for
                 } // for
             } // for
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            } // if
+            failed = true;
+        } // try/catch
+    };
+
+    // The main thread computes rows with the first query while the worker threads use the others.
+    std::vector<std::thread> threads;
+    for (size_t iThread = 1; iThread < numThreads; ++iThread) {
+        threads.push_back(std::thread(computeRows, iThread));
+    } // for
+    computeRows(0);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    } // for
+    if (error) {
+        std::rethrow_exception(error);
+    } // if
+
+    writer.write();
+    writer.close();
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        isosurfacers[iThread]->finalize();
+    } // for
+    if (_showStats) {
+        geomodelgrids::serial::QueryStats stats;
+        for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+            stats.add(*isosurfacers[iThread]->getQuery()->getStats());
         } // for
-        delete toXYOrder;toXYOrder = nullptr;
-        writer.write();
-        writer.close();
-        isosurfacer.finalize();
-    } catch (const std::exception& err) {
-        delete toXYOrder;toXYOrder = nullptr;
-        throw;
-    } catch (...) {
-        delete toXYOrder;toXYOrder = nullptr;
-        throw;
-    } // try/catch
+        stats.write(std::cout);
+    } // if
 
     return 0;
 #endif
@@ -234,7 +294,7 @@ geomodelgrids::apps::Isosurface::run(int argc,
 void
 geomodelgrids::apps::Isosurface::_parseArgs(int argc,
                                             char* argv[]) {
-    static struct option options[14] = {
+    static struct option options[18] = {
         {"help", no_argument, nullptr, 'h'},
         {"log", required_argument, nullptr, 'l'},
         {"bbox", required_argument, nullptr, 'b'},
@@ -248,13 +308,17 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"prefer-deep", no_argument, nullptr, 'p'},
         {"bbox-coordsys", required_argument, nullptr, 'c'},
+        {"prefetch", no_argument, nullptr, 'f'},
+        {"stats", no_argument, nullptr, 't'},
+        {"threads", required_argument, nullptr, 'j'},
+        {"column-search", no_argument, nullptr, 'w'},
         {0, 0, 0, 0}
     };
 
     _isosurfaces.clear();
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:ftj:w", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -343,6 +407,22 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
             _bboxCRS = optarg;
             break;
         } // 'c'
+        case 'f': {
+            _prefetch = true;
+            break;
+        } // 'f'
+        case 't': {
+            _showStats = true;
+            break;
+        } // 't'
+        case 'j': {
+            _numThreads = atoi(optarg);
+            break;
+        } // 'j'
+        case 'w': {
+            _columnSearch = true;
+            break;
+        } // 'w'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -392,6 +472,10 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
             msg << "    - Number of search points (" << _numSearchPoints << ") must be at least 2.\n";
             optionsOkay = false;
         } // if
+        if (_numThreads < 1) {
+            msg << "    - Number of threads (" << _numThreads << ") must be at least 1.\n";
+            optionsOkay = false;
+        } // if
         if (_isosurfaces.empty()) {
             msg << "    - Missing isosurfaces. Use --isosurface=NAME,VALUE (can be repeated)\n";
             optionsOkay = false;
@@ -425,7 +509,7 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "[--help] [--log=FILE_LOG] --bbox=XMIN,XMAX,YMIN,YMAX --hresolution=RESOLUTION "
               << "[--vresolution=RESOLUTION] --isosurface=NAME,VALUE [--depth-reference=SURFACE] "
               << "--max-depth=DEPTH [--num-search-points=NUM] --models=FILE_0,...,FILE_M --output=FILE_OUTPUT "
-              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT]\n\n"
+              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT] [--column-search] [--prefetch] [--stats] [--threads=NUM]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --bbox=XMIN,XMAX,YMIN,YMAX       Bounding box for iosurface.\n"
@@ -441,7 +525,12 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "    --vresolution=RESOLUTION         Vertical resolution for depth of isosurface (default=10.0).\n"
               << "    --prefer-deep                    Prefer deepest elevation for isosurface rather than "
               << "shallowest (default=shallowest).\n"
-              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326)."
+              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326).\n"
+              << "    --column-search                  Find isosurfaces directly from the model grid points along each "
+              << "column rather than with a line search.\n"
+              << "    --prefetch                       Prefetch model data along the raster traversal direction.\n"
+              << "    --stats                          Print query statistics to stdout when done.\n"
+              << "    --threads=NUM                    Number of threads used to compute raster rows (default=1)."
               << std::endl;
 } // _printHelp
 
@@ -449,11 +538,13 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::Isosurfacer::Isosurfacer(const Isosurface& app) :
     _app(app),
-    _query(nullptr) {}
+    _query(nullptr),
+    _lineSearch(nullptr) {}
 
 
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::Isosurfacer::~Isosurfacer(void) {
+    delete _lineSearch;_lineSearch = nullptr;
     delete _query;_query = nullptr;
 }
 
@@ -468,6 +559,8 @@ geomodelgrids::apps::Isosurfacer::initialize(void) {
     for (size_t i = 0; i < numIsosurfaces; ++i) {
         valueNames[i] = _app._isosurfaces[i].first;
     } // for
+    _query->setHyperslabPrefetch(_app._prefetch);
+    _query->setStatsOn(_app._showStats);
     _query->initialize(_app._modelFilenames, valueNames, _app._bboxCRS);
 
     _numLevels = size_t(ceil(log(_app._maxDepth/_app._vertRes) / log(_app._numSearchPoints)));
@@ -475,6 +568,11 @@ geomodelgrids::apps::Isosurfacer::initialize(void) {
 
     const size_t numValues = _app._isosurfaces.size();
     _vbuffer.resize(numValues);
+
+    delete _lineSearch;
+    _lineSearch = _app._preferShallow ?
+                  (LineSearch*) new LineSearchDown(_query, _vbuffer, _app._numSearchPoints) :
+                  (LineSearch*) new LineSearchUp(_query, _vbuffer, _app._numSearchPoints);
 }
 
 
@@ -492,6 +590,7 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
                                         const double y) {
     assert(values);
     assert(_query);
+    assert(_lineSearch);
 
     double topElev = 0.0;
     switch (_app._depthSurface) {
@@ -511,10 +610,10 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
         } // for
         return;
     } // if
-
-    LineSearch* lineSearch = _app._preferShallow ?
-                             (LineSearch*) new LineSearchDown(_query, _vbuffer, _app._numSearchPoints, x, y) :
-                             (LineSearch*) new LineSearchUp(_query, _vbuffer, _app._numSearchPoints, x, y);
+    if (_app._columnSearch) {
+        _searchColumn(values, x, y, topElev);
+        return;
+    } // if
 
     const size_t numValues = _vbuffer.size();
     for (size_t iValue = 0; iValue < numValues; ++iValue) {
@@ -525,7 +624,7 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
 
         for (size_t iLevel = 0; iLevel < _numLevels; ++iLevel) {
             const double dz = (zTop - zBot) / (_app._numSearchPoints-1);
-            const size_t iTop = lineSearch->search(zTop, zBot, dz, vTarget, iValue);
+            const size_t iTop = _lineSearch->search(x, y, zTop, zBot, dz, vTarget, iValue);
             zTop -= iTop*dz;
             zBot = zTop - dz;
         } // for
@@ -548,8 +647,49 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
         } // if/else
 
     } // for
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::apps::Isosurfacer::_searchColumn(double* values,
+                                                const double x,
+                                                const double y,
+                                                const double topElev) {
+    assert(values);
+    assert(_query);
 
-    delete lineSearch;lineSearch = nullptr;
+    // Values vary linearly between consecutive points in the column, so the isosurface is where a segment goes
+    // from below the target value (above) to at or above the target value (below).
+    _query->queryColumn(&_columnElevations, &_columnValues, x, y, topElev - 1.0e-4, topElev - _app._maxDepth);
+    const size_t numPoints = _columnElevations.size();
+    const size_t numValues = _vbuffer.size();
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        const double vTarget = _app._isosurfaces[iValue].second;
+
+        values[iValue] = geomodelgrids::NODATA_VALUE;
+        if (_app._preferShallow && numPoints && (_columnValues[iValue] >= vTarget)) {
+            values[iValue] = 0.0;
+            continue;
+        } // if
+        bool found = false;
+        for (size_t iSeg = 0; iSeg+1 < numPoints; ++iSeg) {
+            const size_t iPt = _app._preferShallow ? iSeg : numPoints - 2 - iSeg;
+            const double zTop = _columnElevations[iPt];
+            const double zBot = _columnElevations[iPt+1];
+            const double vTop = _columnValues[iPt*numValues+iValue];
+            const double vBot = _columnValues[(iPt+1)*numValues+iValue];
+            if ((vTop < vTarget) && (vTarget <= vBot)) {
+                const double z = (zTop > zBot) ? zTop + (vTarget - vTop) * (zBot - zTop) / (vBot - vTop) : zTop;
+                values[iValue] = topElev - z;
+                found = true;
+                break;
+            } // if
+        } // for
+        if (!found && numPoints && (_columnValues[iValue] >= vTarget)) {
+            values[iValue] = 0.0;
+        } // if
+    } // for
 }
 
 
@@ -564,14 +704,10 @@ geomodelgrids::apps::Isosurfacer::finalize(void) {
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::LineSearch::LineSearch(geomodelgrids::serial::Query* query,
                                             std::vector<double>& vbuffer,
-                                            const size_t numSeachPoints,
-                                            const double x,
-                                            const double y) :
+                                            const size_t numSeachPoints) :
     _query(query),
     _vbuffer(vbuffer),
-    _numSearchPoints(numSeachPoints),
-    _x(x),
-    _y(y) {}
+    _numSearchPoints(numSeachPoints) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -581,15 +717,15 @@ geomodelgrids::apps::LineSearch::~LineSearch(void) {}
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::LineSearchDown::LineSearchDown(geomodelgrids::serial::Query* query,
                                                     std::vector<double>& vbuffer,
-                                                    const size_t numSeachPoints,
-                                                    const double x,
-                                                    const double y) :
-    LineSearch(query, vbuffer, numSeachPoints, x, y) {}
+                                                    const size_t numSeachPoints) :
+    LineSearch(query, vbuffer, numSeachPoints) {}
 
 
 // ------------------------------------------------------------------------------------------------
 size_t
-geomodelgrids::apps::LineSearchDown::search(const double zTop,
+geomodelgrids::apps::LineSearchDown::search(const double x,
+                                            const double y,
+                                            const double zTop,
                                             const double zBot,
                                             const double dz,
                                             const double vTarget,
@@ -597,7 +733,7 @@ geomodelgrids::apps::LineSearchDown::search(const double zTop,
     size_t iTop = 0;
     for (size_t iPt = 1; iPt < _numSearchPoints; ++iPt) {
         const double z = zTop - iPt*dz;
-        _query->query(&_vbuffer[0], _x, _y, z);
+        _query->query(&_vbuffer[0], x, y, z);
         const double v = _vbuffer[iValue];
         if (v >= vTarget) {
             iTop = iPt - 1;
@@ -612,15 +748,15 @@ geomodelgrids::apps::LineSearchDown::search(const double zTop,
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::LineSearchUp::LineSearchUp(geomodelgrids::serial::Query* query,
                                                 std::vector<double>&vbuffer,
-                                                const size_t numSeachPoints,
-                                                const double x,
-                                                const double y) :
-    LineSearch(query, vbuffer, numSeachPoints, x, y) {}
+                                                const size_t numSeachPoints) :
+    LineSearch(query, vbuffer, numSeachPoints) {}
 
 
 // ------------------------------------------------------------------------------------------------
 size_t
-geomodelgrids::apps::LineSearchUp::search(const double zTop,
+geomodelgrids::apps::LineSearchUp::search(const double x,
+                                          const double y,
+                                          const double zTop,
                                           const double zBot,
                                           const double dz,
                                           const double vTarget,
@@ -628,7 +764,7 @@ geomodelgrids::apps::LineSearchUp::search(const double zTop,
     size_t iTop = 0;
     for (size_t iPt = 1; iPt < _numSearchPoints; ++iPt) {
         const double z = zBot + iPt * dz;
-        _query->query(&_vbuffer[0], _x, _y, z);
+        _query->query(&_vbuffer[0], x, y, z);
         const double v = _vbuffer[iValue];
         if (v < vTarget) {
             iTop = _numSearchPoints - iPt - 1;
@@ -38,6 +38,10 @@ public:
      *   --output=FILE_OUTPUT
      *   --prefer-deep
      *   --bbox-coordsys=PROJ|EPSG|WKT
+     *   --column-search
+     *   --prefetch
+     *   --stats
+     *   --threads=NUM
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -85,8 +89,12 @@ private:
     double _vertRes;
     double _maxDepth;
     int _numSearchPoints;
+    int _numThreads;
     geomodelgrids::serial::Query::SquashingEnum _depthSurface;
     bool _preferShallow;
+    bool _columnSearch;
+    bool _prefetch;
+    bool _showStats;
     bool _showHelp;
 
     // NOT IMPLEMENTED /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,8 @@
 #include "Query.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
+#include "geomodelgrids/serial/SharedChunkCache.hh" // USES SharedChunkCache
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include <getopt.h> // USES getopt_long()
@@ -30,6 +32,11 @@ geomodelgrids::apps::Query::Query() :
     _logFilename(""),
     _squashMinElev(-10.0e+3),
     _squash(geomodelgrids::serial::Query::SQUASH_NONE),
+    _prefetch(false),
+    _resolution(0.0),
+    _metadataCacheFilename(""),
+    _sharedCacheName(""),
+    _showStats(false),
     _showHelp(false) {}
 
 
@@ -56,6 +63,12 @@ geomodelgrids::apps::Query::run(int argc,
         errorHandler->setLogFilename(_logFilename.c_str());
         errorHandler->setLoggingOn(true);
     } // if
+    query.setHyperslabPrefetch(_prefetch);
+    query.setQueryResolution(_resolution);
+    query.setMetadataCache(_metadataCacheFilename.c_str());
+    query.setSharedCache(_sharedCacheName.c_str(), geomodelgrids::serial::SharedChunkCache::DEFAULT_CACHE_BYTES,
+                         geomodelgrids::serial::SharedChunkCache::DEFAULT_SLOT_BYTES);
+    query.setStatsOn(_showStats);
     query.initialize(_modelFilenames, _valueNames, _pointsCRS);
     if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
         query.setSquashing(_squash);
@@ -99,6 +112,9 @@ geomodelgrids::apps::Query::run(int argc,
     } // while
 
     query.finalize();
+    if (_showStats) {
+        query.getStats()->write(std::cout);
+    } // if
 
     return 0;
 } // run
@@ -109,7 +125,7 @@ geomodelgrids::apps::Query::run(int argc,
 void
 geomodelgrids::apps::Query::_parseArgs(int argc,
                                        char* argv[]) {
-    static struct option options[10] = {
+    static struct option options[15] = {
         {"help", no_argument, nullptr, 'h'},
         {"values", required_argument, nullptr, 'v'},
         {"squash-min-elev", required_argument, nullptr, 's'},
@@ -119,12 +135,17 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
+        {"prefetch", no_argument, nullptr, 'f'},
+        {"resolution", required_argument, nullptr, 'x'},
+        {"metadata-cache", required_argument, nullptr, 'a'},
+        {"shared-cache", required_argument, nullptr, 'g'},
+        {"stats", no_argument, nullptr, 't'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:r:p:c:o:l:m:fx:a:g:t", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -182,6 +203,26 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             } // while
             break;
         } // 'm'
+        case 'f': {
+            _prefetch = true;
+            break;
+        } // 'f'
+        case 'x': {
+            _resolution = std::stod(optarg);
+            break;
+        } // 'x'
+        case 'a': {
+            _metadataCacheFilename = optarg;
+            break;
+        } // 'a'
+        case 'g': {
+            _sharedCacheName = optarg;
+            break;
+        } // 'g'
+        case 't': {
+            _showStats = true;
+            break;
+        } // 't'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -230,7 +271,8 @@ geomodelgrids::apps::Query::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_query "
               << "[--help]  [--log=FILE_LOG] --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
               << "--points=FILE_POINTS  --output=FILE_OUTPUT [--squash-min-elev=ELEV] "
-              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT] "
+              << "[--prefetch] [--resolution=RES] [--metadata-cache=FILE_CACHE] [--shared-cache=NAME] [--stats]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in query.\n"
@@ -239,7 +281,16 @@ geomodelgrids::apps::Query::_printHelp(void) {
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --squash-min-elev=ELEV           Top of the model is squashed/stretched to z=0 with the model below z=ELEV held fixed (default=-10.0e+3).\n"
               << "    --squash-surface=none|top_surface|topography_bathymetry    Surface reference for squashing/stretching (default=none).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --prefetch                       Prefetch model data along the direction points are traversed "
+              << "(for points ordered along lines or grids).\n"
+              << "    --resolution=RES                 Query coarser levels of multi-resolution pyramids with horizontal "
+              << "resolution no coarser than RES (m) (default=0, full resolution).\n"
+              << "    --metadata-cache=FILE_CACHE      Cache model metadata in FILE_CACHE so models not containing any "
+              << "points are not opened in later runs.\n"
+              << "    --shared-cache=NAME              Share model chunks with other processes on this node using "
+              << "POSIX shared memory NAME.\n"
+              << "    --stats                          Print query statistics to stdout when done."
               << std::endl;
 } // _printHelp
 
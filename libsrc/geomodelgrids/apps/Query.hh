@@ -75,6 +75,11 @@ private:
     std::string _logFilename;
     double _squashMinElev;
     geomodelgrids::serial::Query::SquashingEnum _squash;
+    bool _prefetch;
+    double _resolution;
+    std::string _metadataCacheFilename;
+    std::string _sharedCacheName;
+    bool _showStats;
     bool _showHelp;
 
     // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,7 @@
 #include "QueryElev.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include <getopt.h> // USES getopt_long()
@@ -28,6 +29,7 @@ geomodelgrids::apps::QueryElev::QueryElev() :
     _outputFilename(""),
     _logFilename(""),
     _useTopoBathy(false),
+    _showStats(false),
     _showHelp(false) {}
 
 
@@ -55,6 +57,7 @@ geomodelgrids::apps::QueryElev::run(int argc,
         errorHandler->setLoggingOn(true);
     } // if
     std::vector<std::string> valueNames;
+    query.setStatsOn(_showStats);
     query.initialize(_modelFilenames, valueNames, _pointsCRS);
 
     std::ifstream sin(_pointsFilename);
@@ -89,6 +92,9 @@ geomodelgrids::apps::QueryElev::run(int argc,
     } // while
 
     query.finalize();
+    if (_showStats) {
+        query.getStats()->write(std::cout);
+    } // if
 
     return 0;
 } // run
@@ -107,12 +113,13 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
         {"surface", required_argument, nullptr, 's'},
+        {"stats", no_argument, nullptr, 't'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:t", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -151,6 +158,10 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
             } // if
             break;
         } // 'm'
+        case 't': {
+            _showStats = true;
+            break;
+        } // 't'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -194,14 +205,15 @@ void
 geomodelgrids::apps::QueryElev::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_queryelev "
               << "[--help] [--log=FILE_LOG] --models=FILE_0,...,FILE_M --points=FILE_POINTS --output=FILE_OUTPUT "
-              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry]\n\n"
+              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry] [--stats]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --points=FILE_POINTS             Read input points from FILE_POINTS.\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
-              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface)."
+              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface).\n"
+              << "    --stats                          Print query statistics to stdout when done."
               << std::endl;
 } // _printHelp
 
@@ -69,6 +69,7 @@ private:
     std::string _outputFilename;
     std::string _logFilename;
     bool _useTopoBathy;
+    bool _showStats;
     bool _showHelp;
 
     // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
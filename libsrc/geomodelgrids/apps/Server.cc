@@ -0,0 +1,281 @@
+#include <portinfo>
+
+#include "Server.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryServer.hh" // USES QueryServer
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <getopt.h> // USES getopt_long()
+#include <signal.h> // USES sigaction()
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <cassert> // USES assert()
+#include <iostream> // USES std::cout
+
+namespace geomodelgrids {
+    namespace apps {
+        class _Server;
+    } // apps
+} // geomodelgrids
+
+/// Stop query server on SIGINT and SIGTERM while in scope.
+class geomodelgrids::apps::_Server {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] server Query server to stop.
+     */
+    _Server(geomodelgrids::serial::QueryServer* server) {
+        _server = server;
+        struct sigaction action;
+        action.sa_handler = _Server::stop;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = 0;
+        sigaction(SIGINT, &action, &_actionIntOrig);
+        sigaction(SIGTERM, &action, &_actionTermOrig);
+    } // constructor
+
+    /// Destructor.
+    ~_Server(void) {
+        sigaction(SIGINT, &_actionIntOrig, nullptr);
+        sigaction(SIGTERM, &_actionTermOrig, nullptr);
+        _server = nullptr;
+    } // destructor
+
+    /** Stop server.
+     *
+     * @param[in] signum Signal number.
+     */
+    static
+    void stop(int signum) {
+        if (_server) {
+            _server->stop();
+        } // if
+    } // stop
+
+private:
+
+    static geomodelgrids::serial::QueryServer* _server; ///< Server stopped by signals.
+    struct sigaction _actionIntOrig; ///< Original action for SIGINT.
+    struct sigaction _actionTermOrig; ///< Original action for SIGTERM.
+
+}; // _Server
+
+geomodelgrids::serial::QueryServer* geomodelgrids::apps::_Server::_server = nullptr;
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::apps::Server::Server() :
+    _socketPath(""),
+    _pointsCRS("EPSG:4326"),
+    _logFilename(""),
+    _metadataCacheFilename(""),
+    _squashMinElev(-10.0e+3),
+    _squash(geomodelgrids::serial::Query::SQUASH_NONE),
+    _prefetch(false),
+    _resolution(0.0),
+    _showHelp(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::apps::Server::~Server(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Run server application.
+int
+geomodelgrids::apps::Server::run(int argc,
+                                 char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    geomodelgrids::serial::Query query;
+    if (!_logFilename.empty()) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
+        errorHandler->setLogFilename(_logFilename.c_str());
+        errorHandler->setLoggingOn(true);
+    } // if
+    query.setHyperslabPrefetch(_prefetch);
+    query.setQueryResolution(_resolution);
+    query.setMetadataCache(_metadataCacheFilename.c_str());
+    query.initialize(_modelFilenames, _valueNames, _pointsCRS);
+    if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
+        query.setSquashing(_squash);
+        query.setSquashMinElev(_squashMinElev);
+    } // if
+
+    geomodelgrids::serial::QueryServer server;
+    server.open(_socketPath.c_str(), &query);
+
+    { // Answer queries
+        _Server signalHandler(&server);
+        server.run();
+    } // Answer queries
+
+    server.close();
+    query.finalize();
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::apps::Server::_parseArgs(int argc,
+                                        char* argv[]) {
+    static struct option options[12] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"values", required_argument, nullptr, 'v'},
+        {"models", required_argument, nullptr, 'm'},
+        {"socket", required_argument, nullptr, 'k'},
+        {"squash-min-elev", required_argument, nullptr, 's'},
+        {"squash-surface", required_argument, nullptr, 'r'},
+        {"points-coordsys", required_argument, nullptr, 'c'},
+        {"log", required_argument, nullptr, 'l'},
+        {"prefetch", no_argument, nullptr, 'f'},
+        {"resolution", required_argument, nullptr, 'x'},
+        {"metadata-cache", required_argument, nullptr, 'a'},
+        {0, 0, 0, 0}
+    };
+
+    while (true) {
+        // extern char* optarg;
+        const char c = getopt_long(argc, argv, "hv:m:k:s:r:c:l:fx:a:", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'v': {
+            _valueNames.clear();
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            while (std::getline(tokenStream, token, ',')) {
+                _valueNames.push_back(token);
+            } // while
+            break;
+        } // 'v'
+        case 'm': {
+            _modelFilenames.clear();
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            while (std::getline(tokenStream, token, ',')) {
+                _modelFilenames.push_back(token);
+            } // while
+            break;
+        } // 'm'
+        case 'k': {
+            _socketPath = optarg;
+            break;
+        } // 'k'
+        case 's': {
+            if (geomodelgrids::serial::Query::SQUASH_NONE == _squash) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOP_SURFACE;
+            } // if
+            _squashMinElev = std::stod(optarg);
+            break;
+        } // 's'
+        case 'r': {
+            const std::string& surface = optarg;
+            if (std::string("top_surface") == surface) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOP_SURFACE;
+            } else if (std::string("topography_bathymetry") == surface) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY;
+            } else {
+                _squash = geomodelgrids::serial::Query::SQUASH_NONE;
+            }
+            break;
+        } // 'r'
+        case 'c': {
+            _pointsCRS = optarg;
+            break;
+        } // 'c'
+        case 'l': {
+            _logFilename = optarg;
+            break;
+        } // 'l'
+        case 'f': {
+            _prefetch = true;
+            break;
+        } // 'f'
+        case 'x': {
+            _resolution = std::stod(optarg);
+            break;
+        } // 'x'
+        case 'a': {
+            _metadataCacheFilename = optarg;
+            break;
+        } // 'a'
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error parsing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+
+    if (1 == argc) {
+        _showHelp = true;
+    } // if
+    if (!_showHelp) { // Verify required arguments were provided.
+        bool optionsOkay = true;
+        std::ostringstream msg;
+        if (_valueNames.empty()) {
+            msg << "    - Missing names of values to return in queries. Use --values=VALUE_0,...,VALUE_N\n";
+            optionsOkay = false;
+        } // if
+        if (_modelFilenames.empty()) {
+            msg << "    - Missing list of model filenames. Use --models=FILE_0,...,FILE_M\n";
+            optionsOkay = false;
+        } // if
+        if (_socketPath.empty()) {
+            msg << "    - Missing path of socket for clients. Use --socket=FILE_SOCKET\n";
+            optionsOkay = false;
+        } // if
+
+        if (!optionsOkay) {
+            throw std::runtime_error(std::string("Missing required command line arguments:\n")+ msg.str());
+        } // if
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::apps::Server::_printHelp(void) {
+    std::cout << "Usage: geomodelgrids_server "
+              << "[--help]  [--log=FILE_LOG] --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
+              << "--socket=FILE_SOCKET [--squash-min-elev=ELEV] "
+              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT] "
+              << "[--prefetch] [--resolution=RES] [--metadata-cache=FILE_CACHE]\n\n"
+              << "    --help                           Print help information to stdout and exit.\n"
+              << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
+              << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in queries.\n"
+              << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
+              << "    --socket=FILE_SOCKET             Listen for clients on Unix-domain socket FILE_SOCKET.\n"
+              << "    --squash-min-elev=ELEV           Top of the model is squashed/stretched to z=0 with the model below z=ELEV held fixed (default=-10.0e+3).\n"
+              << "    --squash-surface=none|top_surface|topography_bathymetry    Surface reference for squashing/stretching (default=none).\n"
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of points sent by clients (default=EPSG:4326).\n"
+              << "    --prefetch                       Prefetch model data along the direction points are traversed "
+              << "(for points ordered along lines or grids).\n"
+              << "    --resolution=RES                 Query coarser levels of multi-resolution pyramids with horizontal "
+              << "resolution no coarser than RES (m) (default=0, full resolution).\n"
+              << "    --metadata-cache=FILE_CACHE      Cache model metadata in FILE_CACHE so models not containing any "
+              << "points are not opened in later runs.\n\n"
+              << "The server runs until it receives SIGINT or SIGTERM or a client requests shutdown."
+              << std::endl;
+} // _printHelp
+
+
+// End of file
@@ -0,0 +1,86 @@
+/// C++ application to keep a query resident and answer queries from other processes.
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/Query.hh" // HASA SquashingEnum
+
+#include <vector> // HASA std::std::vector
+#include <string> // HASA std::string
+
+class geomodelgrids::apps::Server {
+    friend class TestServer; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    Server(void);
+
+    /// Destructor
+    ~Server(void);
+
+    /**
+     * Run server application.
+     *
+     * Arguments:
+     *   --help
+     *   --values=VALUE_0,...,VALUE_N
+     *   --models=FILE_0,...,FILE_M
+     *   --socket=FILE_SOCKET
+     *   --squash-min-elev=ELEV
+     *   --squash-surface=top_surface|topography_bathymetry
+     *   --points-coordsys=PROJ|EPSG|WKT
+     *   --log=FILE_LOG
+     *   --prefetch
+     *   --resolution=RES
+     *   --metadata-cache=FILE_CACHE
+     *
+     * The server answers queries until it receives SIGINT or SIGTERM or a client requests shutdown.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::vector<std::string> _modelFilenames;
+    std::vector<std::string> _valueNames;
+    std::string _socketPath;
+    std::string _pointsCRS;
+    std::string _logFilename;
+    std::string _metadataCacheFilename;
+    double _squashMinElev;
+    geomodelgrids::serial::Query::SquashingEnum _squash;
+    bool _prefetch;
+    double _resolution;
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    Server(const Server&); ///< Not implemented
+    const Server& operator=(const Server&); ///< Not implemented
+
+}; // Server
+
+// End of file
@@ -7,6 +7,7 @@ namespace geomodelgrids {
         class QueryElev;
         class Borehole;
         class Isosurface;
+        class Server;
     } // apps
 } // geomodelgrids
 
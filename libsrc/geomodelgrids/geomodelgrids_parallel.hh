@@ -0,0 +1,13 @@
+/** High-level header file for geomodelgrids library.
+ * This file can be used as the include for the parallel query api.
+ */
+
+#if !defined(geomodelgrids_parallel_hh)
+#define geomodelgrids_parallel_hh
+
+#include "serial/Query.hh"
+#include "parallel/Query.hh"
+
+#endif // geomodelgrids_parallel_hh
+
+// End of file
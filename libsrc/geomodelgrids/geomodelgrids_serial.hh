@@ -6,6 +6,7 @@
 #define geomodelgrids_serial_hh
 
 #include "serial/Query.hh"
+#include "serial/QueryClient.hh"
 
 #endif // geomodelgrids_serial_hh
 
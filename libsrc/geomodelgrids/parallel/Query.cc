@@ -0,0 +1,910 @@
+#include <portinfo>
+
+#include "Query.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include <fstream> // USES std::ifstream
+#include <algorithm> // USES std::sort(), std::lower_bound()
+#include <numeric> // USES std::iota()
+#include <limits> // USES std::numeric_limits
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cstdint> // USES uint64_t
+#include <cmath> // USES M_PI, cos(), sin(), ceil(), floor()
+#include <cassert> // USES assert()
+#include <unistd.h> // USES sysconf()
+
+namespace geomodelgrids {
+    namespace parallel {
+        class _Query;
+    } // parallel
+} // geomodelgrids
+
+class geomodelgrids::parallel::_Query {
+public:
+
+    /// Maximum number of bytes in a single broadcast of a model file.
+    static const size_t BCAST_BYTES;
+
+    /// Number of keys each process contributes to selecting the partition of points.
+    static const size_t NUM_SAMPLES;
+
+    /** Read model file on process 0 and share it with all processes if it fits in the shared memory budget.
+     *
+     * @param[inout] query Parallel query.
+     * @param[in] filename Name of model file.
+     * @param[inout] availableBytes Number of bytes remaining in the shared memory budget of each node.
+     * @param[out] image Contents of model file in shared memory (nullptr if the file does not fit).
+     * @param[out] numBytes Size of model file in bytes (0 if the file does not fit).
+     */
+    static
+    void shareModelFile(geomodelgrids::parallel::Query& query,
+                        const std::string& filename,
+                        uint64_t* availableBytes,
+                        const void** image,
+                        size_t* numBytes);
+
+    /** Get default maximum number of bytes of model files in shared memory on each node.
+     *
+     * @returns Half of the physical memory of the node (maximum size_t if unknown).
+     */
+    static
+    size_t defaultMaxSharedBytes(void);
+
+    /** Decompose horizontal domain of first model into tiles aligned with the chunks of its blocks and divide the
+     * tiles among a grid of processes.
+     *
+     * @param[inout] query Parallel query.
+     * @param[in] filename Name of model file defining the domain decomposition.
+     * @param[in] inputCRSString Coordinate reference system (CRS) as string for input points.
+     */
+    static
+    void decomposeDomain(geomodelgrids::parallel::Query& query,
+                         const std::string& filename,
+                         const std::string& inputCRSString);
+
+    /** Assign points to the processes that own the tiles containing them.
+     *
+     * Points outside the horizontal domain of the model defining the decomposition are assigned using
+     * partitionKeys().
+     *
+     * @param[out] owners Process that queries each point.
+     * @param[inout] query Parallel query.
+     * @param[in] x X coordinates of points.
+     * @param[in] y Y coordinates of points.
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[in] keys Keys of points.
+     */
+    static
+    void assignDomainOwners(std::vector<int>* owners,
+                            geomodelgrids::parallel::Query& query,
+                            const double* const x,
+                            const double* const y,
+                            const size_t pointsStride,
+                            const size_t numPoints,
+                            const std::vector<uint64_t>& keys);
+
+    /** Compute keys ordering points along a space-filling (Morton) curve in the horizontal plane.
+     *
+     * The curve spans the bounding box of the points on all processes.
+     *
+     * @param[out] keys Keys of points.
+     * @param[in] comm MPI communicator.
+     * @param[in] x X coordinates of points.
+     * @param[in] y Y coordinates of points.
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     */
+    static
+    void computeKeys(std::vector<uint64_t>* keys,
+                     MPI_Comm comm,
+                     const double* const x,
+                     const double* const y,
+                     const size_t pointsStride,
+                     const size_t numPoints);
+
+    /** Assign points to processes so each process gets about the same number of points with consecutive keys.
+     *
+     * @param[out] owners Process that queries each point.
+     * @param[in] comm MPI communicator.
+     * @param[in] keys Keys of points.
+     */
+    static
+    void partitionKeys(std::vector<int>* owners,
+                       MPI_Comm comm,
+                       const std::vector<uint64_t>& keys);
+
+    /** Send points to the processes that query them, query them, and return the values.
+     *
+     * @param[inout] query Parallel query.
+     * @param[out] values Values at points; values for point i start at values[i*valuesStride].
+     * @param[in] valuesStride Number of values between the starts of consecutive points.
+     * @param[in] x X coordinates of points.
+     * @param[in] y Y coordinates of points.
+     * @param[in] z Z coordinates of points.
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[in] keys Keys ordering points for querying.
+     * @param[in] owners Process that queries each point.
+     * @param[out] status Status for each point.
+     * @returns True if there was an error querying points on this process, false otherwise.
+     */
+    static
+    bool queryOwners(geomodelgrids::parallel::Query& query,
+                     double* const values,
+                     const size_t valuesStride,
+                     const double* const x,
+                     const double* const y,
+                     const double* const z,
+                     const size_t pointsStride,
+                     const size_t numPoints,
+                     const std::vector<uint64_t>& keys,
+                     const std::vector<int>& owners,
+                     int* const status);
+
+    /** Interleave bits of two 32-bit integers.
+     *
+     * @param[in] ix Integer in even bits.
+     * @param[in] iy Integer in odd bits.
+     * @returns Interleaved bits.
+     */
+    static
+    uint64_t interleave(const uint32_t ix,
+                        const uint32_t iy);
+
+    /** Check that counts of values fit in an MPI count.
+     *
+     * @param[in] comm MPI communicator.
+     * @param[in] count Number of values on this process.
+     */
+    static
+    void checkCount(MPI_Comm comm,
+                    const size_t count);
+
+}; // _Query
+const size_t geomodelgrids::parallel::_Query::BCAST_BYTES = 1073741824;
+const size_t geomodelgrids::parallel::_Query::NUM_SAMPLES = 256;
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::parallel::Query::Query(MPI_Comm comm) :
+    _comm(comm),
+    _nodeComm(MPI_COMM_NULL),
+    _nodeLeadersComm(MPI_COMM_NULL),
+    _decomposition(DECOMPOSE_POINTS),
+    _maxSharedBytes(_Query::defaultMaxSharedBytes()),
+    _domainYAzimuth(0.0) {
+    _domainOrigin[0] = 0.0;
+    _domainOrigin[1] = 0.0;
+    _domainDims[0] = 0.0;
+    _domainDims[1] = 0.0;
+    _tileDims[0] = 0.0;
+    _tileDims[1] = 0.0;
+    _numTiles[0] = 0;
+    _numTiles[1] = 0;
+    _procGrid[0] = 0;
+    _procGrid[1] = 0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::parallel::Query::~Query(void) {
+    int isFinalized = 0;
+    MPI_Finalized(&isFinalized);
+    if (!isFinalized && (MPI_COMM_NULL != _nodeComm)) {
+        finalize();
+    } // if
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get MPI communicator.
+MPI_Comm
+geomodelgrids::parallel::Query::getComm(void) const {
+    return _comm;
+} // getComm
+
+
+// ------------------------------------------------------------------------------------------------
+// Get serial query.
+geomodelgrids::serial::Query&
+geomodelgrids::parallel::Query::getSerialQuery(void) {
+    return _query;
+} // getSerialQuery
+
+
+// ------------------------------------------------------------------------------------------------
+// Set how the models and points are divided among processes.
+void
+geomodelgrids::parallel::Query::setDecomposition(const DecompositionEnum value) {
+    _decomposition = value;
+} // setDecomposition
+
+
+// ------------------------------------------------------------------------------------------------
+// Get how the models and points are divided among processes.
+geomodelgrids::parallel::Query::DecompositionEnum
+geomodelgrids::parallel::Query::getDecomposition(void) const {
+    return _decomposition;
+} // getDecomposition
+
+
+// ------------------------------------------------------------------------------------------------
+// Set maximum number of bytes of model files held in shared memory on each node.
+void
+geomodelgrids::parallel::Query::setMaxSharedBytes(const size_t value) {
+    _maxSharedBytes = value;
+} // setMaxSharedBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum number of bytes of model files held in shared memory on each node.
+size_t
+geomodelgrids::parallel::Query::getMaxSharedBytes(void) const {
+    return _maxSharedBytes;
+} // getMaxSharedBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Do setup for querying.
+void
+geomodelgrids::parallel::Query::initialize(const std::vector<std::string>& modelFilenames,
+                                           const std::vector<std::string>& valueNames,
+                                           const std::string& inputCRSString) {
+    finalize();
+
+    if (DECOMPOSE_MODEL == _decomposition) {
+        if (!modelFilenames.empty()) {
+            _Query::decomposeDomain(*this, modelFilenames[0], inputCRSString);
+        } // if
+        _query.initialize(modelFilenames, valueNames, inputCRSString);
+        return;
+    } // if
+
+    int rank = 0;
+    MPI_Comm_rank(_comm, &rank);
+    MPI_Comm_split_type(_comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &_nodeComm);
+    int nodeRank = 0;
+    MPI_Comm_rank(_nodeComm, &nodeRank);
+    MPI_Comm_split(_comm, (0 == nodeRank) ? 0 : MPI_UNDEFINED, rank, &_nodeLeadersComm);
+
+    // All processes must agree on which models are shared.
+    const uint64_t maxSharedBytes = uint64_t(_maxSharedBytes);
+    uint64_t availableBytes = 0;
+    MPI_Allreduce(&maxSharedBytes, &availableBytes, 1, MPI_UINT64_T, MPI_MIN, _comm);
+
+    _modelFilenames = modelFilenames;
+    for (size_t i = 0; i < modelFilenames.size(); ++i) {
+        const void* image = nullptr;
+        size_t numBytes = 0;
+        _Query::shareModelFile(*this, modelFilenames[i], &availableBytes, &image, &numBytes);
+        if (image) {
+            _query.setModelFileImage(modelFilenames[i].c_str(), image, numBytes);
+        } // if
+    } // for
+
+    _query.initialize(modelFilenames, valueNames, inputCRSString);
+} // initialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Query models for values at many points distributed across processes.
+int
+geomodelgrids::parallel::Query::queryPoints(double* const values,
+                                            const size_t valuesStride,
+                                            const double* const x,
+                                            const double* const y,
+                                            const double* const z,
+                                            const size_t pointsStride,
+                                            const size_t numPoints,
+                                            int* const status,
+                                            size_t* const numOutside) {
+    // Check arguments locally, but take part in the collective operations with no points on error.
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = _query.getErrorHandler();
+    assert(errorHandler);
+    bool isError = false;
+    if (numPoints && (!values || !x || !y || !z)) {
+        errorHandler->setError("geomodelgrids::parallel::Query::queryPoints() passed nullptr for values or "
+                               "coordinates argument.");
+        isError = true;
+    } else if (valuesStride < _query.getValueNames().size()) {
+        std::ostringstream msg;
+        msg << "Stride of values (" << valuesStride << ") must be at least the number of query values ("
+            << _query.getValueNames().size() << ").";
+        errorHandler->setError(msg.str().c_str());
+        isError = true;
+    } else if ((numPoints > 1) && !pointsStride) {
+        errorHandler->setError("Stride of points must be positive.");
+        isError = true;
+    } // if/else
+    const size_t numPointsLocal = (isError) ? 0 : numPoints;
+
+    std::vector<uint64_t> keys;
+    _Query::computeKeys(&keys, _comm, x, y, pointsStride, numPointsLocal);
+    std::vector<int> owners;
+    if (_domainTransformer) {
+        _Query::assignDomainOwners(&owners, *this, x, y, pointsStride, numPointsLocal, keys);
+    } else {
+        _Query::partitionKeys(&owners, _comm, keys);
+    } // if/else
+    std::vector<int> statusLocal(numPointsLocal);
+    isError = _Query::queryOwners(*this, values, valuesStride, x, y, z, pointsStride, numPointsLocal, keys, owners,
+                                  statusLocal.data()) || isError;
+
+    size_t numOutsideLocal = 0;
+    for (size_t iPt = 0; iPt < numPointsLocal; ++iPt) {
+        numOutsideLocal += (geomodelgrids::utils::ErrorHandler::OK == statusLocal[iPt]) ? 0 : 1;
+    } // for
+    if (status) {
+        std::copy(statusLocal.begin(), statusLocal.end(), status);
+    } // if
+    if (numOutside) {
+        *numOutside = numOutsideLocal;
+    } // if
+
+    int isErrorAny = 0;
+    const int isErrorLocal = (isError) ? 1 : 0;
+    MPI_Allreduce(&isErrorLocal, &isErrorAny, 1, MPI_INT, MPI_MAX, _comm);
+    if (isErrorAny) {
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    return (numOutsideLocal) ? geomodelgrids::utils::ErrorHandler::WARNING : geomodelgrids::utils::ErrorHandler::OK;
+} // queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Cleanup after querying.
+void
+geomodelgrids::parallel::Query::finalize(void) {
+    // Close models before releasing the memory holding them.
+    _query.finalize();
+    for (size_t i = 0; i < _modelFilenames.size(); ++i) {
+        _query.setModelFileImage(_modelFilenames[i].c_str(), nullptr, 0);
+    } // for
+    for (size_t i = 0; i < _modelImages.size(); ++i) {
+        MPI_Win_unlock_all(_modelImages[i]);
+        MPI_Win_free(&_modelImages[i]);
+    } // for
+    _modelImages.clear();
+    _domainTransformer.reset();
+
+    if (MPI_COMM_NULL != _nodeLeadersComm) {
+        MPI_Comm_free(&_nodeLeadersComm);
+    } // if
+    if (MPI_COMM_NULL != _nodeComm) {
+        MPI_Comm_free(&_nodeComm);
+    } // if
+} // finalize
+
+
+// ------------------------------------------------------------------------------------------------
+// Read model file on process 0 and share it with all processes.
+void
+geomodelgrids::parallel::_Query::shareModelFile(geomodelgrids::parallel::Query& query,
+                                                const std::string& filename,
+                                                uint64_t* availableBytes,
+                                                const void** image,
+                                                size_t* numBytes) {
+    assert(availableBytes);
+    assert(image);
+    assert(numBytes);
+
+    int rank = 0;
+    MPI_Comm_rank(query._comm, &rank);
+    int nodeRank = 0;
+    MPI_Comm_rank(query._nodeComm, &nodeRank);
+
+    // Process 0 is the first process on its node and process 0 among the first processes on each node.
+    std::ifstream fin;
+    uint64_t fileBytes = 0;
+    int isOkay = 1;
+    if (0 == rank) {
+        fin.open(filename.c_str(), std::ios::binary | std::ios::ate);
+        isOkay = fin.is_open() ? 1 : 0;
+        fileBytes = (isOkay) ? uint64_t(fin.tellg()) : 0;
+        fin.seekg(0);
+    } // if
+    MPI_Bcast(&isOkay, 1, MPI_INT, 0, query._comm);
+    if (!isOkay) {
+        std::ostringstream msg;
+        msg << "Could not open model file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    MPI_Bcast(&fileBytes, 1, MPI_UINT64_T, 0, query._comm);
+
+    // Processes read models that do not fit in the budget from the file rather than failing the allocation.
+    *image = nullptr;
+    *numBytes = 0;
+    if (fileBytes > *availableBytes) {
+        return;
+    } // if
+    *availableBytes -= fileBytes;
+
+    char* buffer = nullptr;
+    MPI_Win window = MPI_WIN_NULL;
+    const MPI_Aint windowBytes = (0 == nodeRank) ? MPI_Aint(fileBytes) : 0;
+    MPI_Win_allocate_shared(windowBytes, 1, MPI_INFO_NULL, query._nodeComm, &buffer, &window);
+    query._modelImages.push_back(window);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+
+    if (0 == rank) {
+        isOkay = (fin.read(buffer, fileBytes)) ? 1 : 0;
+    } // if
+    MPI_Bcast(&isOkay, 1, MPI_INT, 0, query._comm);
+    if (!isOkay) {
+        std::ostringstream msg;
+        msg << "Could not read model file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    if (MPI_COMM_NULL != query._nodeLeadersComm) {
+        for (uint64_t offset = 0; offset < fileBytes; offset += BCAST_BYTES) {
+            const int count = int(std::min(uint64_t(BCAST_BYTES), fileBytes - offset));
+            MPI_Bcast(buffer + offset, count, MPI_BYTE, 0, query._nodeLeadersComm);
+        } // for
+    } // if
+
+    // Make the model file written by the first process on the node visible to the other processes.
+    MPI_Win_sync(window);
+    MPI_Barrier(query._nodeComm);
+    MPI_Win_sync(window);
+
+    MPI_Aint sharedBytes = 0;
+    int dispUnit = 0;
+    MPI_Win_shared_query(window, 0, &sharedBytes, &dispUnit, &buffer);
+    assert(uint64_t(sharedBytes) == fileBytes);
+    *image = buffer;
+    *numBytes = size_t(fileBytes);
+} // shareModelFile
+
+
+// ------------------------------------------------------------------------------------------------
+// Get default maximum number of bytes of model files in shared memory on each node.
+size_t
+geomodelgrids::parallel::_Query::defaultMaxSharedBytes(void) {
+    const long numPages = sysconf(_SC_PHYS_PAGES);
+    const long pageBytes = sysconf(_SC_PAGESIZE);
+    if ((numPages <= 0) || (pageBytes <= 0)) {
+        return std::numeric_limits<size_t>::max();
+    } // if
+    return size_t(numPages / 2) * size_t(pageBytes);
+} // defaultMaxSharedBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Decompose horizontal domain of first model into tiles and divide the tiles among a grid of processes.
+void
+geomodelgrids::parallel::_Query::decomposeDomain(geomodelgrids::parallel::Query& query,
+                                                 const std::string& filename,
+                                                 const std::string& inputCRSString) {
+    int rank = 0;
+    int numProcs = 1;
+    MPI_Comm_rank(query._comm, &rank);
+    MPI_Comm_size(query._comm, &numProcs);
+
+    // Process 0 reads the metadata; [origin x, origin y, y azimuth, dim x, dim y, tile x, tile y].
+    const size_t numParams = 7;
+    double params[numParams] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    std::string modelCRS;
+    std::string errorMsg;
+    if (0 == rank) {
+        try {
+            geomodelgrids::serial::Model model;
+            model.open(filename.c_str(), geomodelgrids::serial::Model::READ);
+            model.loadMetadata();
+            const double* origin = model.getOrigin();
+            const double* dims = model.getDims();
+            params[0] = origin[0];
+            params[1] = origin[1];
+            params[2] = model.getYAzimuth();
+            params[3] = dims[0];
+            params[4] = dims[1];
+            modelCRS = model.getCRSString();
+
+            // Tiles cover the largest chunk of any block, so a tile does not split chunks of coarser blocks.
+            geomodelgrids::serial::HDF5 h5;
+            h5.open(filename.c_str(), H5F_ACC_RDONLY);
+            const std::vector<std::shared_ptr<geomodelgrids::serial::Block> >& blocks = model.getBlocks();
+            for (size_t iBlock = 0; iBlock < blocks.size(); ++iBlock) {
+                hsize_t* chunkDims = nullptr;
+                int ndims = 0;
+                h5.getDatasetChunk(&chunkDims, &ndims, blocks[iBlock]->getPath().c_str());
+                const size_t* blockDims = blocks[iBlock]->getDims();
+                for (size_t iDim = 0; iDim < 2; ++iDim) {
+                    const size_t numChunkPoints = (ndims > int(iDim)) ? size_t(chunkDims[iDim]) : 1;
+                    const double spacing = (blockDims[iDim] > 1) ? dims[iDim] / (blockDims[iDim]-1) : dims[iDim];
+                    params[5+iDim] = std::max(params[5+iDim], numChunkPoints*spacing);
+                } // for
+                delete[] chunkDims;chunkDims = nullptr;
+            } // for
+            h5.close();
+            model.close();
+        } catch (const std::exception& err) {
+            errorMsg = err.what();
+        } // try/catch
+    } // if
+
+    // Broadcast error message, model CRS, and parameters.
+    unsigned long lengths[2] = { errorMsg.length(), modelCRS.length() };
+    MPI_Bcast(lengths, 2, MPI_UNSIGNED_LONG, 0, query._comm);
+    errorMsg.resize(lengths[0]);
+    modelCRS.resize(lengths[1]);
+    if (lengths[0]) {
+        MPI_Bcast(&errorMsg[0], int(lengths[0]), MPI_CHAR, 0, query._comm);
+        throw std::runtime_error(errorMsg);
+    } // if
+    MPI_Bcast(&modelCRS[0], int(lengths[1]), MPI_CHAR, 0, query._comm);
+    MPI_Bcast(params, numParams, MPI_DOUBLE, 0, query._comm);
+
+    query._domainOrigin[0] = params[0];
+    query._domainOrigin[1] = params[1];
+    query._domainYAzimuth = params[2];
+    for (size_t iDim = 0; iDim < 2; ++iDim) {
+        query._domainDims[iDim] = params[3+iDim];
+        query._tileDims[iDim] = (params[5+iDim] > 0.0) ? params[5+iDim] : params[3+iDim];
+        query._numTiles[iDim] = (query._tileDims[iDim] > 0.0) ?
+                                std::max(size_t(1), size_t(ceil(params[3+iDim] / query._tileDims[iDim]))) : 1;
+    } // for
+
+    // Choose grid of processes minimizing the largest number of tiles on a process, then the perimeter of a slab.
+    size_t minTiles = std::numeric_limits<size_t>::max();
+    size_t minPerimeter = std::numeric_limits<size_t>::max();
+    for (int px = 1; px <= numProcs; ++px) {
+        if (numProcs % px) {
+            continue;
+        } // if
+        const int py = numProcs / px;
+        const size_t slabX = (query._numTiles[0] + px - 1) / px;
+        const size_t slabY = (query._numTiles[1] + py - 1) / py;
+        if ((slabX*slabY < minTiles) || ((slabX*slabY == minTiles) && (slabX+slabY < minPerimeter))) {
+            minTiles = slabX*slabY;
+            minPerimeter = slabX + slabY;
+            query._procGrid[0] = px;
+            query._procGrid[1] = py;
+        } // if
+    } // for
+
+    query._domainTransformer = std::make_shared<geomodelgrids::utils::CRSTransformer>();
+    query._domainTransformer->setSrc(inputCRSString.c_str());
+    query._domainTransformer->setDest(modelCRS.c_str());
+    query._domainTransformer->initialize();
+} // decomposeDomain
+
+
+// ------------------------------------------------------------------------------------------------
+// Assign points to the processes that own the tiles containing them.
+void
+geomodelgrids::parallel::_Query::assignDomainOwners(std::vector<int>* owners,
+                                                    geomodelgrids::parallel::Query& query,
+                                                    const double* const x,
+                                                    const double* const y,
+                                                    const size_t pointsStride,
+                                                    const size_t numPoints,
+                                                    const std::vector<uint64_t>& keys) {
+    assert(owners);
+    assert(query._domainTransformer);
+
+    // Horizontal model coordinates of points (z is not needed to find the tile).
+    const size_t spaceDim = 3;
+    std::vector<double> xyz(numPoints*spaceDim, 0.0);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        xyz[iPt*spaceDim+0] = x[iPt*pointsStride];
+        xyz[iPt*spaceDim+1] = y[iPt*pointsStride];
+    } // for
+    query._domainTransformer->transform(xyz.data(), numPoints);
+
+    const double yazimuthRad = query._domainYAzimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    owners->resize(numPoints);
+    std::vector<size_t> outside;
+    std::vector<uint64_t> keysOutside;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double xRel = xyz[iPt*spaceDim+0] - query._domainOrigin[0];
+        const double yRel = xyz[iPt*spaceDim+1] - query._domainOrigin[1];
+        const double xyModel[2] = { xRel*cosAz - yRel*sinAz, xRel*sinAz + yRel*cosAz };
+        bool isInside = true;
+        size_t slab[2] = { 0, 0 };
+        for (size_t iDim = 0; iDim < 2; ++iDim) {
+            if ((xyModel[iDim] < 0.0) || (xyModel[iDim] > query._domainDims[iDim])) {
+                isInside = false;
+                break;
+            } // if
+            const size_t numTiles = query._numTiles[iDim];
+            const size_t iTile = std::min(numTiles-1, size_t(floor(xyModel[iDim] / query._tileDims[iDim])));
+            slab[iDim] = (iTile * query._procGrid[iDim]) / numTiles;
+        } // for
+        if (isInside) {
+            (*owners)[iPt] = int(slab[0]) * query._procGrid[1] + int(slab[1]);
+        } else {
+            outside.push_back(iPt);
+            keysOutside.push_back(keys[iPt]);
+        } // if/else
+    } // for
+
+    // Balance points outside the domain across all processes.
+    std::vector<int> ownersOutside;
+    partitionKeys(&ownersOutside, query._comm, keysOutside);
+    for (size_t i = 0; i < outside.size(); ++i) {
+        (*owners)[outside[i]] = ownersOutside[i];
+    } // for
+} // assignDomainOwners
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute keys ordering points along a space-filling curve in the horizontal plane.
+void
+geomodelgrids::parallel::_Query::computeKeys(std::vector<uint64_t>* keys,
+                                             MPI_Comm comm,
+                                             const double* const x,
+                                             const double* const y,
+                                             const size_t pointsStride,
+                                             const size_t numPoints) {
+    assert(keys);
+
+    // Bounding box as minimums of (x, y, -x, -y) so a single reduction gives it.
+    double bboxLocal[4] = {
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::max(),
+    };
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double xPt = x[iPt*pointsStride];
+        const double yPt = y[iPt*pointsStride];
+        bboxLocal[0] = std::min(bboxLocal[0], xPt);
+        bboxLocal[1] = std::min(bboxLocal[1], yPt);
+        bboxLocal[2] = std::min(bboxLocal[2], -xPt);
+        bboxLocal[3] = std::min(bboxLocal[3], -yPt);
+    } // for
+    double bbox[4];
+    MPI_Allreduce(bboxLocal, bbox, 4, MPI_DOUBLE, MPI_MIN, comm);
+
+    const double maxIndex = double(std::numeric_limits<uint32_t>::max());
+    const double xScale = (-bbox[2] > bbox[0]) ? maxIndex / (-bbox[2] - bbox[0]) : 0.0;
+    const double yScale = (-bbox[3] > bbox[1]) ? maxIndex / (-bbox[3] - bbox[1]) : 0.0;
+    keys->resize(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double xIndex = std::max(0.0, std::min(maxIndex, (x[iPt*pointsStride] - bbox[0]) * xScale));
+        const double yIndex = std::max(0.0, std::min(maxIndex, (y[iPt*pointsStride] - bbox[1]) * yScale));
+        (*keys)[iPt] = interleave(uint32_t(xIndex), uint32_t(yIndex));
+    } // for
+} // computeKeys
+
+
+// ------------------------------------------------------------------------------------------------
+// Assign points to processes so each process gets about the same number of points with consecutive keys.
+void
+geomodelgrids::parallel::_Query::partitionKeys(std::vector<int>* owners,
+                                               MPI_Comm comm,
+                                               const std::vector<uint64_t>& keys) {
+    assert(owners);
+
+    int numProcs = 1;
+    MPI_Comm_size(comm, &numProcs);
+
+    // Each process contributes evenly spaced samples of its sorted keys, weighted by the number of points each
+    // sample represents.
+    const size_t numPoints = keys.size();
+    std::vector<uint64_t> keysSorted(keys);
+    std::sort(keysSorted.begin(), keysSorted.end());
+    const int numSamplesLocal = int(std::min(numPoints, NUM_SAMPLES));
+    std::vector<uint64_t> samplesLocal(numSamplesLocal);
+    for (int i = 0; i < numSamplesLocal; ++i) {
+        samplesLocal[i] = keysSorted[((2*i+1) * numPoints) / (2*numSamplesLocal)];
+    } // for
+    const double weightLocal = (numSamplesLocal) ? double(numPoints) / numSamplesLocal : 0.0;
+
+    std::vector<int> numSamples(numProcs);
+    MPI_Allgather(&numSamplesLocal, 1, MPI_INT, numSamples.data(), 1, MPI_INT, comm);
+    std::vector<double> weights(numProcs);
+    MPI_Allgather(&weightLocal, 1, MPI_DOUBLE, weights.data(), 1, MPI_DOUBLE, comm);
+    std::vector<int> displs(numProcs+1, 0);
+    for (int i = 0; i < numProcs; ++i) {
+        displs[i+1] = displs[i] + numSamples[i];
+    } // for
+    std::vector<uint64_t> samplesAll(displs[numProcs]);
+    MPI_Allgatherv(samplesLocal.data(), numSamplesLocal, MPI_UINT64_T, samplesAll.data(), numSamples.data(),
+                   displs.data(), MPI_UINT64_T, comm);
+
+    std::vector<std::pair<uint64_t, double> > samples(samplesAll.size());
+    double weightTotal = 0.0;
+    for (int iProc = 0; iProc < numProcs; ++iProc) {
+        for (int i = displs[iProc]; i < displs[iProc+1]; ++i) {
+            samples[i] = std::make_pair(samplesAll[i], weights[iProc]);
+            weightTotal += weights[iProc];
+        } // for
+    } // for
+    std::sort(samples.begin(), samples.end());
+
+    // Process i queries points with keys in (splitters[i-1], splitters[i]].
+    std::vector<uint64_t> splitters(numProcs-1, std::numeric_limits<uint64_t>::max());
+    double weightSum = 0.0;
+    size_t iSplitter = 0;
+    for (size_t i = 0; i < samples.size() && iSplitter < splitters.size(); ++i) {
+        weightSum += samples[i].second;
+        while (iSplitter < splitters.size() && weightSum >= weightTotal * (iSplitter+1) / numProcs) {
+            splitters[iSplitter++] = samples[i].first;
+        } // while
+    } // for
+
+    owners->resize(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        (*owners)[iPt] = int(std::lower_bound(splitters.begin(), splitters.end(), keys[iPt]) - splitters.begin());
+    } // for
+} // partitionKeys
+
+
+// ------------------------------------------------------------------------------------------------
+// Send points to the processes that query them, query them, and return the values.
+bool
+geomodelgrids::parallel::_Query::queryOwners(geomodelgrids::parallel::Query& query,
+                                             double* const values,
+                                             const size_t valuesStride,
+                                             const double* const x,
+                                             const double* const y,
+                                             const double* const z,
+                                             const size_t pointsStride,
+                                             const size_t numPoints,
+                                             const std::vector<uint64_t>& keys,
+                                             const std::vector<int>& owners,
+                                             int* const status) {
+    assert(keys.size() == numPoints);
+    assert(owners.size() == numPoints);
+
+    int numProcs = 1;
+    MPI_Comm_size(query._comm, &numProcs);
+    const size_t numValues = query._query.getValueNames().size();
+    const size_t spaceDim = 3;
+    checkCount(query._comm, numPoints * std::max(spaceDim, numValues));
+
+    // Order points by owner and then by key.
+    std::vector<size_t> sendOrder(numPoints);
+    std::iota(sendOrder.begin(), sendOrder.end(), 0);
+    std::sort(sendOrder.begin(), sendOrder.end(), [&owners, &keys](const size_t a,
+                                                                   const size_t b) {
+        return (owners[a] < owners[b]) || ((owners[a] == owners[b]) && (keys[a] < keys[b]));
+    });
+    std::vector<int> sendCounts(numProcs, 0);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        ++sendCounts[owners[iPt]];
+    } // for
+    std::vector<int> recvCounts(numProcs, 0);
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, query._comm);
+    size_t numRecv = 0;
+    for (int i = 0; i < numProcs; ++i) {
+        numRecv += recvCounts[i];
+    } // for
+    checkCount(query._comm, numRecv * std::max(spaceDim, numValues));
+
+    // Counts and displacements in units of points, coordinates, and values.
+    std::vector<int> sendDispls(numProcs, 0);
+    std::vector<int> recvDispls(numProcs, 0);
+    for (int i = 1; i < numProcs; ++i) {
+        sendDispls[i] = sendDispls[i-1] + sendCounts[i-1];
+        recvDispls[i] = recvDispls[i-1] + recvCounts[i-1];
+    } // for
+    std::vector<int> sendCountsXYZ(numProcs);
+    std::vector<int> sendDisplsXYZ(numProcs);
+    std::vector<int> recvCountsXYZ(numProcs);
+    std::vector<int> recvDisplsXYZ(numProcs);
+    std::vector<int> sendCountsValues(numProcs);
+    std::vector<int> sendDisplsValues(numProcs);
+    std::vector<int> recvCountsValues(numProcs);
+    std::vector<int> recvDisplsValues(numProcs);
+    for (int i = 0; i < numProcs; ++i) {
+        sendCountsXYZ[i] = sendCounts[i] * spaceDim;
+        sendDisplsXYZ[i] = sendDispls[i] * spaceDim;
+        recvCountsXYZ[i] = recvCounts[i] * spaceDim;
+        recvDisplsXYZ[i] = recvDispls[i] * spaceDim;
+        sendCountsValues[i] = sendCounts[i] * numValues;
+        sendDisplsValues[i] = sendDispls[i] * numValues;
+        recvCountsValues[i] = recvCounts[i] * numValues;
+        recvDisplsValues[i] = recvDispls[i] * numValues;
+    } // for
+
+    // Send points to owners.
+    std::vector<double> sendXYZ(numPoints*spaceDim);
+    std::vector<uint64_t> sendKeys(numPoints);
+    for (size_t i = 0; i < numPoints; ++i) {
+        const size_t iPt = sendOrder[i];
+        sendXYZ[i*spaceDim+0] = x[iPt*pointsStride];
+        sendXYZ[i*spaceDim+1] = y[iPt*pointsStride];
+        sendXYZ[i*spaceDim+2] = z[iPt*pointsStride];
+        sendKeys[i] = keys[iPt];
+    } // for
+    std::vector<double> recvXYZ(numRecv*spaceDim);
+    std::vector<uint64_t> recvKeys(numRecv);
+    MPI_Alltoallv(sendXYZ.data(), sendCountsXYZ.data(), sendDisplsXYZ.data(), MPI_DOUBLE,
+                  recvXYZ.data(), recvCountsXYZ.data(), recvDisplsXYZ.data(), MPI_DOUBLE, query._comm);
+    MPI_Alltoallv(sendKeys.data(), sendCounts.data(), sendDispls.data(), MPI_UINT64_T,
+                  recvKeys.data(), recvCounts.data(), recvDispls.data(), MPI_UINT64_T, query._comm);
+
+    // Query points received from all processes in order of their keys, so consecutive points are close together.
+    std::vector<size_t> queryOrder(numRecv);
+    std::iota(queryOrder.begin(), queryOrder.end(), 0);
+    std::stable_sort(queryOrder.begin(), queryOrder.end(), [&recvKeys](const size_t a,
+                                                                       const size_t b) {
+        return recvKeys[a] < recvKeys[b];
+    });
+    std::vector<double> queryXYZ(numRecv*spaceDim);
+    for (size_t i = 0; i < numRecv; ++i) {
+        std::copy(&recvXYZ[queryOrder[i]*spaceDim], &recvXYZ[queryOrder[i]*spaceDim]+spaceDim, &queryXYZ[i*spaceDim]);
+    } // for
+    std::vector<double> queryValues(numRecv*numValues, geomodelgrids::NODATA_VALUE);
+    std::vector<int> queryStatus(numRecv, geomodelgrids::utils::ErrorHandler::ERROR);
+    bool isError = false;
+    if (numRecv) {
+        try {
+            const int err = query._query.queryPoints(queryValues.data(), numValues, &queryXYZ[0], &queryXYZ[1],
+                                                     &queryXYZ[2], spaceDim, numRecv, queryStatus.data());
+            isError = (geomodelgrids::utils::ErrorHandler::ERROR == err);
+        } catch (const std::exception& err) {
+            query._query.getErrorHandler()->setError(err.what());
+            isError = true;
+        } // try/catch
+    } // if
+
+    // Return values to processes that own the points.
+    std::vector<double> recvValues(numRecv*numValues);
+    std::vector<int> recvStatus(numRecv);
+    for (size_t i = 0; i < numRecv; ++i) {
+        std::copy(&queryValues[i*numValues], &queryValues[i*numValues]+numValues, &recvValues[queryOrder[i]*numValues]);
+        recvStatus[queryOrder[i]] = queryStatus[i];
+    } // for
+    std::vector<double> sendValues(numPoints*numValues);
+    std::vector<int> sendStatus(numPoints);
+    MPI_Alltoallv(recvValues.data(), recvCountsValues.data(), recvDisplsValues.data(), MPI_DOUBLE,
+                  sendValues.data(), sendCountsValues.data(), sendDisplsValues.data(), MPI_DOUBLE, query._comm);
+    MPI_Alltoallv(recvStatus.data(), recvCounts.data(), recvDispls.data(), MPI_INT,
+                  sendStatus.data(), sendCounts.data(), sendDispls.data(), MPI_INT, query._comm);
+    for (size_t i = 0; i < numPoints; ++i) {
+        const size_t iPt = sendOrder[i];
+        std::copy(&sendValues[i*numValues], &sendValues[i*numValues]+numValues, &values[iPt*valuesStride]);
+        status[iPt] = sendStatus[i];
+    } // for
+
+    return isError;
+} // queryOwners
+
+
+// ------------------------------------------------------------------------------------------------
+// Interleave bits of two 32-bit integers.
+uint64_t
+geomodelgrids::parallel::_Query::interleave(const uint32_t ix,
+                                            const uint32_t iy) {
+    uint64_t bits[2] = { ix, iy };
+    for (size_t i = 0; i < 2; ++i) {
+        uint64_t& b = bits[i];
+        b = (b | (b << 16)) & 0x0000FFFF0000FFFFULL;
+        b = (b | (b << 8)) & 0x00FF00FF00FF00FFULL;
+        b = (b | (b << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        b = (b | (b << 2)) & 0x3333333333333333ULL;
+        b = (b | (b << 1)) & 0x5555555555555555ULL;
+    } // for
+    return bits[0] | (bits[1] << 1);
+} // interleave
+
+
+// ------------------------------------------------------------------------------------------------
+// Check that counts of values fit in an MPI count.
+void
+geomodelgrids::parallel::_Query::checkCount(MPI_Comm comm,
+                                            const size_t count) {
+    const int isTooLargeLocal = (count > size_t(std::numeric_limits<int>::max())) ? 1 : 0;
+    int isTooLarge = 0;
+    MPI_Allreduce(&isTooLargeLocal, &isTooLarge, 1, MPI_INT, MPI_MAX, comm);
+    if (isTooLarge) {
+        throw std::length_error("Too many points on a process for MPI; query fewer points in each call.");
+    } // if
+} // checkCount
+
+
+// End of file
@@ -0,0 +1,184 @@
+/** Query for values of models at points distributed across MPI processes.
+ *
+ * The processes read the models collectively: one process reads each model file and broadcasts it to one process
+ * on each node, which stores it in memory shared by all processes on the node. The processes then query the
+ * models from memory, so the file system sees one reader regardless of the number of processes and each node
+ * holds one copy of each model.
+ *
+ * queryPoints() balances the load across processes by partitioning the points spatially: the points from all
+ * processes are ordered along a space-filling curve, split into pieces with about the same number of points,
+ * and each piece is queried by one process. The values are returned to the processes that own the points.
+ *
+ * With the DECOMPOSE_MODEL decomposition, the processes instead read the models directly from the files and
+ * queryPoints() sends each point to the process that owns the region of the model containing it. The horizontal
+ * domain of the first model is split into tiles aligned with the chunks of its blocks, and the tiles are divided
+ * among a grid of processes, so each process reads only its slab of the model. Memory and I/O then scale with the
+ * number of processes rather than with the size of the model; the load is balanced only if the points are
+ * spread evenly over the domain. Points outside the horizontal domain of the first model are balanced as with
+ * DECOMPOSE_POINTS.
+ *
+ * Each node holds the model files in shared memory only up to a budget (see setMaxSharedBytes()); models that do not
+ * fit are read directly from the files by each process.
+ *
+ * Settings (squashing, hyperslab dimensions, query resolution, statistics, etc.) are set on the serial query
+ * returned by getSerialQuery() before calling initialize(). The serial query can also be used to query points
+ * on a single process after calling initialize().
+ */
+#pragma once
+
+#include "parallelfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/Query.hh" // HASA Query
+#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA CRSTransformer
+
+#include <mpi.h> // USES MPI_Comm, MPI_Win
+#include <vector> // USES std::vector
+#include <string> // USES std::string
+#include <memory> // USES std::shared_ptr
+
+class geomodelgrids::parallel::Query {
+    friend class TestQuery; // unit testing
+    friend class _Query; // Helper class
+
+    // PUBLIC ENUMS ------------------------------------------------------------------------------
+public:
+
+    enum DecompositionEnum {
+        DECOMPOSE_POINTS=0, ///< Share models on each node and balance the number of points across processes.
+        DECOMPOSE_MODEL=1, ///< Divide the domain among processes and send points to the owners of their region.
+    }; // DecompositionEnum
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor
+     *
+     * @param[in] comm MPI communicator with processes querying the models.
+     */
+    Query(MPI_Comm comm=MPI_COMM_WORLD);
+
+    /// Destructor (calls finalize() if it has not been called and MPI has not been finalized).
+    ~Query(void);
+
+    /** Get MPI communicator with processes querying the models.
+     *
+     * @returns MPI communicator.
+     */
+    MPI_Comm getComm(void) const;
+
+    /** Get serial query used to query points on this process.
+     *
+     * @returns Serial query.
+     */
+    geomodelgrids::serial::Query& getSerialQuery(void);
+
+    /** Set how the models and points are divided among processes.
+     *
+     * Must be called before initialize().
+     *
+     * @param[in] value Type of decomposition (default is DECOMPOSE_POINTS).
+     */
+    void setDecomposition(const DecompositionEnum value);
+
+    /** Get how the models and points are divided among processes.
+     *
+     * @returns Type of decomposition.
+     */
+    DecompositionEnum getDecomposition(void) const;
+
+    /** Set maximum number of bytes of model files held in shared memory on each node (DECOMPOSE_POINTS).
+     *
+     * Models are shared in query order while they fit in the remaining budget; each process reads the other
+     * models directly from the files. The smallest budget over all processes is used. Must be called
+     * before initialize().
+     *
+     * @param[in] value Maximum number of bytes (default is half of the physical memory of the node).
+     */
+    void setMaxSharedBytes(const size_t value);
+
+    /** Get maximum number of bytes of model files held in shared memory on each node.
+     *
+     * @returns Maximum number of bytes.
+     */
+    size_t getMaxSharedBytes(void) const;
+
+    /** Do setup for querying (collective).
+     *
+     * With DECOMPOSE_POINTS, process 0 reads the model files that fit in the shared memory budget and broadcasts
+     * them to the other nodes. With
+     * DECOMPOSE_MODEL, process 0 reads the metadata of the first model and broadcasts the decomposition of its
+     * domain.
+     *
+     * @param[in] modelFilenames Array of model filenames (in query order).
+     * @param[in] valueNames Array of names of values to return in query.
+     * @param[in] inputCRSString Coordinate reference system (CRS) as string (PROJ, EPSG, WKT) for input points.
+     */
+    void initialize(const std::vector<std::string>& modelFilenames,
+                    const std::vector<std::string>& valueNames,
+                    const std::string& inputCRSString);
+
+    /** Query models for values at many points distributed across processes (collective).
+     *
+     * Each process passes its own points (any number, including zero). The points are redistributed so each
+     * process queries about the same number of points in a compact region, and the values are returned to the
+     * process that passed the points. Points outside all models have values of NODATA_VALUE and a status of
+     * WARNING.
+     *
+     * Values and status arrays must be preallocated.
+     *
+     * @param[out] values Values at points; values for point i start at values[i*valuesStride].
+     * @param[in] valuesStride Number of values between the starts of consecutive points (at least the number
+     * of query values).
+     * @param[in] x X coordinates of points (in input CRS); coordinate for point i is x[i*pointsStride].
+     * @param[in] y Y coordinates of points (in input CRS); coordinate for point i is y[i*pointsStride].
+     * @param[in] z Z coordinates of points (in input CRS); coordinate for point i is z[i*pointsStride].
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points on this process.
+     * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be nullptr).
+     * @param[out] numOutside Number of points on this process outside all models (can be nullptr).
+     * @returns 0 if all points on this process are found, 1 if any are outside all models, 2 on error on any
+     * process.
+     */
+    int queryPoints(double* const values,
+                    const size_t valuesStride,
+                    const double* const x,
+                    const double* const y,
+                    const double* const z,
+                    const size_t pointsStride,
+                    const size_t numPoints,
+                    int* const status=nullptr,
+                    size_t* const numOutside=nullptr);
+
+    /// Cleanup after querying and release shared memory with models (collective).
+    void finalize(void);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    MPI_Comm _comm; ///< Communicator with processes querying the models.
+    MPI_Comm _nodeComm; ///< Communicator with processes sharing memory on this node.
+    MPI_Comm _nodeLeadersComm; ///< Communicator with first process on each node (MPI_COMM_NULL on others).
+    std::vector<MPI_Win> _modelImages; ///< Shared memory windows holding model files.
+    std::vector<std::string> _modelFilenames; ///< Names of model files.
+    geomodelgrids::serial::Query _query; ///< Query for points on this process.
+    DecompositionEnum _decomposition; ///< Type of decomposition.
+    size_t _maxSharedBytes; ///< Maximum number of bytes of model files in shared memory on each node.
+
+    /// Transformation from input CRS to CRS of model defining domain decomposition (DECOMPOSE_MODEL).
+    std::shared_ptr<geomodelgrids::utils::CRSTransformer> _domainTransformer;
+    double _domainOrigin[2]; ///< Origin of model defining domain decomposition.
+    double _domainYAzimuth; ///< Azimuth of y axis of model defining domain decomposition.
+    double _domainDims[2]; ///< Horizontal dimensions of model defining domain decomposition.
+    double _tileDims[2]; ///< Horizontal dimensions of tiles in domain decomposition.
+    size_t _numTiles[2]; ///< Number of tiles along x and y axes.
+    int _procGrid[2]; ///< Number of processes along x and y axes.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    Query(const Query&); ///< Not implemented
+    const Query& operator=(const Query&); ///< Not implemented
+
+}; // Query
+
+// End of file
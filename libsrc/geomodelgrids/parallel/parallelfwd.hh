@@ -0,0 +1,9 @@
+#pragma once
+
+namespace geomodelgrids {
+    namespace parallel {
+        class Query;
+    } // parallel
+} // geomodelgrids
+
+// End of file
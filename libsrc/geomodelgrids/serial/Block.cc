@@ -16,6 +16,7 @@
 // Default constructor.
 geomodelgrids::serial::Block::Block(const char* name) :
     _name(name),
+    _level(0),
     _hyperslab(nullptr),
     _resolutionX(0.0),
     _resolutionY(0.0),
@@ -28,13 +29,16 @@ geomodelgrids::serial::Block::Block(const char* name) :
     _indexingY(nullptr),
     _indexingZ(nullptr),
     _values(nullptr),
-    _numValues(0) {
+    _numValues(0),
+    _hyperslabMaxBytes(geomodelgrids::serial::Hyperslab::DEFAULT_MAX_BYTES),
+    _hyperslabPrefetch(false),
+    _stats(nullptr) {
     _dims[0] = 0;
     _dims[1] = 0;
     _dims[2] = 0;
 
-    _hyperslabDims[0] = 64;
-    _hyperslabDims[1] = 64;
+    _hyperslabDims[0] = 0;
+    _hyperslabDims[1] = 0;
     _hyperslabDims[2] = 0;
     _hyperslabDims[3] = 0;
 
@@ -64,7 +68,7 @@ geomodelgrids::serial::Block::loadMetadata(geomodelgrids::serial::HDF5* const h5
     assert(h5);
     delete[] _values;_values = nullptr;
 
-    const std::string& blockPath = std::string("blocks/") + _name;
+    const std::string& blockPath = getPath();
 
     std::ostringstream msg;
     const char* indent = "            ";
@@ -127,13 +131,6 @@ geomodelgrids::serial::Block::loadMetadata(geomodelgrids::serial::HDF5* const h5
         _dims[i] = hdims[i];
     } // for
 
-    if (0 == _hyperslabDims[2]) {
-        _hyperslabDims[2] = hdims[2];
-    } // if
-    if (0 == _hyperslabDims[3]) {
-        _hyperslabDims[3] = hdims[3];
-    } // if
-
     _numValues = hdims[3];
     delete[] hdims;hdims = nullptr;
 
@@ -189,6 +186,35 @@ geomodelgrids::serial::Block::getName(void) const {
 } // getName
 
 
+// ------------------------------------------------------------------------------------------------
+// Set level of block in multi-resolution pyramid.
+void
+geomodelgrids::serial::Block::setLevel(const size_t value) {
+    _level = value;
+} // setLevel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get level of block in multi-resolution pyramid.
+size_t
+geomodelgrids::serial::Block::getLevel(void) const {
+    return _level;
+} // getLevel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get path of block dataset in model file.
+std::string
+geomodelgrids::serial::Block::getPath(void) const {
+    std::ostringstream path;
+    if (_level > 0) {
+        path << "pyramid/level_" << _level << "/";
+    } // if
+    path << "blocks/" << _name;
+    return path.str();
+} // getPath
+
+
 // ------------------------------------------------------------------------------------------------
 // Get resolution along x-axis.
 double
@@ -296,6 +322,30 @@ geomodelgrids::serial::Block::setHyperslabDims(const size_t dims[],
 } // setHyperslabDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for automatically sized hyperslab dimensions.
+void
+geomodelgrids::serial::Block::setHyperslabMaxBytes(const size_t value) {
+    _hyperslabMaxBytes = value;
+} // setHyperslabMaxBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::Block::setHyperslabPrefetch(const bool value) {
+    _hyperslabPrefetch = value;
+} // setHyperslabPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set statistics object for collecting query statistics.
+void
+geomodelgrids::serial::Block::setStats(geomodelgrids::serial::QueryStats* const stats) {
+    _stats = stats;
+} // setStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Prepare for querying.
 void
@@ -305,8 +355,11 @@ geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5) {
     for (size_t i = 0; i < ndims; ++i) {
         dims[i] = _hyperslabDims[i];
     } // for
-    const std::string blockPath(std::string("/blocks/") + _name);
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, blockPath.c_str(), dims, ndims);
+    const std::string blockPath(getPath());
+    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, blockPath.c_str(), dims, ndims,
+                                                                        _hyperslabMaxBytes);
+    _hyperslab->setPrefetch(_hyperslabPrefetch);
+    _hyperslab->setStats(_stats);
 
     delete[] _values;_values = (_numValues > 0) ? new double[_numValues] : nullptr;
 } // openQuery
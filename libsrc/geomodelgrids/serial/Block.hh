@@ -37,6 +37,27 @@ public:
      */
     const std::string& getName(void) const;
 
+    /** Set level of block in multi-resolution pyramid.
+     *
+     * Must be called before loadMetadata(). Level 0 is the full resolution block stored at 'blocks/NAME'. Level k
+     * is decimated by a factor of 2^k along the x and y axes and is stored at 'pyramid/level_k/blocks/NAME'.
+     *
+     * @param[in] value Level in pyramid.
+     */
+    void setLevel(const size_t value);
+
+    /** Get level of block in multi-resolution pyramid.
+     *
+     * @returns Level in pyramid.
+     */
+    size_t getLevel(void) const;
+
+    /** Get path of block dataset in model file.
+     *
+     * @returns Path of dataset.
+     */
+    std::string getPath(void) const;
+
     /** Get resolution along x axis.
      *
      * @returns Resolution along x axis.
@@ -98,6 +119,9 @@ public:
     size_t getNumValues(void) const;
 
     /** Set hyperslab size.
+     *
+     * Dimensions that are zero are sized automatically from the chunk layout of the dataset when
+     * openQuery() is called.
      *
      * @param[in] dims Dimensions of hyperslab.
      * @param[in] ndims Number of dimensions.
@@ -105,6 +129,26 @@ public:
     void setHyperslabDims(const size_t dims[],
                           const size_t ndims);
 
+    /** Set memory budget for automatically sized hyperslab dimensions.
+     *
+     * @param[in] value Maximum size (in bytes) of hyperslab.
+     */
+    void setHyperslabMaxBytes(const size_t value);
+
+    /** Turn prefetching of the next hyperslab on/off.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setHyperslabPrefetch(const bool value);
+
+    /** Set statistics object for collecting query statistics.
+     *
+     * Must be called before openQuery().
+     *
+     * @param[in] stats Statistics object (nullptr to turn off collecting statistics).
+     */
+    void setStats(geomodelgrids::serial::QueryStats* const stats);
+
     /** Prepare for querying.
      *
      * @param[in] h5 HDF5 with model.
@@ -141,6 +185,7 @@ public:
 private:
 
     std::string _name; ///< Name of block.
+    size_t _level; ///< Level in multi-resolution pyramid.
     geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model.
     double _resolutionX; ///< Resolution along x axis.
     double _resolutionY; ///< Resolution along y axis.
@@ -158,7 +203,10 @@ private:
     double* _values;
     size_t _numValues; ///< Number of values stored at each grid point.
     size_t _dims[3]; ///< Number of points along grid in each coordinate dimension [x, y, z].
-    size_t _hyperslabDims[4]; ///< Dimensions of hyperslab.
+    size_t _hyperslabDims[4]; ///< Dimensions of hyperslab (0 for automatic sizing).
+    size_t _hyperslabMaxBytes; ///< Memory budget for automatically sized hyperslab.
+    bool _hyperslabPrefetch; ///< True if prefetching next hyperslab.
+    geomodelgrids::serial::QueryStats* _stats; ///< Query statistics (nullptr if not collecting statistics).
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -2,10 +2,14 @@
 
 #include "HDF5.hh" // implementation of class methods
 
+#include "geomodelgrids/serial/SharedChunkCache.hh" // USES SharedChunkCache
+
+#include <sys/stat.h> // USES stat()
 #include <cstring> // USES strlen()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
+#include <mutex> // USES std::mutex, std::lock_guard
 
 #if H5_VERSION_GE(1,12,0)
 #define GEOMODELGRIDS_HDF5_USE_API_112
@@ -15,6 +19,10 @@
 #endif
 #endif
 
+#if H5_VERSION_GE(1,10,3)
+#define GEOMODELGRIDS_HDF5_HAVE_WRITE_CHUNK
+#endif
+
 const hid_t geomodelgrids::serial::HDF5::H5_NULL = -1;
 
 // ------------------------------------------------------------------------------------------------
@@ -30,6 +38,12 @@ struct geomodelgrids::serial::_HDF5Access {
     hid_t dataspace;
     hid_t attribute;
     hid_t datatype;
+    hid_t plist;
+
+    /// Serialize all calls into the HDF5 library, because it is not thread safe unless it is built with
+    /// --enable-threadsafe. Hyperslabs prefetch data on background threads while the foreground thread reads
+    /// metadata of other models and blocks, so every method that calls the library must hold this lock.
+    static std::mutex libraryMutex;
 
     _HDF5Access(void) :
         object(HDF5::H5_NULL),
@@ -37,7 +51,8 @@ struct geomodelgrids::serial::_HDF5Access {
         dataset(HDF5::H5_NULL),
         dataspace(HDF5::H5_NULL),
         attribute(HDF5::H5_NULL),
-        datatype(HDF5::H5_NULL) {}
+        datatype(HDF5::H5_NULL),
+        plist(HDF5::H5_NULL) {}
 
 
     ~_HDF5Access(void) {
@@ -47,9 +62,61 @@ struct geomodelgrids::serial::_HDF5Access {
         if (dataspace >= 0) { H5Sclose(dataspace); }
         if (attribute >= 0) { H5Aclose(attribute); }
         if (datatype >= 0) { H5Tclose(datatype); }
+        if (plist >= 0) { H5Pclose(plist); }
     } // destructor
 
 };
+std::mutex geomodelgrids::serial::_HDF5Access::libraryMutex;
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _HDF5Image;
+    } // serial
+} // geomodelgrids
+
+/** Callbacks for the HDF5 core driver that use the image of a file in place instead of copying it.
+ *
+ * The user data is the image, so every buffer "allocated" by the core driver is the image itself. This is only
+ * valid for files opened read only, because the core driver never writes to or resizes the buffer.
+ */
+class geomodelgrids::serial::_HDF5Image {
+public:
+
+    static
+    void* imageMalloc(size_t size,
+                      H5FD_file_image_op_t op,
+                      void* udata) {
+        return udata;
+    } // imageMalloc
+
+    static
+    void* imageMemcpy(void* dest,
+                      const void* src,
+                      size_t size,
+                      H5FD_file_image_op_t op,
+                      void* udata) {
+        return (dest == src) ? dest : nullptr;
+    } // imageMemcpy
+
+    static
+    herr_t imageFree(void* ptr,
+                     H5FD_file_image_op_t op,
+                     void* udata) {
+        return 0;
+    } // imageFree
+
+    static
+    void* udataCopy(void* udata) {
+        return udata;
+    } // udataCopy
+
+    static
+    herr_t udataFree(void* udata) {
+        return 0;
+    } // udataFree
+
+}; // _HDF5Image
 
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
@@ -57,7 +124,11 @@ geomodelgrids::serial::HDF5::HDF5(void) :
     _file(H5_NULL),
     _cacheSize(128*1048576),
     _cacheNumSlots(63997),
-    _cachePreemption(0.75) {}
+    _cachePreemption(0.75),
+    _sharedCache(nullptr),
+    _fileKey(0),
+    _image(nullptr),
+    _imageBytes(0) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -79,6 +150,40 @@ geomodelgrids::serial::HDF5::setCache(const size_t cacheSize,
 } // setDatasetCache
 
 
+// ------------------------------------------------------------------------------------------------
+// Set shared chunk cache used by hyperslabs reading from this file.
+void
+geomodelgrids::serial::HDF5::setSharedCache(geomodelgrids::serial::SharedChunkCache* const cache) {
+    _sharedCache = cache;
+} // setSharedCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Get shared chunk cache used by hyperslabs reading from this file.
+geomodelgrids::serial::SharedChunkCache*
+geomodelgrids::serial::HDF5::getSharedCache(void) const {
+    return _sharedCache;
+} // getSharedCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Get key identifying the file in the shared chunk cache.
+uint64_t
+geomodelgrids::serial::HDF5::getFileKey(void) const {
+    return _fileKey;
+} // getFileKey
+
+
+// ------------------------------------------------------------------------------------------------
+// Read file from an image of it in memory instead of from the file system.
+void
+geomodelgrids::serial::HDF5::setFileImage(const void* const image,
+                                          const size_t numBytes) {
+    _image = image;
+    _imageBytes = (image) ? numBytes : 0;
+} // setFileImage
+
+
 // ------------------------------------------------------------------------------------------------
 // Open HDF5 file.
 void
@@ -90,10 +195,37 @@ geomodelgrids::serial::HDF5::open(const char* filename,
         throw std::runtime_error("HDF5 file already open.");
     } // if
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
     if (fileAccess < 0) { throw std::runtime_error("Could not create property for HDF5 cache parameters."); }
     herr_t err = H5Pset_cache(fileAccess, 0, _cacheNumSlots, _cacheSize, _cachePreemption);
     if (err < 0) { throw std::runtime_error("Could not set HDF5 file cache properties."); }
+    if (_image) {
+        if (hid_t(H5F_ACC_RDONLY) != mode) {
+            H5Pclose(fileAccess);
+            throw std::logic_error("HDF5 file read from image in memory must be opened read only.");
+        } // if
+        H5FD_file_image_callbacks_t callbacks = {
+            _HDF5Image::imageMalloc,
+            _HDF5Image::imageMemcpy,
+            nullptr,
+            _HDF5Image::imageFree,
+            _HDF5Image::udataCopy,
+            _HDF5Image::udataFree,
+            const_cast<void*>(_image),
+        };
+        if ((H5Pset_fapl_core(fileAccess, 1048576, false) < 0) ||
+            (H5Pset_file_image_callbacks(fileAccess, &callbacks) < 0) ||
+            (H5Pset_file_image(fileAccess, const_cast<void*>(_image), _imageBytes) < 0)) {
+            H5Pclose(fileAccess);
+            throw std::runtime_error("Could not set HDF5 file image properties.");
+        } // if
+    } // if
+
+    // The core driver refuses to open an image under the name of a file that exists, so label it by its address.
+    std::ostringstream imageName;
+    imageName << "geomodelgrids-image-" << _image;
+    const std::string& h5Name = (_image) ? imageName.str() : std::string(filename);
 
     if (hid_t(H5F_ACC_TRUNC) == mode) {
         _file = H5Fcreate(filename, mode, H5P_DEFAULT, fileAccess);
@@ -104,7 +236,7 @@ geomodelgrids::serial::HDF5::open(const char* filename,
         } // if
 
     } else {
-        _file = H5Fopen(filename, mode, fileAccess);
+        _file = H5Fopen(h5Name.c_str(), mode, fileAccess);
         if (_file < 0) {
             std::ostringstream msg;
             msg << "Could not open existing HDF5 file '" << filename << "'.";
@@ -113,6 +245,21 @@ geomodelgrids::serial::HDF5::open(const char* filename,
     } // if/else
 
     H5Pclose(fileAccess);
+
+    // Processes may open the same file using different paths, so identify it by device and inode.
+    struct stat fileStatus;
+    if (_sharedCache && (0 == stat(filename, &fileStatus))) {
+        const uint64_t fileId[4] = {
+            uint64_t(fileStatus.st_dev),
+            uint64_t(fileStatus.st_ino),
+            uint64_t(fileStatus.st_size),
+            uint64_t(fileStatus.st_mtime),
+        };
+        _fileKey = SharedChunkCache::hash(fileId, sizeof(fileId));
+    } else {
+        _sharedCache = nullptr;
+        _fileKey = 0;
+    } // if/else
 } // constructor
 
 
@@ -121,6 +268,7 @@ geomodelgrids::serial::HDF5::open(const char* filename,
 void
 geomodelgrids::serial::HDF5::close(void) {
     if (_file >= 0) {
+        std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
         herr_t err = H5Fclose(_file);
         if (err < 0) {
             throw std::runtime_error("Could not close HDF5 file.");
@@ -145,6 +293,7 @@ geomodelgrids::serial::HDF5::hasGroup(const char* name) {
     assert(isOpen());
     assert(name);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -172,6 +321,7 @@ geomodelgrids::serial::HDF5::hasDataset(const char* name) {
     assert(isOpen());
     assert(name);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -203,6 +353,7 @@ geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
     assert(path);
     assert(isOpen());
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -227,6 +378,54 @@ geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
 } // getDatasetDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Get chunk dimensions of dataset.
+void
+geomodelgrids::serial::HDF5::getDatasetChunk(hsize_t** dims,
+                                             int* ndims,
+                                             const char* path) {
+    assert(dims);
+    assert(ndims);
+    assert(path);
+    assert(isOpen());
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        // Open the dataset
+        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        h5access.plist = H5Dget_create_plist(h5access.dataset);
+        if (h5access.plist < 0) { throw std::runtime_error("Could not get dataset creation properties."); }
+
+        delete[] *dims;*dims = nullptr;
+        *ndims = 0;
+        if (H5D_CHUNKED == H5Pget_layout(h5access.plist)) {
+            h5access.dataspace = H5Dget_space(h5access.dataset);
+            if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
+
+            const int ndimsAll = H5Sget_simple_extent_ndims(h5access.dataspace);
+            if (ndimsAll > 0) {
+                *dims = new hsize_t[ndimsAll];
+                *ndims = H5Pget_chunk(h5access.plist, ndimsAll, *dims);
+                if (*ndims != ndimsAll) { throw std::runtime_error("Could not get chunk dimensions."); }
+            } // if
+        } // if
+
+    } catch (const std::exception& err) {
+        delete[] *dims;*dims = nullptr;
+        *ndims = 0;
+        std::ostringstream msg;
+        msg << "Error occurred while reading chunk layout of dataset '"
+            << path << "':\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // getDatasetChunk
+
+
 // ------------------------------------------------------------------------------------------------
 // Get names of datasets in group.
 void
@@ -235,6 +434,7 @@ geomodelgrids::serial::HDF5::getGroupDatasets(std::vector<std::string>* names,
     assert(names);
     assert(isOpen());
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -277,6 +477,7 @@ geomodelgrids::serial::HDF5::hasAttribute(const char* path,
     assert(path);
     assert(name);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     htri_t exists = H5Aexists_by_name(_file, path, name, H5P_DEFAULT);
     return exists > 0;
 } // hasAttribute
@@ -293,6 +494,7 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(name);
     assert(value);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -323,6 +525,7 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(values);
     assert(valuesSize);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -361,6 +564,7 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(path);
     assert(name);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     std::string value;
 
     try {
@@ -415,6 +619,7 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(name);
     assert(values);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -429,7 +634,11 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
         const hsize_t ndims = H5Sget_simple_extent_ndims(h5access.dataspace);assert(1 == ndims);
         hsize_t dims[1];
         H5Sget_simple_extent_dims(h5access.dataspace, dims, nullptr);
-        const hsize_t numStrings = dims[0];assert(numStrings > 0);
+        const hsize_t numStrings = dims[0];
+        if (0 == numStrings) {
+            values->clear();
+            return;
+        } // if
 
         char** buffer = new char*[numStrings];
         if (0 == H5Tis_variable_str(h5access.datatype)) { // Fixed length strings
@@ -492,6 +701,7 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
     assert(dims);
     assert(_file > 0);
 
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
     try {
         _HDF5Access h5access;
 
@@ -555,4 +765,339 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
 } // readDatasetHyperslab
 
 
+// ------------------------------------------------------------------------------------------------
+// Create group if it does not exist.
+void
+geomodelgrids::serial::HDF5::createGroup(const char* name) {
+    assert(isOpen());
+    assert(name);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    if (H5Lexists(_file, name, H5P_DEFAULT) > 0) {
+        return;
+    } // if
+
+    _HDF5Access h5access;
+    h5access.group = H5Gcreate2(_file, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (h5access.group < 0) {
+        std::ostringstream msg;
+        msg << "Could not create group '" << name << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // createGroup
+
+
+// ------------------------------------------------------------------------------------------------
+// Write scalar attribute.
+void
+geomodelgrids::serial::HDF5::writeAttribute(const char* path,
+                                            const char* name,
+                                            hid_t datatype,
+                                            const void* value) {
+    assert(path);
+    assert(name);
+    assert(value);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        if (H5Aexists_by_name(_file, path, name, H5P_DEFAULT) > 0) {
+            if (H5Adelete_by_name(_file, path, name, H5P_DEFAULT) < 0) { throw std::runtime_error("Could not replace"); }
+        } // if
+
+        h5access.dataspace = H5Screate(H5S_SCALAR);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not create dataspace for"); }
+
+        h5access.attribute = H5Acreate_by_name(_file, path, name, datatype, h5access.dataspace,
+                                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (h5access.attribute < 0) { throw std::runtime_error("Could not create"); }
+
+        herr_t err = H5Awrite(h5access.attribute, datatype, value);
+        if (err < 0) { throw std::runtime_error("Could not write"); }
+
+    } catch (std::exception& err) {
+        std::ostringstream msg;
+        msg << err.what() << " attribute '" << name << "' of '" << path << "'.";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeAttribute
+
+
+// ------------------------------------------------------------------------------------------------
+// Write array attribute.
+void
+geomodelgrids::serial::HDF5::writeAttribute(const char* path,
+                                            const char* name,
+                                            hid_t datatype,
+                                            const void* values,
+                                            const size_t valuesSize) {
+    assert(path);
+    assert(name);
+    assert(values);
+    assert(valuesSize > 0);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        if (H5Aexists_by_name(_file, path, name, H5P_DEFAULT) > 0) {
+            if (H5Adelete_by_name(_file, path, name, H5P_DEFAULT) < 0) { throw std::runtime_error("Could not replace"); }
+        } // if
+
+        const hsize_t dims[1] = { valuesSize };
+        h5access.dataspace = H5Screate_simple(1, dims, nullptr);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not create dataspace for"); }
+
+        h5access.attribute = H5Acreate_by_name(_file, path, name, datatype, h5access.dataspace,
+                                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (h5access.attribute < 0) { throw std::runtime_error("Could not create"); }
+
+        herr_t err = H5Awrite(h5access.attribute, datatype, values);
+        if (err < 0) { throw std::runtime_error("Could not write"); }
+
+    } catch (std::exception& err) {
+        std::ostringstream msg;
+        msg << err.what() << " attribute '" << name << "' of '" << path << "'.";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeAttribute
+
+
+// ------------------------------------------------------------------------------------------------
+// Write string attribute.
+void
+geomodelgrids::serial::HDF5::writeAttribute(const char* path,
+                                            const char* name,
+                                            const char* value) {
+    assert(path);
+    assert(name);
+    assert(value);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        if (H5Aexists_by_name(_file, path, name, H5P_DEFAULT) > 0) {
+            if (H5Adelete_by_name(_file, path, name, H5P_DEFAULT) < 0) { throw std::runtime_error("Could not replace"); }
+        } // if
+
+        h5access.datatype = H5Tcopy(H5T_C_S1);
+        if (h5access.datatype < 0) { throw std::runtime_error("Could not create datatype for"); }
+        if (H5Tset_size(h5access.datatype, H5T_VARIABLE) < 0) { throw std::runtime_error("Could not set datatype size for"); }
+
+        h5access.dataspace = H5Screate(H5S_SCALAR);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not create dataspace for"); }
+
+        h5access.attribute = H5Acreate_by_name(_file, path, name, h5access.datatype, h5access.dataspace,
+                                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (h5access.attribute < 0) { throw std::runtime_error("Could not create"); }
+
+        herr_t err = H5Awrite(h5access.attribute, h5access.datatype, &value);
+        if (err < 0) { throw std::runtime_error("Could not write"); }
+
+    } catch (std::exception& err) {
+        std::ostringstream msg;
+        msg << err.what() << " attribute '" << name << "' of '" << path << "'.";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeAttribute
+
+
+// ------------------------------------------------------------------------------------------------
+// Write strings attribute.
+void
+geomodelgrids::serial::HDF5::writeAttribute(const char* path,
+                                            const char* name,
+                                            const std::vector<std::string>& values) {
+    assert(path);
+    assert(name);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        if (H5Aexists_by_name(_file, path, name, H5P_DEFAULT) > 0) {
+            if (H5Adelete_by_name(_file, path, name, H5P_DEFAULT) < 0) { throw std::runtime_error("Could not replace"); }
+        } // if
+
+        h5access.datatype = H5Tcopy(H5T_C_S1);
+        if (h5access.datatype < 0) { throw std::runtime_error("Could not create datatype for"); }
+        if (H5Tset_size(h5access.datatype, H5T_VARIABLE) < 0) { throw std::runtime_error("Could not set datatype size for"); }
+
+        const hsize_t dims[1] = { values.size() };
+        h5access.dataspace = H5Screate_simple(1, dims, nullptr);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not create dataspace for"); }
+
+        h5access.attribute = H5Acreate_by_name(_file, path, name, h5access.datatype, h5access.dataspace,
+                                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (h5access.attribute < 0) { throw std::runtime_error("Could not create"); }
+
+        if (values.size() > 0) {
+            std::vector<const char*> buffer(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                buffer[i] = values[i].c_str();
+            } // for
+            herr_t err = H5Awrite(h5access.attribute, h5access.datatype, &buffer[0]);
+            if (err < 0) { throw std::runtime_error("Could not write"); }
+        } // if
+
+    } catch (std::exception& err) {
+        std::ostringstream msg;
+        msg << err.what() << " attribute '" << name << "' of '" << path << "'.";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeAttribute
+
+
+// ------------------------------------------------------------------------------------------------
+// Create chunked dataset.
+void
+geomodelgrids::serial::HDF5::createDataset(const char* path,
+                                           const hsize_t* const dims,
+                                           const hsize_t* const chunk,
+                                           const int ndims,
+                                           hid_t datatype,
+                                           const int compression) {
+    assert(isOpen());
+    assert(path);
+    assert(dims);
+    assert(chunk);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        if (H5Lexists(_file, path, H5P_DEFAULT) > 0) {
+            if (H5Ldelete(_file, path, H5P_DEFAULT) < 0) { throw std::runtime_error("Could not replace dataset."); }
+        } // if
+
+        h5access.dataspace = H5Screate_simple(ndims, dims, nullptr);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not create dataspace."); }
+
+        h5access.plist = H5Pcreate(H5P_DATASET_CREATE);
+        if (h5access.plist < 0) { throw std::runtime_error("Could not create dataset properties."); }
+        if (H5Pset_chunk(h5access.plist, ndims, chunk) < 0) { throw std::runtime_error("Could not set chunk size."); }
+        if (compression > 0) {
+            if (H5Pset_deflate(h5access.plist, compression) < 0) { throw std::runtime_error("Could not set compression."); }
+        } // if
+
+        h5access.dataset = H5Dcreate2(_file, path, datatype, h5access.dataspace, H5P_DEFAULT, h5access.plist, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not create dataset."); }
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while creating dataset '" << path << "':\n" << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // createDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Write dataset slice.
+void
+geomodelgrids::serial::HDF5::writeDatasetHyperslab(const void* values,
+                                                   const char* path,
+                                                   const hsize_t* const origin,
+                                                   const hsize_t* const dims,
+                                                   const int ndims,
+                                                   hid_t datatype) {
+    assert(values);
+    assert(path);
+    assert(origin);
+    assert(dims);
+    assert(_file > 0);
+
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        h5access.dataspace = H5Dget_space(h5access.dataset);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
+
+        const int ndimsAll = H5Sget_simple_extent_ndims(h5access.dataspace);
+        std::vector<hsize_t> dimsAll(ndimsAll);
+        H5Sget_simple_extent_dims(h5access.dataspace, &dimsAll[0], nullptr);
+
+        // Validate arguments.
+        if (ndims != ndimsAll) {
+            std::ostringstream msg;
+            msg << "Rank of hyperslab origin and dimension (" << ndims
+                << ") does not match rank of dataset (" << ndimsAll << ").";
+            throw std::length_error(msg.str());
+        } // if
+        for (int i = 0; i < ndimsAll; ++i) {
+            if (origin[i] + dims[i] > dimsAll[i]) {
+                std::ostringstream msg;
+                msg << "Hyperslab extent in dimension " << i
+                    << " (origin:" << origin[i] << ", dim: " << dims[i] << ") "
+                    << "exceeds dataset dimension " << dimsAll[i] << ".";
+                throw std::length_error(msg.str());
+            } // if
+        } // for
+
+        hid_t memspace = H5Screate_simple(ndims, dims, dims);
+        if (memspace < 0) { throw std::runtime_error("Could not create memory space."); }
+
+        herr_t err = H5Sselect_hyperslab(h5access.dataspace, H5S_SELECT_SET, origin, nullptr, dims, nullptr);
+        if (err < 0) { H5Sclose(memspace);throw std::runtime_error("Could not select hyperslab."); }
+        err = H5Dwrite(h5access.dataset, datatype, memspace, h5access.dataspace, H5P_DEFAULT, values);
+        H5Sclose(memspace);memspace = H5_NULL;
+        if (err < 0) { throw std::runtime_error("Could not write hyperslab."); }
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while writing dataset '" << path << "':\n" << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeDatasetHyperslab
+
+
+// ------------------------------------------------------------------------------------------------
+// Check whether raw chunks can be written.
+bool
+geomodelgrids::serial::HDF5::canWriteChunks(void) {
+#if defined(GEOMODELGRIDS_HDF5_HAVE_WRITE_CHUNK)
+    return true;
+#else
+    return false;
+#endif
+} // canWriteChunks
+
+
+// ------------------------------------------------------------------------------------------------
+// Write raw (filtered) chunk.
+void
+geomodelgrids::serial::HDF5::writeDatasetChunk(const char* path,
+                                               const hsize_t* const offset,
+                                               const void* buffer,
+                                               const size_t bufferSize) {
+    assert(path);
+    assert(offset);
+    assert(buffer);
+    assert(_file > 0);
+
+#if defined(GEOMODELGRIDS_HDF5_HAVE_WRITE_CHUNK)
+    std::lock_guard<std::mutex> lock(_HDF5Access::libraryMutex);
+    try {
+        _HDF5Access h5access;
+
+        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        const uint32_t filterMask = 0; // All filters were applied.
+        herr_t err = H5Dwrite_chunk(h5access.dataset, H5P_DEFAULT, filterMask, offset, bufferSize, buffer);
+        if (err < 0) { throw std::runtime_error("Could not write chunk."); }
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while writing dataset '" << path << "':\n" << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+#else
+    throw std::logic_error("HDF5 library does not support writing raw chunks (requires v1.10.3 or later).");
+#endif
+} // writeDatasetChunk
+
+
 // End of file
@@ -7,6 +7,7 @@
 #include <hdf5.h> // USES hid_t
 #include <vector> // USES std::std::vector
 #include <string> // USGS std::string
+#include <cstdint> // USES uint64_t
 
 class geomodelgrids::serial::HDF5 {
     friend class TestHDF5; // Unit testing
@@ -48,6 +49,38 @@ public:
                   const size_t nslots,
                   const double preemption=0.75);
 
+    /** Set shared chunk cache used by hyperslabs reading from this file.
+     *
+     * Must be called BEFORE open(). The HDF5 object does not take ownership of the cache.
+     *
+     * @param[in] cache Shared chunk cache (nullptr for none).
+     */
+    void setSharedCache(geomodelgrids::serial::SharedChunkCache* const cache);
+
+    /** Get shared chunk cache used by hyperslabs reading from this file.
+     *
+     * @returns Shared chunk cache (nullptr for none).
+     */
+    geomodelgrids::serial::SharedChunkCache* getSharedCache(void) const;
+
+    /** Get key identifying the file (device, inode, size, and modification time) in the shared chunk cache.
+     *
+     * @returns Key of file (0 if there is no shared chunk cache).
+     */
+    uint64_t getFileKey(void) const;
+
+    /** Read file from an image of it in memory instead of from the file system.
+     *
+     * Must be called BEFORE open(), and the file must be opened read only. The image is not copied, so several
+     * HDF5 objects (for example, in processes sharing memory) can use the same image; it must remain valid until
+     * the file is closed.
+     *
+     * @param[in] image Contents of file (nullptr to read from the file system).
+     * @param[in] numBytes Size of image in bytes.
+     */
+    void setFileImage(const void* const image,
+                      const size_t numBytes);
+
     /** Open HDF5.
      *
      * @param[in] filename Name of HDF5 file
@@ -89,6 +122,16 @@ public:
                         int* ndims,
                         const char* path);
 
+    /** Get chunk dimensions of dataset.
+     *
+     * @param[out] dims Array of chunk dimensions (nullptr if dataset is not chunked).
+     * @param[out] ndims Number of dimensions (0 if dataset is not chunked).
+     * @param[in] path Full path to dataset.
+     */
+    void getDatasetChunk(hsize_t** dims,
+                         int* ndims,
+                         const char* path);
+
     /** Get names of datasets in group.
      *
      * @param[out[names Names of datasets.
@@ -166,6 +209,108 @@ public:
                               int ndims,
                               hid_t datatype);
 
+    /** Create group if it does not exist.
+     *
+     * @param[in] name Full name of group.
+     */
+    void createGroup(const char* name);
+
+    /** Write scalar attribute, replacing any existing attribute with the same name.
+     *
+     * @param[in] path Full path to object with attribute.
+     * @param[in] name Name of attribute.
+     * @param[in] datatype Datatype of scalar.
+     * @param[in] value Attribute value.
+     */
+    void writeAttribute(const char* path,
+                        const char* name,
+                        hid_t datatype,
+                        const void* value);
+
+    /** Write array attribute, replacing any existing attribute with the same name.
+     *
+     * @param[in] path Full path to object with attribute.
+     * @param[in] name Name of attribute.
+     * @param[in] datatype Datatype of array.
+     * @param[in] values Attribute values.
+     * @param[in] valuesSize Number of values.
+     */
+    void writeAttribute(const char* path,
+                        const char* name,
+                        hid_t datatype,
+                        const void* values,
+                        const size_t valuesSize);
+
+    /** Write string attribute, replacing any existing attribute with the same name.
+     *
+     * @param[in] path Full path to object with attribute.
+     * @param[in] name Name of attribute.
+     * @param[in] value String value.
+     */
+    void writeAttribute(const char* path,
+                        const char* name,
+                        const char* value);
+
+    /** Write strings attribute, replacing any existing attribute with the same name.
+     *
+     * @param[in] path Full path to object with attribute.
+     * @param[in] name Name of attribute.
+     * @param[in] values Array of strings.
+     */
+    void writeAttribute(const char* path,
+                        const char* name,
+                        const std::vector<std::string>& values);
+
+    /** Create chunked dataset, replacing any existing dataset with the same name.
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] dims Dimensions of dataset.
+     * @param[in] chunk Dimensions of chunks.
+     * @param[in] ndims Number of dimensions.
+     * @param[in] datatype Type of data in file.
+     * @param[in] compression Deflate (gzip) compression level (0 for no compression).
+     */
+    void createDataset(const char* path,
+                       const hsize_t* const dims,
+                       const hsize_t* const chunk,
+                       int ndims,
+                       hid_t datatype,
+                       int compression);
+
+    /** Write hyperslab (subset of values) to dataset.
+     *
+     * @param[in] values Values of hyperslab.
+     * @param[in] path Full path to dataset.
+     * @param[in] origin Origin of hyperslab in dataset.
+     * @param[in] dims Dimensions of hyperslab.
+     * @param[in] ndims Number of dimensions of hyperslab.
+     * @param[in] datatype Type of data in memory.
+     */
+    void writeDatasetHyperslab(const void* values,
+                               const char* path,
+                               const hsize_t* const origin,
+                               const hsize_t* const dims,
+                               int ndims,
+                               hid_t datatype);
+
+    /** Check whether raw chunks can be written with writeDatasetChunk().
+     *
+     * @returns True if the HDF5 library supports writing raw chunks, false otherwise.
+     */
+    static bool canWriteChunks(void);
+
+    /** Write raw chunk that has already been passed through the dataset filters (compressed).
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] offset Logical position of the first value in the chunk.
+     * @param[in] buffer Filtered chunk.
+     * @param[in] bufferSize Size of filtered chunk in bytes.
+     */
+    void writeDatasetChunk(const char* path,
+                           const hsize_t* const offset,
+                           const void* buffer,
+                           const size_t bufferSize);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -173,6 +318,10 @@ private:
     size_t _cacheSize; ///< Dataset cache size (in bytes).
     size_t _cacheNumSlots; ///< Number of chunk slots in dataset cache.
     double _cachePreemption; ///< Preemption policy value for cache.
+    geomodelgrids::serial::SharedChunkCache* _sharedCache; ///< Shared chunk cache (nullptr for none).
+    uint64_t _fileKey; ///< Key of file in shared chunk cache.
+    const void* _image; ///< Image of file in memory (nullptr if reading from file system).
+    size_t _imageBytes; ///< Size of image of file in bytes.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -3,6 +3,8 @@
 #include "Hyperslab.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
+#include "geomodelgrids/serial/SharedChunkCache.hh" // USES SharedChunkCache
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include <stdexcept> // USES std::runtime_error
@@ -10,6 +12,11 @@
 #include <cassert> // USES assert()
 #include <cmath> // USES floor()
 #include <algorithm> // USES std::min(), std::max()
+#include <vector> // USES std::vector
+#include <future> // USES std::async(), std::future
+#include <cstring> // USES strlen()
+
+const size_t geomodelgrids::serial::Hyperslab::DEFAULT_MAX_BYTES = 32*1048576;
 
 #if !defined(CALL_MEMBER_FN)
 #define CALL_MEMBER_FN(object,ptrToMember)  ((object).*(ptrToMember))
@@ -28,9 +35,16 @@ public:
     /// Destructor.
     ~_Hyperslab(void);
 
+    /** Turn prefetching of the next hyperslab on/off.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setPrefetch(const bool value);
+
     /** Get values for hyperslab containing target point.
      *
-     * Use current hyperslab if possible.
+     * Use current hyperslab if possible, then the prefetched hyperslab, and read from the file only if the
+     * target point is in neither.
      *
      * @param[in] indexFloat Floating point index of target point.
      */
@@ -52,11 +66,54 @@ public:
     void nearest(double* const values,
                  const double indexFloat[]);
 
+    /** Advance multi-dimensional index with the last dimension varying fastest.
+     *
+     * @param[inout] index Index.
+     * @param[in] begin First index in each dimension.
+     * @param[in] end One past the last index in each dimension.
+     * @param[in] ndims Number of dimensions to advance.
+     * @returns True if index was advanced, false if all indices have been visited.
+     */
+    static
+    bool increment(std::vector<hsize_t>* index,
+                   const std::vector<hsize_t>& begin,
+                   const std::vector<hsize_t>& end,
+                   const size_t ndims);
+
 private:
 
     typedef void (_Hyperslab::*interpolate_fn_type)(double* const values,
                                                     const double indexFloat[]);
 
+    /** Compute origin of hyperslab containing target point.
+     *
+     * @param[out] origin Origin of hyperslab.
+     * @param[in] indexFloat Floating point index of target point.
+     */
+    void _computeOrigin(hsize_t* const origin,
+                        const double indexFloat[]) const;
+
+    /** Start reading the hyperslab the traversal will enter next on a background thread.
+     *
+     * The next hyperslab is predicted by extrapolating from the previous target point through the current target
+     * point to the boundary of the current hyperslab.
+     *
+     * @param[in] indexFloat Floating point index of target point.
+     */
+    void _startPrefetch(const double indexFloat[]);
+
+    /** Get size of hyperslab in bytes.
+     *
+     * @returns Size of hyperslab in bytes.
+     */
+    size_t _slabBytes(void) const;
+
+    /** Wait for prefetch in progress to finish.
+     *
+     * @returns True if prefetch completed successfully, false otherwise.
+     */
+    bool _finishPrefetch(void);
+
     /** Compute values at point using bilinear interpolation in 2-D.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -93,6 +150,13 @@ private:
     interpolate_fn_type _interpolate; ///< Function for interpolation.
     interpolate_fn_type _nearest; ///< Function for nearest.
 
+    bool _prefetch; ///< True if prefetching next hyperslab.
+    bool _hasIndexPrev; ///< True if previous target point is set.
+    std::vector<double> _indexPrev; ///< Previous target point (used to get traversal direction).
+    std::vector<hsize_t> _originPrefetch; ///< Origin of prefetched hyperslab.
+    double* _valuesPrefetch; ///< Buffer for prefetched hyperslab values.
+    std::future<void> _prefetchResult; ///< Result of prefetch in progress.
+
 }; // _Hyperslab
 
 // ------------------------------------------------------------------------------------------------
@@ -100,14 +164,19 @@ private:
 geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h5,
                                             const char* path,
                                             const hsize_t dims[],
-                                            const size_t ndims) :
+                                            const size_t ndims,
+                                            const size_t maxBytes) :
     _h5(h5),
     _datasetPath(path),
     _ndims(ndims),
     _origin(nullptr),
     _dims(_ndims > 0 ? new hsize_t[_ndims] : nullptr),
     _dimsAll(nullptr),
+    _chunkDims(nullptr),
     _values(nullptr),
+    _sharedCache(nullptr),
+    _datasetKey(0),
+    _stats(nullptr),
     _hyperslab(nullptr) {
     assert(_h5);
     int ndimsAll = 0;
@@ -123,13 +192,23 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
         throw std::length_error(msg.str());
     } // if
 
+    int ndimsChunk = 0;
+    h5->getDatasetChunk(&_chunkDims, &ndimsChunk, path);
+    assert(!ndimsChunk || _ndims == size_t(ndimsChunk));
+
+    _setDims(dims, maxBytes);
     hsize_t totalSize = 1;
     for (size_t i = 0; i < ndims; ++i) {
-        _dims[i] = std::min(dims[i], _dimsAll[i]);
         totalSize *= _dims[i];
     } // for
     _values = (totalSize > 0) ? new double[totalSize] : nullptr;
 
+    // Use shared chunk cache only if hyperslabs are assembled from whole chunks with all values at a point.
+    if (h5->getSharedCache() && _chunkDims && (_dims[_ndims-1] == _dimsAll[_ndims-1])) {
+        _sharedCache = h5->getSharedCache();
+        _datasetKey = SharedChunkCache::hash(path, strlen(path), h5->getFileKey());
+    } // if
+
     delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
 } // constructor
 
@@ -137,15 +216,34 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
 // ------------------------------------------------------------------------------------------------
 // Destructor
 geomodelgrids::serial::Hyperslab::~Hyperslab(void) {
+    // Delete helper first to wait for any prefetch in progress.
+    delete _hyperslab;_hyperslab = nullptr;
+
     delete[] _origin;_origin = nullptr;
     delete[] _dims;_dims = nullptr;
     delete[] _dimsAll;_dimsAll = nullptr;
+    delete[] _chunkDims;_chunkDims = nullptr;
     delete[] _values;_values = nullptr;
-
-    delete _hyperslab;_hyperslab = nullptr;
 } // destructor
 
 
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::Hyperslab::setPrefetch(const bool value) {
+    assert(_hyperslab);
+    _hyperslab->setPrefetch(value);
+} // setPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set statistics object for collecting query statistics.
+void
+geomodelgrids::serial::Hyperslab::setStats(geomodelgrids::serial::QueryStats* const stats) {
+    _stats = stats;
+} // setStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Compute values at point using bilinear interpolation.
 void
@@ -153,7 +251,13 @@ geomodelgrids::serial::Hyperslab::interpolate(double* const values,
                                               const double indexFloat[]) {
     assert(_hyperslab);
     _hyperslab->getSlab(indexFloat);
-    _hyperslab->interpolate(values, indexFloat);
+    if (_stats) {
+        const double tStart = QueryStats::now();
+        _hyperslab->interpolate(values, indexFloat);
+        _stats->timeInterpolate += QueryStats::now() - tStart;
+    } else {
+        _hyperslab->interpolate(values, indexFloat);
+    } // if/else
 } // interpolate
 
 
@@ -164,14 +268,134 @@ geomodelgrids::serial::Hyperslab::nearest(double* const values,
                                           const double indexFloat[]) {
     assert(_hyperslab);
     _hyperslab->getSlab(indexFloat);
-    _hyperslab->nearest(values, indexFloat);
+    if (_stats) {
+        const double tStart = QueryStats::now();
+        _hyperslab->nearest(values, indexFloat);
+        _stats->timeInterpolate += QueryStats::now() - tStart;
+    } else {
+        _hyperslab->nearest(values, indexFloat);
+    } // if/else
 } // nearest
 
 
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslab.
+void
+geomodelgrids::serial::Hyperslab::_setDims(const hsize_t dims[],
+                                           const size_t maxBytes) {
+    assert(_ndims > 0);
+    assert(_dims);
+    assert(_dimsAll);
+
+    const hsize_t defaultIncrement = 16;
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    std::vector<hsize_t> increment(_ndims, 0);
+    for (size_t i = 0; i < _ndims; ++i) {
+        if (dims[i] > 0) {
+            _dims[i] = std::min(dims[i], _dimsAll[i]);
+        } else if (i == spaceDim) {
+            _dims[i] = _dimsAll[i];
+        } else {
+            increment[i] = (_chunkDims && (_chunkDims[i] > 0)) ? _chunkDims[i] : defaultIncrement;
+            _dims[i] = std::min(increment[i], _dimsAll[i]);
+        } // if/else
+    } // for
+
+    hsize_t numBytes = sizeof(double);
+    for (size_t i = 0; i < _ndims; ++i) {
+        numBytes *= _dims[i];
+    } // for
+
+    // Grow automatically sized dimensions one increment at a time (fastest varying dimension first) until the
+    // hyperslab reaches the memory budget or covers the dataset.
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (size_t i = spaceDim; i-- > 0;) {
+            if (!increment[i] || (_dims[i] >= _dimsAll[i])) {
+                continue;
+            } // if
+            const hsize_t dimNew = std::min(_dims[i] + increment[i], _dimsAll[i]);
+            const hsize_t numBytesNew = (numBytes / _dims[i]) * dimNew;
+            if (numBytesNew <= maxBytes) {
+                _dims[i] = dimNew;
+                numBytes = numBytesNew;
+                grew = true;
+            } // if
+        } // for
+    } // while
+} // _setDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values of hyperslab from the shared chunk cache or the file.
+void
+geomodelgrids::serial::Hyperslab::_readValues(double* const values,
+                                              const hsize_t* const origin) const {
+    if (!_sharedCache) {
+        _h5->readDatasetHyperslab(values, _datasetPath.c_str(), origin, _dims, _ndims, H5T_NATIVE_DOUBLE);
+        return;
+    } // if
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    const hsize_t numValues = _dims[spaceDim];
+    std::vector<hsize_t> chunkBegin(spaceDim);
+    std::vector<hsize_t> chunkEnd(spaceDim);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        chunkBegin[i] = origin[i] / _chunkDims[i];
+        chunkEnd[i] = (origin[i] + _dims[i] - 1) / _chunkDims[i] + 1;
+    } // for
+
+    std::vector<hsize_t> chunkIndex(chunkBegin);
+    std::vector<hsize_t> chunkOrigin(_ndims, 0);
+    std::vector<hsize_t> chunkDims(_ndims, numValues);
+    std::vector<hsize_t> lower(spaceDim);
+    std::vector<hsize_t> upper(spaceDim);
+    std::vector<hsize_t> row(spaceDim);
+    std::vector<double> buffer;
+    do {
+        // Get chunk (clipped to the dataset) from the cache or the file.
+        size_t chunkSize = numValues;
+        for (size_t i = 0; i < spaceDim; ++i) {
+            chunkOrigin[i] = chunkIndex[i] * _chunkDims[i];
+            chunkDims[i] = std::min(_chunkDims[i], _dimsAll[i] - chunkOrigin[i]);
+            chunkSize *= chunkDims[i];
+        } // for
+        const uint64_t key = SharedChunkCache::hash(&chunkIndex[0], spaceDim*sizeof(hsize_t), _datasetKey);
+        buffer.resize(chunkSize);
+        if (!_sharedCache->get(buffer.data(), key, chunkSize*sizeof(double))) {
+            _h5->readDatasetHyperslab(buffer.data(), _datasetPath.c_str(), &chunkOrigin[0], &chunkDims[0], _ndims,
+                                      H5T_NATIVE_DOUBLE);
+            _sharedCache->put(key, buffer.data(), chunkSize*sizeof(double));
+        } // if
+
+        // Copy rows (along the last spatial dimension) of the chunk that overlap the hyperslab.
+        for (size_t i = 0; i < spaceDim; ++i) {
+            lower[i] = std::max(origin[i], chunkOrigin[i]);
+            upper[i] = std::min(origin[i] + _dims[i], chunkOrigin[i] + chunkDims[i]);
+        } // for
+        const size_t rowSize = (upper[spaceDim-1] - lower[spaceDim-1]) * numValues;
+        row = lower;
+        do {
+            size_t iSlab = 0;
+            size_t iChunk = 0;
+            for (size_t i = 0; i < spaceDim; ++i) {
+                iSlab = iSlab*_dims[i] + (row[i] - origin[i]);
+                iChunk = iChunk*chunkDims[i] + (row[i] - chunkOrigin[i]);
+            } // for
+            std::copy(&buffer[iChunk*numValues], &buffer[iChunk*numValues] + rowSize, &values[iSlab*numValues]);
+        } while (_Hyperslab::increment(&row, lower, upper, spaceDim-1));
+    } while (_Hyperslab::increment(&chunkIndex, chunkBegin, chunkEnd, spaceDim));
+} // _readValues
+
+
 // ------------------------------------------------------------------------------------------------
 // Constructor.
 geomodelgrids::serial::_Hyperslab::_Hyperslab(geomodelgrids::serial::Hyperslab& hyperslab) :
-    _hyperslab(hyperslab) {
+    _hyperslab(hyperslab),
+    _prefetch(false),
+    _hasIndexPrev(false),
+    _valuesPrefetch(nullptr) {
     if (3 == hyperslab._ndims-1) {
         _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate3D;
         _nearest = &geomodelgrids::serial::_Hyperslab::_nearest3D;
@@ -187,7 +411,23 @@ geomodelgrids::serial::_Hyperslab::_Hyperslab(geomodelgrids::serial::Hyperslab&
 
 
 // ------------------------------------------------------------------------------------------------
-geomodelgrids::serial::_Hyperslab::~_Hyperslab(void) {}
+geomodelgrids::serial::_Hyperslab::~_Hyperslab(void) {
+    _finishPrefetch();
+    delete[] _valuesPrefetch;_valuesPrefetch = nullptr;
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::_Hyperslab::setPrefetch(const bool value) {
+    _finishPrefetch();
+    _prefetch = value;
+    _hasIndexPrev = false;
+    if (!_prefetch) {
+        delete[] _valuesPrefetch;_valuesPrefetch = nullptr;
+    } // if
+} // setPrefetch
 
 
 // ------------------------------------------------------------------------------------------------
@@ -197,14 +437,17 @@ geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
     const size_t ndims = _hyperslab._ndims;
     hsize_t* origin = _hyperslab._origin;
     const hsize_t* dims = _hyperslab._dims;
-    const hsize_t* dimsAll = _hyperslab._dimsAll;
 
     bool needsNewSlab = false;
     const size_t spaceDim = ndims - 1; // last dimension is values
     if (origin) {
+        const hsize_t* dimsAll = _hyperslab._dimsAll;
         for (size_t i = 0; i < spaceDim; ++i) {
+            // A point on the last index of the hyperslab is only inside it at the end of the dataset.
+            const double indexLast = double(origin[i]+dims[i]-1);
             if (( indexFloat[i] - double(origin[i]) < 0.0) ||
-                ( indexFloat[i] >= double(origin[i]+dims[i]-1)) ) {
+                ( indexFloat[i] > indexLast) ||
+                (( indexFloat[i] == indexLast) && (origin[i]+dims[i] < dimsAll[i])) ) {
                 needsNewSlab = true;
                 break;
             } // if
@@ -215,20 +458,197 @@ geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
         needsNewSlab = true;
     } // if/else
 
+    QueryStats* stats = _hyperslab._stats;
     if (needsNewSlab) {
-        // Get hyperslab with target point in the center.
-        for (size_t i = 0; i < spaceDim; ++i) {
-            hsize_t index = (indexFloat[i] >= dims[i]-1) ? hsize_t(std::floor(indexFloat[i] - (dims[i]-1)/ 2)) : 0;
-            index = std::min(index, dimsAll[i]-dims[i]);
-            origin[i] = index;
-        } // for
+        const double tStart = (stats) ? QueryStats::now() : 0.0;
+
+        std::vector<hsize_t> originNew(ndims, 0);
+        _computeOrigin(&originNew[0], indexFloat);
+
+        bool havePrefetch = false;
+        if (_prefetchResult.valid()) {
+            const bool isMatch = std::equal(originNew.begin(), originNew.end(), _originPrefetch.begin());
+            havePrefetch = _finishPrefetch() && isMatch;
+        } // if
+
+        std::copy(originNew.begin(), originNew.end(), origin);
+        if (havePrefetch) {
+            std::swap(_hyperslab._values, _valuesPrefetch);
+        } else {
+            _hyperslab._readValues(_hyperslab._values, origin);
+        } // if/else
+
+        if (stats) {
+            stats->timeIO += QueryStats::now() - tStart;
+            // Bytes of a prefetched hyperslab count only when it is used, so discarded prefetches are not counted.
+            if (havePrefetch) {
+                stats->numHyperslabPrefetchHits++;
+            } else {
+                stats->numHyperslabMisses++;
+            } // if/else
+            stats->numBytesRead += _slabBytes();
+        } // if
+
+        if (_prefetch) {
+            _startPrefetch(indexFloat);
+        } // if
+    } else if (stats) {
+        stats->numHyperslabHits++;
+    } // if/else
 
-        _hyperslab._h5->readDatasetHyperslab(_hyperslab._values, _hyperslab._datasetPath.c_str(), origin, dims, ndims,
-                                             H5T_NATIVE_DOUBLE);
+    if (_prefetch) {
+        _indexPrev.assign(indexFloat, indexFloat+spaceDim);
+        _hasIndexPrev = true;
     } // if
 } // getSlab
 
 
+// ------------------------------------------------------------------------------------------------
+// Advance multi-dimensional index with the last dimension varying fastest.
+bool
+geomodelgrids::serial::_Hyperslab::increment(std::vector<hsize_t>* index,
+                                             const std::vector<hsize_t>& begin,
+                                             const std::vector<hsize_t>& end,
+                                             const size_t ndims) {
+    assert(index);
+    for (size_t i = ndims; i-- > 0;) {
+        if (++(*index)[i] < end[i]) {
+            return true;
+        } // if
+        (*index)[i] = begin[i];
+    } // for
+    return false;
+} // increment
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute origin of hyperslab containing target point.
+void
+geomodelgrids::serial::_Hyperslab::_computeOrigin(hsize_t* const origin,
+                                                  const double indexFloat[]) const {
+    assert(origin);
+    assert(indexFloat);
+
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dimsAll = _hyperslab._dimsAll;
+    const hsize_t* chunkDims = _hyperslab._chunkDims;
+
+    // Get hyperslab with target point in the center, shifting the origin to the nearest chunk boundary if the
+    // hyperslab still contains the target point.
+    for (size_t i = 0; i < spaceDim; ++i) {
+        hsize_t index = (indexFloat[i] >= dims[i]-1) ? hsize_t(std::floor(indexFloat[i] - (dims[i]-1)/ 2)) : 0;
+        index = std::min(index, dimsAll[i]-dims[i]);
+        if (chunkDims && (chunkDims[i] > 1)) {
+            const hsize_t chunk = chunkDims[i];
+            const hsize_t indexAligned = std::min(((index + chunk/2) / chunk) * chunk, dimsAll[i]-dims[i]);
+            if (( indexFloat[i] >= double(indexAligned)) &&
+                ( indexFloat[i] < double(indexAligned+dims[i]-1)) ) {
+                index = indexAligned;
+            } // if
+        } // if
+        origin[i] = index;
+    } // for
+    origin[spaceDim] = 0;
+} // _computeOrigin
+
+
+// ------------------------------------------------------------------------------------------------
+// Start reading the hyperslab the traversal will enter next on a background thread.
+void
+geomodelgrids::serial::_Hyperslab::_startPrefetch(const double indexFloat[]) {
+    assert(!_prefetchResult.valid());
+    if (!_hasIndexPrev) {
+        return;
+    } // if
+
+    const size_t ndims = _hyperslab._ndims;
+    const size_t spaceDim = ndims - 1; // last dimension is values
+    const hsize_t* origin = _hyperslab._origin;
+    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dimsAll = _hyperslab._dimsAll;
+
+    // Find the first boundary of the current hyperslab crossed when moving along the traversal direction.
+    double tExit = -1.0;
+    size_t iExit = spaceDim;
+    std::vector<double> velocity(spaceDim);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        velocity[i] = indexFloat[i] - _indexPrev[i];
+        double t = -1.0;
+        if ((velocity[i] > 0.0) && (origin[i]+dims[i] < dimsAll[i])) {
+            t = (double(origin[i]+dims[i]-1) - indexFloat[i]) / velocity[i];
+        } else if ((velocity[i] < 0.0) && (origin[i] > 0)) {
+            t = (double(origin[i]) - indexFloat[i]) / velocity[i];
+        } // if/else
+        if ((t >= 0.0) && ((tExit < 0.0) || (t < tExit))) {
+            tExit = t;
+            iExit = i;
+        } // if
+    } // for
+    if (iExit == spaceDim) {
+        return;
+    } // if
+
+    std::vector<double> indexNext(spaceDim);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        indexNext[i] = std::max(0.0, std::min(double(dimsAll[i]-1), indexFloat[i] + velocity[i]*tExit));
+    } // for
+    indexNext[iExit] = (velocity[iExit] > 0.0) ? double(origin[iExit]+dims[iExit]-1) : double(origin[iExit]) - 0.5;
+
+    _originPrefetch.resize(ndims);
+    _computeOrigin(&_originPrefetch[0], &indexNext[0]);
+    if (std::equal(_originPrefetch.begin(), _originPrefetch.end(), origin)) {
+        return;
+    } // if
+
+    if (!_valuesPrefetch) {
+        hsize_t totalSize = 1;
+        for (size_t i = 0; i < ndims; ++i) {
+            totalSize *= dims[i];
+        } // for
+        _valuesPrefetch = new double[totalSize];
+    } // if
+
+    const Hyperslab* hyperslab = &_hyperslab;
+    double* values = _valuesPrefetch;
+    const hsize_t* originPrefetch = &_originPrefetch[0];
+    _prefetchResult = std::async(std::launch::async, [hyperslab, values, originPrefetch](void) {
+        hyperslab->_readValues(values, originPrefetch);
+    });
+} // _startPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of hyperslab in bytes.
+size_t
+geomodelgrids::serial::_Hyperslab::_slabBytes(void) const {
+    size_t numBytes = sizeof(double);
+    for (size_t i = 0; i < _hyperslab._ndims; ++i) {
+        numBytes *= _hyperslab._dims[i];
+    } // for
+    return numBytes;
+} // _slabBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Wait for prefetch in progress to finish.
+bool
+geomodelgrids::serial::_Hyperslab::_finishPrefetch(void) {
+    if (!_prefetchResult.valid()) {
+        return false;
+    } // if
+
+    try {
+        _prefetchResult.get();
+    } catch (const std::exception&) {
+        // Errors are reported when the hyperslab is read in the foreground.
+        return false;
+    } // try/catch
+
+    return true;
+} // _finishPrefetch
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::serial::_Hyperslab::interpolate(double* const values,
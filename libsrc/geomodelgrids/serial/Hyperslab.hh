@@ -1,12 +1,24 @@
 /** Hyperslab for a chunk of data in an HDF5 file.
  *
  * The hyperslab always contains all of the values at a point and that dimension is not given in the constructor.
+ *
+ * Hyperslab dimensions that are zero are sized automatically from the chunk layout of the dataset, growing the
+ * hyperslab in multiples of the chunk dimensions up to a memory budget. The origin of the hyperslab is aligned with
+ * chunk boundaries whenever possible, so refilling the hyperslab decompresses as few chunks as possible.
+ *
+ * Optionally, the hyperslab prefetches the next window along the current traversal direction on a background
+ * thread into a second buffer. When the target point leaves the current window and lands in the prefetched one,
+ * the buffers are swapped instead of reading from the file. Prefetching doubles the memory used by the hyperslab.
+ *
+ * If the HDF5 file has a shared chunk cache (see SharedChunkCache), hyperslabs of chunked datasets are assembled
+ * from chunks in the cache, and chunks that are not in the cache are read from the file and added to it.
  */
 #pragma once
 
 #include "serialfwd.hh" // forward declarations
 
 #include <cstdlib> // USES size_t
+#include <cstdint> // USES uint64_t
 #include <hdf5.h> // USES hsize_t
 #include <string> // USES std::string
 
@@ -20,6 +32,12 @@ namespace geomodelgrids {
 class geomodelgrids::serial::Hyperslab {
     friend class _Hyperslab; // Helper class for getting slab.
     friend class TestHyperslab; // Unit testing
+    friend class TestSharedChunkCache; // Unit testing
+
+    // PUBLIC CONSTANTS ---------------------------------------------------------------------------
+public:
+
+    static const size_t DEFAULT_MAX_BYTES; ///< Default memory budget for automatically sized hyperslabs.
 
     // PUBLIC METHODS -----------------------------------------------------------------------------
 public:
@@ -28,17 +46,31 @@ public:
      *
      * @param[in] h5 HDF5 with model.
      * @param[in] path Full path to dataset.
-     * @param[in] dims Array of hyperslab dimensions.
+     * @param[in] dims Array of hyperslab dimensions (0 for automatic sizing).
      * @param[in] ndims Number of dimensions in hyperslab.
+     * @param[in] maxBytes Memory budget (in bytes) for automatically sized dimensions.
      */
     Hyperslab(geomodelgrids::serial::HDF5* const h5,
               const char* path,
               const hsize_t dims[],
-              const size_t ndims);
+              const size_t ndims,
+              const size_t maxBytes=DEFAULT_MAX_BYTES);
 
     /// Destructor
     ~Hyperslab(void);
 
+    /** Turn prefetching of the next hyperslab on/off.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setPrefetch(const bool value);
+
+    /** Set statistics object for collecting query statistics.
+     *
+     * @param[in] stats Statistics object (nullptr to turn off collecting statistics).
+     */
+    void setStats(geomodelgrids::serial::QueryStats* const stats);
+
     /** Compute values at point using bilinear interpolation.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -55,6 +87,30 @@ public:
     void nearest(double* const values,
                  const double indexFloat[]);
 
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Set dimensions of hyperslab.
+     *
+     * Dimensions that are zero are sized in multiples of the chunk dimensions (or a default increment if the
+     * dataset is not chunked) until reaching the memory budget.
+     *
+     * @param[in] dims Array of requested hyperslab dimensions (0 for automatic sizing).
+     * @param[in] maxBytes Memory budget (in bytes) for automatically sized dimensions.
+     */
+    void _setDims(const hsize_t dims[],
+                  const size_t maxBytes);
+
+    /** Read values of hyperslab from the shared chunk cache or the file.
+     *
+     * Safe to call on a background thread while the foreground uses other hyperslab buffers.
+     *
+     * @param[out] values Values of hyperslab.
+     * @param[in] origin Origin of hyperslab.
+     */
+    void _readValues(double* const values,
+                     const hsize_t* const origin) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -65,7 +121,11 @@ private:
     hsize_t* _origin; ///< Origin of hyperslab relative to dataset.
     hsize_t* _dims; ///< Dimensions of hyperslab.
     hsize_t* _dimsAll; ///< Dimensions of entire dataset.
+    hsize_t* _chunkDims; ///< Chunk dimensions of dataset (nullptr if dataset is not chunked).
     double* _values; ///< Hyperslab values.
+    geomodelgrids::serial::SharedChunkCache* _sharedCache; ///< Shared chunk cache (nullptr if not used).
+    uint64_t _datasetKey; ///< Key of dataset in shared chunk cache.
+    geomodelgrids::serial::QueryStats* _stats; ///< Query statistics (nullptr if not collecting statistics).
 
     geomodelgrids::serial::_Hyperslab* _hyperslab; ///< Helper object.
 
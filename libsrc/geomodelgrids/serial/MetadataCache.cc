@@ -0,0 +1,285 @@
+#include <portinfo>
+
+#include "MetadataCache.hh" // implementation of class methods
+
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <algorithm> // USES std::find()
+#include <sstream> // USES std::ostringstream
+#include <iomanip> // USES std::setw(), std::setfill()
+#include <cstdio> // USES std::rename(), std::remove(), snprintf()
+#include <cstdlib> // USES strtod()
+#include <cstdint> // USES uint64_t
+#include <sys/stat.h> // USES stat()
+#include <unistd.h> // USES getpid()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _MetadataCache;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_MetadataCache {
+public:
+
+    static const char* HEADER; ///< First line of cache file.
+    static const size_t CHECKSUM_BYTES; ///< Number of bytes at beginning of model file included in checksum.
+
+    /** Update 64-bit FNV-1a hash with bytes.
+     *
+     * @param[inout] hash Hash value.
+     * @param[in] bytes Bytes to add to hash.
+     * @param[in] numBytes Number of bytes.
+     */
+    static
+    void hash(uint64_t* hash,
+              const void* bytes,
+              const size_t numBytes) {
+        const unsigned char* b = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < numBytes; ++i) {
+            *hash ^= b[i];
+            *hash *= 1099511628211ULL;
+        } // for
+    } // hash
+
+    /** Write length-prefixed string.
+     *
+     * @param[inout] sout Output stream.
+     * @param[in] value String to write.
+     */
+    static
+    void writeString(std::ostream& sout,
+                     const std::string& value) {
+        sout << value.size() << ":" << value << "\n";
+    } // writeString
+
+    /** Read length-prefixed string.
+     *
+     * @param[inout] sin Input stream.
+     * @param[out] value String read.
+     * @returns True if successful, false otherwise.
+     */
+    static
+    bool readString(std::istream& sin,
+                    std::string* value) {
+        size_t length = 0;
+        char separator = '\0';
+        if (!(sin >> length) || !sin.get(separator) || (separator != ':')) {
+            return false;
+        } // if
+        value->resize(length);
+        if (length && !sin.read(&(*value)[0], length)) {
+            return false;
+        } // if
+        return bool(sin.get(separator)) && (separator == '\n');
+    } // readString
+
+    /** Write number so it can be read back exactly (including infinite values).
+     *
+     * @param[inout] sout Output stream.
+     * @param[in] value Number to write.
+     */
+    static
+    void writeNumber(std::ostream& sout,
+                     const double value) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+        sout << buffer << "\n";
+    } // writeNumber
+
+    /** Read number.
+     *
+     * @param[inout] sin Input stream.
+     * @param[out] value Number read.
+     * @returns True if successful, false otherwise.
+     */
+    static
+    bool readNumber(std::istream& sin,
+                    double* value) {
+        std::string token;
+        if (!(sin >> token)) {
+            return false;
+        } // if
+        char* end = nullptr;
+        *value = strtod(token.c_str(), &end);
+        return *end == '\0';
+    } // readNumber
+
+}; // _MetadataCache
+
+const char* geomodelgrids::serial::_MetadataCache::HEADER = "geomodelgrids-metadata-cache 2";
+const size_t geomodelgrids::serial::_MetadataCache::CHECKSUM_BYTES = 65536;
+const size_t geomodelgrids::serial::MetadataCache::MAX_ENTRIES = 1024;
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::MetadataCache::MetadataCache(void) :
+    _isModified(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::MetadataCache::~MetadataCache(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Load cache from file.
+void
+geomodelgrids::serial::MetadataCache::load(const char* filename) {
+    _filename = filename;
+    _entries.clear();
+    _recent.clear();
+    _savedRecent.clear();
+    _isModified = false;
+
+    std::ifstream sin(filename);
+    std::string header;
+    if (!sin.is_open() || !std::getline(sin, header) || (header != _MetadataCache::HEADER)) {
+        return;
+    } // if
+
+    size_t numEntries = 0;
+    if (!(sin >> numEntries)) {
+        return;
+    } // if
+    std::map<std::string, Entry> entries;
+    std::vector<std::string> recent;
+    for (size_t iEntry = 0; iEntry < numEntries; ++iEntry) {
+        std::string key;
+        Entry entry;
+        size_t numValues = 0;
+        bool isValid = _MetadataCache::readString(sin, &key) && _MetadataCache::readString(sin, &entry.title) &&
+                       bool(sin >> numValues);
+        entry.valueNames.resize(numValues);
+        entry.valueUnits.resize(numValues);
+        for (size_t iValue = 0; isValid && (iValue < numValues); ++iValue) {
+            isValid = _MetadataCache::readString(sin, &entry.valueNames[iValue]) &&
+                      _MetadataCache::readString(sin, &entry.valueUnits[iValue]);
+        } // for
+        for (size_t i = 0; isValid && (i < 4); ++i) {
+            isValid = _MetadataCache::readNumber(sin, &entry.bbox[i]);
+        } // for
+        if (!isValid) {
+            return;
+        } // if
+        if (!entries.count(key)) {
+            recent.push_back(key);
+        } // if
+        entries[key] = entry;
+    } // for
+    _entries.swap(entries);
+    _recent.swap(recent);
+    _savedRecent = _recent;
+} // load
+
+
+// ------------------------------------------------------------------------------------------------
+// Write cache to file if it has changed.
+void
+geomodelgrids::serial::MetadataCache::save(void) {
+    if ((!_isModified && (_recent == _savedRecent)) || _filename.empty()) {
+        return;
+    } // if
+
+    // Drop the least recently used entries.
+    while (_recent.size() > MAX_ENTRIES) {
+        _entries.erase(_recent.back());
+        _recent.pop_back();
+    } // while
+
+    // Write to a temporary file and rename it, so concurrent jobs never read a partially written cache.
+    std::ostringstream tmpFilename;
+    tmpFilename << _filename << ".tmp" << getpid();
+    std::ofstream sout(tmpFilename.str().c_str());
+    if (!sout.is_open()) {
+        return;
+    } // if
+    sout << _MetadataCache::HEADER << "\n" << _recent.size() << "\n";
+    for (auto& key : _recent) {
+        const Entry& entry = _entries[key];
+        _MetadataCache::writeString(sout, key);
+        _MetadataCache::writeString(sout, entry.title);
+        sout << entry.valueNames.size() << "\n";
+        for (size_t iValue = 0; iValue < entry.valueNames.size(); ++iValue) {
+            _MetadataCache::writeString(sout, entry.valueNames[iValue]);
+            _MetadataCache::writeString(sout, entry.valueUnits[iValue]);
+        } // for
+        for (size_t i = 0; i < 4; ++i) {
+            _MetadataCache::writeNumber(sout, entry.bbox[i]);
+        } // for
+    } // for
+    sout.close();
+
+    if (sout.fail() || (0 != std::rename(tmpFilename.str().c_str(), _filename.c_str()))) {
+        std::remove(tmpFilename.str().c_str());
+        return;
+    } // if
+    _isModified = false;
+    _savedRecent = _recent;
+} // save
+
+
+// ------------------------------------------------------------------------------------------------
+// Find entry.
+const geomodelgrids::serial::MetadataCache::Entry*
+geomodelgrids::serial::MetadataCache::find(const std::string& key) const {
+    std::map<std::string, Entry>::const_iterator iter = _entries.find(key);
+    return (iter != _entries.end()) ? &iter->second : nullptr;
+} // find
+
+
+// ------------------------------------------------------------------------------------------------
+// Mark entry as used.
+void
+geomodelgrids::serial::MetadataCache::touch(const std::string& key) {
+    if (!_entries.count(key)) {
+        return;
+    } // if
+    std::vector<std::string>::iterator iter = std::find(_recent.begin(), _recent.end(), key);
+    if (iter != _recent.end()) {
+        _recent.erase(iter);
+    } // if
+    _recent.insert(_recent.begin(), key);
+} // touch
+
+
+// ------------------------------------------------------------------------------------------------
+// Add entry.
+void
+geomodelgrids::serial::MetadataCache::insert(const std::string& key,
+                                             const Entry& entry) {
+    _entries[key] = entry;
+    touch(key);
+    _isModified = true;
+} // insert
+
+
+// ------------------------------------------------------------------------------------------------
+// Create key for model file and input CRS.
+std::string
+geomodelgrids::serial::MetadataCache::createKey(const char* modelFilename,
+                                                const std::string& inputCRS) {
+    struct stat fileStatus;
+    std::ifstream sin(modelFilename, std::ios::binary);
+    if ((0 != stat(modelFilename, &fileStatus)) || !sin.is_open()) {
+        return std::string();
+    } // if
+
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t fileSize = fileStatus.st_size;
+    const int64_t fileTime = fileStatus.st_mtime;
+    _MetadataCache::hash(&hash, &fileSize, sizeof(fileSize));
+    _MetadataCache::hash(&hash, &fileTime, sizeof(fileTime));
+
+    std::vector<char> buffer(_MetadataCache::CHECKSUM_BYTES);
+    sin.read(buffer.data(), buffer.size());
+    _MetadataCache::hash(&hash, buffer.data(), size_t(sin.gcount()));
+    _MetadataCache::hash(&hash, inputCRS.data(), inputCRS.size());
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+} // createKey
+
+
+// End of file
@@ -0,0 +1,109 @@
+/** Persistent cache of the model metadata needed to dispatch queries.
+ *
+ * Query needs the names and units of the values and the bounding box of the domain (in the input CRS) of every
+ * model before it can decide which models to open for querying. Computing the bounding box requires creating a CRS
+ * transformation, which dominates the startup time of short jobs. The cache stores this metadata in a file so later
+ * jobs can skip computing it for models they do not use.
+ *
+ * Entries are keyed by a fingerprint of the model file (size, modification time, and a checksum of the beginning
+ * of the file) and the input CRS. The cache is advisory: a missing or malformed cache file is treated as empty,
+ * and failures writing the cache file are ignored. Entries are kept in order of most recent use, and only the
+ * MAX_ENTRIES most recently used entries are written, so entries for old versions of model files do not
+ * accumulate.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+#include <map> // HASA std::map
+
+class geomodelgrids::serial::MetadataCache {
+    friend class TestMetadataCache; // Unit testing
+
+    // PUBLIC STRUCTS -----------------------------------------------------------------------------
+public:
+
+    /// Metadata for one model and input CRS.
+    struct Entry {
+        std::string title; ///< Title of model.
+        std::vector<std::string> valueNames; ///< Names of values in model.
+        std::vector<std::string> valueUnits; ///< Units of values in model.
+        double bbox[4]; ///< Bounding box of model domain in input CRS [xmin, xmax, ymin, ymax].
+    }; // Entry
+
+    // PUBLIC MEMBERS -----------------------------------------------------------------------------
+public:
+
+    static const size_t MAX_ENTRIES; ///< Maximum number of entries written to the cache file.
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    MetadataCache(void);
+
+    /// Destructor
+    ~MetadataCache(void);
+
+    /** Load cache from file.
+     *
+     * @param[in] filename Name of cache file.
+     */
+    void load(const char* filename);
+
+    /// Write cache to file if it has changed since it was loaded.
+    void save(void);
+
+    /** Find entry.
+     *
+     * @param[in] key Key of entry.
+     * @returns Entry (nullptr if cache does not contain entry).
+     */
+    const Entry* find(const std::string& key) const;
+
+    /** Mark entry as used, so it is kept when the cache is written.
+     *
+     * save() writes the cache if the order of the entries differs from the order in the file.
+     *
+     * @param[in] key Key of entry.
+     */
+    void touch(const std::string& key);
+
+    /** Add entry, replacing any existing entry with the same key, and mark it as used.
+     *
+     * @param[in] key Key of entry.
+     * @param[in] entry Metadata for model.
+     */
+    void insert(const std::string& key,
+                const Entry& entry);
+
+    /** Create key for model file and input CRS.
+     *
+     * @param[in] modelFilename Name of model file.
+     * @param[in] inputCRS CRS of input points as string (PROJ, EPSG, WKT).
+     * @returns Key of entry.
+     */
+    static
+    std::string createKey(const char* modelFilename,
+                          const std::string& inputCRS);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::string _filename; ///< Name of cache file.
+    std::map<std::string, Entry> _entries; ///< Entries in cache.
+    std::vector<std::string> _recent; ///< Keys of entries, most recently used first.
+    std::vector<std::string> _savedRecent; ///< Keys of entries in the order of the cache file.
+    bool _isModified; ///< True if entries have been added since loading the cache.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    MetadataCache(const MetadataCache&); ///< Not implemented
+    const MetadataCache& operator=(const MetadataCache&); ///< Not implemented
+
+}; // MetadataCache
+
+// End of file
@@ -6,6 +6,8 @@
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab::DEFAULT_MAX_BYTES
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
 #include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
 
@@ -15,7 +17,132 @@
 #include <sstream> // USES std::ostringstream
 #include <algorithm> // USES std::fill()
 #include <cassert> // USES assert()
-#include <cmath> // USES M_PI, cos(), sin()
+#include <cmath> // USES M_PI, cos(), sin(), std::isfinite(), HUGE_VAL
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _Model;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_Model {
+public:
+
+    /** Get maximum spacing of points along axis.
+     *
+     * @param[in] resolution Uniform resolution (0 if variable resolution).
+     * @param[in] coordinates Coordinates of points (nullptr if uniform resolution).
+     * @param[in] numPoints Number of points along axis.
+     * @returns Maximum spacing (m) of points.
+     */
+    static
+    double maxSpacing(const double resolution,
+                      const double* coordinates,
+                      const size_t numPoints) {
+        if (!coordinates) {
+            return resolution;
+        } // if
+        double spacing = 0.0;
+        for (size_t i = 1; i < numPoints; ++i) {
+            spacing = std::max(spacing, fabs(coordinates[i] - coordinates[i-1]));
+        } // for
+        return spacing;
+    } // maxSpacing
+
+    /** Get horizontal resolution of block or surface.
+     *
+     * @param[in] item Block or surface.
+     * @returns Maximum spacing (m) of points along x and y axes.
+     */
+    template<typename T>
+    static
+    double horizontalResolution(const T& item) {
+        const size_t* dims = item.getDims();
+        return std::max(maxSpacing(item.getResolutionX(), item.getCoordinatesX(), dims[0]),
+                        maxSpacing(item.getResolutionY(), item.getCoordinatesY(), dims[1]));
+    } // horizontalResolution
+
+    /** Check whether model file contains pyramid level of dataset.
+     *
+     * Intermediate groups are checked first, because not all HDF5 versions handle missing groups in paths.
+     *
+     * @param[in] h5 Model file.
+     * @param[in] level Level in pyramid.
+     * @param[in] path Path of dataset.
+     * @returns True if model file contains dataset, false otherwise.
+     */
+    static
+    bool hasLevel(geomodelgrids::serial::HDF5* const h5,
+                  const size_t level,
+                  const std::string& path) {
+        std::ostringstream levelPath;
+        levelPath << "pyramid/level_" << level;
+        const std::string& groupPath = path.substr(0, path.rfind('/'));
+        return h5->hasGroup(levelPath.str().c_str()) && h5->hasGroup(groupPath.c_str()) &&
+               h5->hasDataset(path.c_str());
+    } // hasLevel
+
+    /** Get coarsest pyramid level of block or surface with a horizontal resolution no coarser than the given
+     * resolution.
+     *
+     * @param[in] item Block or surface at full resolution.
+     * @param[in] h5 Model file.
+     * @param[in] resolution Horizontal resolution (m) needed by queries.
+     * @returns Block or surface at selected level.
+     */
+    template<typename T>
+    static
+    std::shared_ptr<T> selectLevel(const std::shared_ptr<T>& item,
+                                   geomodelgrids::serial::HDF5* const h5,
+                                   const double resolution) {
+        std::shared_ptr<T> selected = item;
+        if (!item) {
+            return selected;
+        } // if
+
+        for (size_t level = 1;; ++level) {
+            std::shared_ptr<T> candidate = std::make_shared<T>(item->getName().c_str());
+            candidate->setLevel(level);
+            if (!hasLevel(h5, level, candidate->getPath())) {
+                break;
+            } // if
+            candidate->loadMetadata(h5);
+            if (horizontalResolution(*candidate) > resolution*(1.0 + geomodelgrids::TOLERANCE)) {
+                break;
+            } // if
+            selected = candidate;
+        } // for
+        return selected;
+    } // selectLevel
+
+    /** Expand bounding box to include points.
+     *
+     * @param[inout] bbox Bounding box [xmin, xmax, ymin, ymax].
+     * @param[in] xyz Coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     * @returns False if any point has infinite or NaN coordinates, true otherwise.
+     */
+    static
+    bool expandBoundingBox(double bbox[4],
+                           const std::vector<double>& xyz,
+                           const size_t numPoints) {
+        const size_t spaceDim = 3;
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double x = xyz[iPt*spaceDim+0];
+            const double y = xyz[iPt*spaceDim+1];
+            if (!std::isfinite(x) || !std::isfinite(y)) {
+                return false;
+            } // if
+            bbox[0] = std::min(bbox[0], x);
+            bbox[1] = std::max(bbox[1], x);
+            bbox[2] = std::min(bbox[2], y);
+            bbox[3] = std::max(bbox[3], y);
+        } // for
+        return true;
+    } // expandBoundingBox
+
+}; // _Model
 
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
@@ -23,12 +150,23 @@ geomodelgrids::serial::Model::Model(void) :
     _layout(VERTEX),
     _modelCRSString(""),
     _inputCRSString("EPSG:4326"),
-    _yazimuth(0.0) {
+    _yazimuth(0.0),
+    _hyperslabMaxBytes(geomodelgrids::serial::Hyperslab::DEFAULT_MAX_BYTES),
+    _hyperslabPrefetch(false),
+    _queryResolution(0.0),
+    _stats(nullptr),
+    _sharedCache(nullptr),
+    _fileImage(nullptr),
+    _fileImageBytes(0) {
     _origin[0] = 0.0;
     _origin[1] = 0.0;
     _dims[0] = 0.0;
     _dims[1] = 0.0;
     _dims[2] = 0.0;
+    _bbox[0] = -HUGE_VAL;
+    _bbox[1] = +HUGE_VAL;
+    _bbox[2] = -HUGE_VAL;
+    _bbox[3] = +HUGE_VAL;
 } // constructor
 
 
@@ -44,9 +182,113 @@ geomodelgrids::serial::Model::~Model(void) {
 void
 geomodelgrids::serial::Model::setInputCRS(const std::string& value) {
     _inputCRSString = value;
+    _crsTransformer.reset();
 } // setInputCRS
 
 
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying blocks.
+void
+geomodelgrids::serial::Model::setBlockHyperslabDims(const size_t dims[],
+                                                    const size_t ndims) {
+    if (3 != ndims) {
+        std::ostringstream msg;
+        msg << "Expected array of length 3 for block hyperslab dimensions, got array of length " << ndims << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    _blockHyperslabDims.assign(dims, dims+ndims);
+} // setBlockHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying surfaces.
+void
+geomodelgrids::serial::Model::setSurfaceHyperslabDims(const size_t dims[],
+                                                      const size_t ndims) {
+    if (2 != ndims) {
+        std::ostringstream msg;
+        msg << "Expected array of length 2 for surface hyperslab dimensions, got array of length " << ndims << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    _surfaceHyperslabDims.assign(dims, dims+ndims);
+} // setSurfaceHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for automatically sized hyperslab dimensions.
+void
+geomodelgrids::serial::Model::setHyperslabMaxBytes(const size_t value) {
+    _hyperslabMaxBytes = value;
+} // setHyperslabMaxBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::Model::setHyperslabPrefetch(const bool value) {
+    _hyperslabPrefetch = value;
+} // setHyperslabPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set horizontal resolution needed by queries.
+void
+geomodelgrids::serial::Model::setQueryResolution(const double value) {
+    if (value < 0.0) {
+        std::ostringstream msg;
+        msg << "Query resolution (" << value << ") must be nonnegative.";
+        throw std::invalid_argument(msg.str().c_str());
+    } // if
+    _queryResolution = value;
+} // setQueryResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Get horizontal resolution needed by queries.
+double
+geomodelgrids::serial::Model::getQueryResolution(void) const {
+    return _queryResolution;
+} // getQueryResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Set shared chunk cache used to read blocks and surfaces.
+void
+geomodelgrids::serial::Model::setSharedCache(geomodelgrids::serial::SharedChunkCache* const cache) {
+    _sharedCache = cache;
+} // setSharedCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Read model from an image of the model file in memory.
+void
+geomodelgrids::serial::Model::setFileImage(const void* const image,
+                                           const size_t numBytes) {
+    _fileImage = image;
+    _fileImageBytes = numBytes;
+} // setFileImage
+
+
+// ------------------------------------------------------------------------------------------------
+// Set statistics object for collecting query statistics.
+void
+geomodelgrids::serial::Model::setStats(geomodelgrids::serial::QueryStats* const stats) {
+    _stats = stats;
+} // setStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Get statistics object for collecting query statistics.
+geomodelgrids::serial::QueryStats*
+geomodelgrids::serial::Model::getStats(void) const {
+    return _stats;
+} // getStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Open Model file.
 void
@@ -73,6 +315,8 @@ geomodelgrids::serial::Model::open(const char* filename,
         throw std::logic_error(msg.str());
     } // switch
 
+    _h5->setSharedCache(_sharedCache);
+    _h5->setFileImage(_fileImage, _fileImageBytes);
     _h5->open(filename, h5Mode);
 } // open
 
@@ -110,6 +354,7 @@ geomodelgrids::serial::Model::loadMetadata(void) {
     if (!_h5) {
         throw std::logic_error("Model not open. Call open() before loading metadata.");
     } // if
+    _crsTransformer.reset();
 
     std::ostringstream msg;
     const char* indent = "            ";
@@ -249,23 +494,50 @@ geomodelgrids::serial::Model::loadMetadata(void) {
 
 
 // ------------------------------------------------------------------------------------------------
-// Initialize.
+// Initialize CRS transformation and bounding box of model domain.
 void
-geomodelgrids::serial::Model::initialize(void) {
+geomodelgrids::serial::Model::initializeDomain(void) {
     // Initialize CRS transformation
     _crsTransformer = std::make_shared<geomodelgrids::utils::CRSTransformer>();
     _crsTransformer->setSrc(_inputCRSString.c_str());
     _crsTransformer->setDest(_modelCRSString.c_str());
     _crsTransformer->initialize();
+    _computeBoundingBox();
+} // initializeDomain
 
-    if (_surfaceTop) {
-        _surfaceTop->openQuery(_h5.get());
+
+// ------------------------------------------------------------------------------------------------
+// Initialize.
+void
+geomodelgrids::serial::Model::initialize(void) {
+    if (!_crsTransformer) {
+        initializeDomain();
     } // if
-    if (_surfaceTopoBathy) {
-        _surfaceTopoBathy->openQuery(_h5.get());
+
+    if (_queryResolution > 0.0) {
+        _selectLevels();
     } // if
+
+    std::shared_ptr<geomodelgrids::serial::Surface> surfaces[2] = { _surfaceTop, _surfaceTopoBathy };
+    for (size_t i = 0; i < 2; ++i) {
+        if (surfaces[i]) {
+            if (!_surfaceHyperslabDims.empty()) {
+                surfaces[i]->setHyperslabDims(&_surfaceHyperslabDims[0], _surfaceHyperslabDims.size());
+            } // if
+            surfaces[i]->setHyperslabMaxBytes(_hyperslabMaxBytes);
+            surfaces[i]->setHyperslabPrefetch(_hyperslabPrefetch);
+            surfaces[i]->setStats(_stats);
+            surfaces[i]->openQuery(_h5.get());
+        } // if
+    } // for
     size_t numBlocks = _blocks.size();
     for (size_t i = 0; i < numBlocks; ++i) {
+        if (!_blockHyperslabDims.empty()) {
+            _blocks[i]->setHyperslabDims(&_blockHyperslabDims[0], _blockHyperslabDims.size());
+        } // if
+        _blocks[i]->setHyperslabMaxBytes(_hyperslabMaxBytes);
+        _blocks[i]->setHyperslabPrefetch(_hyperslabPrefetch);
+        _blocks[i]->setStats(_stats);
         _blocks[i]->openQuery(_h5.get());
     } // for
 } // initialize
@@ -374,24 +646,25 @@ bool
 geomodelgrids::serial::Model::contains(const double x,
                                        const double y,
                                        const double z) const {
+    if (!inBoundingBox(x, y)) {
+        return false;
+    } // if
+
     double xModel = 0.0;
     double yModel = 0.0;
     double zModel = 0.0;
     _toModelXYZ(&xModel, &yModel, &zModel, x, y, z);
 
-    bool inModel = false;
-    if (( xModel >= 0.0) && ( xModel <= _dims[0]) &&
-        ( yModel >= 0.0) && ( yModel <= _dims[1]) &&
-        ( zModel <= 0.0) && ( zModel >= -_dims[2]) ) {
-        inModel = true;
-    } // if
-
-    return inModel;
+    return containsModelXYZ(xModel, yModel, zModel);
 } // contains
 
 bool
 geomodelgrids::serial::Model::containsIn(const double x,
                                        const double y) const {
+    if (!inBoundingBox(x, y)) {
+        return false;
+    } // if
+
     double xModel = 0.0;
     double yModel = 0.0;
     bool inModel = false;
@@ -406,6 +679,23 @@ geomodelgrids::serial::Model::containsIn(const double x,
 } // contains
 
 
+// ------------------------------------------------------------------------------------------------
+// Could model contain latlon?
+bool
+geomodelgrids::serial::Model::inBoundingBox(const double x,
+                                            const double y) const {
+    return (x >= _bbox[0]) && (x <= _bbox[1]) && (y >= _bbox[2]) && (y <= _bbox[3]);
+} // inBoundingBox
+
+
+// ------------------------------------------------------------------------------------------------
+// Get conservative bounding box of model domain in input CRS.
+const double*
+geomodelgrids::serial::Model::getBoundingBox(void) const {
+    return _bbox;
+} // getBoundingBox
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for elevation of top of model at point using bilinear interpolation.
 double
@@ -429,7 +719,12 @@ geomodelgrids::serial::Model::queryTopElevation(const double x,
 
         double xIn = 0.0;
         double yIn = 0.0;
+        const double tStart = (_stats) ? QueryStats::now() : 0.0;
         _crsTransformer->inverse_transform(&xIn, &yIn, &elevation, xModelCRS, yModelCRS, zModelCRS);
+        if (_stats) {
+            _stats->numTransforms++;
+            _stats->timeTransform += QueryStats::now() - tStart;
+        } // if
     } // if
 
     return elevation;
@@ -459,7 +754,12 @@ geomodelgrids::serial::Model::queryTopoBathyElevation(const double x,
 
         double xIn = 0.0;
         double yIn = 0.0;
+        const double tStart = (_stats) ? QueryStats::now() : 0.0;
         _crsTransformer->inverse_transform(&xIn, &yIn, &elevation, xModelCRS, yModelCRS, zModelCRS);
+        if (_stats) {
+            _stats->numTransforms++;
+            _stats->timeTransform += QueryStats::now() - tStart;
+        } // if
     } // if
 
     return elevation;
@@ -476,12 +776,259 @@ geomodelgrids::serial::Model::query(const double x,
     double yModel = 0.0;
     double zModel = 0.0;
     _toModelXYZ(&xModel, &yModel, &zModel, x, y, z);
-    assert(contains(x, y, z));
+    return queryModelXYZ(xModel, yModel, zModel);
+
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at grid points along vertical column through point.
+void
+geomodelgrids::serial::Model::queryColumn(std::vector<double>* elevations,
+                                          std::vector<double>* values,
+                                          const double x,
+                                          const double y) {
+    assert(elevations);
+    assert(values);
+    assert(containsIn(x, y));
+
+    // Along a vertical column the model z coordinate is an affine function of the input elevation, so two
+    // transformations give the mapping for every grid point.
+    double xModel = 0.0;
+    double yModel = 0.0;
+    double zModel0 = 0.0;
+    double zModel1 = 0.0;
+    _toModelXYZ(&xModel, &yModel, &zModel0, x, y, 0.0);
+    _toModelXYZ(&xModel, &yModel, &zModel1, x, y, 1.0);
+    const double dzModel = zModel1 - zModel0;
+    assert(dzModel != 0.0);
+
+    const size_t numValues = _valueNames.size();
+    elevations->clear();
+    values->clear();
+    for (auto block : _blocks) {
+        assert(block);
+        const double* coordinatesZ = block->getCoordinatesZ();
+        const double resolutionZ = block->getResolutionZ();
+        const double zTop = block->getZTop();
+        const size_t numZ = block->getDims()[2];
+        for (size_t iZ = 0; iZ < numZ; ++iZ) {
+            const double zModel = std::min(coordinatesZ ? coordinatesZ[iZ] : zTop - iZ*resolutionZ, 0.0);
+            const double* blockValues = block->query(xModel, yModel, zModel, _unitsBoolean);
+            elevations->push_back((zModel - zModel0) / dzModel);
+            values->insert(values->end(), blockValues, blockValues+numValues);
+        } // for
+    } // for
+} // queryColumn
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert points in input CRS to model coordinates.
+void
+geomodelgrids::serial::Model::toModelXYZ(double* xyzModel,
+                                         const double* xyz,
+                                         const size_t numPoints) const {
+    assert(!numPoints || (xyzModel && xyz));
+    assert(_crsTransformer);
+
+    const size_t spaceDim = 3;
+    std::copy(xyz, xyz+numPoints*spaceDim, xyzModel);
+    const double tStart = (_stats) ? QueryStats::now() : 0.0;
+    _crsTransformer->transform(xyzModel, numPoints);
+    if (_stats) {
+        _stats->numTransforms += numPoints;
+        _stats->timeTransform += QueryStats::now() - tStart;
+    } // if
+
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    const double zBottom = -_dims[2];
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        double* pt = &xyzModel[iPt*spaceDim];
+        const double xRel = pt[0] - _origin[0];
+        const double yRel = pt[1] - _origin[1];
+        const double zModelCRS = pt[2];
+        pt[0] = xRel*cosAz - yRel*sinAz;
+        pt[1] = xRel*sinAz + yRel*cosAz;
+
+        const double zGroundSurf = (_surfaceTop) ? _surfaceTop->query(pt[0], pt[1]) : 0.0;
+        pt[2] = zBottom * (zGroundSurf - zModelCRS) / (zGroundSurf - zBottom);
+        if ((pt[2] > 0.0) && (pt[2] < TOLERANCE)) {
+            pt[2] = 0.0;
+        } // if
+    } // for
+} // toModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Does model contain point in model coordinates?
+bool
+geomodelgrids::serial::Model::containsModelXYZ(const double xModel,
+                                               const double yModel,
+                                               const double zModel) const {
+    return ( xModel >= 0.0) && ( xModel <= _dims[0]) &&
+           ( yModel >= 0.0) && ( yModel <= _dims[1]) &&
+           ( zModel <= 0.0) && ( zModel >= -_dims[2]);
+} // containsModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at point in model coordinates.
+const double*
+geomodelgrids::serial::Model::queryModelXYZ(const double xModel,
+                                            const double yModel,
+                                            const double zModel) {
+    assert(containsModelXYZ(xModel, yModel, zModel));
 
     std::shared_ptr<geomodelgrids::serial::Block> block = _findBlock(xModel, yModel, zModel);assert(block);
     return block->query(xModel, yModel, zModel, _unitsBoolean);
+} // queryModelXYZ
 
-} // query
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at points in model coordinates.
+void
+geomodelgrids::serial::Model::queryTopElevations(double* elevations,
+                                                 const double* xyzModel,
+                                                 const size_t numPoints) {
+    _querySurfaceElevations(elevations, _surfaceTop.get(), xyzModel, numPoints);
+} // queryTopElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at points in model coordinates.
+void
+geomodelgrids::serial::Model::queryTopoBathyElevations(double* elevations,
+                                                       const double* xyzModel,
+                                                       const size_t numPoints) {
+    Surface* surface = (_surfaceTopoBathy) ? _surfaceTopoBathy.get() : _surfaceTop.get();
+    _querySurfaceElevations(elevations, surface, xyzModel, numPoints);
+} // queryTopoBathyElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of surface at points in model coordinates.
+void
+geomodelgrids::serial::Model::_querySurfaceElevations(double* elevations,
+                                                      geomodelgrids::serial::Surface* surface,
+                                                      const double* xyzModel,
+                                                      const size_t numPoints) {
+    assert(!numPoints || (elevations && xyzModel));
+
+    if (!surface) {
+        std::fill(elevations, elevations+numPoints, 0.0);
+        return;
+    } // if
+
+    const size_t spaceDim = 3;
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    _surfaceXYZ.resize(numPoints*spaceDim);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double xModel = xyzModel[iPt*spaceDim+0];
+        const double yModel = xyzModel[iPt*spaceDim+1];
+        const double xRel = +xModel*cosAz + yModel*sinAz;
+        const double yRel = -xModel*sinAz + yModel*cosAz;
+        _surfaceXYZ[iPt*spaceDim+0] = xRel + _origin[0];
+        _surfaceXYZ[iPt*spaceDim+1] = yRel + _origin[1];
+        _surfaceXYZ[iPt*spaceDim+2] = surface->query(xModel, yModel);
+    } // for
+
+    const double tStart = (_stats) ? QueryStats::now() : 0.0;
+    _crsTransformer->inverse_transform(_surfaceXYZ.data(), numPoints);
+    if (_stats) {
+        _stats->numTransforms += numPoints;
+        _stats->timeTransform += QueryStats::now() - tStart;
+    } // if
+
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        elevations[iPt] = _surfaceXYZ[iPt*spaceDim+2];
+    } // for
+} // _querySurfaceElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute conservative bounding box of model domain in input CRS.
+void
+geomodelgrids::serial::Model::_computeBoundingBox(void) {
+    assert(_crsTransformer);
+
+    // Points cover the interior as well as the boundary, so the bounding box includes features such as a pole
+    // inside the domain. The edges of the domain are then sampled more densely until the bounding box stops
+    // growing, so curved edges are covered. The padding accounts for any remaining curvature between points.
+    const size_t numSamples = 33;
+    const size_t maxEdgeSamples = 32769;
+    const double tolerance = 1.0e-4;
+    const double padding = 0.02;
+    const size_t spaceDim = 3;
+
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    const double zValues[2] = { 0.0, -_dims[2] };
+    std::vector<double> xyz;
+    xyz.reserve(2*numSamples*numSamples*spaceDim);
+    for (size_t iZ = 0; iZ < 2; ++iZ) {
+        for (size_t iX = 0; iX < numSamples; ++iX) {
+            const double xModel = _dims[0] * iX / (numSamples-1);
+            for (size_t iY = 0; iY < numSamples; ++iY) {
+                const double yModel = _dims[1] * iY / (numSamples-1);
+                xyz.push_back(+xModel*cosAz + yModel*sinAz + _origin[0]);
+                xyz.push_back(-xModel*sinAz + yModel*cosAz + _origin[1]);
+                xyz.push_back(zValues[iZ]);
+            } // for
+        } // for
+    } // for
+    size_t numPoints = xyz.size() / spaceDim;
+    _crsTransformer->inverse_transform(xyz.data(), numPoints);
+
+    double bbox[4] = { +HUGE_VAL, -HUGE_VAL, +HUGE_VAL, -HUGE_VAL };
+    bool isBounded = _Model::expandBoundingBox(bbox, xyz, numPoints);
+    for (size_t numEdgeSamples = 2*numSamples-1; isBounded && (numEdgeSamples <= maxEdgeSamples);
+         numEdgeSamples = 2*numEdgeSamples-1) {
+        xyz.clear();
+        for (size_t iZ = 0; iZ < 2; ++iZ) {
+            for (size_t i = 0; i < numEdgeSamples; ++i) {
+                const double xModel = _dims[0] * i / (numEdgeSamples-1);
+                const double yModel = _dims[1] * i / (numEdgeSamples-1);
+                const double edgesModel[4][2] = {
+                    { xModel, 0.0 }, { xModel, _dims[1] }, { 0.0, yModel }, { _dims[0], yModel },
+                };
+                for (size_t iEdge = 0; iEdge < 4; ++iEdge) {
+                    xyz.push_back(+edgesModel[iEdge][0]*cosAz + edgesModel[iEdge][1]*sinAz + _origin[0]);
+                    xyz.push_back(-edgesModel[iEdge][0]*sinAz + edgesModel[iEdge][1]*cosAz + _origin[1]);
+                    xyz.push_back(zValues[iZ]);
+                } // for
+            } // for
+        } // for
+        numPoints = xyz.size() / spaceDim;
+        _crsTransformer->inverse_transform(xyz.data(), numPoints);
+
+        const double bboxPrev[4] = { bbox[0], bbox[1], bbox[2], bbox[3] };
+        isBounded = _Model::expandBoundingBox(bbox, xyz, numPoints);
+        const double growth = std::max(std::max(bboxPrev[0] - bbox[0], bbox[1] - bboxPrev[1]),
+                                       std::max(bboxPrev[2] - bbox[2], bbox[3] - bboxPrev[3]));
+        if (growth <= tolerance * std::max(bbox[1] - bbox[0], bbox[3] - bbox[2])) {
+            break;
+        } // if
+    } // for
+    if (!isBounded) {
+        _bbox[0] = -HUGE_VAL;
+        _bbox[1] = +HUGE_VAL;
+        _bbox[2] = -HUGE_VAL;
+        _bbox[3] = +HUGE_VAL;
+        return;
+    } // if
+
+    const double padX = padding * (bbox[1] - bbox[0]);
+    const double padY = padding * (bbox[3] - bbox[2]);
+    _bbox[0] = bbox[0] - padX;
+    _bbox[1] = bbox[1] + padX;
+    _bbox[2] = bbox[2] - padY;
+    _bbox[3] = bbox[3] + padY;
+} // _computeBoundingBox
 
 
 // ------------------------------------------------------------------------------------------------
@@ -499,7 +1046,12 @@ geomodelgrids::serial::Model::_toModelXYZ(double* xModel,
     double xModelCRS = 0.0;
     double yModelCRS = 0.0;
     double zModelCRS = 0.0;
+    const double tStart = (_stats) ? QueryStats::now() : 0.0;
     _crsTransformer->transform(&xModelCRS, &yModelCRS, &zModelCRS, x, y, z);
+    if (_stats) {
+        _stats->numTransforms++;
+        _stats->timeTransform += QueryStats::now() - tStart;
+    } // if
     const double yazimuthRad = _yazimuth * M_PI / 180.0;
     const double cosAz = cos(yazimuthRad);
     const double sinAz = sin(yazimuthRad);
@@ -537,6 +1089,24 @@ geomodelgrids::serial::Model::_findBlock(const double x,
 } // _findBlock
 
 
+// ------------------------------------------------------------------------------------------------
+// Replace blocks and surfaces with coarsest pyramid levels satisfying the query resolution.
+void
+geomodelgrids::serial::Model::_selectLevels(void) {
+    assert(_h5);
+
+    if (!_h5->hasGroup("pyramid")) {
+        return;
+    } // if
+
+    _surfaceTop = _Model::selectLevel(_surfaceTop, _h5.get(), _queryResolution);
+    _surfaceTopoBathy = _Model::selectLevel(_surfaceTopoBathy, _h5.get(), _queryResolution);
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        _blocks[i] = _Model::selectLevel(_blocks[i], _h5.get(), _queryResolution);
+    } // for
+} // _selectLevels
+
+
 // ------------------------------------------------------------------------------------------------
 std::vector<std::size_t>
 geomodelgrids::serial::Model::_toUnitsBoolean(const std::vector<std::string>& strings) const {
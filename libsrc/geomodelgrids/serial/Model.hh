@@ -41,6 +41,94 @@ public:
      */
     void setInputCRS(const std::string& value);
 
+    /** Set dimensions of hyperslabs used in querying blocks.
+     *
+     * Must be called before initialize(). Dimensions that are zero are sized automatically from the chunk layout
+     * of the block datasets.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y, z].
+     * @param[in] ndims Number of dimensions.
+     */
+    void setBlockHyperslabDims(const size_t dims[],
+                               const size_t ndims);
+
+    /** Set dimensions of hyperslabs used in querying surfaces.
+     *
+     * Must be called before initialize(). Dimensions that are zero are sized automatically from the chunk layout
+     * of the surface datasets.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y].
+     * @param[in] ndims Number of dimensions.
+     */
+    void setSurfaceHyperslabDims(const size_t dims[],
+                                 const size_t ndims);
+
+    /** Set memory budget for automatically sized hyperslab dimensions.
+     *
+     * Must be called before initialize().
+     *
+     * @param[in] value Maximum size (in bytes) of each hyperslab.
+     */
+    void setHyperslabMaxBytes(const size_t value);
+
+    /** Turn prefetching of the next hyperslab along the traversal direction on/off.
+     *
+     * Must be called before initialize(). Prefetching overlaps reading data with querying for points that move
+     * steadily through the model, such as rasters and profiles, at the cost of doubling hyperslab memory.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setHyperslabPrefetch(const bool value);
+
+    /** Set horizontal resolution needed by queries.
+     *
+     * Must be called before initialize(). If the model file contains a multi-resolution pyramid, each block and
+     * surface is queried using the coarsest level with a horizontal resolution no coarser than the requested
+     * resolution. Coarser levels read less data, so this speeds up queries for coarse grids and previews.
+     *
+     * @param[in] value Horizontal resolution (m) (0 for full resolution).
+     */
+    void setQueryResolution(const double value);
+
+    /** Get horizontal resolution needed by queries.
+     *
+     * @returns Horizontal resolution (m) (0 for full resolution).
+     */
+    double getQueryResolution(void) const;
+
+    /** Set shared chunk cache used to read blocks and surfaces.
+     *
+     * Must be called before open(). The model does not take ownership of the cache.
+     *
+     * @param[in] cache Shared chunk cache (nullptr for none).
+     */
+    void setSharedCache(geomodelgrids::serial::SharedChunkCache* const cache);
+
+    /** Read model from an image of the model file in memory instead of from the file system.
+     *
+     * Must be called before open(); the model must be opened READ. The image is not copied and must remain
+     * valid until the model is closed.
+     *
+     * @param[in] image Contents of model file (nullptr to read from the file system).
+     * @param[in] numBytes Size of image in bytes.
+     */
+    void setFileImage(const void* const image,
+                      const size_t numBytes);
+
+    /** Set statistics object for collecting query statistics.
+     *
+     * Must be called before initialize(). The model does not take ownership of the statistics object.
+     *
+     * @param[in] stats Statistics object (nullptr to turn off collecting statistics).
+     */
+    void setStats(geomodelgrids::serial::QueryStats* const stats);
+
+    /** Get statistics object for collecting query statistics.
+     *
+     * @returns Statistics object (nullptr if not collecting statistics).
+     */
+    geomodelgrids::serial::QueryStats* getStats(void) const;
+
     /** Open Model.
      *
      * @param[in] filename Name of Model file
@@ -56,6 +144,13 @@ public:
      */
     void loadMetadata(void);
 
+    /** Initialize CRS transformation and bounding box of model domain.
+     *
+     * This is the part of initialize() needed by inBoundingBox() and getBoundingBox(). It does not open the
+     * surfaces and blocks for querying, so it is much faster for models that may not be queried.
+     */
+    void initializeDomain(void);
+
     /** Initialize.
      */
     void initialize(void);
@@ -152,6 +247,27 @@ public:
     bool containsIn(const double x,
                     const double y) const;
 
+    /** Could model contain given latlon?
+     *
+     * Compares the point against a conservative bounding box of the model domain in the input CRS that is
+     * computed in initialize(), so it does not require transforming the point. Points outside the bounding box
+     * are not in the model; points inside the bounding box may or may not be in the model. The bounding box is
+     * computed from transformed sample points of the domain (see _computeBoundingBox()), so it is conservative
+     * for domains whose edges are smooth in the input CRS.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @returns False if model does not contain given latlon, true if it might.
+     */
+    bool inBoundingBox(const double x,
+                       const double y) const;
+
+    /** Get conservative bounding box of model domain in input CRS.
+     *
+     * @returns Bounding box [xmin, xmax, ymin, ymax] (unbounded before initialize()).
+     */
+    const double* getBoundingBox(void) const;
+
     /** Query for elevation of top of model at point using bilinear interpolation.
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -181,9 +297,104 @@ public:
                         const double y,
                         const double z);
 
+    /** Query for model values at grid points along vertical column through point.
+     *
+     * The grid points of each block are returned from the top of the model to the bottom. Model values vary
+     * linearly with elevation between consecutive points; consecutive points at the same elevation (interfaces
+     * between blocks) mark a jump in the values. The column must be inside the model (see containsIn()).
+     *
+     * @param[out] elevations Elevations (m) of grid points (in input CRS).
+     * @param[out] values Model values at grid points [numPoints][numValues].
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     */
+    void queryColumn(std::vector<double>* elevations,
+                     std::vector<double>* values,
+                     const double x,
+                     const double y);
+
+    /** Convert points in input CRS to model coordinates.
+     *
+     * All points are transformed with a single call to the CRS transformation, so this is much faster than
+     * converting the points one at a time.
+     *
+     * @param[out] xyzModel Model coordinates of points [numPoints][3].
+     * @param[in] xyz Coordinates of points (in input CRS) [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void toModelXYZ(double* xyzModel,
+                    const double* xyz,
+                    const size_t numPoints) const;
+
+    /** Does model contain given point in model coordinates?
+     *
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     * @param[in] zModel Model z coordinate of point.
+     * @returns True if model contains given point, false otherwise.
+     */
+    bool containsModelXYZ(const double xModel,
+                          const double yModel,
+                          const double zModel) const;
+
+    /** Query for model values at point in model coordinates using bilinear interpolation.
+     *
+     * The model must contain the point (see containsModelXYZ()).
+     *
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     * @param[in] zModel Model z coordinate of point.
+     * @returns Array of model values at point.
+     */
+    const double* queryModelXYZ(const double xModel,
+                                const double yModel,
+                                const double zModel);
+
+    /** Query for elevation of top of model at points in model coordinates.
+     *
+     * @param[out] elevations Elevations (m) of top of model (in input CRS) [numPoints].
+     * @param[in] xyzModel Model coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopElevations(double* elevations,
+                            const double* xyzModel,
+                            const size_t numPoints);
+
+    /** Query for elevation of topography/bathymetry at points in model coordinates.
+     *
+     * @param[out] elevations Elevations (m) of solid surface (in input CRS) [numPoints].
+     * @param[in] xyzModel Model coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopoBathyElevations(double* elevations,
+                                  const double* xyzModel,
+                                  const size_t numPoints);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
+    /** Query for elevation of surface at points in model coordinates.
+     *
+     * @param[out] elevations Elevations (m) of surface (in input CRS) [numPoints].
+     * @param[in] surface Surface to query (nullptr if model has no surface).
+     * @param[in] xyzModel Model coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void _querySurfaceElevations(double* elevations,
+                                 geomodelgrids::serial::Surface* surface,
+                                 const double* xyzModel,
+                                 const size_t numPoints);
+
+    /** Compute conservative bounding box of model domain in input CRS.
+     *
+     * Transforms a grid of points covering the top and bottom of the model domain to the input CRS, refines the
+     * points along the edges of the domain until the extent stops growing (by at most 1.0e-4 of the extent) or
+     * 32769 points per edge are reached, and pads the extent by 2%. The result is an approximation: an edge that
+     * bulges more than the padding between the final points, or an extreme value inside the domain between the
+     * interior points, may lie outside it. The bounding box is unbounded if any point cannot be transformed.
+     */
+    void _computeBoundingBox(void);
+
     /** Convert xyz in input CRS to xyz in model CRS.
      *
      * @param[out] xModel Model x coordinate of point.
@@ -211,6 +422,11 @@ private:
                                                              const double y,
                                                              const double z) const;
 
+    /** Replace blocks and surfaces with the coarsest levels of the multi-resolution pyramid that satisfy the
+     * query resolution.
+     */
+    void _selectLevels(void);
+
     /** Transform array of Units strings to booleans ("none" = 0, others = 1)
      *
      * @param[in] strings Array of strings.
@@ -231,6 +447,16 @@ private:
     double _origin[2]; ///< x and y coordinates of model origin.
     double _yazimuth; ///< Azimuth of y coordinate axis.
     double _dims[3]; ///< Dimensions of model along coordinate axes.
+    double _bbox[4]; ///< Conservative bounding box of model domain in input CRS [xmin, xmax, ymin, ymax].
+    std::vector<size_t> _blockHyperslabDims; ///< Dimensions of hyperslabs for blocks (empty for default).
+    std::vector<size_t> _surfaceHyperslabDims; ///< Dimensions of hyperslabs for surfaces (empty for default).
+    size_t _hyperslabMaxBytes; ///< Memory budget for automatically sized hyperslabs.
+    bool _hyperslabPrefetch; ///< True if prefetching next hyperslab.
+    double _queryResolution; ///< Horizontal resolution needed by queries (0 for full resolution).
+    geomodelgrids::serial::QueryStats* _stats; ///< Query statistics (nullptr if not collecting statistics).
+    geomodelgrids::serial::SharedChunkCache* _sharedCache; ///< Shared chunk cache (nullptr for none).
+    const void* _fileImage; ///< Image of model file in memory (nullptr if reading from file system).
+    size_t _fileImageBytes; ///< Size of image of model file in bytes.
 
     std::unique_ptr<geomodelgrids::serial::HDF5> _h5; ///< Model file.
     std::shared_ptr<geomodelgrids::serial::ModelInfo> _info; ///< Model description information.
@@ -238,6 +464,7 @@ private:
     std::shared_ptr<geomodelgrids::serial::Surface> _surfaceTopoBathy; ///< Model topography/bathymetry.
     std::shared_ptr<geomodelgrids::utils::CRSTransformer> _crsTransformer; ///< Coordinate system transformer.
     std::vector<std::shared_ptr<geomodelgrids::serial::Block> > _blocks; ///< Model blocks.
+    std::vector<double> _surfaceXYZ; ///< Work array for transforming surface points.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -0,0 +1,184 @@
+#include <portinfo>
+
+#include "ModelIndex.hh" // implementation of class methods
+
+#include <algorithm> // USES std::min(), std::max()
+#include <cassert> // USES assert()
+#include <cmath> // USES sqrt(), ceil(), floor(), std::isfinite(), HUGE_VAL
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _ModelIndex;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_ModelIndex {
+public:
+
+    /** Get index of cell along axis containing coordinate.
+     *
+     * @param[in] value Coordinate.
+     * @param[in] min Minimum coordinate of grid.
+     * @param[in] cellSize Dimension of cells along axis.
+     * @param[in] numCells Number of cells along axis.
+     * @returns Index of cell.
+     */
+    static
+    size_t cellIndex(const double value,
+                     const double min,
+                     const double cellSize,
+                     const size_t numCells) {
+        if (cellSize <= 0.0) {
+            return 0;
+        } // if
+        const double index = floor((value - min) / cellSize);
+        return (index > 0.0) ? std::min(size_t(index), numCells-1) : 0;
+    } // cellIndex
+
+    /** Get number of cells along axis.
+     *
+     * @param[in] length Length of grid along axis.
+     * @param[in] otherLength Length of grid along other axis.
+     * @param[in] numCellsTotal Target total number of cells.
+     * @returns Number of cells along axis.
+     */
+    static
+    size_t numCells(const double length,
+                    const double otherLength,
+                    const size_t numCellsTotal) {
+        const size_t maxCells = 1024;
+        if ((length <= 0.0) || (otherLength <= 0.0)) {
+            return (length > 0.0) ? std::min(numCellsTotal, maxCells) : 1;
+        } // if
+        const double numCells = ceil(sqrt(numCellsTotal * length / otherLength));
+        return size_t(std::max(1.0, std::min(numCells, double(maxCells))));
+    } // numCells
+
+    /** Does bounding box have finite bounds?
+     *
+     * @param[in] bbox Bounding box [xmin, xmax, ymin, ymax].
+     * @returns True if bounding box is bounded, false otherwise.
+     */
+    static
+    bool isBounded(const double* bbox) {
+        return std::isfinite(bbox[0]) && std::isfinite(bbox[1]) && std::isfinite(bbox[2]) && std::isfinite(bbox[3]);
+    } // isBounded
+
+}; // _ModelIndex
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::ModelIndex::ModelIndex(void) {
+    _extent[0] = +HUGE_VAL;
+    _extent[1] = -HUGE_VAL;
+    _extent[2] = +HUGE_VAL;
+    _extent[3] = -HUGE_VAL;
+    _cellSize[0] = 0.0;
+    _cellSize[1] = 0.0;
+    _numCells[0] = 0;
+    _numCells[1] = 0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::ModelIndex::~ModelIndex(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Build index.
+void
+geomodelgrids::serial::ModelIndex::initialize(const double* const bboxes,
+                                              const size_t numModels) {
+    assert(!numModels || bboxes);
+
+    _extent[0] = +HUGE_VAL;
+    _extent[1] = -HUGE_VAL;
+    _extent[2] = +HUGE_VAL;
+    _extent[3] = -HUGE_VAL;
+    _bboxes.assign(bboxes, bboxes+numModels*4);
+    _cells.clear();
+    _unbounded.clear();
+
+    size_t numBounded = 0;
+    for (size_t iModel = 0; iModel < numModels; ++iModel) {
+        const double* bbox = &bboxes[iModel*4];
+        if (_ModelIndex::isBounded(bbox)) {
+            _extent[0] = std::min(_extent[0], bbox[0]);
+            _extent[1] = std::max(_extent[1], bbox[1]);
+            _extent[2] = std::min(_extent[2], bbox[2]);
+            _extent[3] = std::max(_extent[3], bbox[3]);
+            ++numBounded;
+        } // if
+    } // for
+
+    // Target about four cells per model, with cells of similar dimensions along x and y.
+    if (numBounded) {
+        const double lengthX = _extent[1] - _extent[0];
+        const double lengthY = _extent[3] - _extent[2];
+        const size_t numCellsTotal = 4 * numBounded;
+        _numCells[0] = _ModelIndex::numCells(lengthX, lengthY, numCellsTotal);
+        _numCells[1] = _ModelIndex::numCells(lengthY, lengthX, numCellsTotal);
+        _cellSize[0] = lengthX / _numCells[0];
+        _cellSize[1] = lengthY / _numCells[1];
+    } else {
+        _numCells[0] = 0;
+        _numCells[1] = 0;
+        _cellSize[0] = 0.0;
+        _cellSize[1] = 0.0;
+    } // if/else
+    _cells.resize(_numCells[0]*_numCells[1]);
+
+    // Models are added in priority order, so the list for each cell is in priority order.
+    for (size_t iModel = 0; iModel < numModels; ++iModel) {
+        const double* bbox = &bboxes[iModel*4];
+        if (!_ModelIndex::isBounded(bbox)) {
+            _unbounded.push_back(iModel);
+            for (size_t iCell = 0; iCell < _cells.size(); ++iCell) {
+                _cells[iCell].push_back(iModel);
+            } // for
+            continue;
+        } // if
+
+        const size_t iXStart = _ModelIndex::cellIndex(bbox[0], _extent[0], _cellSize[0], _numCells[0]);
+        const size_t iXEnd = _ModelIndex::cellIndex(bbox[1], _extent[0], _cellSize[0], _numCells[0]);
+        const size_t iYStart = _ModelIndex::cellIndex(bbox[2], _extent[2], _cellSize[1], _numCells[1]);
+        const size_t iYEnd = _ModelIndex::cellIndex(bbox[3], _extent[2], _cellSize[1], _numCells[1]);
+        for (size_t iX = iXStart; iX <= iXEnd; ++iX) {
+            for (size_t iY = iYStart; iY <= iYEnd; ++iY) {
+                _cells[iX*_numCells[1]+iY].push_back(iModel);
+            } // for
+        } // for
+    } // for
+} // initialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get models that might contain point.
+const std::vector<size_t>&
+geomodelgrids::serial::ModelIndex::getCandidates(const double x,
+                                                 const double y) const {
+    if (!((x >= _extent[0]) && (x <= _extent[1]) && (y >= _extent[2]) && (y <= _extent[3]))) {
+        return _unbounded;
+    } // if
+
+    const size_t iX = _ModelIndex::cellIndex(x, _extent[0], _cellSize[0], _numCells[0]);
+    const size_t iY = _ModelIndex::cellIndex(y, _extent[2], _cellSize[1], _numCells[1]);
+    return _cells[iX*_numCells[1]+iY];
+} // getCandidates
+
+
+// ------------------------------------------------------------------------------------------------
+// Is point inside bounding box of model?
+bool
+geomodelgrids::serial::ModelIndex::inBoundingBox(const size_t index,
+                                                 const double x,
+                                                 const double y) const {
+    assert(index*4 < _bboxes.size());
+    const double* bbox = &_bboxes[index*4];
+    return (x >= bbox[0]) && (x <= bbox[1]) && (y >= bbox[2]) && (y <= bbox[3]);
+} // inBoundingBox
+
+
+// End of file
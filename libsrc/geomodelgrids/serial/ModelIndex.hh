@@ -0,0 +1,73 @@
+/** Spatial index of model footprints for dispatching queries to models.
+ *
+ * The union of the model bounding boxes (in the input CRS) is divided into a uniform grid of cells. Each cell
+ * holds the indices of the models whose bounding box overlaps the cell, in priority order, so finding the
+ * models that might contain a point does not depend on the number of models. Models with an unbounded bounding
+ * box are candidates for every point.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <cstddef> // USES size_t
+
+class geomodelgrids::serial::ModelIndex {
+    friend class TestModelIndex; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    ModelIndex(void);
+
+    /// Destructor
+    ~ModelIndex(void);
+
+    /** Build index.
+     *
+     * @param[in] bboxes Bounding boxes of models in priority order [numModels][xmin, xmax, ymin, ymax].
+     * @param[in] numModels Number of models.
+     */
+    void initialize(const double* const bboxes,
+                    const size_t numModels);
+
+    /** Get models that might contain point.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @returns Indices of models in priority order.
+     */
+    const std::vector<size_t>& getCandidates(const double x,
+                                             const double y) const;
+
+    /** Is point inside bounding box of model?
+     *
+     * @param[in] index Index of model.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @returns True if bounding box of model contains point, false otherwise.
+     */
+    bool inBoundingBox(const size_t index,
+                       const double x,
+                       const double y) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<double> _bboxes; ///< Bounding boxes of models [numModels][xmin, xmax, ymin, ymax].
+    double _extent[4]; ///< Extent of grid [xmin, xmax, ymin, ymax].
+    double _cellSize[2]; ///< Dimensions of grid cells [x, y].
+    size_t _numCells[2]; ///< Number of grid cells along axes [x, y].
+    std::vector<std::vector<size_t> > _cells; ///< Indices of models overlapping each cell.
+    std::vector<size_t> _unbounded; ///< Indices of models with unbounded bounding boxes.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    ModelIndex(const ModelIndex&); ///< Not implemented
+    const ModelIndex& operator=(const ModelIndex&); ///< Not implemented
+
+}; // ModelIndex
+
+// End of file
@@ -160,6 +160,132 @@ geomodelgrids::serial::ModelInfo::getAuxiliary(void) const {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setTitle(const std::string& value) {
+    _title = value;
+} // setTitle
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setId(const std::string& value) {
+    _id = value;
+} // setId
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setDescription(const std::string& value) {
+    _description = value;
+} // setDescription
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setKeywords(const std::vector<std::string>& value) {
+    _keywords = value;
+} // setKeywords
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setHistory(const std::string& value) {
+    _history = value;
+} // setHistory
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setComment(const std::string& value) {
+    _comment = value;
+} // setComment
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setCreatorName(const std::string& value) {
+    _creatorName = value;
+} // setCreatorName
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setCreatorInstitution(const std::string& value) {
+    _creatorInstitution = value;
+} // setCreatorInstitution
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setCreatorEmail(const std::string& value) {
+    _creatorEmail = value;
+} // setCreatorEmail
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setAcknowledgement(const std::string& value) {
+    _acknowledgement = value;
+} // setAcknowledgement
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setAuthors(const std::vector<std::string>& value) {
+    _authors = value;
+} // setAuthors
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setReferences(const std::vector<std::string>& value) {
+    _references = value;
+} // setReferences
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setRepositoryName(const std::string& value) {
+    _repositoryName = value;
+} // setRepositoryName
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setRepositoryURL(const std::string& value) {
+    _repositoryURL = value;
+} // setRepositoryURL
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setRepositoryDOI(const std::string& value) {
+    _repositoryDOI = value;
+} // setRepositoryDOI
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setVersion(const std::string& value) {
+    _version = value;
+} // setVersion
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setLicense(const std::string& value) {
+    _license = value;
+} // setLicense
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::ModelInfo::setAuxiliary(const std::string& value) {
+    _auxiliary = value;
+} // setAuxiliary
+
+
 // ------------------------------------------------------------------------------------------------
 // Load info from HDF5 file.
 void
@@ -298,4 +424,33 @@ geomodelgrids::serial::ModelInfo::load(geomodelgrids::serial::HDF5* const h5) {
 } // load
 
 
+// ------------------------------------------------------------------------------------------------
+// Save metadata.
+void
+geomodelgrids::serial::ModelInfo::save(geomodelgrids::serial::HDF5* const h5) const {
+    assert(h5);
+
+    h5->writeAttribute("/", "title", _title.c_str());
+    h5->writeAttribute("/", "id", _id.c_str());
+    h5->writeAttribute("/", "description", _description.c_str());
+    h5->writeAttribute("/", "keywords", _keywords);
+    h5->writeAttribute("/", "history", _history.c_str());
+    h5->writeAttribute("/", "comment", _comment.c_str());
+    h5->writeAttribute("/", "creator_name", _creatorName.c_str());
+    h5->writeAttribute("/", "creator_institution", _creatorInstitution.c_str());
+    h5->writeAttribute("/", "creator_email", _creatorEmail.c_str());
+    h5->writeAttribute("/", "acknowledgement", _acknowledgement.c_str());
+    h5->writeAttribute("/", "authors", _authors);
+    h5->writeAttribute("/", "references", _references);
+    h5->writeAttribute("/", "repository_name", _repositoryName.c_str());
+    h5->writeAttribute("/", "repository_url", _repositoryURL.c_str());
+    h5->writeAttribute("/", "repository_doi", _repositoryDOI.c_str());
+    h5->writeAttribute("/", "version", _version.c_str());
+    h5->writeAttribute("/", "license", _license.c_str());
+    if (!_auxiliary.empty()) {
+        h5->writeAttribute("/", "auxiliary", _auxiliary.c_str());
+    } // if
+} // save
+
+
 // End of file
@@ -128,10 +128,124 @@ public:
      */
     const std::string& getAuxiliary(void) const;
 
+    /** Set title of model.
+     *
+     * @param[in] value Title of model.
+     */
+    void setTitle(const std::string& value);
+
+    /** Set model identifier.
+     *
+     * @param[in] value Model identifier.
+     */
+    void setId(const std::string& value);
+
+    /** Set model description.
+     *
+     * @param[in] value Model description.
+     */
+    void setDescription(const std::string& value);
+
+    /** Set keywords describing model.
+     *
+     * @param[in] value Keywords describing model.
+     */
+    void setKeywords(const std::vector<std::string>& value);
+
+    /** Set history of model.
+     *
+     * @param[in] value History of model.
+     */
+    void setHistory(const std::string& value);
+
+    /** Set comment on model.
+     *
+     * @param[in] value Comment on model.
+     */
+    void setComment(const std::string& value);
+
+    /** Set name of creator.
+     *
+     * @param[in] value Name of creator.
+     */
+    void setCreatorName(const std::string& value);
+
+    /** Set institution of creator.
+     *
+     * @param[in] value Institution of creator.
+     */
+    void setCreatorInstitution(const std::string& value);
+
+    /** Set email of creator.
+     *
+     * @param[in] value Email of creator.
+     */
+    void setCreatorEmail(const std::string& value);
+
+    /** Set acknowledgment for model.
+     *
+     * @param[in] value Acknowledgment for model.
+     */
+    void setAcknowledgement(const std::string& value);
+
+    /** Set names of authors.
+     *
+     * @param[in] value Names of authors.
+     */
+    void setAuthors(const std::vector<std::string>& value);
+
+    /** Set references associated with model.
+     *
+     * @param[in] value References associated with model.
+     */
+    void setReferences(const std::vector<std::string>& value);
+
+    /** Set name of repository holding model.
+     *
+     * @param[in] value Name of repository holding model.
+     */
+    void setRepositoryName(const std::string& value);
+
+    /** Set URL of repository holding model.
+     *
+     * @param[in] value URL of repository holding model.
+     */
+    void setRepositoryURL(const std::string& value);
+
+    /** Set DOI for model.
+     *
+     * @param[in] value DOI for model.
+     */
+    void setRepositoryDOI(const std::string& value);
+
+    /** Set model version.
+     *
+     * @param[in] value Model version.
+     */
+    void setVersion(const std::string& value);
+
+    /** Set license for model.
+     *
+     * @param[in] value License for model.
+     */
+    void setLicense(const std::string& value);
+
+    /** Set auxiliary information (JSON as string).
+     *
+     * @param[in] value Auxiliary information (JSON as string).
+     */
+    void setAuxiliary(const std::string& value);
+
     /** Load metadata.
      */
     void load(geomodelgrids::serial::HDF5* const h5);
 
+    /** Save metadata.
+     *
+     * @param[in] h5 HDF5 file open for writing.
+     */
+    void save(geomodelgrids::serial::HDF5* const h5) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
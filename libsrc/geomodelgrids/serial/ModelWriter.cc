@@ -0,0 +1,464 @@
+#include <portinfo>
+
+#include "ModelWriter.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+
+#include <zlib.h> // USES compress2()
+
+#include <algorithm> // USES std::min()
+#include <thread> // USES std::thread
+#include <atomic> // USES std::atomic
+#include <cstring> // USES memcpy()
+#include <cstdint> // USES uint32_t
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace serial {
+        class _ModelWriter {
+public:
+
+            /// Default number of points along each dimension of chunks.
+            static const size_t defaultChunkSize;
+
+            /** Check whether native floats are stored as little endian.
+             *
+             * @returns True if native floats are little endian, false otherwise.
+             */
+            static
+            bool isLittleEndian(void) {
+                const uint32_t one = 1;
+                return 1 == *reinterpret_cast<const unsigned char*>(&one);
+            } // isLittleEndian
+
+        }; // _ModelWriter
+        const size_t _ModelWriter::defaultChunkSize = 32;
+    } // serial
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Create axis with uniform grid spacing.
+geomodelgrids::serial::ModelWriter::Axis
+geomodelgrids::serial::ModelWriter::Axis::uniform(const size_t numPoints,
+                                                  const double resolution) {
+    Axis axis;
+    axis.numPoints = numPoints;
+    axis.resolution = resolution;
+    return axis;
+} // uniform
+
+
+// ------------------------------------------------------------------------------------------------
+// Create axis with variable grid spacing.
+geomodelgrids::serial::ModelWriter::Axis
+geomodelgrids::serial::ModelWriter::Axis::variable(const std::vector<double>& coordinates) {
+    Axis axis;
+    axis.numPoints = coordinates.size();
+    axis.resolution = 0.0;
+    axis.coordinates = coordinates;
+    return axis;
+} // variable
+
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::ModelWriter::ModelWriter(void) :
+    _h5(nullptr),
+    _numValues(0),
+    _numThreads(1),
+    _compression(4) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::ModelWriter::~ModelWriter(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Set compression level.
+void
+geomodelgrids::serial::ModelWriter::setCompression(const int value) {
+    if ((value < 0) || (value > 9)) {
+        std::ostringstream msg;
+        msg << "Compression level (" << value << ") must be in the range 0-9.";
+        throw std::invalid_argument(msg.str());
+    } // if
+    _compression = value;
+} // setCompression
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of threads used to compress chunks.
+void
+geomodelgrids::serial::ModelWriter::setNumThreads(const size_t value) {
+    _numThreads = std::max(value, size_t(1));
+} // setNumThreads
+
+
+// ------------------------------------------------------------------------------------------------
+// Create model file.
+void
+geomodelgrids::serial::ModelWriter::open(const char* filename) {
+    assert(filename);
+
+    close();
+    _h5.reset(new geomodelgrids::serial::HDF5());
+    _h5->open(filename, H5F_ACC_TRUNC);
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Close model file.
+void
+geomodelgrids::serial::ModelWriter::close(void) {
+    if (_h5) {
+        _h5->close();
+        _h5.reset(nullptr);
+    } // if
+    _datasets.clear();
+    _numValues = 0;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Write model metadata.
+void
+geomodelgrids::serial::ModelWriter::writeInfo(const geomodelgrids::serial::ModelInfo& info) {
+    if (!_h5) { throw std::logic_error("Model file must be opened before writing metadata."); }
+
+    info.save(_h5.get());
+} // writeInfo
+
+
+// ------------------------------------------------------------------------------------------------
+// Write model domain.
+void
+geomodelgrids::serial::ModelWriter::writeDomain(const std::vector<std::string>& valueNames,
+                                                const std::vector<std::string>& valueUnits,
+                                                const std::string& crs,
+                                                const double origin[2],
+                                                const double yAzimuth,
+                                                const double dims[3]) {
+    if (!_h5) { throw std::logic_error("Model file must be opened before writing domain."); }
+    if (valueNames.empty()) { throw std::invalid_argument("Model must have at least one value."); }
+    if (valueNames.size() != valueUnits.size()) {
+        std::ostringstream msg;
+        msg << "Number of value names (" << valueNames.size() << ") does not match number of value units ("
+            << valueUnits.size() << ").";
+        throw std::invalid_argument(msg.str());
+    } // if
+
+    _h5->writeAttribute("/", "data_values", valueNames);
+    _h5->writeAttribute("/", "data_units", valueUnits);
+    _h5->writeAttribute("/", "data_layout", "vertex");
+    _h5->writeAttribute("/", "crs", crs.c_str());
+    _h5->writeAttribute("/", "origin_x", H5T_NATIVE_DOUBLE, &origin[0]);
+    _h5->writeAttribute("/", "origin_y", H5T_NATIVE_DOUBLE, &origin[1]);
+    _h5->writeAttribute("/", "y_azimuth", H5T_NATIVE_DOUBLE, &yAzimuth);
+    _h5->writeAttribute("/", "dim_x", H5T_NATIVE_DOUBLE, &dims[0]);
+    _h5->writeAttribute("/", "dim_y", H5T_NATIVE_DOUBLE, &dims[1]);
+    _h5->writeAttribute("/", "dim_z", H5T_NATIVE_DOUBLE, &dims[2]);
+
+    _h5->createGroup("blocks");
+    _numValues = valueNames.size();
+} // writeDomain
+
+
+// ------------------------------------------------------------------------------------------------
+// Create surface.
+void
+geomodelgrids::serial::ModelWriter::createSurface(const char* name,
+                                                  const Axis& x,
+                                                  const Axis& y,
+                                                  const size_t* chunk) {
+    assert(name);
+    if (!_h5) { throw std::logic_error("Model file must be opened before creating surfaces."); }
+
+    const std::string path = std::string("surfaces/") + name;
+    const std::vector<size_t> dims = { x.numPoints, y.numPoints, 1 };
+    std::vector<size_t> chunkDims = { _ModelWriter::defaultChunkSize, _ModelWriter::defaultChunkSize, 1 };
+    if (chunk) {
+        chunkDims[0] = chunk[0];
+        chunkDims[1] = chunk[1];
+    } // if
+
+    _h5->createGroup("surfaces");
+    _createDataset(path, dims, chunkDims);
+    _writeAxis(path.c_str(), "x", x);
+    _writeAxis(path.c_str(), "y", y);
+} // createSurface
+
+
+// ------------------------------------------------------------------------------------------------
+// Write hyperslab of surface elevations.
+void
+geomodelgrids::serial::ModelWriter::writeSurface(const char* name,
+                                                 const float* elevation,
+                                                 const size_t origin[2],
+                                                 const size_t dims[2]) {
+    assert(name);
+    assert(elevation);
+
+    const std::string path = std::string("surfaces/") + name;
+    _writeHyperslab(path, elevation, { origin[0], origin[1], 0 }, { dims[0], dims[1], 1 });
+} // writeSurface
+
+
+// ------------------------------------------------------------------------------------------------
+// Create block.
+void
+geomodelgrids::serial::ModelWriter::createBlock(const char* name,
+                                                const Axis& x,
+                                                const Axis& y,
+                                                const Axis& z,
+                                                const double zTop,
+                                                const size_t* chunk) {
+    assert(name);
+    if (!_h5) { throw std::logic_error("Model file must be opened before creating blocks."); }
+    if (!_numValues) { throw std::logic_error("Domain must be written before creating blocks."); }
+
+    const std::string path = std::string("blocks/") + name;
+    const std::vector<size_t> dims = { x.numPoints, y.numPoints, z.numPoints, _numValues };
+    std::vector<size_t> chunkDims = {
+        _ModelWriter::defaultChunkSize, _ModelWriter::defaultChunkSize, _ModelWriter::defaultChunkSize, _numValues,
+    };
+    if (chunk) {
+        chunkDims[0] = chunk[0];
+        chunkDims[1] = chunk[1];
+        chunkDims[2] = chunk[2];
+    } // if
+
+    _createDataset(path, dims, chunkDims);
+    _writeAxis(path.c_str(), "x", x);
+    _writeAxis(path.c_str(), "y", y);
+    _writeAxis(path.c_str(), "z", z);
+    if (z.coordinates.empty()) {
+        _h5->writeAttribute(path.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+    } // if
+} // createBlock
+
+
+// ------------------------------------------------------------------------------------------------
+// Write hyperslab of block values.
+void
+geomodelgrids::serial::ModelWriter::writeBlock(const char* name,
+                                               const float* values,
+                                               const size_t origin[3],
+                                               const size_t dims[3]) {
+    assert(name);
+    assert(values);
+
+    const std::string path = std::string("blocks/") + name;
+    _writeHyperslab(path, values, { origin[0], origin[1], origin[2], 0 }, { dims[0], dims[1], dims[2], _numValues });
+} // writeBlock
+
+
+// ------------------------------------------------------------------------------------------------
+// Write grid spacing attributes for axis.
+void
+geomodelgrids::serial::ModelWriter::_writeAxis(const char* path,
+                                               const char* axisName,
+                                               const Axis& axis) {
+    assert(path);
+    assert(axisName);
+
+    if (axis.coordinates.empty()) {
+        if (axis.resolution <= 0.0) {
+            std::ostringstream msg;
+            msg << "Resolution (" << axis.resolution << ") along " << axisName << " axis of '" << path
+                << "' must be positive.";
+            throw std::invalid_argument(msg.str());
+        } // if
+        const std::string attrName = std::string(axisName) + "_resolution";
+        _h5->writeAttribute(path, attrName.c_str(), H5T_NATIVE_DOUBLE, &axis.resolution);
+    } else {
+        assert(axis.numPoints == axis.coordinates.size());
+        const std::string attrName = std::string(axisName) + "_coordinates";
+        _h5->writeAttribute(path, attrName.c_str(), H5T_NATIVE_DOUBLE, &axis.coordinates[0], axis.coordinates.size());
+    } // if/else
+} // _writeAxis
+
+
+// ------------------------------------------------------------------------------------------------
+// Create dataset and remember its layout.
+void
+geomodelgrids::serial::ModelWriter::_createDataset(const std::string& path,
+                                                   const std::vector<size_t>& dims,
+                                                   const std::vector<size_t>& chunk) {
+    const size_t ndims = dims.size();
+    assert(chunk.size() == ndims);
+
+    DatasetInfo info;
+    info.dims = dims;
+    info.chunk.resize(ndims);
+    std::vector<hsize_t> hdims(ndims);
+    std::vector<hsize_t> hchunk(ndims);
+    for (size_t i = 0; i < ndims; ++i) {
+        if (!dims[i]) {
+            std::ostringstream msg;
+            msg << "Dimension " << i << " of '" << path << "' must be positive.";
+            throw std::invalid_argument(msg.str());
+        } // if
+        info.chunk[i] = std::max(std::min(chunk[i], dims[i]), size_t(1));
+        hdims[i] = dims[i];
+        hchunk[i] = info.chunk[i];
+    } // for
+
+    _h5->createDataset(path.c_str(), &hdims[0], &hchunk[0], int(ndims), H5T_IEEE_F32LE, _compression);
+    _datasets[path] = info;
+} // _createDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Write hyperslab of values to dataset.
+void
+geomodelgrids::serial::ModelWriter::_writeHyperslab(const std::string& path,
+                                                    const float* values,
+                                                    const std::vector<size_t>& origin,
+                                                    const std::vector<size_t>& dims) {
+    if (!_h5) { throw std::logic_error("Model file must be opened before writing values."); }
+
+    const DatasetInfo& info = _getDatasetInfo(path);
+    const size_t ndims = info.dims.size();
+    assert(origin.size() == ndims);
+    assert(dims.size() == ndims);
+
+    bool isAligned = true;
+    for (size_t i = 0; i < ndims; ++i) {
+        if (origin[i] + dims[i] > info.dims[i]) {
+            std::ostringstream msg;
+            msg << "Hyperslab extent in dimension " << i << " (origin: " << origin[i] << ", dim: " << dims[i]
+                << ") exceeds dimension " << info.dims[i] << " of '" << path << "'.";
+            throw std::length_error(msg.str());
+        } // if
+        isAligned = isAligned && (0 == origin[i] % info.chunk[i]) &&
+                    ((0 == dims[i] % info.chunk[i]) || (origin[i] + dims[i] == info.dims[i]));
+    } // for
+
+    if ((_numThreads > 1) && (_compression > 0) && isAligned && HDF5::canWriteChunks() &&
+        _ModelWriter::isLittleEndian()) {
+        _writeChunksParallel(path, info, values, origin, dims);
+    } else {
+        const std::vector<hsize_t> horigin(origin.begin(), origin.end());
+        const std::vector<hsize_t> hdims(dims.begin(), dims.end());
+        _h5->writeDatasetHyperslab(values, path.c_str(), &horigin[0], &hdims[0], int(ndims), H5T_NATIVE_FLOAT);
+    } // if/else
+} // _writeHyperslab
+
+
+// ------------------------------------------------------------------------------------------------
+// Compress chunks of hyperslab in parallel and write them directly to the dataset.
+void
+geomodelgrids::serial::ModelWriter::_writeChunksParallel(const std::string& path,
+                                                         const DatasetInfo& info,
+                                                         const float* values,
+                                                         const std::vector<size_t>& origin,
+                                                         const std::vector<size_t>& dims) {
+    const size_t ndims = dims.size();
+    const std::vector<size_t>& chunk = info.chunk;
+
+    std::vector<size_t> numChunks(ndims);
+    size_t numChunksTotal = 1;
+    size_t chunkSize = 1;
+    for (size_t i = 0; i < ndims; ++i) {
+        numChunks[i] = (dims[i] + chunk[i] - 1) / chunk[i];
+        numChunksTotal *= numChunks[i];
+        chunkSize *= chunk[i];
+    } // for
+
+    std::vector<std::vector<Bytef> > compressed(numChunksTotal);
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<bool> failed(false);
+
+    // Gather each chunk from the hyperslab (padding chunks that extend past the edge of the dataset with zeros)
+    // and compress it the same way as the HDF5 deflate filter.
+    auto compressChunks = [&](void) {
+        std::vector<float> buffer(chunkSize);
+        std::vector<size_t> offset(ndims);
+        std::vector<size_t> extent(ndims);
+        std::vector<size_t> index(ndims);
+        for (size_t iChunk = nextChunk++; iChunk < numChunksTotal && !failed; iChunk = nextChunk++) {
+            for (size_t i = ndims, remainder = iChunk; i-- > 0;) {
+                offset[i] = (remainder % numChunks[i]) * chunk[i];
+                extent[i] = std::min(chunk[i], dims[i] - offset[i]);
+                remainder /= numChunks[i];
+            } // for
+
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            const size_t numRows = chunkSize / chunk[ndims-1];
+            for (size_t iRow = 0; iRow < numRows; ++iRow) {
+                bool inSlab = true;
+                for (size_t i = ndims-1, remainder = iRow; i-- > 0;) {
+                    index[i] = remainder % chunk[i];
+                    remainder /= chunk[i];
+                    inSlab = inSlab && (index[i] < extent[i]);
+                } // for
+                if (!inSlab) { continue; }
+
+                size_t iSrc = 0;
+                for (size_t i = 0; i < ndims-1; ++i) {
+                    iSrc = (iSrc + offset[i] + index[i]) * dims[i+1];
+                } // for
+                iSrc += offset[ndims-1];
+                std::memcpy(&buffer[iRow*chunk[ndims-1]], &values[iSrc], extent[ndims-1]*sizeof(float));
+            } // for
+
+            const uLong srcBytes = chunkSize * sizeof(float);
+            uLongf dstBytes = compressBound(srcBytes);
+            std::vector<Bytef>& dst = compressed[iChunk];
+            dst.resize(dstBytes);
+            if (Z_OK != compress2(&dst[0], &dstBytes, reinterpret_cast<const Bytef*>(&buffer[0]), srcBytes,
+                                  _compression)) {
+                failed = true;
+                break;
+            } // if
+            dst.resize(dstBytes);
+        } // for
+    };
+
+    const size_t numThreads = std::min(_numThreads, numChunksTotal);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.push_back(std::thread(compressChunks));
+    } // for
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    } // for
+    if (failed) {
+        std::ostringstream msg;
+        msg << "Could not compress chunks of '" << path << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    std::vector<hsize_t> chunkOffset(ndims);
+    for (size_t iChunk = 0; iChunk < numChunksTotal; ++iChunk) {
+        for (size_t i = ndims, remainder = iChunk; i-- > 0;) {
+            chunkOffset[i] = origin[i] + (remainder % numChunks[i]) * chunk[i];
+            remainder /= numChunks[i];
+        } // for
+        _h5->writeDatasetChunk(path.c_str(), &chunkOffset[0], &compressed[iChunk][0], compressed[iChunk].size());
+        std::vector<Bytef>().swap(compressed[iChunk]);
+    } // for
+} // _writeChunksParallel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get dataset layout.
+const geomodelgrids::serial::ModelWriter::DatasetInfo&
+geomodelgrids::serial::ModelWriter::_getDatasetInfo(const std::string& path) const {
+    const std::map<std::string, DatasetInfo>::const_iterator iter = _datasets.find(path);
+    if (iter == _datasets.end()) {
+        std::ostringstream msg;
+        msg << "Dataset '" << path << "' must be created before writing values.";
+        throw std::logic_error(msg.str());
+    } // if
+    return iter->second;
+} // _getDatasetInfo
+
+
+// End of file
@@ -0,0 +1,242 @@
+/** Writer for models stored as HDF5 files.
+ *
+ * Writes the domain attributes, surfaces, and blocks in the layout read by Model. Surfaces and blocks are
+ * created first and then their values are written as one or more hyperslabs, so models larger than memory can
+ * be streamed to the file.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <memory> // HASA std::unique_ptr
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+#include <map> // HASA std::map
+
+class geomodelgrids::serial::ModelWriter {
+    friend class TestModelWriter; // Unit testing
+
+    // PUBLIC STRUCTS -----------------------------------------------------------------------------
+public:
+
+    /// Grid points along one coordinate axis.
+    struct Axis {
+        size_t numPoints; ///< Number of points along axis.
+        double resolution; ///< Uniform grid spacing (m) (0 for variable spacing).
+        std::vector<double> coordinates; ///< Coordinates of points for variable spacing (empty for uniform spacing).
+
+        /** Create axis with uniform grid spacing.
+         *
+         * @param[in] numPoints Number of points along axis.
+         * @param[in] resolution Grid spacing (m).
+         * @returns Axis.
+         */
+        static
+        Axis uniform(const size_t numPoints,
+                     const double resolution);
+
+        /** Create axis with variable grid spacing.
+         *
+         * @param[in] coordinates Coordinates of points along axis (for z, elevations of points).
+         * @returns Axis.
+         */
+        static
+        Axis variable(const std::vector<double>& coordinates);
+
+    }; // Axis
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    ModelWriter(void);
+
+    /// Destructor
+    ~ModelWriter(void);
+
+    /** Set deflate (gzip) compression level for surfaces and blocks.
+     *
+     * Must be called before creating surfaces and blocks.
+     *
+     * @param[in] value Compression level (0-9, 0 for no compression).
+     */
+    void setCompression(const int value);
+
+    /** Set number of threads used to compress chunks.
+     *
+     * With more than one thread and compression on, chunks in hyperslabs aligned with the chunk boundaries are
+     * compressed in parallel and written directly to the file (requires HDF5 v1.10.3 or later). Otherwise,
+     * values are written through the HDF5 filter pipeline.
+     *
+     * @param[in] value Number of threads.
+     */
+    void setNumThreads(const size_t value);
+
+    /** Create model file, replacing any existing file.
+     *
+     * @param[in] filename Name of model file.
+     */
+    void open(const char* filename);
+
+    /// Close model file.
+    void close(void);
+
+    /** Write model metadata.
+     *
+     * @param[in] info Model metadata.
+     */
+    void writeInfo(const geomodelgrids::serial::ModelInfo& info);
+
+    /** Write model domain.
+     *
+     * Must be called before creating blocks.
+     *
+     * @param[in] valueNames Names of values stored in blocks.
+     * @param[in] valueUnits Units of values stored in blocks.
+     * @param[in] crs Model CRS as string (PROJ, EPSG, WKT).
+     * @param[in] origin Origin of model in CRS [x, y].
+     * @param[in] yAzimuth Azimuth (degrees) of y axis from north.
+     * @param[in] dims Dimensions of model [x, y, z].
+     */
+    void writeDomain(const std::vector<std::string>& valueNames,
+                     const std::vector<std::string>& valueUnits,
+                     const std::string& crs,
+                     const double origin[2],
+                     const double yAzimuth,
+                     const double dims[3]);
+
+    /** Create surface.
+     *
+     * @param[in] name Name of surface ('top_surface' or 'topography_bathymetry').
+     * @param[in] x Grid points along x axis.
+     * @param[in] y Grid points along y axis.
+     * @param[in] chunk Dimensions of chunks [x, y] (nullptr for default).
+     */
+    void createSurface(const char* name,
+                       const Axis& x,
+                       const Axis& y,
+                       const size_t* chunk=nullptr);
+
+    /** Write hyperslab of surface elevations.
+     *
+     * @param[in] name Name of surface.
+     * @param[in] elevation Elevations in hyperslab [x][y] in C order.
+     * @param[in] origin Origin of hyperslab [x, y].
+     * @param[in] dims Dimensions of hyperslab [x, y].
+     */
+    void writeSurface(const char* name,
+                      const float* elevation,
+                      const size_t origin[2],
+                      const size_t dims[2]);
+
+    /** Create block.
+     *
+     * @param[in] name Name of block.
+     * @param[in] x Grid points along x axis.
+     * @param[in] y Grid points along y axis.
+     * @param[in] z Grid points along z axis.
+     * @param[in] zTop Elevation of top of block (ignored for variable grid spacing along z axis).
+     * @param[in] chunk Dimensions of chunks [x, y, z] (nullptr for default).
+     */
+    void createBlock(const char* name,
+                     const Axis& x,
+                     const Axis& y,
+                     const Axis& z,
+                     const double zTop,
+                     const size_t* chunk=nullptr);
+
+    /** Write hyperslab of block values.
+     *
+     * @param[in] name Name of block.
+     * @param[in] values Values in hyperslab [x][y][z][value] in C order.
+     * @param[in] origin Origin of hyperslab [x, y, z].
+     * @param[in] dims Dimensions of hyperslab [x, y, z].
+     */
+    void writeBlock(const char* name,
+                    const float* values,
+                    const size_t origin[3],
+                    const size_t dims[3]);
+
+    // PRIVATE STRUCTS ----------------------------------------------------------------------------
+private:
+
+    /// Layout of dataset in file.
+    struct DatasetInfo {
+        std::vector<size_t> dims; ///< Dimensions of dataset.
+        std::vector<size_t> chunk; ///< Dimensions of chunks.
+    }; // DatasetInfo
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Write grid spacing attributes for axis.
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] axisName Name of axis ('x', 'y', or 'z').
+     * @param[in] axis Grid points along axis.
+     */
+    void _writeAxis(const char* path,
+                    const char* axisName,
+                    const Axis& axis);
+
+    /** Create dataset and remember its layout.
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] dims Dimensions of dataset.
+     * @param[in] chunk Dimensions of chunks.
+     */
+    void _createDataset(const std::string& path,
+                        const std::vector<size_t>& dims,
+                        const std::vector<size_t>& chunk);
+
+    /** Write hyperslab of values to dataset.
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] values Values in hyperslab in C order.
+     * @param[in] origin Origin of hyperslab.
+     * @param[in] dims Dimensions of hyperslab.
+     */
+    void _writeHyperslab(const std::string& path,
+                         const float* values,
+                         const std::vector<size_t>& origin,
+                         const std::vector<size_t>& dims);
+
+    /** Compress chunks of hyperslab in parallel and write them directly to the dataset.
+     *
+     * @param[in] path Full path to dataset.
+     * @param[in] info Layout of dataset.
+     * @param[in] values Values in hyperslab in C order.
+     * @param[in] origin Origin of hyperslab (aligned with chunks).
+     * @param[in] dims Dimensions of hyperslab.
+     */
+    void _writeChunksParallel(const std::string& path,
+                              const DatasetInfo& info,
+                              const float* values,
+                              const std::vector<size_t>& origin,
+                              const std::vector<size_t>& dims);
+
+    /** Get dataset layout.
+     *
+     * @param[in] path Full path to dataset.
+     * @returns Layout of dataset.
+     */
+    const DatasetInfo& _getDatasetInfo(const std::string& path) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::unique_ptr<geomodelgrids::serial::HDF5> _h5; ///< HDF5 file.
+    std::map<std::string, DatasetInfo> _datasets; ///< Layout of datasets created in file.
+    size_t _numValues; ///< Number of values in blocks (0 if domain has not been written).
+    size_t _numThreads; ///< Number of threads used to compress chunks.
+    int _compression; ///< Deflate compression level.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    ModelWriter(const ModelWriter&); ///< Not implemented
+    const ModelWriter& operator=(const ModelWriter&); ///< Not implemented
+
+}; // ModelWriter
+
+// End of file
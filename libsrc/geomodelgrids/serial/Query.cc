@@ -3,17 +3,25 @@
 #include "Query.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/ModelIndex.hh" // USES ModelIndex
+#include "geomodelgrids/serial/MetadataCache.hh" // USES MetadataCache
+#include "geomodelgrids/serial/SharedChunkCache.hh" // USES SharedChunkCache
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Block.hh" // USES Block
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab::DEFAULT_MAX_BYTES
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include <getopt.h> // USES getopt_long()
-#include <algorithm> // USES std::transform
+#include <algorithm> // USES std::transform, std::sort(), std::upper_bound()
+#include <functional> // USES std::greater
 #include <cctype> // USES std::lower
 #include <cassert> // USES assert()
+#include <stdexcept> // USES std::length_error
 #include <sstream> // USES std::ostringstream, std::istringstream
+#include <mutex> // USES std::mutex, std::lock_guard
 
 // ------------------------------------------------------------------------------------------------
 namespace geomodelgrids {
@@ -25,6 +33,8 @@ namespace geomodelgrids {
 class geomodelgrids::serial::_Query {
 public:
 
+    static std::mutex initializeMutex; ///< Serializes opening models for querying across threads.
+
     /** Transform array of strings to lowercase.
      *
      * @param[in] strings Array of strings.
@@ -34,14 +44,47 @@ public:
     std::vector<std::string> toLower(const std::vector<std::string>& strings);
 
     /** Create map from index of query values to index of values in model.
-     * @param[in] model Model to query.
+     * @param[in] modelTitle Title of model.
+     * @param[in] modelNames Names of values in model.
      * @param[in] queryNamesLower Array of lowercase names of values to query.
      * @returns Map of value indices for query values.
      */
     static
-    geomodelgrids::serial::Query::values_map_type createModelValuesIndex(const geomodelgrids::serial::Model& model,
+    geomodelgrids::serial::Query::values_map_type createModelValuesIndex(const std::string& modelTitle,
+                                                                         const std::vector<std::string>& modelNames,
                                                                          const std::vector<std::string>& queryNamesLower);
 
+    /** Create model with query settings and load its metadata.
+     *
+     * @param[in] query Query with settings.
+     * @param[in] index Index of model.
+     * @returns Model.
+     */
+    static
+    std::unique_ptr<geomodelgrids::serial::Model> createModel(const geomodelgrids::serial::Query& query,
+                                                              const size_t index);
+
+    /** Get model, opening it for querying on first use.
+     *
+     * @param[inout] query Query with models.
+     * @param[in] index Index of model.
+     * @returns Model.
+     */
+    static
+    geomodelgrids::serial::Model* getModel(geomodelgrids::serial::Query& query,
+                                           const size_t index);
+
+    /** Replace metadata of model that does not match the metadata from the metadata cache.
+     *
+     * The values index and spatial index are rebuilt as needed and the cache entry is updated.
+     *
+     * @param[inout] query Query with models.
+     * @param[in] index Index of model.
+     */
+    static
+    void updateMetadata(geomodelgrids::serial::Query& query,
+                        const size_t index);
+
     /** Check consistency of units in model.
      *
      * @param[in] valueUnits Map from index of query value to units.
@@ -58,14 +101,176 @@ public:
     static
     unsigned char tolower(unsigned char c);
 
+    /** Convert elevation in input CRS to elevation in squashed input CRS.
+     *
+     * @param[in] query Query with squashing parameters.
+     * @param[in] squashElev Elevation (m) of surface used for squashing.
+     * @param[in] z Elevation (m) in input CRS.
+     * @returns Elevation (m) in squashed input CRS.
+     */
+    static
+    double squash(const geomodelgrids::serial::Query& query,
+                  const double squashElev,
+                  const double z);
+
+    /** Convert elevation in squashed input CRS to elevation in input CRS.
+     *
+     * @param[in] query Query with squashing parameters.
+     * @param[in] squashElev Elevation (m) of surface used for squashing.
+     * @param[in] zSquash Elevation (m) in squashed input CRS.
+     * @returns Elevation (m) in input CRS.
+     */
+    static
+    double unsquash(const geomodelgrids::serial::Query& query,
+                    const double squashElev,
+                    const double zSquash);
+
+    /** Interpolate values along model column.
+     *
+     * @param[out] values Array of query values.
+     * @param[in] column Grid points along column in model.
+     * @param[in] modelMap Map from index of query value to index of model value.
+     * @param[in] numModelValues Number of values in model.
+     * @param[in] zSquash Elevation (m) in squashed input CRS where values are interpolated.
+     * @param[in] zSquashSegment Elevation (m) in squashed input CRS selecting the pair of grid points.
+     */
+    static
+    void interpolateColumn(double* values,
+                           const geomodelgrids::serial::Query::ModelColumn& column,
+                           geomodelgrids::serial::Query::values_map_type& modelMap,
+                           const size_t numModelValues,
+                           const double zSquash,
+                           const double zSquashSegment);
+
+    /** Query models for values at point.
+     *
+     * Values are converted to the type of the output array as they are copied from the model.
+     *
+     * @param[inout] query Query with models.
+     * @param[out] values Values at point.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @returns 0 on success, 1 if point is outside all models, 2 on error.
+     */
+    template<typename T>
+    static
+    int queryPoint(geomodelgrids::serial::Query& query,
+                   T* const values,
+                   const double x,
+                   const double y,
+                   const double z);
+
+    /** Query models for values at many points.
+     *
+     * @param[inout] query Query with models and work arrays.
+     * @param[out] values Values at points.
+     * @param[in] valuesStride Number of values between the starts of consecutive points.
+     * @param[in] x X coordinates of points (in input CRS).
+     * @param[in] y Y coordinates of points (in input CRS).
+     * @param[in] z Z coordinates of points (in input CRS).
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status for each point (can be nullptr).
+     * @param[out] numOutside Number of points outside all models (can be nullptr).
+     * @returns 0 if all points are found, 1 if any points are outside all models, 2 on error.
+     */
+    template<typename T>
+    static
+    int queryPoints(geomodelgrids::serial::Query& query,
+                    T* const values,
+                    const size_t valuesStride,
+                    const double* const x,
+                    const double* const y,
+                    const double* const z,
+                    const size_t pointsStride,
+                    const size_t numPoints,
+                    int* const status,
+                    size_t* const numOutside);
+
+    /** Query models for values at a batch of points.
+     *
+     * Values are converted to the type of the output array as they are copied from the model.
+     *
+     * @param[inout] query Query with models and work arrays.
+     * @param[out] values Values at points.
+     * @param[in] valuesStride Number of values between the starts of consecutive points.
+     * @param[in] x X coordinates of points (in input CRS).
+     * @param[in] y Y coordinates of points (in input CRS).
+     * @param[in] z Z coordinates of points (in input CRS).
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status for each point (can be nullptr).
+     * @returns Number of points found in a model.
+     */
+    template<typename T>
+    static
+    size_t queryBatch(geomodelgrids::serial::Query& query,
+                      T* const values,
+                      const size_t valuesStride,
+                      const double* const x,
+                      const double* const y,
+                      const double* const z,
+                      const size_t pointsStride,
+                      const size_t numPoints,
+                      int* const status);
+
+    /** Query models for elevation of surface at a batch of points.
+     *
+     * @param[inout] query Query with models and work arrays.
+     * @param[out] elevations Elevations (m) of surface at points.
+     * @param[in] points Coordinates of points (in input CRS) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     * @param[in] topoBathy True for topography/bathymetry, false for top surface.
+     */
+    static
+    void queryElevationsBatch(geomodelgrids::serial::Query& query,
+                              double* const elevations,
+                              const double* const points,
+                              const size_t numPoints,
+                              const bool topoBathy);
+
+    /** Reset work arrays for a batch of points.
+     *
+     * @param[inout] query Query with models and work arrays.
+     * @param[in] numPoints Number of points in batch.
+     */
+    static
+    void startBatch(geomodelgrids::serial::Query& query,
+                    const size_t numPoints);
+
+    /** Queue point for the next of its candidate models whose bounding box contains the point.
+     *
+     * Candidate models are in priority order, so a point is checked against each model at most once and the
+     * first model containing the point wins. Points without more candidate models are not queued.
+     *
+     * @param[inout] query Query with models and work arrays.
+     * @param[in] iPt Index of point in batch.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     */
+    static
+    void queueNextModel(geomodelgrids::serial::Query& query,
+                        const size_t iPt,
+                        const double x,
+                        const double y);
+
 }; // _Query
 
+std::mutex geomodelgrids::serial::_Query::initializeMutex;
+
 // ------------------------------------------------------------------------------------------------
 // Constructor
 geomodelgrids::serial::Query::Query() :
+    _sharedCacheBytes(SharedChunkCache::DEFAULT_CACHE_BYTES),
+    _sharedCacheSlotBytes(SharedChunkCache::DEFAULT_SLOT_BYTES),
     _squashMinElev(0.0),
     _errorHandler(std::make_shared<geomodelgrids::utils::ErrorHandler>()),
-    _squash(SQUASH_NONE) {}
+    _squash(SQUASH_NONE),
+    _hyperslabMaxBytes(geomodelgrids::serial::Hyperslab::DEFAULT_MAX_BYTES),
+    _hyperslabPrefetch(false),
+    _queryResolution(0.0),
+    _modelIndex(std::make_unique<geomodelgrids::serial::ModelIndex>()) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -97,26 +302,194 @@ geomodelgrids::serial::Query::initialize(const std::vector<std::string>& modelFi
         _models[i].reset();
     } // for
 
+    _sharedCache.reset();
+    if (!_sharedCacheName.empty()) {
+        _sharedCache = std::make_unique<geomodelgrids::serial::SharedChunkCache>();
+        _sharedCache->open(_sharedCacheName.c_str(), _sharedCacheBytes, _sharedCacheSlotBytes);
+    } // if
+
     const size_t numModels = modelFilenames.size();
+    _modelFilenames = modelFilenames;
+    _inputCRSString = inputCRSString;
     _models.resize(numModels);
+    _modelsInitialized.assign(numModels, false);
     _valuesIndex.resize(numModels);
-    std::map<size_t, std::string> valueUnits;
+
+    // Models without a metadata cache entry are opened and their metadata is loaded here, so missing or invalid
+    // model files are detected immediately. The cache key includes a fingerprint of the model file, so models with
+    // a cache entry are not opened until they are queried. Blocks and surfaces are always opened lazily.
+    geomodelgrids::serial::MetadataCache cache;
+    if (!_metadataCacheFilename.empty()) {
+        cache.load(_metadataCacheFilename.c_str());
+    } // if
+    _valueUnits.clear();
+    _bboxes.resize(numModels*4);
+    _metadata.resize(numModels);
+    _metadataCacheKeys.assign(numModels, std::string());
     for (size_t iModel = 0; iModel < numModels; ++iModel) {
-        _models[iModel] = std::make_unique<geomodelgrids::serial::Model>();assert(_models[iModel]);
-        _models[iModel]->setInputCRS(inputCRSString);
-        _models[iModel]->open(modelFilenames[iModel].c_str(), geomodelgrids::serial::Model::READ);
-        _models[iModel]->loadMetadata();
-        _models[iModel]->initialize();
+        const std::string key = (_metadataCacheFilename.empty()) ? std::string() :
+                                MetadataCache::createKey(modelFilenames[iModel].c_str(), inputCRSString);
+        _metadataCacheKeys[iModel] = key;
+        const MetadataCache::Entry* cached = (key.empty()) ? nullptr : cache.find(key);
+        MetadataCache::Entry& entry = _metadata[iModel];
+        if (cached) {
+            entry = *cached;
+            cache.touch(key);
+        } else {
+            _models[iModel] = _Query::createModel(*this, iModel);assert(_models[iModel]);
+            _models[iModel]->initializeDomain();
+            entry.title = _models[iModel]->getInfo()->getTitle();
+            entry.valueNames = _models[iModel]->getValueNames();
+            entry.valueUnits = _models[iModel]->getValueUnits();
+            const double* bbox = _models[iModel]->getBoundingBox();
+            std::copy(bbox, bbox+4, entry.bbox);
+            if (!key.empty()) {
+                cache.insert(key, entry);
+            } // if
+        } // if/else
 
-        _valuesIndex[iModel] = _Query::createModelValuesIndex(*_models[iModel], _valuesLowercase);
+        _valuesIndex[iModel] = _Query::createModelValuesIndex(entry.title, entry.valueNames, _valuesLowercase);
 
-        const std::vector<std::string>& modelValues = _models[iModel]->getValueNames();
-        const std::vector<std::string>& modelUnitsLower = _Query::toLower(_models[iModel]->getValueUnits());
-        _Query::checkUnits(&valueUnits, _valuesIndex[iModel], modelValues, modelUnitsLower);
+        const std::vector<std::string>& modelUnitsLower = _Query::toLower(entry.valueUnits);
+        _Query::checkUnits(&_valueUnits, _valuesIndex[iModel], entry.valueNames, modelUnitsLower);
+        std::copy(entry.bbox, entry.bbox+4, &_bboxes[iModel*4]);
     } // for
+    cache.save();
+
+    _staleModelIndices.clear();
+    _modelIndex->initialize(_bboxes.data(), numModels);
 } // initialize
 
 
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying blocks.
+void
+geomodelgrids::serial::Query::setBlockHyperslabDims(const size_t dims[],
+                                                    const size_t ndims) {
+    if (3 != ndims) {
+        std::ostringstream msg;
+        msg << "Expected array of length 3 for block hyperslab dimensions, got array of length " << ndims << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    _blockHyperslabDims.assign(dims, dims+ndims);
+} // setBlockHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying surfaces.
+void
+geomodelgrids::serial::Query::setSurfaceHyperslabDims(const size_t dims[],
+                                                      const size_t ndims) {
+    if (2 != ndims) {
+        std::ostringstream msg;
+        msg << "Expected array of length 2 for surface hyperslab dimensions, got array of length " << ndims << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    _surfaceHyperslabDims.assign(dims, dims+ndims);
+} // setSurfaceHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for automatically sized hyperslab dimensions.
+void
+geomodelgrids::serial::Query::setHyperslabMaxBytes(const size_t value) {
+    _hyperslabMaxBytes = value;
+} // setHyperslabMaxBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::Query::setHyperslabPrefetch(const bool value) {
+    _hyperslabPrefetch = value;
+} // setHyperslabPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set horizontal resolution needed by queries.
+void
+geomodelgrids::serial::Query::setQueryResolution(const double value) {
+    if (value < 0.0) {
+        std::ostringstream msg;
+        msg << "Query resolution (" << value << ") must be nonnegative.";
+        throw std::invalid_argument(msg.str().c_str());
+    } // if
+    _queryResolution = value;
+} // setQueryResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Set file used to cache model metadata between runs.
+void
+geomodelgrids::serial::Query::setMetadataCache(const char* filename) {
+    _metadataCacheFilename = (filename) ? filename : "";
+} // setMetadataCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Set POSIX shared memory cache of model chunks shared by processes on the same node.
+void
+geomodelgrids::serial::Query::setSharedCache(const char* name,
+                                             const size_t cacheBytes,
+                                             const size_t slotBytes) {
+    _sharedCacheName = (name) ? name : "";
+    _sharedCacheBytes = cacheBytes;
+    _sharedCacheSlotBytes = slotBytes;
+} // setSharedCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Read model from an image of the model file in memory.
+void
+geomodelgrids::serial::Query::setModelFileImage(const char* filename,
+                                                const void* const image,
+                                                const size_t numBytes) {
+    assert(filename);
+    if (image) {
+        _modelFileImages[filename] = std::make_pair(image, numBytes);
+    } else {
+        _modelFileImages.erase(filename);
+    } // if/else
+} // setModelFileImage
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn collecting query statistics on/off.
+void
+geomodelgrids::serial::Query::setStatsOn(const bool value) {
+    if (!_models.empty()) {
+        throw std::logic_error("Collecting query statistics must be turned on/off before calling initialize().");
+    } // if
+    if (value && !_stats) {
+        _stats = std::make_shared<geomodelgrids::serial::QueryStats>();
+    } else if (!value) {
+        _stats.reset();
+    } // if/else
+} // setStatsOn
+
+
+// ------------------------------------------------------------------------------------------------
+// Get query statistics.
+std::shared_ptr<geomodelgrids::serial::QueryStats>&
+geomodelgrids::serial::Query::getStats(void) {
+    return _stats;
+} // getStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Reset query statistics to zero.
+void
+geomodelgrids::serial::Query::resetStats(void) {
+    if (_stats) {
+        _stats->reset();
+    } // if
+} // resetStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Turn on squashing and set minimum z for squashing.
 void
@@ -151,10 +524,15 @@ geomodelgrids::serial::Query::queryTopElevation(const double x,
                                                 const double y) {
     double elevation = NODATA_VALUE;
     const double zOffset = -1.0e-3;
-    for (size_t i = 0; i < _models.size(); ++i) {
-        assert(_models[i]);
-        const double elevationTmp = _models[i]->queryTopElevation(x, y);
-        if (_models[i]->contains(x, y, elevationTmp+zOffset)) {
+    const std::vector<size_t>& candidates = _modelIndex->getCandidates(x, y);
+    for (size_t iCandidate = 0; iCandidate < candidates.size(); ++iCandidate) {
+        const size_t i = candidates[iCandidate];
+        if (!_modelIndex->inBoundingBox(i, x, y)) {
+            continue;
+        } // if
+        Model* model = _Query::getModel(*this, i);assert(model);
+        const double elevationTmp = model->queryTopElevation(x, y);
+        if (model->contains(x, y, elevationTmp+zOffset)) {
             elevation = elevationTmp;
             break;
         } // if
@@ -171,10 +549,15 @@ geomodelgrids::serial::Query::queryTopoBathyElevation(const double x,
                                                       const double y) {
     double elevation = NODATA_VALUE;
     const double zOffset = -1.0e-3;
-    for (size_t i = 0; i < _models.size(); ++i) {
-        assert(_models[i]);
-        const double elevationTmp = _models[i]->queryTopoBathyElevation(x, y);
-        if (_models[i]->contains(x, y, elevationTmp+zOffset)) {
+    const std::vector<size_t>& candidates = _modelIndex->getCandidates(x, y);
+    for (size_t iCandidate = 0; iCandidate < candidates.size(); ++iCandidate) {
+        const size_t i = candidates[iCandidate];
+        if (!_modelIndex->inBoundingBox(i, x, y)) {
+            continue;
+        } // if
+        Model* model = _Query::getModel(*this, i);assert(model);
+        const double elevationTmp = model->queryTopoBathyElevation(x, y);
+        if (model->contains(x, y, elevationTmp+zOffset)) {
             elevation = elevationTmp;
             break;
         } // if
@@ -184,14 +567,43 @@ geomodelgrids::serial::Query::queryTopoBathyElevation(const double x,
 } // queryTopoBathyElevation
 
 
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at many points.
+void
+geomodelgrids::serial::Query::queryTopElevations(double* const elevations,
+                                                 const double* const points,
+                                                 const size_t numPoints) {
+    const size_t maxBatchSize = 4096;
+    for (size_t iStart = 0; iStart < numPoints; iStart += maxBatchSize) {
+        const size_t batchSize = std::min(maxBatchSize, numPoints - iStart);
+        _Query::queryElevationsBatch(*this, &elevations[iStart], &points[2*iStart], batchSize, false);
+    } // for
+} // queryTopElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at many points.
+void
+geomodelgrids::serial::Query::queryTopoBathyElevations(double* const elevations,
+                                                       const double* const points,
+                                                       const size_t numPoints) {
+    const size_t maxBatchSize = 4096;
+    for (size_t iStart = 0; iStart < numPoints; iStart += maxBatchSize) {
+        const size_t batchSize = std::min(maxBatchSize, numPoints - iStart);
+        _Query::queryElevationsBatch(*this, &elevations[iStart], &points[2*iStart], batchSize, true);
+    } // for
+} // queryTopoBathyElevations
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for model index of containing model at given point.
 int
 geomodelgrids::serial::Query::queryModelContains(const double x,
                                                  const double y) {
-    for (size_t i = 0; i < _models.size(); ++i) {
-        assert(_models[i]);
-        if (_models[i]->containsIn(x, y)) {
+    const std::vector<size_t>& candidates = _modelIndex->getCandidates(x, y);
+    for (size_t iCandidate = 0; iCandidate < candidates.size(); ++iCandidate) {
+        const size_t i = candidates[iCandidate];
+        if (_modelIndex->inBoundingBox(i, x, y) && _Query::getModel(*this, i)->containsIn(x, y)) {
           return i;
         } // if
     } // for
@@ -207,55 +619,181 @@ geomodelgrids::serial::Query::query(double* const values,
                                     const double x,
                                     const double y,
                                     const double z) {
-    if (!values) {
+    return _Query::queryPoint(*this, values, x, y, z);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at point with single precision values.
+int
+geomodelgrids::serial::Query::query(float* const values,
+                                    const double x,
+                                    const double y,
+                                    const double z) {
+    return _Query::queryPoint(*this, values, x, y, z);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at many points.
+int
+geomodelgrids::serial::Query::queryPoints(double* const values,
+                                          const size_t valuesStride,
+                                          const double* const x,
+                                          const double* const y,
+                                          const double* const z,
+                                          const size_t pointsStride,
+                                          const size_t numPoints,
+                                          int* const status,
+                                          size_t* const numOutside) {
+    return _Query::queryPoints(*this, values, valuesStride, x, y, z, pointsStride, numPoints, status, numOutside);
+} // queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for single precision values at many points.
+int
+geomodelgrids::serial::Query::queryPoints(float* const values,
+                                          const size_t valuesStride,
+                                          const double* const x,
+                                          const double* const y,
+                                          const double* const z,
+                                          const size_t pointsStride,
+                                          const size_t numPoints,
+                                          int* const status,
+                                          size_t* const numOutside) {
+    return _Query::queryPoints(*this, values, valuesStride, x, y, z, pointsStride, numPoints, status, numOutside);
+} // queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values along vertical column.
+int
+geomodelgrids::serial::Query::queryColumn(std::vector<double>* elevations,
+                                          std::vector<double>* values,
+                                          const double x,
+                                          const double y,
+                                          const double zTop,
+                                          const double zBottom) {
+    if (!elevations || !values) {
         assert(_errorHandler);
-        _errorHandler->setError("geomodelgrids::serial::Query::query() passed nullptr for values argument.");
+        _errorHandler->setError("geomodelgrids::serial::Query::queryColumn() passed nullptr for elevations or "
+                                "values argument.");
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
     if (!_valuesLowercase.size()) {
         assert(_errorHandler);
-        _errorHandler->setError("geomodelgrids::serial::Query::query() not initialized.");
+        _errorHandler->setError("geomodelgrids::serial::Query::queryColumn() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (zTop <= zBottom) {
+        std::ostringstream msg;
+        msg << "Elevation of top of column (" << zTop << ") must be above elevation of bottom of column ("
+            << zBottom << ").";
+        assert(_errorHandler);
+        _errorHandler->setError(msg.str().c_str());
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
 
-    const size_t numQueryValues = _valuesLowercase.size();
-    std::fill(values, values+numQueryValues, NODATA_VALUE);
-    bool found = false;
-    for (size_t i = 0; i < _models.size(); ++i) {
-        assert(_models[i]);
-        double zSquash = z;
+    // Gather grid points along column in each model containing the column. The elevations where the values may
+    // change slope (grid points, squashing elevation, and ends of column) split the column into segments.
+    size_t numColumns = 0;
+    _columnBreaks.clear();
+    _columnBreaks.push_back(zTop);
+    _columnBreaks.push_back(zBottom);
+    if ((SQUASH_NONE != _squash) && (_squashMinElev < zTop) && (_squashMinElev > zBottom)) {
+        _columnBreaks.push_back(_squashMinElev);
+    } // if
+    const std::vector<size_t>& candidates = _modelIndex->getCandidates(x, y);
+    for (size_t iCandidate = 0; iCandidate < candidates.size(); ++iCandidate) {
+        const size_t i = candidates[iCandidate];
+        if (!_modelIndex->inBoundingBox(i, x, y)) {
+            continue;
+        } // if
+        Model* model = _Query::getModel(*this, i);assert(model);
+        if (!model->containsIn(x, y)) {
+            continue;
+        } // if
+        if (numColumns == _columns.size()) {
+            _columns.resize(numColumns+1);
+        } // if
+        ModelColumn& column = _columns[numColumns++];
+        column.model = i;
         switch (_squash) {
         case SQUASH_NONE:
+            column.squashElev = 0.0;
             break;
         case SQUASH_TOP_SURFACE:
-            if (z > _squashMinElev) {
-                const double topElev = _models[i]->queryTopElevation(x, y);
-                zSquash = topElev + z * (_squashMinElev - topElev) / _squashMinElev;
-            } // if
+            column.squashElev = model->queryTopElevation(x, y);
             break;
         case SQUASH_TOPOGRAPHY_BATHYMETRY:
-            if (z > _squashMinElev) {
-                const double groundElev = _models[i]->queryTopoBathyElevation(x, y);
-                zSquash = groundElev + z * (_squashMinElev - groundElev) / _squashMinElev;
-            } // if
+            column.squashElev = model->queryTopoBathyElevation(x, y);
             break;
         default:
             throw std::logic_error("Unknown squashing type.");
         } // switch
-        if (_models[i]->contains(x, y, zSquash)) {
-            const double* modelValues = _models[i]->query(x, y, zSquash);
-            values_map_type& modelMap = _valuesIndex[i];
-            for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
-                values[iValue] = modelValues[modelMap[iValue]];
-            } // for
+        model->queryColumn(&column.elevations, &column.values, x, y);
+        for (size_t iPt = 0; iPt < column.elevations.size(); ++iPt) {
+            const double z = _Query::unsquash(*this, column.squashElev, column.elevations[iPt]);
+            if ((z < zTop) && (z > zBottom)) {
+                _columnBreaks.push_back(z);
+            } // if
+        } // for
+    } // for
+    std::sort(_columnBreaks.begin(), _columnBreaks.end(), std::greater<double>());
+    _columnBreaks.erase(std::unique(_columnBreaks.begin(), _columnBreaks.end()), _columnBreaks.end());
+
+    // Values in each segment come from the first model containing it (as in query()).
+    const size_t numQueryValues = _valuesLowercase.size();
+    std::vector<double> valuesTop(numQueryValues);
+    std::vector<double> valuesBot(numQueryValues);
+    elevations->clear();
+    values->clear();
+    bool found = false;
+    for (size_t iSeg = 0; iSeg+1 < _columnBreaks.size(); ++iSeg) {
+        const double zSegTop = _columnBreaks[iSeg];
+        const double zSegBot = _columnBreaks[iSeg+1];
+        const double zSegMid = 0.5 * (zSegTop + zSegBot);
 
+        std::fill(valuesTop.begin(), valuesTop.end(), NODATA_VALUE);
+        std::fill(valuesBot.begin(), valuesBot.end(), NODATA_VALUE);
+        for (size_t iColumn = 0; iColumn < numColumns; ++iColumn) {
+            const ModelColumn& column = _columns[iColumn];
+            const double zSquashMid = _Query::squash(*this, column.squashElev, zSegMid);
+            if (column.elevations.empty() || (zSquashMid > column.elevations.front()) ||
+                (zSquashMid < column.elevations.back())) {
+                continue;
+            } // if
+            const size_t numModelValues = column.values.size() / column.elevations.size();
+            _Query::interpolateColumn(&valuesTop[0], column, _valuesIndex[column.model], numModelValues,
+                                      _Query::squash(*this, column.squashElev, zSegTop), zSquashMid);
+            _Query::interpolateColumn(&valuesBot[0], column, _valuesIndex[column.model], numModelValues,
+                                      _Query::squash(*this, column.squashElev, zSegBot), zSquashMid);
             found = true;
             break;
+        } // for
+
+        // Skip top of segment if it continues the previous segment without a jump.
+        const size_t numPoints = elevations->size();
+        if (!numPoints || !std::equal(valuesTop.begin(), valuesTop.end(), values->end()-numQueryValues)) {
+            elevations->push_back(zSegTop);
+            values->insert(values->end(), valuesTop.begin(), valuesTop.end());
         } // if
+        elevations->push_back(zSegBot);
+        values->insert(values->end(), valuesBot.begin(), valuesBot.end());
     } // for
 
+    if (_stats) {
+        _stats->numPoints += elevations->size();
+        if (found) {
+            _stats->numPointsFound += elevations->size();
+        } else {
+            _stats->numPointsOutside += elevations->size();
+        } // if/else
+    } // if
+
     return found ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
-} // query
+} // queryColumn
 
 
 // ------------------------------------------------------------------------------------------------
@@ -293,9 +831,9 @@ geomodelgrids::serial::_Query::tolower(unsigned char c) {
 
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::serial::Query::values_map_type
-geomodelgrids::serial::_Query::createModelValuesIndex(const geomodelgrids::serial::Model& model,
+geomodelgrids::serial::_Query::createModelValuesIndex(const std::string& modelTitle,
+                                                      const std::vector<std::string>& modelNames,
                                                       const std::vector<std::string>& queryNamesLower) {
-    const std::vector<std::string>& modelNames = model.getValueNames();
     std::vector<std::string> modelNamesLower = _Query::toLower(modelNames);
 
     const size_t numNamesQuery = queryNamesLower.size();
@@ -307,8 +845,7 @@ geomodelgrids::serial::_Query::createModelValuesIndex(const geomodelgrids::seria
             valuesIndex[i] = iter - modelNamesLower.begin();
         } else {
             std::ostringstream msg;
-            const std::shared_ptr<geomodelgrids::serial::ModelInfo>& info = model.getInfo();assert(info);
-            msg << "Model '" << info->getTitle() << "' does not contain requested value '"
+            msg << "Model '" << modelTitle << "' does not contain requested value '"
                 << queryNamesLower[i] << "'. Available values:\n";
             for (size_t j = 0; j < modelNames.size(); ++j) {
                 msg << "    " << modelNames[j] << "\n";
@@ -344,4 +881,521 @@ geomodelgrids::serial::_Query::checkUnits(std::map<size_t,std::string>* valueUni
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// Create model with query settings and load its metadata.
+std::unique_ptr<geomodelgrids::serial::Model>
+geomodelgrids::serial::_Query::createModel(const geomodelgrids::serial::Query& query,
+                                           const size_t index) {
+    std::unique_ptr<Model> model = std::make_unique<geomodelgrids::serial::Model>();assert(model);
+    model->setInputCRS(query._inputCRSString);
+    if (!query._blockHyperslabDims.empty()) {
+        model->setBlockHyperslabDims(&query._blockHyperslabDims[0], query._blockHyperslabDims.size());
+    } // if
+    if (!query._surfaceHyperslabDims.empty()) {
+        model->setSurfaceHyperslabDims(&query._surfaceHyperslabDims[0], query._surfaceHyperslabDims.size());
+    } // if
+    model->setHyperslabMaxBytes(query._hyperslabMaxBytes);
+    model->setHyperslabPrefetch(query._hyperslabPrefetch);
+    model->setQueryResolution(query._queryResolution);
+    model->setStats(query._stats.get());
+    model->setSharedCache(query._sharedCache.get());
+    const std::string& filename = query._modelFilenames[index];
+    if (query._modelFileImages.count(filename)) {
+        const std::pair<const void*, size_t>& image = query._modelFileImages.at(filename);
+        model->setFileImage(image.first, image.second);
+    } // if
+    model->open(filename.c_str(), geomodelgrids::serial::Model::READ);
+    model->loadMetadata();
+
+    return model;
+} // createModel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get model, opening it for querying on first use.
+geomodelgrids::serial::Model*
+geomodelgrids::serial::_Query::getModel(geomodelgrids::serial::Query& query,
+                                        const size_t index) {
+    assert(index < query._models.size());
+    if (!query._modelsInitialized[index]) {
+        // Queries on different threads (for example, isosurface with multiple threads) may open models at the same
+        // time, so opening models for querying is serialized.
+        std::lock_guard<std::mutex> lock(_Query::initializeMutex);
+        if (!query._models[index]) {
+            query._models[index] = createModel(query, index);
+        } // if
+        query._models[index]->initialize();
+        query._modelsInitialized[index] = true;
+
+        // The metadata used to dispatch points may have come from the metadata cache, so make sure it matches the
+        // model.
+        updateMetadata(query, index);
+    } // if
+
+    Model* model = query._models[index].get();assert(model);
+    return model;
+} // getModel
+
+
+// ------------------------------------------------------------------------------------------------
+// Replace metadata of model that does not match the metadata from the metadata cache.
+void
+geomodelgrids::serial::_Query::updateMetadata(geomodelgrids::serial::Query& query,
+                                              const size_t index) {
+    const Model* model = query._models[index].get();assert(model);
+    MetadataCache::Entry entry;
+    entry.title = model->getInfo()->getTitle();
+    entry.valueNames = model->getValueNames();
+    entry.valueUnits = model->getValueUnits();
+    const double* bbox = model->getBoundingBox();
+    std::copy(bbox, bbox+4, entry.bbox);
+
+    MetadataCache::Entry& current = query._metadata[index];
+    const bool sameValues = (entry.title == current.title) && (entry.valueNames == current.valueNames) &&
+                            (entry.valueUnits == current.valueUnits);
+    const bool sameBoundingBox = std::equal(bbox, bbox+4, current.bbox);
+    if (sameValues && sameBoundingBox) {
+        return;
+    } // if
+
+    if (!sameValues) {
+        query._valuesIndex[index] = createModelValuesIndex(entry.title, entry.valueNames, query._valuesLowercase);
+        checkUnits(&query._valueUnits, query._valuesIndex[index], entry.valueNames, toLower(entry.valueUnits));
+    } // if
+    if (!sameBoundingBox) {
+        std::copy(bbox, bbox+4, &query._bboxes[index*4]);
+
+        // Points already dispatched may refer to the candidates in the current index, so it is kept until the next
+        // call to initialize().
+        query._staleModelIndices.push_back(std::move(query._modelIndex));
+        query._modelIndex = std::make_unique<geomodelgrids::serial::ModelIndex>();
+        query._modelIndex->initialize(query._bboxes.data(), query._models.size());
+    } // if
+    current = entry;
+
+    const std::string& key = query._metadataCacheKeys[index];
+    if (!key.empty()) {
+        MetadataCache cache;
+        cache.load(query._metadataCacheFilename.c_str());
+        cache.insert(key, entry);
+        cache.save();
+    } // if
+} // updateMetadata
+
+
+// ------------------------------------------------------------------------------------------------
+// Query models for values at point.
+template<typename T>
+int
+geomodelgrids::serial::_Query::queryPoint(geomodelgrids::serial::Query& query,
+                                          T* const values,
+                                          const double x,
+                                          const double y,
+                                          const double z) {
+    if (!values) {
+        assert(query._errorHandler);
+        query._errorHandler->setError("geomodelgrids::serial::Query::query() passed nullptr for values argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!query._valuesLowercase.size()) {
+        assert(query._errorHandler);
+        query._errorHandler->setError("geomodelgrids::serial::Query::query() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = query._valuesLowercase.size();
+    std::fill(values, values+numQueryValues, NODATA_VALUE);
+    bool found = false;
+    const std::vector<size_t>& candidates = query._modelIndex->getCandidates(x, y);
+    for (size_t iCandidate = 0; iCandidate < candidates.size(); ++iCandidate) {
+        const size_t i = candidates[iCandidate];
+        if (!query._modelIndex->inBoundingBox(i, x, y)) {
+            continue;
+        } // if
+        Model* model = getModel(query, i);assert(model);
+        double zSquash = z;
+        switch (query._squash) {
+        case Query::SQUASH_NONE:
+            break;
+        case Query::SQUASH_TOP_SURFACE:
+            if (z > query._squashMinElev) {
+                const double topElev = model->queryTopElevation(x, y);
+                zSquash = topElev + z * (query._squashMinElev - topElev) / query._squashMinElev;
+            } // if
+            break;
+        case Query::SQUASH_TOPOGRAPHY_BATHYMETRY:
+            if (z > query._squashMinElev) {
+                const double groundElev = model->queryTopoBathyElevation(x, y);
+                zSquash = groundElev + z * (query._squashMinElev - groundElev) / query._squashMinElev;
+            } // if
+            break;
+        default:
+            throw std::logic_error("Unknown squashing type.");
+        } // switch
+        if (model->contains(x, y, zSquash)) {
+            const double* modelValues = model->query(x, y, zSquash);
+            Query::values_map_type& modelMap = query._valuesIndex[i];
+            for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                values[iValue] = T(modelValues[modelMap[iValue]]);
+            } // for
+
+            found = true;
+            break;
+        } // if
+    } // for
+
+    if (query._stats) {
+        query._stats->numPoints++;
+        if (found) {
+            query._stats->numPointsFound++;
+        } else {
+            query._stats->numPointsOutside++;
+        } // if/else
+    } // if
+
+    return found ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // queryPoint
+
+
+// ------------------------------------------------------------------------------------------------
+// Query models for values at many points.
+template<typename T>
+int
+geomodelgrids::serial::_Query::queryPoints(geomodelgrids::serial::Query& query,
+                                           T* const values,
+                                           const size_t valuesStride,
+                                           const double* const x,
+                                           const double* const y,
+                                           const double* const z,
+                                           const size_t pointsStride,
+                                           const size_t numPoints,
+                                           int* const status,
+                                           size_t* const numOutside) {
+    if (numPoints && (!values || !x || !y || !z)) {
+        assert(query._errorHandler);
+        query._errorHandler->setError("geomodelgrids::serial::Query::queryPoints() passed nullptr for values or "
+                                      "coordinates argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!query._valuesLowercase.size()) {
+        assert(query._errorHandler);
+        query._errorHandler->setError("geomodelgrids::serial::Query::queryPoints() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (valuesStride < query._valuesLowercase.size()) {
+        std::ostringstream msg;
+        msg << "Stride of values (" << valuesStride << ") must be at least the number of query values ("
+            << query._valuesLowercase.size() << ").";
+        assert(query._errorHandler);
+        query._errorHandler->setError(msg.str().c_str());
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (numPoints > 1 && !pointsStride) {
+        assert(query._errorHandler);
+        query._errorHandler->setError("Stride of points must be positive.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    // Limit size of batches so the work arrays stay small while amortizing the cost of each CRS
+    // transformation over many points.
+    const size_t maxBatchSize = 4096;
+    size_t numFound = 0;
+    for (size_t iStart = 0; iStart < numPoints; iStart += maxBatchSize) {
+        const size_t batchSize = std::min(maxBatchSize, numPoints - iStart);
+        numFound += queryBatch(query, &values[iStart*valuesStride], valuesStride,
+                               &x[iStart*pointsStride], &y[iStart*pointsStride], &z[iStart*pointsStride],
+                               pointsStride, batchSize, (status) ? &status[iStart] : nullptr);
+    } // for
+
+    if (numOutside) {
+        *numOutside = numPoints - numFound;
+    } // if
+    if (query._stats) {
+        query._stats->numPoints += numPoints;
+        query._stats->numPointsFound += numFound;
+        query._stats->numPointsOutside += numPoints - numFound;
+    } // if
+
+    return (numFound == numPoints) ?
+           geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Query models for values at a batch of points.
+template<typename T>
+size_t
+geomodelgrids::serial::_Query::queryBatch(geomodelgrids::serial::Query& query,
+                                          T* const values,
+                                          const size_t valuesStride,
+                                          const double* const x,
+                                          const double* const y,
+                                          const double* const z,
+                                          const size_t pointsStride,
+                                          const size_t numPoints,
+                                          int* const status) {
+    const size_t spaceDim = 3;
+    const size_t numQueryValues = query._valuesLowercase.size();
+    Query::PointsBatch& batch = query._batch;
+
+    startBatch(query, numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        std::fill(&values[iPt*valuesStride], &values[iPt*valuesStride+numQueryValues], NODATA_VALUE);
+        if (status) {
+            status[iPt] = geomodelgrids::utils::ErrorHandler::WARNING;
+        } // if
+        const double xPt = x[iPt*pointsStride];
+        const double yPt = y[iPt*pointsStride];
+        batch.candidateModels[iPt] = &query._modelIndex->getCandidates(xPt, yPt);
+        queueNextModel(query, iPt, xPt, yPt);
+    } // for
+
+    size_t numFound = 0;
+    for (size_t iModel = 0; iModel < query._models.size(); ++iModel) {
+        batch.candidates.swap(batch.queues[iModel]);
+        batch.queues[iModel].clear();
+        const size_t numCandidates = batch.candidates.size();
+        if (!numCandidates) {
+            continue;
+        } // if
+        Model* model = getModel(query, iModel);assert(model);
+
+        batch.xyz.resize(numCandidates*spaceDim);
+        batch.xyzModel.resize(numCandidates*spaceDim);
+        for (size_t i = 0; i < numCandidates; ++i) {
+            const size_t iPt = batch.candidates[i];
+            batch.xyz[i*spaceDim+0] = x[iPt*pointsStride];
+            batch.xyz[i*spaceDim+1] = y[iPt*pointsStride];
+            batch.xyz[i*spaceDim+2] = z[iPt*pointsStride];
+        } // for
+        model->toModelXYZ(batch.xyzModel.data(), batch.xyz.data(), numCandidates);
+
+        // Points above the squashing elevation are transformed again using their squashed elevation.
+        batch.squashed.clear();
+        if (Query::SQUASH_NONE != query._squash) {
+            for (size_t i = 0; i < numCandidates; ++i) {
+                if (batch.xyz[i*spaceDim+2] > query._squashMinElev) {
+                    batch.squashed.push_back(i);
+                } // if
+            } // for
+        } // if
+        const size_t numSquashed = batch.squashed.size();
+        if (numSquashed) {
+            batch.squashXYZ.resize(numSquashed*spaceDim);
+            batch.squashXYZModel.resize(numSquashed*spaceDim);
+            batch.surfaceElev.resize(numSquashed);
+            for (size_t i = 0; i < numSquashed; ++i) {
+                const double* xyzModel = &batch.xyzModel[batch.squashed[i]*spaceDim];
+                std::copy(xyzModel, xyzModel+spaceDim, &batch.squashXYZModel[i*spaceDim]);
+            } // for
+            switch (query._squash) {
+            case Query::SQUASH_TOP_SURFACE:
+                model->queryTopElevations(batch.surfaceElev.data(), batch.squashXYZModel.data(), numSquashed);
+                break;
+            case Query::SQUASH_TOPOGRAPHY_BATHYMETRY:
+                model->queryTopoBathyElevations(batch.surfaceElev.data(), batch.squashXYZModel.data(), numSquashed);
+                break;
+            default:
+                throw std::logic_error("Unknown squashing type.");
+            } // switch
+            for (size_t i = 0; i < numSquashed; ++i) {
+                const double* xyz = &batch.xyz[batch.squashed[i]*spaceDim];
+                batch.squashXYZ[i*spaceDim+0] = xyz[0];
+                batch.squashXYZ[i*spaceDim+1] = xyz[1];
+                batch.squashXYZ[i*spaceDim+2] = squash(query, batch.surfaceElev[i], xyz[2]);
+            } // for
+            model->toModelXYZ(batch.squashXYZModel.data(), batch.squashXYZ.data(), numSquashed);
+            for (size_t i = 0; i < numSquashed; ++i) {
+                std::copy(&batch.squashXYZModel[i*spaceDim], &batch.squashXYZModel[(i+1)*spaceDim],
+                          &batch.xyzModel[batch.squashed[i]*spaceDim]);
+            } // for
+        } // if
+
+        // Query points inside the model; keep the others for the next model.
+        Query::values_map_type& modelMap = query._valuesIndex[iModel];
+        batch.valuesIndex.resize(numQueryValues);
+        for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+            batch.valuesIndex[iValue] = modelMap[iValue];
+        } // for
+        for (size_t i = 0; i < numCandidates; ++i) {
+            const size_t iPt = batch.candidates[i];
+            const double* xyzModel = &batch.xyzModel[i*spaceDim];
+            if (model->containsModelXYZ(xyzModel[0], xyzModel[1], xyzModel[2])) {
+                const double* modelValues = model->queryModelXYZ(xyzModel[0], xyzModel[1], xyzModel[2]);
+                T* pointValues = &values[iPt*valuesStride];
+                for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                    pointValues[iValue] = T(modelValues[batch.valuesIndex[iValue]]);
+                } // for
+                if (status) {
+                    status[iPt] = geomodelgrids::utils::ErrorHandler::OK;
+                } // if
+                ++numFound;
+            } else {
+                queueNextModel(query, iPt, x[iPt*pointsStride], y[iPt*pointsStride]);
+            } // if/else
+        } // for
+    } // for
+
+    return numFound;
+} // queryBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Query models for elevation of surface at a batch of points.
+void
+geomodelgrids::serial::_Query::queryElevationsBatch(geomodelgrids::serial::Query& query,
+                                                    double* const elevations,
+                                                    const double* const points,
+                                                    const size_t numPoints,
+                                                    const bool topoBathy) {
+    const size_t spaceDim = 3;
+    const double zOffset = -1.0e-3;
+    Query::PointsBatch& batch = query._batch;
+
+    startBatch(query, numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        elevations[iPt] = NODATA_VALUE;
+        batch.candidateModels[iPt] = &query._modelIndex->getCandidates(points[iPt*2+0], points[iPt*2+1]);
+        queueNextModel(query, iPt, points[iPt*2+0], points[iPt*2+1]);
+    } // for
+
+    // As in queryTopElevation() and queryTopoBathyElevation(), the elevation comes from the first model
+    // containing the point just below the surface.
+    for (size_t iModel = 0; iModel < query._models.size(); ++iModel) {
+        batch.candidates.swap(batch.queues[iModel]);
+        batch.queues[iModel].clear();
+        const size_t numCandidates = batch.candidates.size();
+        if (!numCandidates) {
+            continue;
+        } // if
+        Model* model = getModel(query, iModel);assert(model);
+
+        batch.xyz.resize(numCandidates*spaceDim);
+        batch.xyzModel.resize(numCandidates*spaceDim);
+        batch.surfaceElev.resize(numCandidates);
+        for (size_t i = 0; i < numCandidates; ++i) {
+            const size_t iPt = batch.candidates[i];
+            batch.xyz[i*spaceDim+0] = points[iPt*2+0];
+            batch.xyz[i*spaceDim+1] = points[iPt*2+1];
+            batch.xyz[i*spaceDim+2] = 0.0;
+        } // for
+        model->toModelXYZ(batch.xyzModel.data(), batch.xyz.data(), numCandidates);
+        if (topoBathy) {
+            model->queryTopoBathyElevations(batch.surfaceElev.data(), batch.xyzModel.data(), numCandidates);
+        } else {
+            model->queryTopElevations(batch.surfaceElev.data(), batch.xyzModel.data(), numCandidates);
+        } // if/else
+
+        for (size_t i = 0; i < numCandidates; ++i) {
+            batch.xyz[i*spaceDim+2] = batch.surfaceElev[i] + zOffset;
+        } // for
+        model->toModelXYZ(batch.xyzModel.data(), batch.xyz.data(), numCandidates);
+
+        for (size_t i = 0; i < numCandidates; ++i) {
+            const size_t iPt = batch.candidates[i];
+            const double* xyzModel = &batch.xyzModel[i*spaceDim];
+            if (model->containsModelXYZ(xyzModel[0], xyzModel[1], xyzModel[2])) {
+                elevations[iPt] = batch.surfaceElev[i];
+            } else {
+                queueNextModel(query, iPt, points[iPt*2+0], points[iPt*2+1]);
+            } // if/else
+        } // for
+    } // for
+} // queryElevationsBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Reset work arrays for a batch of points.
+void
+geomodelgrids::serial::_Query::startBatch(geomodelgrids::serial::Query& query,
+                                          const size_t numPoints) {
+    Query::PointsBatch& batch = query._batch;
+
+    batch.queues.resize(query._models.size());
+    for (size_t iModel = 0; iModel < batch.queues.size(); ++iModel) {
+        batch.queues[iModel].clear();
+    } // for
+    batch.candidateModels.resize(numPoints);
+    batch.nextCandidate.assign(numPoints, 0);
+} // startBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Queue point for the next candidate model whose bounding box contains the point.
+void
+geomodelgrids::serial::_Query::queueNextModel(geomodelgrids::serial::Query& query,
+                                              const size_t iPt,
+                                              const double x,
+                                              const double y) {
+    Query::PointsBatch& batch = query._batch;
+    const std::vector<size_t>& candidateModels = *batch.candidateModels[iPt];
+    size_t& iNext = batch.nextCandidate[iPt];
+    while (iNext < candidateModels.size()) {
+        const size_t iModel = candidateModels[iNext++];
+        if (query._modelIndex->inBoundingBox(iModel, x, y)) {
+            batch.queues[iModel].push_back(iPt);
+            break;
+        } // if
+    } // while
+} // queueNextModel
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert elevation in input CRS to elevation in squashed input CRS.
+double
+geomodelgrids::serial::_Query::squash(const geomodelgrids::serial::Query& query,
+                                      const double squashElev,
+                                      const double z) {
+    if ((Query::SQUASH_NONE == query._squash) || (z <= query._squashMinElev)) {
+        return z;
+    } // if
+    return squashElev + z * (query._squashMinElev - squashElev) / query._squashMinElev;
+} // squash
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert elevation in squashed input CRS to elevation in input CRS.
+double
+geomodelgrids::serial::_Query::unsquash(const geomodelgrids::serial::Query& query,
+                                        const double squashElev,
+                                        const double zSquash) {
+    if ((Query::SQUASH_NONE == query._squash) || (zSquash <= query._squashMinElev)) {
+        return zSquash;
+    } // if
+    return (zSquash - squashElev) * query._squashMinElev / (query._squashMinElev - squashElev);
+} // unsquash
+
+
+// ------------------------------------------------------------------------------------------------
+// Interpolate values along model column.
+void
+geomodelgrids::serial::_Query::interpolateColumn(double* values,
+                                                 const geomodelgrids::serial::Query::ModelColumn& column,
+                                                 geomodelgrids::serial::Query::values_map_type& modelMap,
+                                                 const size_t numModelValues,
+                                                 const double zSquash,
+                                                 const double zSquashSegment) {
+    assert(values);
+    const std::vector<double>& elevations = column.elevations;
+    const size_t numPoints = elevations.size();
+    assert(numPoints > 0);
+
+    // Pair of grid points bracketing zSquashSegment (elevations are in descending order).
+    size_t iBot = std::upper_bound(elevations.begin(), elevations.end(), zSquashSegment, std::greater<double>())
+                  - elevations.begin();
+    iBot = std::min(std::max(iBot, size_t(1)), numPoints-1);
+    const size_t iTop = (numPoints > 1) ? iBot - 1 : 0;
+    const double dz = elevations[iBot] - elevations[iTop];
+    const double wtBot = (dz != 0.0) ? (zSquash - elevations[iTop]) / dz : 0.0;
+
+    const double* valuesTop = &column.values[iTop*numModelValues];
+    const double* valuesBot = &column.values[iBot*numModelValues];
+    const size_t numQueryValues = modelMap.size();
+    for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+        const size_t iModel = modelMap[iValue];
+        values[iValue] = valuesTop[iModel] + wtBot * (valuesBot[iModel] - valuesTop[iModel]);
+    } // for
+} // interpolateColumn
+
+
 // End of file
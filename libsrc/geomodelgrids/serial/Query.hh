@@ -4,11 +4,13 @@
 #include "serialfwd.hh" // forward declarations
 
 #include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA ErrorHandler
+#include "geomodelgrids/serial/MetadataCache.hh" // HASA MetadataCache::Entry
 
 #include <memory> // USES std::vector
 #include <vector> // USES std::vector
 #include <map> // USES std::map
 #include <string> // USES std::string
+#include <utility> // USES std::pair
 
 class geomodelgrids::serial::Query {
     friend class TestQuery; // unit testing
@@ -39,7 +41,28 @@ public:
      */
     std::shared_ptr<geomodelgrids::utils::ErrorHandler>& getErrorHandler(void);
 
+    /** Turn collecting query statistics on/off.
+     *
+     * Must be called before initialize().
+     *
+     * @param[in] value True if collecting statistics is on, false otherwise.
+     */
+    void setStatsOn(const bool value);
+
+    /** Get query statistics.
+     *
+     * @returns Query statistics (nullptr if collecting statistics is off).
+     */
+    std::shared_ptr<geomodelgrids::serial::QueryStats>& getStats(void);
+
+    /// Reset query statistics to zero.
+    void resetStats(void);
+
     /** Do setup for querying.
+     *
+     * Model files are opened and their metadata is read here, but the blocks and surfaces of a model are opened
+     * for querying when the first point is dispatched to the model. The bounding box of the domain in the input
+     * CRS comes from the metadata cache if it is set and its entry matches the model.
      *
      * @param[in] modelFilenames Array of model filenames (in query order).
      * @param[in] valueNames Array of names of values to return in query.
@@ -49,6 +72,92 @@ public:
                     const std::vector<std::string>& valueNames,
                     const std::string& inputCRSString);
 
+    /** Set dimensions of hyperslabs used in querying blocks.
+     *
+     * Must be called before initialize(). Dimensions that are zero are sized automatically from the chunk layout
+     * of the block datasets.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y, z].
+     * @param[in] ndims Number of dimensions.
+     */
+    void setBlockHyperslabDims(const size_t dims[],
+                               const size_t ndims);
+
+    /** Set dimensions of hyperslabs used in querying surfaces.
+     *
+     * Must be called before initialize(). Dimensions that are zero are sized automatically from the chunk layout
+     * of the surface datasets.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y].
+     * @param[in] ndims Number of dimensions.
+     */
+    void setSurfaceHyperslabDims(const size_t dims[],
+                                 const size_t ndims);
+
+    /** Set memory budget for automatically sized hyperslab dimensions.
+     *
+     * Must be called before initialize().
+     *
+     * @param[in] value Maximum size (in bytes) of each hyperslab.
+     */
+    void setHyperslabMaxBytes(const size_t value);
+
+    /** Turn prefetching of the next hyperslab along the traversal direction on/off.
+     *
+     * Must be called before initialize(). Prefetching overlaps reading data with querying for points that move
+     * steadily through the model, such as rasters and profiles, at the cost of doubling hyperslab memory.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setHyperslabPrefetch(const bool value);
+
+    /** Set horizontal resolution needed by queries.
+     *
+     * Must be called before initialize(). Models with multi-resolution pyramids are queried using the coarsest
+     * level with a horizontal resolution no coarser than the requested resolution.
+     *
+     * @param[in] value Horizontal resolution (m) (0 for full resolution).
+     */
+    void setQueryResolution(const double value);
+
+    /** Set file used to cache model metadata between runs.
+     *
+     * Must be called before initialize(). With the cache, initialize() does not open models or compute their
+     * bounding boxes until they are queried, which speeds up startup for short jobs using several models.
+     *
+     * @param[in] filename Name of cache file (empty string to turn off caching).
+     */
+    void setMetadataCache(const char* filename);
+
+    /** Set POSIX shared memory cache of model chunks shared by processes on the same node.
+     *
+     * Must be called before initialize(). Processes using a cache with the same name share the chunks read
+     * from the models, so each chunk is read from the file and decompressed once per node instead of once per
+     * process. The first process to use a cache creates it with the given size. The shared memory persists after
+     * the processes finish; remove it with SharedChunkCache::remove().
+     *
+     * @param[in] name Name of shared memory cache (empty string to turn off the shared cache).
+     * @param[in] cacheBytes Size of cache in bytes (see SharedChunkCache::DEFAULT_CACHE_BYTES).
+     * @param[in] slotBytes Maximum size of a chunk in the cache in bytes (see SharedChunkCache::DEFAULT_SLOT_BYTES).
+     */
+    void setSharedCache(const char* name,
+                        const size_t cacheBytes,
+                        const size_t slotBytes);
+
+    /** Read model from an image of the model file in memory instead of from the file system.
+     *
+     * Must be called before initialize(). The image is not copied and must remain valid until finalize() is
+     * called. This allows one process to read a model file and share it with other processes (see
+     * geomodelgrids::parallel::Query).
+     *
+     * @param[in] filename Name of model file (as passed to initialize()).
+     * @param[in] image Contents of model file (nullptr to read the model from the file system).
+     * @param[in] numBytes Size of image in bytes.
+     */
+    void setModelFileImage(const char* filename,
+                           const void* const image,
+                           const size_t numBytes);
+
     /** Turn on squashing and set minimum elevation for squashing.
      *
      * Geometry below minimum elevation is not perturbed.
@@ -87,6 +196,30 @@ public:
     double queryTopoBathyElevation(const double x,
                                    const double y);
 
+    /** Query for elevation of top of model at many points.
+     *
+     * Same as queryTopElevation() with the points processed in batches and transformed in bulk.
+     *
+     * @param[out] elevations Elevations (m) of top of model at points [numPoints].
+     * @param[in] points Coordinates of points (in input CRS) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopElevations(double* const elevations,
+                            const double* const points,
+                            const size_t numPoints);
+
+    /** Query for elevation of topography/bathymetry at many points.
+     *
+     * Same as queryTopoBathyElevation() with the points processed in batches and transformed in bulk.
+     *
+     * @param[out] elevations Elevations (m) of ground surface at points [numPoints].
+     * @param[in] points Coordinates of points (in input CRS) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopoBathyElevations(double* const elevations,
+                                  const double* const points,
+                                  const size_t numPoints);
+
 
     /** Query for model containing the given point.
      *
@@ -114,6 +247,103 @@ public:
               const double y,
               const double z);
 
+    /** Query model for single precision values at a point.
+     *
+     * Values are interpolated in double precision and rounded to single precision as they are copied to the
+     * values array, which must be preallocated.
+     *
+     * @param[out] values Array of values returned in query.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @returns 0 on success, 1 on error.
+     */
+    int query(float* const values,
+              const double x,
+              const double y,
+              const double z);
+
+    /** Query model for values at many points.
+     *
+     * Points are processed in batches. The points in a batch that have not been found in a model are transformed
+     * to the coordinates of the next model with a single CRS transformation, so this is much faster than calling
+     * query() for each point. Points outside all models have values of NODATA_VALUE and a status of WARNING; no
+     * message is generated for individual points.
+     *
+     * Values and status arrays must be preallocated.
+     *
+     * @param[out] values Values at points; values for point i start at values[i*valuesStride].
+     * @param[in] valuesStride Number of values between the starts of consecutive points (at least the number
+     * of query values).
+     * @param[in] x X coordinates of points (in input CRS); coordinate for point i is x[i*pointsStride].
+     * @param[in] y Y coordinates of points (in input CRS); coordinate for point i is y[i*pointsStride].
+     * @param[in] z Z coordinates of points (in input CRS); coordinate for point i is z[i*pointsStride].
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be nullptr).
+     * @param[out] numOutside Number of points outside all models (can be nullptr).
+     * @returns 0 if all points are found, 1 if any points are outside all models, 2 on error.
+     */
+    int queryPoints(double* const values,
+                    const size_t valuesStride,
+                    const double* const x,
+                    const double* const y,
+                    const double* const z,
+                    const size_t pointsStride,
+                    const size_t numPoints,
+                    int* const status=nullptr,
+                    size_t* const numOutside=nullptr);
+
+    /** Query model for single precision values at many points.
+     *
+     * Same as queryPoints() with double precision values, except values are rounded to single precision as they
+     * are copied to the values array, which halves the memory for the values of large numbers of points.
+     *
+     * @param[out] values Values at points; values for point i start at values[i*valuesStride].
+     * @param[in] valuesStride Number of values between the starts of consecutive points (at least the number
+     * of query values).
+     * @param[in] x X coordinates of points (in input CRS); coordinate for point i is x[i*pointsStride].
+     * @param[in] y Y coordinates of points (in input CRS); coordinate for point i is y[i*pointsStride].
+     * @param[in] z Z coordinates of points (in input CRS); coordinate for point i is z[i*pointsStride].
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be nullptr).
+     * @param[out] numOutside Number of points outside all models (can be nullptr).
+     * @returns 0 if all points are found, 1 if any points are outside all models, 2 on error.
+     */
+    int queryPoints(float* const values,
+                    const size_t valuesStride,
+                    const double* const x,
+                    const double* const y,
+                    const double* const z,
+                    const size_t pointsStride,
+                    const size_t numPoints,
+                    int* const status=nullptr,
+                    size_t* const numOutside=nullptr);
+
+    /** Query models for values along vertical column through point.
+     *
+     * Each model contributes the grid points of its blocks, so the values are exactly those returned by query()
+     * at the grid points and vary linearly with elevation between consecutive points (values without units,
+     * which query() takes from the nearest grid point, are also interpolated linearly). Consecutive points at
+     * the same elevation mark a jump in the values, such as at interfaces between blocks or models. Points
+     * outside all models have values of NODATA_VALUE.
+     *
+     * @param[out] elevations Elevations (m) of points from zTop to zBottom (in input CRS).
+     * @param[out] values Values at points [numPoints][numQueryValues].
+     * @param[in] x X coordinate of column (in input CRS).
+     * @param[in] y Y coordinate of column (in input CRS).
+     * @param[in] zTop Elevation (m) of top of column (in input CRS).
+     * @param[in] zBottom Elevation (m) of bottom of column (in input CRS).
+     * @returns 0 on success, 1 if column is outside all models, 2 on error.
+     */
+    int queryColumn(std::vector<double>* elevations,
+                    std::vector<double>* values,
+                    const double x,
+                    const double y,
+                    const double zTop,
+                    const double zBottom);
+
     /// Cleanup after querying.
     void finalize(void);
 
@@ -122,15 +352,65 @@ private:
 
     typedef std::map<size_t, size_t> values_map_type;
 
+    // PRIVATE STRUCTS ----------------------------------------------------------------------------
+private:
+
+    /// Grid points along vertical column in one model.
+    struct ModelColumn {
+        size_t model; ///< Index of model.
+        double squashElev; ///< Elevation (m) of surface used for squashing.
+        std::vector<double> elevations; ///< Elevations (m) of grid points (in squashed input CRS).
+        std::vector<double> values; ///< Model values at grid points.
+    }; // ModelColumn
+
+    /// Work arrays for querying a batch of points.
+    struct PointsBatch {
+        std::vector<std::vector<size_t> > queues; ///< Indices of points waiting to be checked against each model.
+        std::vector<const std::vector<size_t>*> candidateModels; ///< Models that might contain each point.
+        std::vector<size_t> nextCandidate; ///< Index into candidate models of next model for each point.
+        std::vector<size_t> candidates; ///< Indices of points checked against current model.
+        std::vector<size_t> valuesIndex; ///< Index of model value for each query value.
+        std::vector<double> xyz; ///< Coordinates of candidate points (in input CRS).
+        std::vector<double> xyzModel; ///< Model coordinates of candidate points.
+        std::vector<size_t> squashed; ///< Indices into candidate points of points that are squashed.
+        std::vector<double> squashXYZ; ///< Coordinates of squashed points (in squashed input CRS).
+        std::vector<double> squashXYZModel; ///< Model coordinates of squashed points.
+        std::vector<double> surfaceElev; ///< Elevation (m) of surface at candidate or squashed points.
+    }; // PointsBatch
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
-    std::vector<std::unique_ptr<geomodelgrids::serial::Model> > _models;
+    std::vector<std::unique_ptr<geomodelgrids::serial::Model> > _models; ///< Models.
+    std::vector<bool> _modelsInitialized; ///< True if model has been opened for querying.
+    std::vector<std::string> _modelFilenames; ///< Names of model files.
+    std::vector<double> _bboxes; ///< Bounding boxes of models in input CRS [numModels][xmin, xmax, ymin, ymax].
+    std::string _inputCRSString; ///< CRS of input points.
+    std::string _metadataCacheFilename; ///< Name of metadata cache file (empty if not caching).
+    std::vector<std::string> _metadataCacheKeys; ///< Keys of models in metadata cache (empty if not caching).
+    std::vector<MetadataCache::Entry> _metadata; ///< Metadata used to dispatch points (from cache or models).
+    std::map<size_t, std::string> _valueUnits; ///< Units of query values.
+    std::string _sharedCacheName; ///< Name of shared chunk cache (empty if not sharing chunks).
+    size_t _sharedCacheBytes; ///< Size of shared chunk cache.
+    size_t _sharedCacheSlotBytes; ///< Maximum size of a chunk in shared chunk cache.
+    std::unique_ptr<geomodelgrids::serial::SharedChunkCache> _sharedCache; ///< Shared chunk cache.
+    std::map<std::string, std::pair<const void*, size_t> > _modelFileImages; ///< Images of model files.
     std::vector<std::string> _valuesLowercase;
     std::vector<values_map_type> _valuesIndex;
     double _squashMinElev;
     std::shared_ptr<geomodelgrids::utils::ErrorHandler> _errorHandler;
     SquashingEnum _squash;
+    std::vector<size_t> _blockHyperslabDims;
+    std::vector<size_t> _surfaceHyperslabDims;
+    size_t _hyperslabMaxBytes;
+    bool _hyperslabPrefetch;
+    double _queryResolution;
+    std::shared_ptr<geomodelgrids::serial::QueryStats> _stats;
+    std::unique_ptr<geomodelgrids::serial::ModelIndex> _modelIndex; ///< Spatial index of models.
+    std::vector<std::unique_ptr<geomodelgrids::serial::ModelIndex> > _staleModelIndices; ///< Replaced indices.
+    std::vector<ModelColumn> _columns;
+    std::vector<double> _columnBreaks;
+    PointsBatch _batch;
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
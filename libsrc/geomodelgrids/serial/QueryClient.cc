@@ -0,0 +1,208 @@
+#include <portinfo>
+
+#include "QueryClient.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/QueryProtocol.hh" // USES QueryProtocol
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <sys/socket.h> // USES socket(), connect()
+#include <sys/un.h> // USES sockaddr_un
+#include <unistd.h> // USES close()
+#include <cerrno> // USES errno
+#include <cstring> // USES strerror(), memset(), strncpy()
+#include <algorithm> // USES std::min(), std::max(), std::copy()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::QueryClient::QueryClient(void) :
+    _errorHandler(std::make_shared<geomodelgrids::utils::ErrorHandler>()),
+    _socket(-1) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::QueryClient::~QueryClient(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get error handler.
+std::shared_ptr<geomodelgrids::utils::ErrorHandler>&
+geomodelgrids::serial::QueryClient::getErrorHandler(void) {
+    return _errorHandler;
+} // getErrorHandler
+
+
+// ------------------------------------------------------------------------------------------------
+// Connect to server.
+void
+geomodelgrids::serial::QueryClient::connect(const char* socketPath) {
+    close();
+
+    sockaddr_un address;
+    const std::string path = (socketPath) ? socketPath : "";
+    if (path.empty() || (path.size() >= sizeof(address.sun_path))) {
+        std::ostringstream msg;
+        msg << "Path of query server socket '" << path << "' must be between 1 and "
+            << sizeof(address.sun_path)-1 << " characters long.";
+        throw std::invalid_argument(msg.str());
+    } // if
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path)-1);
+
+    _socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((_socket < 0) || ::connect(_socket, (const sockaddr*)&address, sizeof(address))) {
+        std::ostringstream msg;
+        msg << "Could not connect to query server at '" << path << "': " << strerror(errno) << ".";
+        close();
+        throw std::runtime_error(msg.str());
+    } // if
+
+    try {
+        size_t numValues = 0;
+        _request(QueryProtocol::REQUEST_INFO, nullptr, 0, 0, &numValues);
+        _valueNames.resize(numValues);
+        for (size_t i = 0; i < numValues; ++i) {
+            _valueNames[i] = QueryProtocol::readString(_socket);
+        } // for
+    } catch (...) {
+        close();
+        throw;
+    } // try/catch
+} // connect
+
+
+// ------------------------------------------------------------------------------------------------
+// Get names of values returned by queries.
+const std::vector<std::string>&
+geomodelgrids::serial::QueryClient::getValueNames(void) const {
+    return _valueNames;
+} // getValueNames
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for values at many points.
+int
+geomodelgrids::serial::QueryClient::queryPoints(double* const values,
+                                                const double* const points,
+                                                const size_t numPoints,
+                                                int* const status) {
+    const size_t spaceDim = 3;
+    const size_t numValues = _valueNames.size();
+    int queryStatus = geomodelgrids::utils::ErrorHandler::OK;
+    std::vector<int32_t> statusBuffer;
+    for (size_t iStart = 0; iStart < numPoints; iStart += QueryProtocol::MAX_POINTS) {
+        const size_t count = std::min(QueryProtocol::MAX_POINTS, numPoints-iStart);
+        const int err = _request(QueryProtocol::REQUEST_VALUES, &points[iStart*spaceDim], count, spaceDim);
+        queryStatus = std::max(queryStatus, err);
+
+        statusBuffer.resize(count);
+        QueryProtocol::readBytes(_socket, &values[iStart*numValues], count*numValues*sizeof(double));
+        QueryProtocol::readBytes(_socket, statusBuffer.data(), count*sizeof(int32_t));
+        if (status) {
+            std::copy(statusBuffer.begin(), statusBuffer.end(), &status[iStart]);
+        } // if
+    } // for
+
+    return queryStatus;
+} // queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for elevation of top surface at many points.
+void
+geomodelgrids::serial::QueryClient::queryTopElevations(double* const elevations,
+                                                       const double* const points,
+                                                       const size_t numPoints) {
+    _queryElevations(elevations, points, numPoints, QueryProtocol::REQUEST_TOP_ELEVATION);
+} // queryTopElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for elevation of topography/bathymetry at many points.
+void
+geomodelgrids::serial::QueryClient::queryTopoBathyElevations(double* const elevations,
+                                                             const double* const points,
+                                                             const size_t numPoints) {
+    _queryElevations(elevations, points, numPoints, QueryProtocol::REQUEST_TOPOBATHY_ELEVATION);
+} // queryTopoBathyElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Ask server to shut down.
+void
+geomodelgrids::serial::QueryClient::shutdownServer(void) {
+    _request(QueryProtocol::REQUEST_SHUTDOWN, nullptr, 0, 0);
+    close();
+} // shutdownServer
+
+
+// ------------------------------------------------------------------------------------------------
+// Close connection to server.
+void
+geomodelgrids::serial::QueryClient::close(void) {
+    if (_socket >= 0) {
+        ::close(_socket);_socket = -1;
+    } // if
+    _valueNames.clear();
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Send request and read header of response.
+int
+geomodelgrids::serial::QueryClient::_request(const int type,
+                                             const double* const points,
+                                             const size_t numPoints,
+                                             const size_t spaceDim,
+                                             size_t* const count) {
+    if (_socket < 0) {
+        throw std::logic_error("Query client is not connected to a server.");
+    } // if
+
+    QueryProtocol::writeHeader(_socket, type, numPoints);
+    if (numPoints) {
+        QueryProtocol::writeBytes(_socket, points, numPoints*spaceDim*sizeof(double));
+    } // if
+
+    QueryProtocol::Header header;
+    if (!QueryProtocol::readHeader(_socket, &header)) {
+        close();
+        throw std::runtime_error("Query server closed connection.");
+    } // if
+    if (geomodelgrids::utils::ErrorHandler::ERROR == header.type) {
+        const std::string& message = QueryProtocol::readString(_socket);
+        throw std::runtime_error(std::string("Query server error: ") + message);
+    } // if
+    if (count) {
+        *count = header.count;
+    } else if (header.count != numPoints) {
+        close();
+        throw std::runtime_error("Query server response does not match request.");
+    } // if/else
+
+    return int(header.type);
+} // _request
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for elevations at many points.
+void
+geomodelgrids::serial::QueryClient::_queryElevations(double* const elevations,
+                                                     const double* const points,
+                                                     const size_t numPoints,
+                                                     const int type) {
+    const size_t spaceDim = 2;
+    for (size_t iStart = 0; iStart < numPoints; iStart += QueryProtocol::MAX_POINTS) {
+        const size_t count = std::min(QueryProtocol::MAX_POINTS, numPoints-iStart);
+        _request(type, &points[iStart*spaceDim], count, spaceDim);
+        QueryProtocol::readBytes(_socket, &elevations[iStart], count*sizeof(double));
+    } // for
+} // _queryElevations
+
+
+// End of file
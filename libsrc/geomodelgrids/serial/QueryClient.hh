@@ -0,0 +1,129 @@
+/** Thin client for querying a resident query server (see QueryServer) over a local (Unix-domain) socket.
+ *
+ * The client does not open any models; points are sent to the server in batches and the values are returned
+ * in the same layout as Query::queryPoints(). Points must be in the input CRS of the server.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA ErrorHandler
+
+#include <string> // HASA std::string
+#include <vector> // HASA std::vector
+#include <memory> // HOLDSA std::shared_ptr
+
+class geomodelgrids::serial::QueryClient {
+    friend class TestQueryServer; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    QueryClient(void);
+
+    /// Destructor
+    ~QueryClient(void);
+
+    /** Get error handler.
+     *
+     * @returns Error handler.
+     */
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& getErrorHandler(void);
+
+    /** Connect to server.
+     *
+     * @param[in] socketPath Path of Unix-domain socket of server.
+     */
+    void connect(const char* socketPath);
+
+    /** Get names of values returned by queries.
+     *
+     * @returns Names of values (in order returned by queries).
+     */
+    const std::vector<std::string>& getValueNames(void) const;
+
+    /** Query server for values at many points.
+     *
+     * @param[out] values Values at points [numPoints][numValues] (must be preallocated).
+     * @param[in] points Coordinates of points (in input CRS of server) [numPoints][3].
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status (0 if found, 1 if outside all models) for each point (optional).
+     * @returns 0 if all points are found, 1 if any points are outside all models.
+     */
+    int queryPoints(double* const values,
+                    const double* const points,
+                    const size_t numPoints,
+                    int* const status=nullptr);
+
+    /** Query server for elevation of top surface at many points.
+     *
+     * @param[out] elevations Elevations (m) of top surface at points [numPoints] (must be preallocated).
+     * @param[in] points Coordinates of points (in input CRS of server) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopElevations(double* const elevations,
+                            const double* const points,
+                            const size_t numPoints);
+
+    /** Query server for elevation of topography/bathymetry at many points.
+     *
+     * @param[out] elevations Elevations (m) of topography/bathymetry at points [numPoints] (must be preallocated).
+     * @param[in] points Coordinates of points (in input CRS of server) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopoBathyElevations(double* const elevations,
+                                  const double* const points,
+                                  const size_t numPoints);
+
+    /// Ask server to shut down.
+    void shutdownServer(void);
+
+    /// Close connection to server.
+    void close(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Send request and read header of response.
+     *
+     * @param[in] type Type of request.
+     * @param[in] points Coordinates of points.
+     * @param[in] numPoints Number of points.
+     * @param[in] spaceDim Number of coordinates of each point.
+     * @param[out] count Count in response (if null, count must match numPoints).
+     * @returns Status of response.
+     */
+    int _request(const int type,
+                 const double* const points,
+                 const size_t numPoints,
+                 const size_t spaceDim,
+                 size_t* const count=nullptr);
+
+    /** Query server for elevations at many points.
+     *
+     * @param[out] elevations Elevations (m) at points [numPoints].
+     * @param[in] points Coordinates of points (in input CRS of server) [numPoints][2].
+     * @param[in] numPoints Number of points.
+     * @param[in] type Type of request.
+     */
+    void _queryElevations(double* const elevations,
+                          const double* const points,
+                          const size_t numPoints,
+                          const int type);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler> _errorHandler; ///< Error handler.
+    std::vector<std::string> _valueNames; ///< Names of values returned by server.
+    int _socket; ///< Socket connected to server.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    QueryClient(const QueryClient&); ///< Not implemented
+    const QueryClient& operator=(const QueryClient&); ///< Not implemented
+
+}; // QueryClient
+
+// End of file
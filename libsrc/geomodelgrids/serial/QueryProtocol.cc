@@ -0,0 +1,123 @@
+#include <portinfo>
+
+#include "QueryProtocol.hh" // implementation of class methods
+
+#include <sys/socket.h> // USES send(), recv()
+#include <cerrno> // USES errno
+#include <cstring> // USES strerror()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+
+const uint32_t geomodelgrids::serial::QueryProtocol::MAGIC = 0x474d4731; // "GMG1"
+const size_t geomodelgrids::serial::QueryProtocol::MAX_POINTS = 1048576;
+
+// ------------------------------------------------------------------------------------------------
+// Write bytes to socket.
+void
+geomodelgrids::serial::QueryProtocol::writeBytes(const int socket,
+                                                 const void* bytes,
+                                                 const size_t numBytes) {
+    const char* buffer = static_cast<const char*>(bytes);
+    size_t numWritten = 0;
+    while (numWritten < numBytes) {
+        // MSG_NOSIGNAL turns SIGPIPE into EPIPE if the peer has gone away.
+        const ssize_t n = send(socket, buffer+numWritten, numBytes-numWritten, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (EINTR == errno) { continue; }
+            std::ostringstream msg;
+            msg << "Error writing to query server socket: " << strerror(errno) << ".";
+            throw std::runtime_error(msg.str());
+        } // if
+        numWritten += size_t(n);
+    } // while
+} // writeBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Read bytes from socket.
+bool
+geomodelgrids::serial::QueryProtocol::readBytes(const int socket,
+                                                void* bytes,
+                                                const size_t numBytes) {
+    char* buffer = static_cast<char*>(bytes);
+    size_t numRead = 0;
+    while (numRead < numBytes) {
+        const ssize_t n = recv(socket, buffer+numRead, numBytes-numRead, 0);
+        if (n < 0) {
+            if (EINTR == errno) { continue; }
+            std::ostringstream msg;
+            msg << "Error reading from query server socket: " << strerror(errno) << ".";
+            throw std::runtime_error(msg.str());
+        } else if (0 == n) {
+            if (!numRead) {
+                return false;
+            } // if
+            throw std::runtime_error("Query server socket closed in the middle of a message.");
+        } // if/else
+        numRead += size_t(n);
+    } // while
+
+    return true;
+} // readBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Write header to socket.
+void
+geomodelgrids::serial::QueryProtocol::writeHeader(const int socket,
+                                                  const uint32_t type,
+                                                  const uint64_t count) {
+    Header header;
+    header.magic = MAGIC;
+    header.type = type;
+    header.count = count;
+    writeBytes(socket, &header, sizeof(header));
+} // writeHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Read header from socket.
+bool
+geomodelgrids::serial::QueryProtocol::readHeader(const int socket,
+                                                 Header* header) {
+    if (!readBytes(socket, header, sizeof(Header))) {
+        return false;
+    } // if
+    if (MAGIC != header->magic) {
+        throw std::runtime_error("Message on query server socket does not use the geomodelgrids query protocol.");
+    } // if
+
+    return true;
+} // readHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Write string to socket.
+void
+geomodelgrids::serial::QueryProtocol::writeString(const int socket,
+                                                  const std::string& value) {
+    const uint64_t length = value.size();
+    writeBytes(socket, &length, sizeof(length));
+    writeBytes(socket, value.data(), value.size());
+} // writeString
+
+
+// ------------------------------------------------------------------------------------------------
+// Read string from socket.
+std::string
+geomodelgrids::serial::QueryProtocol::readString(const int socket) {
+    const uint64_t maxLength = 1048576;
+    uint64_t length = 0;
+    if (!readBytes(socket, &length, sizeof(length)) || (length > maxLength)) {
+        throw std::runtime_error("Could not read string from query server socket.");
+    } // if
+    std::string value(length, '\0');
+    if (length && !readBytes(socket, &value[0], length)) {
+        throw std::runtime_error("Could not read string from query server socket.");
+    } // if
+
+    return value;
+} // readString
+
+
+// End of file
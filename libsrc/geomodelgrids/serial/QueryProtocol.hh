@@ -0,0 +1,123 @@
+/** Binary protocol between QueryServer and QueryClient over a local (Unix-domain) socket.
+ *
+ * Every message starts with a header (magic number, type or status, count). The server and clients run on the
+ * same node, so numbers are sent in native byte order without conversion.
+ *
+ * Requests (client to server):
+ *   REQUEST_INFO, count=0.
+ *   REQUEST_VALUES, count=numPoints, followed by points [numPoints][x, y, z].
+ *   REQUEST_TOP_ELEVATION, REQUEST_TOPOBATHY_ELEVATION, count=numPoints, followed by points [numPoints][x, y].
+ *   REQUEST_SHUTDOWN, count=0.
+ *
+ * Responses (server to client) have the status of the error handler in place of the type:
+ *   ERROR, count=0, followed by the error message.
+ *   REQUEST_INFO, count=numValues, followed by the names of the values.
+ *   REQUEST_VALUES, count=numPoints, followed by values [numPoints][numValues] and status (int32) [numPoints].
+ *   REQUEST_*_ELEVATION, count=numPoints, followed by elevations [numPoints].
+ *   REQUEST_SHUTDOWN, count=0.
+ *
+ * Strings are sent as a length (uint64) followed by the characters.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <string> // USES std::string
+#include <cstdint> // USES uint32_t, uint64_t
+#include <cstddef> // USES size_t
+
+class geomodelgrids::serial::QueryProtocol {
+    // PUBLIC ENUMS -------------------------------------------------------------------------------
+public:
+
+    enum RequestEnum {
+        REQUEST_INFO=1, ///< Get names of values.
+        REQUEST_VALUES=2, ///< Query for values at points.
+        REQUEST_TOP_ELEVATION=3, ///< Query for elevation of top surface at points.
+        REQUEST_TOPOBATHY_ELEVATION=4, ///< Query for elevation of topography/bathymetry at points.
+        REQUEST_SHUTDOWN=5, ///< Stop server.
+    }; // RequestEnum
+
+    // PUBLIC STRUCTS -----------------------------------------------------------------------------
+public:
+
+    /// Header of requests and responses.
+    struct Header {
+        uint32_t magic; ///< Magic number identifying protocol and version.
+        uint32_t type; ///< Type of request (RequestEnum) or status of response (ErrorHandler::StatusEnum).
+        uint64_t count; ///< Number of points or values.
+    }; // Header
+
+    // PUBLIC MEMBERS -----------------------------------------------------------------------------
+public:
+
+    static const uint32_t MAGIC; ///< Magic number identifying protocol and version.
+    static const size_t MAX_POINTS; ///< Maximum number of points in a request.
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Write bytes to socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @param[in] bytes Bytes to write.
+     * @param[in] numBytes Number of bytes.
+     */
+    static
+    void writeBytes(const int socket,
+                    const void* bytes,
+                    const size_t numBytes);
+
+    /** Read bytes from socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @param[out] bytes Bytes read.
+     * @param[in] numBytes Number of bytes.
+     * @returns False if socket was closed before any bytes were read, true otherwise.
+     */
+    static
+    bool readBytes(const int socket,
+                   void* bytes,
+                   const size_t numBytes);
+
+    /** Write header to socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @param[in] type Type of request or status of response.
+     * @param[in] count Number of points or values.
+     */
+    static
+    void writeHeader(const int socket,
+                     const uint32_t type,
+                     const uint64_t count);
+
+    /** Read header from socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @param[out] header Header.
+     * @returns False if socket was closed before header, true otherwise.
+     */
+    static
+    bool readHeader(const int socket,
+                    Header* header);
+
+    /** Write string to socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @param[in] value String.
+     */
+    static
+    void writeString(const int socket,
+                     const std::string& value);
+
+    /** Read string from socket.
+     *
+     * @param[in] socket Socket file descriptor.
+     * @returns String.
+     */
+    static
+    std::string readString(const int socket);
+
+}; // QueryProtocol
+
+// End of file
@@ -0,0 +1,429 @@
+#include <portinfo>
+
+#include "QueryServer.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryProtocol.hh" // USES QueryProtocol
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <sys/socket.h> // USES socket(), bind(), listen(), accept(), setsockopt()
+#include <sys/un.h> // USES sockaddr_un
+#include <sys/time.h> // USES timeval
+#include <poll.h> // USES poll()
+#include <fcntl.h> // USES fcntl()
+#include <unistd.h> // USES pipe(), read(), write(), unlink()
+#include <cerrno> // USES errno
+#include <cstring> // USES strerror(), memset(), strncpy()
+#include <cassert> // USES assert()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <utility> // USES std::move()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _QueryServer;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_QueryServer {
+public:
+
+    /** Create address for Unix-domain socket.
+     *
+     * @param[out] address Socket address.
+     * @param[in] socketPath Path of socket.
+     */
+    static
+    void createAddress(sockaddr_un* address,
+                       const std::string& socketPath) {
+        if (socketPath.empty() || (socketPath.size() >= sizeof(address->sun_path))) {
+            std::ostringstream msg;
+            msg << "Path of query server socket '" << socketPath << "' must be between 1 and "
+                << sizeof(address->sun_path)-1 << " characters long.";
+            throw std::invalid_argument(msg.str());
+        } // if
+        memset(address, 0, sizeof(sockaddr_un));
+        address->sun_family = AF_UNIX;
+        strncpy(address->sun_path, socketPath.c_str(), sizeof(address->sun_path)-1);
+    } // createAddress
+
+    /** Is a server listening on socket?
+     *
+     * @param[in] address Socket address.
+     * @returns True if a server accepted a connection, false otherwise.
+     */
+    static
+    bool isListening(const sockaddr_un& address) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        } // if
+        const bool isListening = 0 == connect(fd, (const sockaddr*)&address, sizeof(address));
+        ::close(fd);
+        return isListening;
+    } // isListening
+
+    /** Set file descriptor to close on exec.
+     *
+     * @param[in] fd File descriptor.
+     */
+    static
+    void setCloseOnExec(const int fd) {
+        fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    } // setCloseOnExec
+
+    /** Send error response.
+     *
+     * @param[in] socket Socket of client.
+     * @param[in] message Error message.
+     */
+    static
+    void writeError(const int socket,
+                    const std::string& message) {
+        QueryProtocol::writeHeader(socket, geomodelgrids::utils::ErrorHandler::ERROR, 0);
+        QueryProtocol::writeString(socket, message);
+    } // writeError
+
+    /** Get number of values per point in request.
+     *
+     * @param[in] type Type of request.
+     * @returns Number of values per point (0 if request has no points).
+     */
+    static
+    size_t getPointSize(const uint32_t type) {
+        switch (type) {
+        case QueryProtocol::REQUEST_VALUES:
+            return 3;
+        case QueryProtocol::REQUEST_TOP_ELEVATION:
+        case QueryProtocol::REQUEST_TOPOBATHY_ELEVATION:
+            return 2;
+        default:
+            return 0;
+        } // switch
+    } // getPointSize
+
+    static const int TIMEOUT_SECONDS; ///< Timeout for sending response.
+
+}; // _QueryServer
+
+const int geomodelgrids::serial::_QueryServer::TIMEOUT_SECONDS = 5;
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::QueryServer::QueryServer(void) :
+    _query(nullptr),
+    _listenSocket(-1),
+    _numRequests(0),
+    _isStopping(false) {
+    _wakePipe[0] = -1;
+    _wakePipe[1] = -1;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::QueryServer::~QueryServer(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Create socket and listen for connections.
+void
+geomodelgrids::serial::QueryServer::open(const char* socketPath,
+                                         geomodelgrids::serial::Query* query) {
+    if (!query) {
+        throw std::invalid_argument("Query server requires an initialized query.");
+    } // if
+    if (_listenSocket >= 0) {
+        throw std::logic_error("Query server is already open.");
+    } // if
+
+    sockaddr_un address;
+    _QueryServer::createAddress(&address, socketPath);
+
+    _listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenSocket < 0) {
+        std::ostringstream msg;
+        msg << "Could not create query server socket: " << strerror(errno) << ".";
+        throw std::runtime_error(msg.str());
+    } // if
+    _QueryServer::setCloseOnExec(_listenSocket);
+
+    int err = bind(_listenSocket, (const sockaddr*)&address, sizeof(address));
+    if (err && (EADDRINUSE == errno) && !_QueryServer::isListening(address)) {
+        // Socket file left behind by a server that did not shut down cleanly.
+        unlink(socketPath);
+        err = bind(_listenSocket, (const sockaddr*)&address, sizeof(address));
+    } // if
+    if (err || listen(_listenSocket, SOMAXCONN)) {
+        std::ostringstream msg;
+        msg << "Could not listen on query server socket '" << socketPath << "': " << strerror(errno) << ".";
+        ::close(_listenSocket);_listenSocket = -1;
+        throw std::runtime_error(msg.str());
+    } // if
+    _socketPath = socketPath;
+
+    if (pipe(_wakePipe)) {
+        std::ostringstream msg;
+        msg << "Could not create pipe for query server: " << strerror(errno) << ".";
+        close();
+        throw std::runtime_error(msg.str());
+    } // if
+    for (size_t i = 0; i < 2; ++i) {
+        _QueryServer::setCloseOnExec(_wakePipe[i]);
+        fcntl(_wakePipe[i], F_SETFL, fcntl(_wakePipe[i], F_GETFL) | O_NONBLOCK);
+    } // for
+
+    _query = query;
+    _isStopping = false;
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Answer requests until stopped.
+void
+geomodelgrids::serial::QueryServer::run(void) {
+    if (_listenSocket < 0) {
+        throw std::logic_error("Query server must be opened before running.");
+    } // if
+
+    std::vector<pollfd> fds;
+    while (!_isStopping) {
+        fds.resize(2 + _clients.size());
+        fds[0].fd = _wakePipe[0];
+        fds[1].fd = _listenSocket;
+        for (size_t i = 0; i < _clients.size(); ++i) {
+            fds[2+i].fd = _clients[i].socket;
+        } // for
+        for (size_t i = 0; i < fds.size(); ++i) {
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        } // for
+
+        if (poll(&fds[0], fds.size(), -1) < 0) {
+            if (EINTR == errno) { continue; }
+            std::ostringstream msg;
+            msg << "Error waiting for query server requests: " << strerror(errno) << ".";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        if (fds[0].revents) {
+            char buffer[64];
+            while (read(_wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+            break;
+        } // if
+
+        std::vector<Client> clients;
+        clients.reserve(_clients.size()+1);
+        for (size_t i = 0; i < _clients.size(); ++i) {
+            if (!fds[2+i].revents || _receive(&_clients[i])) {
+                clients.push_back(std::move(_clients[i]));
+            } else {
+                ::close(_clients[i].socket);
+            } // if/else
+        } // for
+
+        if (fds[1].revents & POLLIN) {
+            Client client;
+            client.socket = accept(_listenSocket, nullptr, nullptr);
+            client.numBytes = 0;
+            if (client.socket >= 0) {
+                // Do not let a client that does not read its response block other clients for long.
+                timeval timeout;
+                timeout.tv_sec = _QueryServer::TIMEOUT_SECONDS;
+                timeout.tv_usec = 0;
+                setsockopt(client.socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                _QueryServer::setCloseOnExec(client.socket);
+                clients.push_back(client);
+            } // if
+        } // if
+        _clients.swap(clients);
+    } // while
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Stop run().
+void
+geomodelgrids::serial::QueryServer::stop(void) {
+    if (_wakePipe[1] >= 0) {
+        const char wake = 1;
+        ssize_t numWritten = write(_wakePipe[1], &wake, 1);
+        (void)numWritten; // Pipe is only full if a wakeup is already pending.
+    } // if
+} // stop
+
+
+// ------------------------------------------------------------------------------------------------
+// Close connections and socket and remove socket file.
+void
+geomodelgrids::serial::QueryServer::close(void) {
+    for (size_t i = 0; i < _clients.size(); ++i) {
+        ::close(_clients[i].socket);
+    } // for
+    _clients.clear();
+
+    if (_listenSocket >= 0) {
+        ::close(_listenSocket);_listenSocket = -1;
+        unlink(_socketPath.c_str());
+    } // if
+    _socketPath = "";
+
+    for (size_t i = 0; i < 2; ++i) {
+        if (_wakePipe[i] >= 0) {
+            ::close(_wakePipe[i]);_wakePipe[i] = -1;
+        } // if
+    } // for
+    _query = nullptr;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of requests answered.
+size_t
+geomodelgrids::serial::QueryServer::getNumRequests(void) const {
+    return _numRequests;
+} // getNumRequests
+
+
+// ------------------------------------------------------------------------------------------------
+// Receive available bytes of request from client and answer it once it is complete.
+bool
+geomodelgrids::serial::QueryServer::_receive(Client* client) {
+    assert(client);
+
+    // Read only up to the end of the current request, so the next request stays in the socket.
+    const size_t headerBytes = sizeof(QueryProtocol::Header);
+    size_t requestBytes = headerBytes + client->points.size()*sizeof(double);
+    while (client->numBytes < requestBytes) {
+        char* buffer = (client->numBytes < headerBytes) ?
+                       reinterpret_cast<char*>(&client->header) + client->numBytes :
+                       reinterpret_cast<char*>(client->points.data()) + (client->numBytes - headerBytes);
+        const size_t numBytes = (client->numBytes < headerBytes) ?
+                                headerBytes - client->numBytes : requestBytes - client->numBytes;
+        const ssize_t n = recv(client->socket, buffer, numBytes, MSG_DONTWAIT);
+        if (n < 0) {
+            if (EINTR == errno) { continue; }
+            // Rest of request has not arrived yet; wait for it without blocking other clients.
+            return (EAGAIN == errno) || (EWOULDBLOCK == errno);
+        } else if (0 == n) {
+            return false; // Client closed connection (possibly in the middle of a request).
+        } // if/else
+        client->numBytes += size_t(n);
+
+        if (client->numBytes == headerBytes) {
+            if (QueryProtocol::MAGIC != client->header.magic) {
+                return false;
+            } // if
+            const size_t pointSize = _QueryServer::getPointSize(client->header.type);
+            if (pointSize && (client->header.count > QueryProtocol::MAX_POINTS)) {
+                try {
+                    _QueryServer::writeError(client->socket, "Too many points in query server request.");
+                } catch (const std::exception&) {} // Dropping client anyway.
+                return false;
+            } // if
+            client->points.resize(pointSize*client->header.count);
+            requestBytes = headerBytes + client->points.size()*sizeof(double);
+        } // if
+    } // while
+
+    const bool isOkay = _answer(client->socket, client->header, client->points);
+    client->points.clear();
+    client->points.shrink_to_fit(); // Do not hold memory of large requests for idle clients.
+    client->numBytes = 0;
+
+    return isOkay;
+} // _receive
+
+
+// ------------------------------------------------------------------------------------------------
+// Send response to request.
+bool
+geomodelgrids::serial::QueryServer::_answer(const int socket,
+                                            const QueryProtocol::Header& header,
+                                            const std::vector<double>& points) {
+    assert(_query);
+
+    try {
+        ++_numRequests;
+
+        const size_t numPoints = header.count;
+        switch (header.type) {
+        case QueryProtocol::REQUEST_INFO: {
+            const std::vector<std::string>& valueNames = _query->getValueNames();
+            QueryProtocol::writeHeader(socket, geomodelgrids::utils::ErrorHandler::OK, valueNames.size());
+            for (size_t i = 0; i < valueNames.size(); ++i) {
+                QueryProtocol::writeString(socket, valueNames[i]);
+            } // for
+            break;
+        } // REQUEST_INFO
+        case QueryProtocol::REQUEST_VALUES: {
+            const size_t spaceDim = 3;
+            assert(points.size() == numPoints*spaceDim);
+            const size_t numValues = _query->getValueNames().size();
+            std::vector<double> values(numPoints*numValues);
+            std::vector<int> status(numPoints);
+            int err = geomodelgrids::utils::ErrorHandler::OK;
+            try {
+                err = (numPoints) ? _query->queryPoints(values.data(), numValues, &points[0], &points[1], &points[2],
+                                                        spaceDim, numPoints, status.data()) : err;
+            } catch (const std::exception& error) {
+                _query->getErrorHandler()->setError(error.what());
+                err = geomodelgrids::utils::ErrorHandler::ERROR;
+            } // try/catch
+            if (geomodelgrids::utils::ErrorHandler::ERROR == err) {
+                _QueryServer::writeError(socket, _query->getErrorHandler()->getMessage());
+                _query->getErrorHandler()->resetStatus();
+                break;
+            } // if
+
+            std::vector<int32_t> status32(status.begin(), status.end());
+            QueryProtocol::writeHeader(socket, err, numPoints);
+            QueryProtocol::writeBytes(socket, values.data(), values.size()*sizeof(double));
+            QueryProtocol::writeBytes(socket, status32.data(), status32.size()*sizeof(int32_t));
+            break;
+        } // REQUEST_VALUES
+        case QueryProtocol::REQUEST_TOP_ELEVATION:
+        case QueryProtocol::REQUEST_TOPOBATHY_ELEVATION: {
+            const size_t spaceDim = 2;
+            assert(points.size() == numPoints*spaceDim);
+
+            std::vector<double> elevations(numPoints);
+            try {
+                if (QueryProtocol::REQUEST_TOP_ELEVATION == header.type) {
+                    _query->queryTopElevations(elevations.data(), points.data(), numPoints);
+                } else {
+                    _query->queryTopoBathyElevations(elevations.data(), points.data(), numPoints);
+                } // if/else
+            } catch (const std::exception& error) {
+                _QueryServer::writeError(socket, error.what());
+                break;
+            } // try/catch
+            QueryProtocol::writeHeader(socket, geomodelgrids::utils::ErrorHandler::OK, numPoints);
+            QueryProtocol::writeBytes(socket, elevations.data(), elevations.size()*sizeof(double));
+            break;
+        } // REQUEST_*_ELEVATION
+        case QueryProtocol::REQUEST_SHUTDOWN: {
+            QueryProtocol::writeHeader(socket, geomodelgrids::utils::ErrorHandler::OK, 0);
+            _isStopping = true;
+            break;
+        } // REQUEST_SHUTDOWN
+        default: {
+            std::ostringstream msg;
+            msg << "Unknown query server request type " << header.type << ".";
+            _QueryServer::writeError(socket, msg.str());
+            return false;
+        } // default
+        } // switch
+    } catch (const std::exception&) {
+        // Broken or malformed connection; drop the client.
+        return false;
+    } // try/catch
+
+    return true;
+} // _answer
+
+
+// End of file
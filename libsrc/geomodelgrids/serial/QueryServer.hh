@@ -0,0 +1,113 @@
+/** Resident server answering batched queries from other processes over a local (Unix-domain) socket.
+ *
+ * The server keeps an initialized Query, with its models, coordinate transformations, and hyperslabs, resident
+ * in memory so that many short-lived processes on a node can share one warm query instead of each paying for
+ * opening models and filling caches. Clients (see QueryClient) send batches of points and receive arrays of
+ * values using the binary protocol in QueryProtocol.
+ *
+ * Connections are multiplexed on a single thread, so requests are answered one at a time in the order they
+ * arrive; Query is not thread safe. Requests are received without blocking, so a client that stops in the middle
+ * of a request does not hold up the other clients. Responses are sent with a short timeout, after which a client
+ * that does not read its response is dropped.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/QueryProtocol.hh" // HASA QueryProtocol::Header
+
+#include <string> // HASA std::string
+#include <vector> // HASA std::vector
+
+class geomodelgrids::serial::QueryServer {
+    friend class TestQueryServer; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    QueryServer(void);
+
+    /// Destructor
+    ~QueryServer(void);
+
+    /** Create socket and listen for connections.
+     *
+     * If a socket file exists at socketPath and no server is listening on it, the stale file is removed.
+     *
+     * @param[in] socketPath Path of Unix-domain socket.
+     * @param[in] query Query used to answer requests (must be initialized).
+     */
+    void open(const char* socketPath,
+              geomodelgrids::serial::Query* query);
+
+    /// Answer requests until stop() is called or a client requests shutdown.
+    void run(void);
+
+    /** Stop run().
+     *
+     * Safe to call from other threads and from signal handlers.
+     */
+    void stop(void);
+
+    /// Close connections and socket and remove the socket file.
+    void close(void);
+
+    /** Get number of requests answered.
+     *
+     * @returns Number of requests.
+     */
+    size_t getNumRequests(void) const;
+
+    // PRIVATE STRUCTS ----------------------------------------------------------------------------
+private:
+
+    /// Connected client and the part of its current request received so far.
+    struct Client {
+        int socket; ///< Socket of client.
+        QueryProtocol::Header header; ///< Header of request.
+        std::vector<double> points; ///< Points in request.
+        size_t numBytes; ///< Number of bytes of request (header and points) received.
+    }; // Client
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Receive available bytes of request from client without blocking and answer it once it is complete.
+     *
+     * @param[inout] client Client with request.
+     * @returns False if client closed connection or connection should be closed, true otherwise.
+     */
+    bool _receive(Client* client);
+
+    /** Send response to request.
+     *
+     * @param[in] socket Socket of client.
+     * @param[in] header Header of request.
+     * @param[in] points Points in request.
+     * @returns False if connection should be closed, true otherwise.
+     */
+    bool _answer(const int socket,
+                 const QueryProtocol::Header& header,
+                 const std::vector<double>& points);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    geomodelgrids::serial::Query* _query; ///< Query used to answer requests.
+    std::string _socketPath; ///< Path of Unix-domain socket.
+    int _listenSocket; ///< Socket listening for connections.
+    int _wakePipe[2]; ///< Pipe used to wake up run() when stopping.
+    std::vector<Client> _clients; ///< Connected clients.
+    size_t _numRequests; ///< Number of requests answered.
+    bool _isStopping; ///< True if a client requested shutdown.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    QueryServer(const QueryServer&); ///< Not implemented
+    const QueryServer& operator=(const QueryServer&); ///< Not implemented
+
+}; // QueryServer
+
+// End of file
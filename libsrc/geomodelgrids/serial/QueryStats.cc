@@ -0,0 +1,86 @@
+#include <portinfo>
+
+#include "QueryStats.hh" // implementation of class methods
+
+#include <chrono> // USES std::chrono
+#include <ostream> // USES std::ostream
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::QueryStats::QueryStats(void) {
+    reset();
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::QueryStats::~QueryStats(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Reset all counters and timers to zero.
+void
+geomodelgrids::serial::QueryStats::reset(void) {
+    numPoints = 0;
+    numPointsFound = 0;
+    numPointsOutside = 0;
+    numTransforms = 0;
+    numSurfaceQueries = 0;
+    numHyperslabHits = 0;
+    numHyperslabPrefetchHits = 0;
+    numHyperslabMisses = 0;
+    numBytesRead = 0;
+    timeTransform = 0.0;
+    timeIO = 0.0;
+    timeInterpolate = 0.0;
+} // reset
+
+
+// ------------------------------------------------------------------------------------------------
+// Add counters and timers from other statistics.
+void
+geomodelgrids::serial::QueryStats::add(const QueryStats& other) {
+    numPoints += other.numPoints;
+    numPointsFound += other.numPointsFound;
+    numPointsOutside += other.numPointsOutside;
+    numTransforms += other.numTransforms;
+    numSurfaceQueries += other.numSurfaceQueries;
+    numHyperslabHits += other.numHyperslabHits;
+    numHyperslabPrefetchHits += other.numHyperslabPrefetchHits;
+    numHyperslabMisses += other.numHyperslabMisses;
+    numBytesRead += other.numBytesRead;
+    timeTransform += other.timeTransform;
+    timeIO += other.timeIO;
+    timeInterpolate += other.timeInterpolate;
+} // add
+
+
+// ------------------------------------------------------------------------------------------------
+// Write statistics in human readable form.
+void
+geomodelgrids::serial::QueryStats::write(std::ostream& sout) const {
+    sout << "Query statistics\n"
+         << "    Points queried: " << numPoints << "\n"
+         << "    Points found: " << numPointsFound << "\n"
+         << "    Points outside all models: " << numPointsOutside << "\n"
+         << "    CRS transformations: " << numTransforms << "\n"
+         << "    Surface lookups: " << numSurfaceQueries << "\n"
+         << "    Hyperslab hits: " << numHyperslabHits << "\n"
+         << "    Hyperslab prefetch hits: " << numHyperslabPrefetchHits << "\n"
+         << "    Hyperslab misses: " << numHyperslabMisses << "\n"
+         << "    Bytes read: " << numBytesRead << "\n"
+         << "    Time in CRS transformations (s): " << timeTransform << "\n"
+         << "    Time in I/O (s): " << timeIO << "\n"
+         << "    Time in interpolation (s): " << timeInterpolate << "\n";
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Get current time for timers.
+double
+geomodelgrids::serial::QueryStats::now(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} // now
+
+
+// End of file
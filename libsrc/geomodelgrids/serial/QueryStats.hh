@@ -0,0 +1,63 @@
+/** Statistics collected while querying models.
+ *
+ * Collecting statistics is opt-in. Objects that perform the work (Model, Surface, Block, Hyperslab) hold a pointer to
+ * the statistics object and only update it when the pointer is not null.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <cstddef> // USES size_t
+#include <iosfwd> // USES std::ostream
+
+class geomodelgrids::serial::QueryStats {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    QueryStats(void);
+
+    /// Destructor
+    ~QueryStats(void);
+
+    /// Reset all counters and timers to zero.
+    void reset(void);
+
+    /** Add counters and timers from other statistics (for example, from another thread).
+     *
+     * @param[in] other Statistics to add.
+     */
+    void add(const QueryStats& other);
+
+    /** Write statistics in human readable form.
+     *
+     * @param[inout] sout Output stream.
+     */
+    void write(std::ostream& sout) const;
+
+    /** Get current time for timers.
+     *
+     * @returns Time in seconds relative to an arbitrary (fixed) point in time.
+     */
+    static
+    double now(void);
+
+    // PUBLIC MEMBERS -----------------------------------------------------------------------------
+public:
+
+    size_t numPoints; ///< Number of points queried for values.
+    size_t numPointsFound; ///< Number of points found in a model.
+    size_t numPointsOutside; ///< Number of points outside all models.
+    size_t numTransforms; ///< Number of coordinate system transformations (forward and inverse).
+    size_t numSurfaceQueries; ///< Number of surface elevation lookups.
+    size_t numHyperslabHits; ///< Number of lookups satisfied by the current hyperslab.
+    size_t numHyperslabPrefetchHits; ///< Number of lookups satisfied by the prefetched hyperslab.
+    size_t numHyperslabMisses; ///< Number of lookups requiring a hyperslab read from the file.
+    size_t numBytesRead; ///< Number of bytes read from HDF5 files into hyperslabs used (not discarded prefetches).
+    double timeTransform; ///< Time (s) spent in coordinate system transformations.
+    double timeIO; ///< Time (s) spent waiting on hyperslab reads.
+    double timeInterpolate; ///< Time (s) spent interpolating values from hyperslabs.
+
+}; // QueryStats
+
+// End of file
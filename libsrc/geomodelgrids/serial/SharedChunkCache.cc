@@ -0,0 +1,368 @@
+#include <portinfo>
+
+#include "SharedChunkCache.hh" // implementation of class methods
+
+#include <sys/mman.h> // USES shm_open(), shm_unlink(), mmap(), munmap()
+#include <sys/stat.h> // USES fstat()
+#include <fcntl.h> // USES O_CREAT, O_EXCL, O_RDWR
+#include <unistd.h> // USES ftruncate(), close(), usleep()
+#include <atomic> // USES std::atomic
+#include <cerrno> // USES errno
+#include <cstring> // USES memcpy(), strerror()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+#if !defined(ATOMIC_LLONG_LOCK_FREE) || ATOMIC_LLONG_LOCK_FREE != 2
+#error "Shared chunk cache requires lock-free 64-bit atomics."
+#endif
+
+const size_t geomodelgrids::serial::SharedChunkCache::DEFAULT_CACHE_BYTES = 1024*1048576;
+const size_t geomodelgrids::serial::SharedChunkCache::DEFAULT_SLOT_BYTES = 1048576;
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _SharedChunkCache;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_SharedChunkCache {
+public:
+
+    /// Layout of shared memory: header followed by slots.
+    struct Header {
+        std::atomic<uint64_t> magic; ///< Set to MAGIC once the creator has initialized the header.
+        uint64_t numSlots; ///< Number of slots.
+        uint64_t slotBytes; ///< Maximum size of chunk in slot.
+        uint64_t slotStride; ///< Distance in bytes between slots.
+        std::atomic<uint64_t> clock; ///< Counter used to pick slots to evict.
+    }; // Header
+
+    /// Slot header; chunk values follow.
+    struct Slot {
+        std::atomic<uint64_t> sequence; ///< Odd while a process is writing the slot.
+        std::atomic<uint64_t> key; ///< Key of chunk in slot (0 if empty).
+        std::atomic<uint64_t> numBytes; ///< Size of chunk in slot.
+    }; // Slot
+
+    static const uint64_t MAGIC; ///< Marks initialized cache.
+    static const size_t ALIGNMENT; ///< Alignment of header and slots.
+    static const size_t NUM_WAYS; ///< Number of slots that may hold a given chunk.
+    static const size_t OPEN_TIMEOUT_USECS; ///< Time to wait for creator to initialize cache.
+
+    /** Round up to multiple of ALIGNMENT.
+     *
+     * @param[in] numBytes Number of bytes.
+     * @returns Number of bytes rounded up to multiple of ALIGNMENT.
+     */
+    static
+    size_t align(const size_t numBytes) {
+        return ((numBytes + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+    } // align
+
+    /** Get header of cache.
+     *
+     * @param[in] memory Mapped shared memory.
+     * @returns Header.
+     */
+    static
+    Header* header(void* memory) {
+        return static_cast<Header*>(memory);
+    } // header
+
+    /** Get slot.
+     *
+     * @param[in] memory Mapped shared memory.
+     * @param[in] key Key of chunk.
+     * @param[in] way Index of slot among those that may hold chunk.
+     * @returns Slot.
+     */
+    static
+    Slot* slot(void* memory,
+               const uint64_t key,
+               const size_t way) {
+        const Header* h = header(memory);
+        const size_t index = (key + way) % h->numSlots;
+        char* slots = static_cast<char*>(memory) + align(sizeof(Header));
+        return reinterpret_cast<Slot*>(slots + index*h->slotStride);
+    } // slot
+
+    /** Get chunk values in slot.
+     *
+     * @param[in] s Slot.
+     * @returns Pointer to chunk values.
+     */
+    static
+    char* data(Slot* s) {
+        return reinterpret_cast<char*>(s) + align(sizeof(Slot));
+    } // data
+
+    /** Map key to nonzero value (0 marks empty slots).
+     *
+     * @param[in] key Key of chunk.
+     * @returns Nonzero key.
+     */
+    static
+    uint64_t nonzero(const uint64_t key) {
+        return (key) ? key : 1;
+    } // nonzero
+
+}; // _SharedChunkCache
+
+const uint64_t geomodelgrids::serial::_SharedChunkCache::MAGIC = 0x474d47434143484bULL;
+const size_t geomodelgrids::serial::_SharedChunkCache::ALIGNMENT = 64;
+const size_t geomodelgrids::serial::_SharedChunkCache::NUM_WAYS = 4;
+const size_t geomodelgrids::serial::_SharedChunkCache::OPEN_TIMEOUT_USECS = 10000000;
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::SharedChunkCache::SharedChunkCache(void) :
+    _memory(nullptr),
+    _memoryBytes(0) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::SharedChunkCache::~SharedChunkCache(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Open cache, creating it if it does not exist.
+void
+geomodelgrids::serial::SharedChunkCache::open(const char* name,
+                                              const size_t cacheBytes,
+                                              const size_t slotBytes) {
+    if (_memory) {
+        throw std::logic_error("Shared chunk cache already open.");
+    } // if
+    if (!name || !strlen(name)) {
+        throw std::invalid_argument("Name of shared chunk cache must not be empty.");
+    } // if
+    _name = ('/' == name[0]) ? name : std::string("/") + name;
+
+    const size_t headerBytes = _SharedChunkCache::align(sizeof(_SharedChunkCache::Header));
+    const size_t slotStride = _SharedChunkCache::align(sizeof(_SharedChunkCache::Slot))
+                              + _SharedChunkCache::align(slotBytes);
+    const size_t numSlots = (cacheBytes > headerBytes) ? (cacheBytes - headerBytes) / slotStride : 0;
+
+    int fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    const bool isCreator = (fd >= 0);
+    if (isCreator) {
+        if (!slotBytes || !numSlots) {
+            ::close(fd);
+            shm_unlink(_name.c_str());
+            std::ostringstream msg;
+            msg << "Shared chunk cache of " << cacheBytes << " bytes is too small for slots of " << slotBytes
+                << " bytes.";
+            throw std::invalid_argument(msg.str());
+        } // if
+        _memoryBytes = headerBytes + numSlots*slotStride;
+        if (ftruncate(fd, off_t(_memoryBytes))) {
+            const int err = errno;
+            ::close(fd);
+            shm_unlink(_name.c_str());
+            std::ostringstream msg;
+            msg << "Could not set size of shared chunk cache '" << _name << "': " << strerror(err) << ".";
+            throw std::runtime_error(msg.str());
+        } // if
+    } else if (EEXIST == errno) {
+        fd = shm_open(_name.c_str(), O_RDWR, 0600);
+        // Wait for the creator to set the size.
+        struct stat fileStatus;
+        for (size_t t = 0; fd >= 0; t += 1000) {
+            if (fstat(fd, &fileStatus)) {
+                break;
+            } // if
+            _memoryBytes = size_t(fileStatus.st_size);
+            if (_memoryBytes >= headerBytes) {
+                break;
+            } else if (t > _SharedChunkCache::OPEN_TIMEOUT_USECS) {
+                ::close(fd);fd = -1;
+                errno = ETIMEDOUT;
+            } else {
+                usleep(1000);
+            } // if/else
+        } // for
+    } // if/else
+    if (fd < 0) {
+        std::ostringstream msg;
+        msg << "Could not open shared chunk cache '" << _name << "': " << strerror(errno) << ".";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    void* memory = mmap(nullptr, _memoryBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (MAP_FAILED == memory) {
+        std::ostringstream msg;
+        msg << "Could not map shared chunk cache '" << _name << "': " << strerror(errno) << ".";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    // New shared memory is zero filled, so all slots are empty.
+    _SharedChunkCache::Header* header = _SharedChunkCache::header(memory);
+    if (isCreator) {
+        header->numSlots = numSlots;
+        header->slotBytes = slotBytes;
+        header->slotStride = slotStride;
+        header->magic.store(_SharedChunkCache::MAGIC, std::memory_order_release);
+    } else {
+        for (size_t t = 0; _SharedChunkCache::MAGIC != header->magic.load(std::memory_order_acquire); t += 1000) {
+            if (t > _SharedChunkCache::OPEN_TIMEOUT_USECS) {
+                munmap(memory, _memoryBytes);
+                std::ostringstream msg;
+                msg << "Timed out waiting for shared chunk cache '" << _name << "' to be initialized.";
+                throw std::runtime_error(msg.str());
+            } // if
+            usleep(1000);
+        } // for
+        if (headerBytes + header->numSlots*header->slotStride > _memoryBytes) {
+            munmap(memory, _memoryBytes);
+            std::ostringstream msg;
+            msg << "Shared chunk cache '" << _name << "' is corrupted.";
+            throw std::runtime_error(msg.str());
+        } // if
+    } // if/else
+    _memory = memory;
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Close cache.
+void
+geomodelgrids::serial::SharedChunkCache::close(void) {
+    if (_memory) {
+        munmap(_memory, _memoryBytes);
+    } // if
+    _memory = nullptr;
+    _memoryBytes = 0;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Check if cache is open.
+bool
+geomodelgrids::serial::SharedChunkCache::isOpen(void) const {
+    return _memory != nullptr;
+} // isOpen
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of slots in cache.
+size_t
+geomodelgrids::serial::SharedChunkCache::getNumSlots(void) const {
+    return (_memory) ? size_t(_SharedChunkCache::header(_memory)->numSlots) : 0;
+} // getNumSlots
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum size of a chunk in the cache.
+size_t
+geomodelgrids::serial::SharedChunkCache::getSlotBytes(void) const {
+    return (_memory) ? size_t(_SharedChunkCache::header(_memory)->slotBytes) : 0;
+} // getSlotBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy chunk from cache.
+bool
+geomodelgrids::serial::SharedChunkCache::get(void* buffer,
+                                             const uint64_t key,
+                                             const size_t numBytes) const {
+    assert(buffer);
+    if (!_memory || (numBytes > getSlotBytes())) {
+        return false;
+    } // if
+
+    const uint64_t slotKey = _SharedChunkCache::nonzero(key);
+    for (size_t way = 0; way < _SharedChunkCache::NUM_WAYS; ++way) {
+        _SharedChunkCache::Slot* slot = _SharedChunkCache::slot(_memory, slotKey, way);
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) || (slot->key.load(std::memory_order_relaxed) != slotKey) ||
+            (slot->numBytes.load(std::memory_order_relaxed) != numBytes)) {
+            continue;
+        } // if
+        memcpy(buffer, _SharedChunkCache::data(slot), numBytes);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == sequence) {
+            return true;
+        } // if
+    } // for
+
+    return false;
+} // get
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy chunk into cache.
+bool
+geomodelgrids::serial::SharedChunkCache::put(const uint64_t key,
+                                             const void* buffer,
+                                             const size_t numBytes) {
+    assert(buffer);
+    if (!_memory || (numBytes > getSlotBytes())) {
+        return false;
+    } // if
+
+    // Use an empty slot if there is one; otherwise evict slots in turn.
+    const uint64_t slotKey = _SharedChunkCache::nonzero(key);
+    _SharedChunkCache::Slot* slot = nullptr;
+    for (size_t way = 0; way < _SharedChunkCache::NUM_WAYS; ++way) {
+        _SharedChunkCache::Slot* s = _SharedChunkCache::slot(_memory, slotKey, way);
+        const uint64_t keyCurrent = s->key.load(std::memory_order_relaxed);
+        if (keyCurrent == slotKey) {
+            return false; // Another process already stored chunk.
+        } else if (!keyCurrent && !slot) {
+            slot = s;
+        } // if/else
+    } // for
+    if (!slot) {
+        const size_t way = _SharedChunkCache::header(_memory)->clock.fetch_add(1, std::memory_order_relaxed);
+        slot = _SharedChunkCache::slot(_memory, slotKey, way % _SharedChunkCache::NUM_WAYS);
+    } // if
+
+    uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) ||
+        !slot->sequence.compare_exchange_strong(sequence, sequence+1, std::memory_order_acquire)) {
+        return false; // Another process is writing slot.
+    } // if
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->key.store(slotKey, std::memory_order_relaxed);
+    slot->numBytes.store(numBytes, std::memory_order_relaxed);
+    memcpy(_SharedChunkCache::data(slot), buffer, numBytes);
+    slot->sequence.store(sequence+2, std::memory_order_release);
+
+    return true;
+} // put
+
+
+// ------------------------------------------------------------------------------------------------
+// Remove shared memory for cache.
+void
+geomodelgrids::serial::SharedChunkCache::remove(const char* name) {
+    if (name && strlen(name)) {
+        const std::string path = ('/' == name[0]) ? name : std::string("/") + name;
+        shm_unlink(path.c_str());
+    } // if
+} // remove
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute key from bytes (64-bit FNV-1a hash).
+uint64_t
+geomodelgrids::serial::SharedChunkCache::hash(const void* bytes,
+                                              const size_t numBytes,
+                                              const uint64_t key) {
+    uint64_t value = (key) ? key : 14695981039346656037ULL;
+    const unsigned char* b = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < numBytes; ++i) {
+        value ^= b[i];
+        value *= 1099511628211ULL;
+    } // for
+    return value;
+} // hash
+
+
+// End of file
@@ -0,0 +1,134 @@
+/** Cache of decoded dataset chunks in POSIX shared memory shared by all processes on a node.
+ *
+ * Each process that opens a model has its own HDF5 chunk cache and hyperslabs, so many processes on a node
+ * querying the same region of a model hold many copies of the same chunks and each reads and decompresses them
+ * from the file. With a shared chunk cache, the first process that needs a chunk reads it from the file and stores
+ * the decoded values in the cache; the other processes copy the values from the cache.
+ *
+ * The cache is a fixed number of fixed-size slots. A chunk is stored in one of a small set of slots selected by a
+ * hash of its key. Each slot is guarded by a sequence number (seqlock): writers claim a slot by atomically making
+ * the sequence number odd and release it by making it even again, and readers retry from the file if the sequence
+ * number is odd or changes while they copy the values. Neither readers nor writers ever wait, so a process that
+ * dies while writing a slot only loses that slot.
+ *
+ * The first process to open a cache with a given name creates it and sets its size; later processes use the size
+ * of the existing cache. The shared memory persists until it is removed with remove() (or the node reboots).
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <string> // HASA std::string
+#include <cstddef> // USES size_t
+#include <cstdint> // USES uint64_t
+
+class geomodelgrids::serial::SharedChunkCache {
+    friend class TestSharedChunkCache; // Unit testing
+
+    // PUBLIC CONSTANTS ---------------------------------------------------------------------------
+public:
+
+    static const size_t DEFAULT_CACHE_BYTES; ///< Default size of cache.
+    static const size_t DEFAULT_SLOT_BYTES; ///< Default maximum size of a chunk in the cache.
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    SharedChunkCache(void);
+
+    /// Destructor
+    ~SharedChunkCache(void);
+
+    /** Open cache, creating it if it does not exist.
+     *
+     * @param[in] name Name of POSIX shared memory object (for example, "/geomodelgrids-job1234").
+     * @param[in] cacheBytes Size of cache in bytes (ignored if cache exists).
+     * @param[in] slotBytes Maximum size of a chunk in bytes (ignored if cache exists).
+     */
+    void open(const char* name,
+              const size_t cacheBytes=DEFAULT_CACHE_BYTES,
+              const size_t slotBytes=DEFAULT_SLOT_BYTES);
+
+    /// Close cache (the shared memory persists until it is removed).
+    void close(void);
+
+    /** Check if cache is open.
+     *
+     * @returns True if cache is open, false otherwise.
+     */
+    bool isOpen(void) const;
+
+    /** Get number of slots in cache.
+     *
+     * @returns Number of slots.
+     */
+    size_t getNumSlots(void) const;
+
+    /** Get maximum size of a chunk in the cache.
+     *
+     * @returns Size of slots in bytes.
+     */
+    size_t getSlotBytes(void) const;
+
+    /** Copy chunk from cache.
+     *
+     * @param[out] buffer Buffer for chunk.
+     * @param[in] key Key of chunk.
+     * @param[in] numBytes Size of chunk in bytes.
+     * @returns True if chunk was found, false otherwise.
+     */
+    bool get(void* buffer,
+             const uint64_t key,
+             const size_t numBytes) const;
+
+    /** Copy chunk into cache.
+     *
+     * The chunk is not stored if it is larger than the slots or if another process is writing the slot.
+     *
+     * @param[in] key Key of chunk.
+     * @param[in] buffer Chunk.
+     * @param[in] numBytes Size of chunk in bytes.
+     * @returns True if chunk was stored, false otherwise.
+     */
+    bool put(const uint64_t key,
+             const void* buffer,
+             const size_t numBytes);
+
+    /** Remove shared memory for cache.
+     *
+     * Processes that have the cache open can continue to use it.
+     *
+     * @param[in] name Name of POSIX shared memory object.
+     */
+    static
+    void remove(const char* name);
+
+    /** Compute key from bytes, continuing from a previous key.
+     *
+     * @param[in] bytes Bytes to hash.
+     * @param[in] numBytes Number of bytes.
+     * @param[in] key Previous key (0 to start a new key).
+     * @returns Key.
+     */
+    static
+    uint64_t hash(const void* bytes,
+                  const size_t numBytes,
+                  const uint64_t key=0);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::string _name; ///< Name of shared memory object.
+    void* _memory; ///< Mapped shared memory.
+    size_t _memoryBytes; ///< Size of mapped shared memory.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    SharedChunkCache(const SharedChunkCache&); ///< Not implemented
+    const SharedChunkCache& operator=(const SharedChunkCache&); ///< Not implemented
+
+}; // SharedChunkCache
+
+// End of file
@@ -4,6 +4,7 @@
 
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
 #include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/Indexing.hh" // USES Resolution
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 					    
@@ -18,17 +19,21 @@
 geomodelgrids::serial::Surface::Surface(const char* const name) :
     _hyperslab(nullptr),
     _name(name),
+    _level(0),
     _resolutionX(0.0),
     _resolutionY(0.0),
     _coordinatesX(nullptr),
     _coordinatesY(nullptr),
     _indexingX(nullptr),
-    _indexingY(nullptr) {
+    _indexingY(nullptr),
+    _hyperslabMaxBytes(geomodelgrids::serial::Hyperslab::DEFAULT_MAX_BYTES),
+    _hyperslabPrefetch(false),
+    _stats(nullptr) {
     _dims[0] = 0;
     _dims[1] = 0;
 
-    _hyperslabDims[0] = 128;
-    _hyperslabDims[1] = 128;
+    _hyperslabDims[0] = 0;
+    _hyperslabDims[1] = 0;
     _hyperslabDims[2] = 1;
 } // constructor
 
@@ -51,7 +56,7 @@ void
 geomodelgrids::serial::Surface::loadMetadata(geomodelgrids::serial::HDF5* const h5) {
     assert(h5);
 
-    const std::string& surfacePath = std::string("surfaces/") + _name;
+    const std::string& surfacePath = getPath();
 
     std::ostringstream msg;
     const char* indent = "            ";
@@ -122,6 +127,43 @@ geomodelgrids::serial::Surface::loadMetadata(geomodelgrids::serial::HDF5* const
 } // loadMetadata
 
 
+// ------------------------------------------------------------------------------------------------
+// Get name of surface.
+const std::string&
+geomodelgrids::serial::Surface::getName(void) const {
+    return _name;
+} // getName
+
+
+// ------------------------------------------------------------------------------------------------
+// Set level of surface in multi-resolution pyramid.
+void
+geomodelgrids::serial::Surface::setLevel(const size_t value) {
+    _level = value;
+} // setLevel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get level of surface in multi-resolution pyramid.
+size_t
+geomodelgrids::serial::Surface::getLevel(void) const {
+    return _level;
+} // getLevel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get path of surface dataset in model file.
+std::string
+geomodelgrids::serial::Surface::getPath(void) const {
+    std::ostringstream path;
+    if (_level > 0) {
+        path << "pyramid/level_" << _level << "/";
+    } // if
+    path << "surfaces/" << _name;
+    return path.str();
+} // getPath
+
+
 // ------------------------------------------------------------------------------------------------
 // Get resolution along x-axis.
 double
@@ -182,17 +224,44 @@ geomodelgrids::serial::Surface::setHyperslabDims(const size_t dims[],
 } // setHyperslabDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for automatically sized hyperslab dimensions.
+void
+geomodelgrids::serial::Surface::setHyperslabMaxBytes(const size_t value) {
+    _hyperslabMaxBytes = value;
+} // setHyperslabMaxBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+void
+geomodelgrids::serial::Surface::setHyperslabPrefetch(const bool value) {
+    _hyperslabPrefetch = value;
+} // setHyperslabPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set statistics object for collecting query statistics.
+void
+geomodelgrids::serial::Surface::setStats(geomodelgrids::serial::QueryStats* const stats) {
+    _stats = stats;
+} // setStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Prepare for querying.
 void
 geomodelgrids::serial::Surface::openQuery(geomodelgrids::serial::HDF5* const h5) {
     const size_t ndims = 3;
     hsize_t dims[ndims];
-    dims[0] = 128;
-    dims[1] = 128;
-    dims[2] = 1;
-    const std::string& surfacePath = std::string("surfaces/") + _name;
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, surfacePath.c_str(), dims, ndims);
+    for (size_t i = 0; i < ndims; ++i) {
+        dims[i] = _hyperslabDims[i];
+    } // for
+    const std::string& surfacePath = getPath();
+    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, surfacePath.c_str(), dims, ndims,
+                                                                        _hyperslabMaxBytes);
+    _hyperslab->setPrefetch(_hyperslabPrefetch);
+    _hyperslab->setStats(_stats);
 } // openQuery
 
 
@@ -212,6 +281,10 @@ geomodelgrids::serial::Surface::query(const double x,
     assert(_indexingX);
     assert(_indexingY);
 
+    if (_stats) {
+        _stats->numSurfaceQueries++;
+    } // if
+
     double index[2];
     index[0] = _indexingX->getIndex(x);
     index[1] = _indexingY->getIndex(y);
@@ -28,6 +28,34 @@ public:
      */
     void loadMetadata(geomodelgrids::serial::HDF5* const h5);
 
+    /** Get name of surface.
+     *
+     * @returns Name of surface.
+     */
+    const std::string& getName(void) const;
+
+    /** Set level of surface in multi-resolution pyramid.
+     *
+     * Must be called before loadMetadata(). Level 0 is the full resolution surface stored at 'surfaces/NAME'.
+     * Level k is decimated by a factor of 2^k along the x and y axes and is stored at
+     * 'pyramid/level_k/surfaces/NAME'.
+     *
+     * @param[in] value Level in pyramid.
+     */
+    void setLevel(const size_t value);
+
+    /** Get level of surface in multi-resolution pyramid.
+     *
+     * @returns Level in pyramid.
+     */
+    size_t getLevel(void) const;
+
+    /** Get path of surface dataset in model file.
+     *
+     * @returns Path of dataset.
+     */
+    std::string getPath(void) const;
+
     /** Get resolution along x axis.
      *
      * @returns Resolution along x axis.
@@ -59,6 +87,9 @@ public:
     const size_t* getDims(void) const;
 
     /** Set hyperslab size.
+     *
+     * Dimensions that are zero are sized automatically from the chunk layout of the dataset when
+     * openQuery() is called.
      *
      * @param[in] dims Dimensions of hyperslab.
      * @param[in] ndims Number of dimensions.
@@ -66,6 +97,26 @@ public:
     void setHyperslabDims(const size_t dims[],
                           const size_t ndims);
 
+    /** Set memory budget for automatically sized hyperslab dimensions.
+     *
+     * @param[in] value Maximum size (in bytes) of hyperslab.
+     */
+    void setHyperslabMaxBytes(const size_t value);
+
+    /** Turn prefetching of the next hyperslab on/off.
+     *
+     * @param[in] value True if prefetching is on, false otherwise.
+     */
+    void setHyperslabPrefetch(const bool value);
+
+    /** Set statistics object for collecting query statistics.
+     *
+     * Must be called before openQuery().
+     *
+     * @param[in] stats Statistics object (nullptr to turn off collecting statistics).
+     */
+    void setStats(geomodelgrids::serial::QueryStats* const stats);
+
     /** Prepare for querying.
      *
      * @param[in] h5 HDF5 with model.
@@ -89,6 +140,7 @@ private:
 
     geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model.
     std::string _name; ///< Name of surface (matches dataset in HDF5 file).
+    size_t _level; ///< Level in multi-resolution pyramid.
 
     // Only resolution or coordinates are given.
     double _resolutionX; ///< Resolution along x axis.
@@ -100,7 +152,10 @@ private:
     geomodelgrids::utils::Indexing* _indexingY; ///< Procedure for finding index along y axis.
 
     size_t _dims[2]; ///< Number of points along grid in each x and y dimension [x, y].
-    size_t _hyperslabDims[3]; ///< Dimensions of hyperslab.
+    size_t _hyperslabDims[3]; ///< Dimensions of hyperslab (0 for automatic sizing).
+    size_t _hyperslabMaxBytes; ///< Memory budget for automatically sized hyperslab.
+    bool _hyperslabPrefetch; ///< True if prefetching next hyperslab.
+    geomodelgrids::serial::QueryStats* _stats; ///< Query statistics (nullptr if not collecting statistics).
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
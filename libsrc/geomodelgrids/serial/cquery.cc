@@ -5,6 +5,8 @@ extern "C" {
 }
 
 #include "Query.hh" // USES Query
+#include "QueryStats.hh" // USES QueryStats
+#include "SharedChunkCache.hh" // USES SharedChunkCache
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
@@ -14,6 +16,64 @@ extern "C" {
 #include <sstream> // USES std::ostringstream, std::istringstream
 #include <iomanip> // USES io manipulators
 
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _CQuery;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_CQuery {
+public:
+
+    /** Query for values at point with values of type T.
+     *
+     * @param[inout] handle Handle to query object.
+     * @param[out] values Array of values returned in query.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[in] function Name of C API function for error messages.
+     * @returns Status of error handler.
+     */
+    template<typename T>
+    static
+    int query(void* handle,
+              T* const values,
+              const double x,
+              const double y,
+              const double z,
+              const char* const function);
+
+    /** Query for values at many points with strided arrays and values of type T.
+     *
+     * @param[inout] handle Handle to query object.
+     * @param[out] values Array of values returned in query; values for point i start at values[i*valuesStride].
+     * @param[in] valuesStride Number of values between the starts of consecutive points.
+     * @param[in] x X coordinates of points (in input CRS).
+     * @param[in] y Y coordinates of points (in input CRS).
+     * @param[in] z Z coordinates of points (in input CRS).
+     * @param[in] pointsStride Number of values between coordinates of consecutive points.
+     * @param[in] numPoints Number of points.
+     * @param[out] status Status for each point (can be NULL).
+     * @param[in] function Name of C API function for error messages.
+     * @returns Status of error handler.
+     */
+    template<typename T>
+    static
+    int queryPointsStrided(void* handle,
+                           T* const values,
+                           const size_t valuesStride,
+                           const double* const x,
+                           const double* const y,
+                           const double* const z,
+                           const size_t pointsStride,
+                           const size_t numPoints,
+                           int* const status,
+                           const char* const function);
+
+}; // _CQuery
+
 // ------------------------------------------------------------------------------------------------
 // Create query object.
 void*
@@ -87,6 +147,230 @@ geomodelgrids_squery_initialize(void* handle,
 } // initialize
 
 
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying blocks.
+int
+geomodelgrids_squery_setBlockHyperslabDims(void* handle,
+                                           const size_t dims[],
+                                           const int dimsSize) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setBlockHyperslabDims().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    try {
+        query->setBlockHyperslabDims(dims, size_t(dimsSize));
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return query->getErrorHandler()->getStatus();
+} // setBlockHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslabs used in querying surfaces.
+int
+geomodelgrids_squery_setSurfaceHyperslabDims(void* handle,
+                                             const size_t dims[],
+                                             const int dimsSize) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setSurfaceHyperslabDims().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    try {
+        query->setSurfaceHyperslabDims(dims, size_t(dimsSize));
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return query->getErrorHandler()->getStatus();
+} // setSurfaceHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for automatically sized hyperslab dimensions.
+int
+geomodelgrids_squery_setHyperslabMaxBytes(void* handle,
+                                          const size_t value) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setHyperslabMaxBytes().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->setHyperslabMaxBytes(value);
+
+    return query->getErrorHandler()->getStatus();
+} // setHyperslabMaxBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn prefetching of the next hyperslab on/off.
+int
+geomodelgrids_squery_setHyperslabPrefetch(void* handle,
+                                          const int value) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setHyperslabPrefetch().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->setHyperslabPrefetch(bool(value));
+
+    return query->getErrorHandler()->getStatus();
+} // setHyperslabPrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Set horizontal resolution needed by queries.
+int
+geomodelgrids_squery_setQueryResolution(void* handle,
+                                        const double value) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setQueryResolution().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    try {
+        query->setQueryResolution(value);
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return query->getErrorHandler()->getStatus();
+} // setQueryResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Set file used to cache model metadata between runs.
+int
+geomodelgrids_squery_setMetadataCache(void* handle,
+                                      const char* filename) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setMetadataCache().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->setMetadataCache(filename);
+
+    return query->getErrorHandler()->getStatus();
+} // setMetadataCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Set POSIX shared memory cache of model chunks shared by processes on the same node.
+int
+geomodelgrids_squery_setSharedCache(void* handle,
+                                    const char* name,
+                                    const size_t cacheBytes,
+                                    const size_t slotBytes) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setSharedCache().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->setSharedCache(name,
+                          (cacheBytes) ? cacheBytes : geomodelgrids::serial::SharedChunkCache::DEFAULT_CACHE_BYTES,
+                          (slotBytes) ? slotBytes : geomodelgrids::serial::SharedChunkCache::DEFAULT_SLOT_BYTES);
+
+    return query->getErrorHandler()->getStatus();
+} // setSharedCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn collecting query statistics on/off.
+int
+geomodelgrids_squery_setStatsOn(void* handle,
+                                const int value) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setStatsOn().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    try {
+        query->setStatsOn(bool(value));
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return query->getErrorHandler()->getStatus();
+} // setStatsOn
+
+
+// ------------------------------------------------------------------------------------------------
+// Get query statistics.
+int
+geomodelgrids_squery_getStats(void* handle,
+                              struct GeomodelgridsQueryStats* stats) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_getStats().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    const geomodelgrids::serial::QueryStats* queryStats = query->getStats().get();
+    if (!stats) {
+        query->getErrorHandler()->setError("NULL stats argument in call to geomodelgrids_squery_getStats().");
+    } else if (!queryStats) {
+        query->getErrorHandler()->setError("Collecting query statistics is off. "
+                                           "Call geomodelgrids_squery_setStatsOn() before initializing query.");
+    } else {
+        stats->numPoints = queryStats->numPoints;
+        stats->numPointsFound = queryStats->numPointsFound;
+        stats->numPointsOutside = queryStats->numPointsOutside;
+        stats->numTransforms = queryStats->numTransforms;
+        stats->numSurfaceQueries = queryStats->numSurfaceQueries;
+        stats->numHyperslabHits = queryStats->numHyperslabHits;
+        stats->numHyperslabPrefetchHits = queryStats->numHyperslabPrefetchHits;
+        stats->numHyperslabMisses = queryStats->numHyperslabMisses;
+        stats->numBytesRead = queryStats->numBytesRead;
+        stats->timeTransform = queryStats->timeTransform;
+        stats->timeIO = queryStats->timeIO;
+        stats->timeInterpolate = queryStats->timeInterpolate;
+    } // if/else
+
+    return query->getErrorHandler()->getStatus();
+} // getStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Reset query statistics to zero.
+int
+geomodelgrids_squery_resetStats(void* handle) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_resetStats().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->resetStats();
+
+    return query->getErrorHandler()->getStatus();
+} // resetStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Turn on squashing and set minimum z for squashing.
 int
@@ -272,16 +556,149 @@ geomodelgrids_squery_queryModelContains(void* handle,
 } // queryModelContains
   
 // ------------------------------------------------------------------------------------------------
-// Query at point.
+// Query for values at point.
 int
 geomodelgrids_squery_query(void* handle,
                            double* const values,
                            const double x,
                            const double y,
                            const double z) {
+    return geomodelgrids::serial::_CQuery::query(handle, values, x, y, z, "geomodelgrids_squery_query");
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for single precision values at point.
+int
+geomodelgrids_squery_query_float(void* handle,
+                                 float* const values,
+                                 const double x,
+                                 const double y,
+                                 const double z) {
+    return geomodelgrids::serial::_CQuery::query(handle, values, x, y, z, "geomodelgrids_squery_query_float");
+} // query_float
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at many points.
+int
+geomodelgrids_squery_query_points(void* handle,
+                                  double* const values,
+                                  const double* const points,
+                                  const size_t numPoints,
+                                  int* const status) {
     geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
     if (!handle) {
-        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_query().";
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_query_points().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (numPoints && !points) {
+        query->getErrorHandler()->setError("NULL points in call to geomodelgrids_squery_query_points().");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t spaceDim = 3;
+    const double* const x = points;
+    const double* const y = (points) ? points+1 : NULL;
+    const double* const z = (points) ? points+2 : NULL;
+    return geomodelgrids_squery_query_points_strided(handle, values, query->getValueNames().size(), x, y, z,
+                                                     spaceDim, numPoints, status);
+} // query_points
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for single precision values at many points.
+int
+geomodelgrids_squery_query_points_float(void* handle,
+                                        float* const values,
+                                        const double* const points,
+                                        const size_t numPoints,
+                                        int* const status) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_query_points_float().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (numPoints && !points) {
+        query->getErrorHandler()->setError("NULL points in call to geomodelgrids_squery_query_points_float().");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t spaceDim = 3;
+    const double* const x = points;
+    const double* const y = (points) ? points+1 : NULL;
+    const double* const z = (points) ? points+2 : NULL;
+    return geomodelgrids_squery_query_points_strided_float(handle, values, query->getValueNames().size(), x, y, z,
+                                                           spaceDim, numPoints, status);
+} // query_points_float
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at many points with strided arrays.
+int
+geomodelgrids_squery_query_points_strided(void* handle,
+                                          double* const values,
+                                          const size_t valuesStride,
+                                          const double* const x,
+                                          const double* const y,
+                                          const double* const z,
+                                          const size_t pointsStride,
+                                          const size_t numPoints,
+                                          int* const status) {
+    return geomodelgrids::serial::_CQuery::queryPointsStrided(handle, values, valuesStride, x, y, z, pointsStride,
+                                                              numPoints, status,
+                                                              "geomodelgrids_squery_query_points_strided");
+} // query_points_strided
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for single precision values at many points with strided arrays.
+int
+geomodelgrids_squery_query_points_strided_float(void* handle,
+                                                float* const values,
+                                                const size_t valuesStride,
+                                                const double* const x,
+                                                const double* const y,
+                                                const double* const z,
+                                                const size_t pointsStride,
+                                                const size_t numPoints,
+                                                int* const status) {
+    return geomodelgrids::serial::_CQuery::queryPointsStrided(handle, values, valuesStride, x, y, z, pointsStride,
+                                                              numPoints, status,
+                                                              "geomodelgrids_squery_query_points_strided_float");
+} // query_points_strided_float
+
+
+// ------------------------------------------------------------------------------------------------
+// Cleanup after querying.
+int
+geomodelgrids_squery_finalize(void* handle) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setSquashMinElev.";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    query->finalize();
+
+    return query->getErrorHandler()->getStatus();
+} // finalize
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at point.
+template<typename T>
+int
+geomodelgrids::serial::_CQuery::query(void* handle,
+                                      T* const values,
+                                      const double x,
+                                      const double y,
+                                      const double z,
+                                      const char* const function) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to " << function << "().";
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
 
@@ -315,20 +732,46 @@ geomodelgrids_squery_query(void* handle,
 
 
 // ------------------------------------------------------------------------------------------------
-// Cleanup after querying.
+// Query for values at many points with strided arrays.
+template<typename T>
 int
-geomodelgrids_squery_finalize(void* handle) {
+geomodelgrids::serial::_CQuery::queryPointsStrided(void* handle,
+                                                   T* const values,
+                                                   const size_t valuesStride,
+                                                   const double* const x,
+                                                   const double* const y,
+                                                   const double* const z,
+                                                   const size_t pointsStride,
+                                                   const size_t numPoints,
+                                                   int* const status,
+                                                   const char* const function) {
     geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
     if (!handle) {
-        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setSquashMinElev.";
+        std::cerr << "NULL handle for query object in call to " << function << "().";
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
 
     assert(query);
-    query->finalize();
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+    try {
+        size_t numOutside = 0;
+        int err = query->queryPoints(values, valuesStride, x, y, z, pointsStride, numPoints, status, &numOutside);
+        if (err == geomodelgrids::utils::ErrorHandler::WARNING) {
+            std::ostringstream warning;
+            warning << "WARNING: Could not find model containing " << numOutside << " of " << numPoints
+                    << " points during query.";
+            errorHandler->setWarning(warning.str().c_str());
+            errorHandler->logMessage(warning.str().c_str());
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying for values at " << numPoints << " points.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
 
-    return query->getErrorHandler()->getStatus();
-} // finalize
+    return errorHandler->getStatus();
+} // queryPointsStrided
 
 
 // End of file
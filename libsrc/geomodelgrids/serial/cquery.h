@@ -2,11 +2,29 @@
  */
 #pragma once
 
+#include <stddef.h> /* USES size_t */
+
 #define GEOMODELGRIDS_NODATA_VALUE -1.0e+20
 #define GEOMODELGRIDS_SQUASH_NONE 0
 #define GEOMODELGRIDS_SQUASH_TOP_SURFACE 1
 #define GEOMODELGRIDS_SQUASH_TOPOGRAPHY_BATHYMETRY 2
 
+/** Query statistics (see geomodelgrids::serial::QueryStats). */
+struct GeomodelgridsQueryStats {
+    size_t numPoints; /**< Number of points queried for values. */
+    size_t numPointsFound; /**< Number of points found in a model. */
+    size_t numPointsOutside; /**< Number of points outside all models. */
+    size_t numTransforms; /**< Number of coordinate system transformations. */
+    size_t numSurfaceQueries; /**< Number of surface elevation lookups. */
+    size_t numHyperslabHits; /**< Number of lookups satisfied by the current hyperslab. */
+    size_t numHyperslabPrefetchHits; /**< Number of lookups satisfied by the prefetched hyperslab. */
+    size_t numHyperslabMisses; /**< Number of lookups requiring a hyperslab read from the file. */
+    size_t numBytesRead; /**< Number of bytes read into hyperslabs used (not discarded prefetches). */
+    double timeTransform; /**< Time (s) spent in coordinate system transformations. */
+    double timeIO; /**< Time (s) spent waiting on hyperslab reads. */
+    double timeInterpolate; /**< Time (s) spent interpolating values from hyperslabs. */
+};
+
 /** Create query object.
  *
  * @returns Pointer to Query object (NULL on failure).
@@ -43,6 +61,133 @@ int geomodelgrids_squery_initialize(void* handle,
                                     const int valueNamesSize,
                                     const char* const inputCRSString);
 
+/** Set dimensions of hyperslabs used in querying blocks.
+ *
+ * Must be called before geomodelgrids_squery_initialize(). Dimensions that are zero are sized
+ * automatically from the chunk layout of the block datasets.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] dims Dimensions of hyperslab [x, y, z].
+ * @param[in] dimsSize Size of dims array (must be 3).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setBlockHyperslabDims(void* handle,
+                                               const size_t dims[],
+                                               const int dimsSize);
+
+/** Set dimensions of hyperslabs used in querying surfaces.
+ *
+ * Must be called before geomodelgrids_squery_initialize(). Dimensions that are zero are sized
+ * automatically from the chunk layout of the surface datasets.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] dims Dimensions of hyperslab [x, y].
+ * @param[in] dimsSize Size of dims array (must be 2).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setSurfaceHyperslabDims(void* handle,
+                                                 const size_t dims[],
+                                                 const int dimsSize);
+
+/** Set memory budget for automatically sized hyperslab dimensions.
+ *
+ * Must be called before geomodelgrids_squery_initialize().
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] value Maximum size (in bytes) of each hyperslab.
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setHyperslabMaxBytes(void* handle,
+                                              const size_t value);
+
+/** Turn prefetching of the next hyperslab along the traversal direction on/off.
+ *
+ * Must be called before geomodelgrids_squery_initialize().
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] value 1 if prefetching is on, 0 otherwise.
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setHyperslabPrefetch(void* handle,
+                                              const int value);
+
+/** Set horizontal resolution needed by queries.
+ *
+ * Must be called before geomodelgrids_squery_initialize(). Models with multi-resolution pyramids are queried
+ * using the coarsest level with a horizontal resolution no coarser than the requested resolution.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] value Horizontal resolution (m) (0 for full resolution).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setQueryResolution(void* handle,
+                                            const double value);
+
+/** Set file used to cache model metadata between runs.
+ *
+ * Must be called before geomodelgrids_squery_initialize(). Models are opened when they are first queried; with
+ * the cache, models that are not queried are never opened.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] filename Name of cache file (empty string to turn off caching).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setMetadataCache(void* handle,
+                                          const char* filename);
+
+/** Set POSIX shared memory cache of model chunks shared by processes on the same node.
+ *
+ * Must be called before geomodelgrids_squery_initialize(). Processes using a cache with the same name read and
+ * decompress each chunk once per node. The first process to use a cache creates it with the given size.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] name Name of shared memory cache (empty string to turn off the shared cache).
+ * @param[in] cacheBytes Size of cache in bytes (0 for default).
+ * @param[in] slotBytes Maximum size of a chunk in the cache in bytes (0 for default).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setSharedCache(void* handle,
+                                        const char* name,
+                                        const size_t cacheBytes,
+                                        const size_t slotBytes);
+
+/** Turn collecting query statistics on/off.
+ *
+ * Must be called before geomodelgrids_squery_initialize().
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] value 1 if collecting statistics is on, 0 otherwise.
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setStatsOn(void* handle,
+                                    const int value);
+
+/** Get query statistics.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[out] stats Query statistics.
+ *
+ * @returns Status of error handler (error if collecting statistics is off).
+ */
+int geomodelgrids_squery_getStats(void* handle,
+                                  struct GeomodelgridsQueryStats* stats);
+
+/** Reset query statistics to zero.
+ *
+ * @param[inout] handle Handle to query object.
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_resetStats(void* handle);
+
 /** Turn on squashing and set minimum elevation for squashing.
  *
  * Geometry below minimum elevation is not perturbed.
@@ -114,6 +259,115 @@ int geomodelgrids_squery_query(void* handle,
                                const double y,
                                const double z);
 
+/** Query model for single precision values at a point.
+ *
+ * Same as geomodelgrids_squery_query() except values are rounded to single precision.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[out] values Array of values returned in query.
+ * @param[in] x X coordinate of point (in input CRS).
+ * @param[in] y Y coordinate of point (in input CRS).
+ * @param[in] z Z coordinate of point (in input CRS).
+ * @returns 0 on success, 1 on error.
+ */
+int geomodelgrids_squery_query_float(void* handle,
+                                     float* const values,
+                                     const double x,
+                                     const double y,
+                                     const double z);
+
+/** Query model for values at many points.
+ *
+ * Points are processed in batches with one coordinate transformation per batch and model, which is much faster
+ * than calling geomodelgrids_squery_query() for each point. Points outside all models have values of
+ * GEOMODELGRIDS_NODATA_VALUE and a status of 1. Instead of a warning for each point, a single warning with the
+ * number of points outside all models is generated.
+ *
+ * Values and status arrays must be preallocated.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[out] values Array of values returned in query [numPoints][numValues].
+ * @param[in] points Coordinates of points (in input CRS) [numPoints][3].
+ * @param[in] numPoints Number of points.
+ * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_query_points(void* handle,
+                                      double* const values,
+                                      const double* const points,
+                                      const size_t numPoints,
+                                      int* const status);
+
+/** Query model for single precision values at many points.
+ *
+ * Same as geomodelgrids_squery_query_points() except values are rounded to single precision, which halves the
+ * memory for the values of large numbers of points.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[out] values Array of values returned in query [numPoints][numValues].
+ * @param[in] points Coordinates of points (in input CRS) [numPoints][3].
+ * @param[in] numPoints Number of points.
+ * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_query_points_float(void* handle,
+                                            float* const values,
+                                            const double* const points,
+                                            const size_t numPoints,
+                                            int* const status);
+
+/** Query model for values at many points with strided arrays.
+ *
+ * Same as geomodelgrids_squery_query_points() with arbitrary layouts of the values and coordinates. For
+ * example, coordinates in separate x, y, and z arrays use a stride of 1, and values in a Fortran array
+ * values(numValues, numPoints) use a stride of numValues.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[out] values Array of values returned in query; values for point i start at values[i*valuesStride].
+ * @param[in] valuesStride Number of values between the starts of consecutive points (at least numValues).
+ * @param[in] x X coordinates of points (in input CRS); coordinate for point i is x[i*pointsStride].
+ * @param[in] y Y coordinates of points (in input CRS); coordinate for point i is y[i*pointsStride].
+ * @param[in] z Z coordinates of points (in input CRS); coordinate for point i is z[i*pointsStride].
+ * @param[in] pointsStride Number of values between coordinates of consecutive points.
+ * @param[in] numPoints Number of points.
+ * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_query_points_strided(void* handle,
+                                              double* const values,
+                                              const size_t valuesStride,
+                                              const double* const x,
+                                              const double* const y,
+                                              const double* const z,
+                                              const size_t pointsStride,
+                                              const size_t numPoints,
+                                              int* const status);
+
+/** Query model for single precision values at many points with strided arrays.
+ *
+ * Same as geomodelgrids_squery_query_points_strided() except values are rounded to single precision.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[out] values Array of values returned in query; values for point i start at values[i*valuesStride].
+ * @param[in] valuesStride Number of values between the starts of consecutive points (at least numValues).
+ * @param[in] x X coordinates of points (in input CRS); coordinate for point i is x[i*pointsStride].
+ * @param[in] y Y coordinates of points (in input CRS); coordinate for point i is y[i*pointsStride].
+ * @param[in] z Z coordinates of points (in input CRS); coordinate for point i is z[i*pointsStride].
+ * @param[in] pointsStride Number of values between coordinates of consecutive points.
+ * @param[in] numPoints Number of points.
+ * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_query_points_strided_float(void* handle,
+                                                    float* const values,
+                                                    const size_t valuesStride,
+                                                    const double* const x,
+                                                    const double* const y,
+                                                    const double* const z,
+                                                    const size_t pointsStride,
+                                                    const size_t numPoints,
+                                                    int* const status);
+
 /* Cleanup after querying.
  *
  * @param[inout] handle Handle to query object.
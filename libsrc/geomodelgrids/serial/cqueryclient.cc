@@ -0,0 +1,223 @@
+#include <portinfo>
+
+extern "C" {
+#include "cqueryclient.h"
+}
+
+#include "QueryClient.hh" // USES QueryClient
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <cassert> // USES assert()
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+#include <sstream> // USES std::ostringstream
+
+// ------------------------------------------------------------------------------------------------
+// Create query client object.
+void*
+geomodelgrids_squeryclient_create(void) {
+    return (void*) new geomodelgrids::serial::QueryClient();
+} // create
+
+
+// ------------------------------------------------------------------------------------------------
+// Destroy query client object.
+void
+geomodelgrids_squeryclient_destroy(void** handle) {
+    geomodelgrids::serial::QueryClient** client = (geomodelgrids::serial::QueryClient**) handle;
+    if (client) {
+        delete *client;*client = NULL;
+    } // if
+} // destroy
+
+
+// ------------------------------------------------------------------------------------------------
+// Get error handler.
+void*
+geomodelgrids_squeryclient_getErrorHandler(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    geomodelgrids::utils::ErrorHandler* errorHandler = NULL;
+    if (client) {
+        errorHandler = client->getErrorHandler().get();
+    } // if
+
+    return errorHandler;
+} // getErrorHandler
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of values returned by queries.
+size_t
+geomodelgrids_squeryclient_getNumValues(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_squeryclient_getNumValues().";
+        return 0;
+    } // if
+
+    assert(client);
+    return client->getValueNames().size();
+} // getNumValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Connect to query server.
+int
+geomodelgrids_squeryclient_connect(void* handle,
+                                   const char* socketPath) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_squeryclient_connect().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = client->getErrorHandler();
+    try {
+        client->connect(socketPath);
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Could not connect to query server.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // connect
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for values at many points.
+int
+geomodelgrids_squeryclient_query_points(void* handle,
+                                        double* const values,
+                                        const double* const points,
+                                        const size_t numPoints,
+                                        int* const status) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_squeryclient_query_points().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = client->getErrorHandler();
+    try {
+        const int err = client->queryPoints(values, points, numPoints, status);
+        if (err == geomodelgrids::utils::ErrorHandler::WARNING) {
+            errorHandler->setWarning("WARNING: Could not find model containing some points during query.");
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying server for values at " << numPoints << " points.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // query_points
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for elevation of top surface at many points.
+int
+geomodelgrids_squeryclient_query_top_elevations(void* handle,
+                                                double* const elevations,
+                                                const double* const points,
+                                                const size_t numPoints) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to "
+                  << "geomodelgrids_squeryclient_query_top_elevations().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = client->getErrorHandler();
+    try {
+        client->queryTopElevations(elevations, points, numPoints);
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying server for elevation of top surface at " << numPoints
+              << " points.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // query_top_elevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Query server for elevation of topography/bathymetry at many points.
+int
+geomodelgrids_squeryclient_query_topobathy_elevations(void* handle,
+                                                      double* const elevations,
+                                                      const double* const points,
+                                                      const size_t numPoints) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to "
+                  << "geomodelgrids_squeryclient_query_topobathy_elevations().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = client->getErrorHandler();
+    try {
+        client->queryTopoBathyElevations(elevations, points, numPoints);
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying server for elevation of topography/bathymetry at " << numPoints
+              << " points.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // query_topobathy_elevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Ask query server to shut down.
+int
+geomodelgrids_squeryclient_shutdownServer(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_squeryclient_shutdownServer().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = client->getErrorHandler();
+    try {
+        client->shutdownServer();
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Could not shut down query server.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // shutdownServer
+
+
+// ------------------------------------------------------------------------------------------------
+// Close connection to query server.
+int
+geomodelgrids_squeryclient_close(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_squeryclient_close().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    client->close();
+
+    return client->getErrorHandler()->getStatus();
+} // close
+
+
+// End of file
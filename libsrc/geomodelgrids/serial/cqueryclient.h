@@ -0,0 +1,100 @@
+/* C interface for querying a resident query server (geomodelgrids_server).
+ */
+#pragma once
+
+#include <stddef.h> /* USES size_t */
+
+/** Create query client object.
+ *
+ * @returns Pointer to QueryClient object (NULL on failure).
+ */
+void* geomodelgrids_squeryclient_create(void);
+
+/** Destroy query client object.
+ *
+ * @param handle Query client object.
+ */
+void geomodelgrids_squeryclient_destroy(void** handle);
+
+/** Get error handler.
+ *
+ * @param[in] handle Query client object.
+ */
+void* geomodelgrids_squeryclient_getErrorHandler(void* handle);
+
+/** Connect to query server.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[in] socketPath Path of Unix-domain socket of server.
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_connect(void* handle,
+                                       const char* socketPath);
+
+/** Get number of values returned by queries.
+ *
+ * @param[in] handle Handle to query client object.
+ *
+ * @returns Number of values (0 if not connected).
+ */
+size_t geomodelgrids_squeryclient_getNumValues(void* handle);
+
+/** Query server for values at many points.
+ *
+ * Values and status arrays must be preallocated.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] values Array of values returned in query [numPoints][numValues].
+ * @param[in] points Coordinates of points (in input CRS of server) [numPoints][3].
+ * @param[in] numPoints Number of points.
+ * @param[out] status Status (0 if found, 1 if outside all models) for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_query_points(void* handle,
+                                            double* const values,
+                                            const double* const points,
+                                            const size_t numPoints,
+                                            int* const status);
+
+/** Query server for elevation of top surface at many points.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] elevations Elevations (m) of top surface at points [numPoints] (must be preallocated).
+ * @param[in] points Coordinates of points (in input CRS of server) [numPoints][2].
+ * @param[in] numPoints Number of points.
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_query_top_elevations(void* handle,
+                                                    double* const elevations,
+                                                    const double* const points,
+                                                    const size_t numPoints);
+
+/** Query server for elevation of topography/bathymetry at many points.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] elevations Elevations (m) of topography/bathymetry at points [numPoints] (must be preallocated).
+ * @param[in] points Coordinates of points (in input CRS of server) [numPoints][2].
+ * @param[in] numPoints Number of points.
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_query_topobathy_elevations(void* handle,
+                                                          double* const elevations,
+                                                          const double* const points,
+                                                          const size_t numPoints);
+
+/** Ask query server to shut down and close connection.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_shutdownServer(void* handle);
+
+/** Close connection to query server.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squeryclient_close(void* handle);
+
+// End of file
@@ -4,13 +4,21 @@ namespace geomodelgrids {
     namespace serial {
         class ModelInfo;
         class Model;
+        class ModelIndex;
+        class MetadataCache;
+        class ModelWriter;
         class Block;
         class Surface;
 
         class Query;
+        class QueryStats;
+        class QueryServer;
+        class QueryClient;
+        class QueryProtocol;
 
         class HDF5;
         class Hyperslab;
+        class SharedChunkCache;
     } // serial
 } // geomodelgrids
 
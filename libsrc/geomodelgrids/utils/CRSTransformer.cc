@@ -4,6 +4,7 @@
 
 #include <cmath> // USES HUGE_VAL
 #include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::runtime_error
 #include <cassert> // USES assert()
 #include <cstring> // USES strlen()
 #include <strings.h> // USES stdcasecmp()
@@ -34,7 +35,12 @@ public:
 geomodelgrids::utils::CRSTransformer::CRSTransformer(void) :
     _srcString("EPSG:4326"), // latitude/longitude WGS84
     _destString("EPSG:3488"), // NAD83(HARN) California Albers
-    _proj(nullptr) {}
+    _context(proj_context_create()),
+    _proj(nullptr) {
+    if (!_context) {
+        throw std::runtime_error("Could not create PROJ context.");
+    } // if
+} // constructor
 
 
 // ------------------------------------------------------------------------------------------------
@@ -43,6 +49,7 @@ geomodelgrids::utils::CRSTransformer::~CRSTransformer(void) {
     if (_proj) {
         proj_destroy(_proj);_proj = nullptr;
     } // if
+    proj_context_destroy(_context);_context = nullptr;
 } // destructor
 
 
@@ -69,8 +76,7 @@ geomodelgrids::utils::CRSTransformer::initialize(void) {
     if (_proj) {
         proj_destroy(_proj);_proj = nullptr;
     } // if
-    PJ_CONTEXT* context = PJ_DEFAULT_CTX;
-    _proj = proj_create_crs_to_crs(context, _srcString.c_str(), _destString.c_str(), nullptr);
+    _proj = proj_create_crs_to_crs(_context, _srcString.c_str(), _destString.c_str(), nullptr);
     if (!_proj) {
         std::stringstream msg;
         msg << "Error creating CRS transformation from '" << _srcString << "' to '" << _destString << "'.\n"
@@ -124,13 +130,43 @@ geomodelgrids::utils::CRSTransformer::inverse_transform(double* srcX,
 } // transform
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute from src CRS to dest CRS for array of points.
+void
+geomodelgrids::utils::CRSTransformer::transform(double* xyz,
+                                                const size_t numPoints) {
+    if (!numPoints) { return; }
+    assert(xyz);
+
+    const size_t stride = 3*sizeof(double);
+    proj_trans_generic(_proj, PJ_FWD, &xyz[0], stride, numPoints, &xyz[1], stride, numPoints,
+                       &xyz[2], stride, numPoints, nullptr, 0, 0);
+} // transform
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute from dest CRS to src CRS for array of points.
+void
+geomodelgrids::utils::CRSTransformer::inverse_transform(double* xyz,
+                                                        const size_t numPoints) {
+    if (!numPoints) { return; }
+    assert(xyz);
+
+    const size_t stride = 3*sizeof(double);
+    proj_trans_generic(_proj, PJ_INV, &xyz[0], stride, numPoints, &xyz[1], stride, numPoints,
+                       &xyz[2], stride, numPoints, nullptr, 0, 0);
+} // inverse_transform
+
+
 // ------------------------------------------------------------------------------------------------
 // Get boundary box in x/y order from bounding box in CRS.
 geomodelgrids::utils::CRSTransformer*
 geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(const char* crsString) {
-    PJ_CONTEXT* context = PJ_DEFAULT_CTX;
+    CRSTransformer* transformer = new CRSTransformer();
+    PJ_CONTEXT* context = transformer->_context;
     PJ* projGeo = proj_create(context, crsString);
     if (!projGeo) {
+        delete transformer;transformer = nullptr;
         std::stringstream msg;
         msg << "Error creating CRS from '" << crsString << "'.\n"
             << proj_errno_string(proj_errno(projGeo));
@@ -139,6 +175,7 @@ geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(const char* crsStri
     PJ* projXY = proj_normalize_for_visualization(context, projGeo);
     if (!projXY) {
         proj_destroy(projGeo);
+        delete transformer;transformer = nullptr;
 
         std::stringstream msg;
         msg << "Error creating normalized CRS from '" << crsString << "'.\n"
@@ -149,12 +186,12 @@ geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(const char* crsStri
     proj_destroy(projGeo);
     proj_destroy(projXY);
     if (!transform) {
+        delete transformer;transformer = nullptr;
         std::stringstream msg;
         msg << "Error geo to xy transformation for CRS from '" << crsString << "'.\n"
             << proj_errno_string(proj_errno(transform));
         throw std::runtime_error(msg.str());
     } // if
-    CRSTransformer* transformer = new CRSTransformer();
     transformer->_proj = transform;
 
     return transformer;
@@ -173,18 +210,20 @@ geomodelgrids::utils::CRSTransformer::getCRSUnits(std::string* xUnit,
     if (zUnit) { *zUnit = "meter (assumed)"; }
     if (!crsString || (0 == strlen(crsString))) { return; }
 
-    PJ_CONTEXT* context = PJ_DEFAULT_CTX;
+    // Use a context of our own, because the default context is not safe to use from multiple threads.
+    PJ_CONTEXT* context = proj_context_create();
+    if (!context) { return; }
     PJ* proj = proj_create(context, crsString);assert(proj);
     PJ* projCoordSys = proj_crs_get_coordinate_system(context, proj);
     if (projCoordSys) {
         _CRSTransformer::getUnits(xUnit, yUnit, zUnit, projCoordSys);
         proj_destroy(proj);
         proj_destroy(projCoordSys);
-        return;
     } else if (proj_get_type(proj) == PJ_TYPE_BOUND_CRS) {
         PJ* projTmp = proj_get_source_crs(context, proj);
         proj_destroy(proj);
         if (!projTmp) {
+            proj_context_destroy(context);
             return;
         } // if
         const char* srcWKT = proj_as_wkt(context, projTmp, PJ_WKT2_2019, nullptr);
@@ -192,13 +231,14 @@ geomodelgrids::utils::CRSTransformer::getCRSUnits(std::string* xUnit,
         projCoordSys = proj_crs_get_coordinate_system(context, projSrc);
         proj_destroy(projTmp);
         proj_destroy(projSrc);
-        if (!projCoordSys) {
-            return;
-        }
-        _CRSTransformer::getUnits(xUnit, yUnit, zUnit, projCoordSys);
-        proj_destroy(projCoordSys);
-        return;
-    }
+        if (projCoordSys) {
+            _CRSTransformer::getUnits(xUnit, yUnit, zUnit, projCoordSys);
+            proj_destroy(projCoordSys);
+        } // if
+    } else {
+        proj_destroy(proj);
+    } // if/else
+    proj_context_destroy(context);
 }
 
 
@@ -73,6 +73,26 @@ public:
                            const double destY,
                            const double destZ);
 
+    /** Transform coordinates of points from source to destination coordinate system in place.
+     *
+     * All points are transformed in a single call to Proj.
+     *
+     * @param[inout] xyz Coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void transform(double* xyz,
+                   const size_t numPoints);
+
+    /** Transform coordinates of points from destination to source coordinate system in place.
+     *
+     * All points are transformed in a single call to Proj.
+     *
+     * @param[inout] xyz Coordinates of points [numPoints][3].
+     * @param[in] numPoints Number of points.
+     */
+    void inverse_transform(double* xyz,
+                           const size_t numPoints);
+
     /** Create CRSTransformer that transforms axis order from geo to xy order.
      *
      * @param[in] crsString CRS for coordinate system.
@@ -99,6 +119,7 @@ private:
 
     std::string _srcString;
     std::string _destString;
+    PJ_CONTEXT* _context; ///< PROJ context owned by this transformer (the default context is not thread safe).
     PJ* _proj;
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
@@ -30,18 +30,24 @@ The rules were originally developed with Vp and Vs in km/s, density in
 g/cm**3, and depth in km. Here all rules have been converted to SI
 base units with Vp and Vs in m/s, density in kg/m**3, and depth in m.
 
+The rules are vectorized; x, y, and depth may be floats or numpy arrays.
+Piecewise functions of depth are evaluated with numpy.select.
+
 """
 
+import numpy
+
 from geomodelgrids.create.core import NODATA_VALUE
+from geomodelgrids.create.data_srcs.earthvision.rules import vectorized
 
 
 def default_vs(depth, vp):
     """Default rule for shear wave speed as a function of Vp.
 
     Args:
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
-        vp (float)
+        vp (numpy.array)
             P wave speed in m/s.
 
     Returns:
@@ -54,9 +60,9 @@ def default_density(depth, vp):
     """Default rule for density as a function of Vp.
 
     Args:
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
-        vp (float)
+        vp (numpy.array)
             P wave speed in m/s.
 
     Returns:
@@ -69,9 +75,9 @@ def default_qs(depth, vs):
     """Default rule for Qs as a function of Vs.
 
     Args:
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
-        vs (float)
+        vs (numpy.array)
             S wave speed in m/s.
 
     Returns:
@@ -84,9 +90,9 @@ def default_qp(depth, qs):
     """Default rule for Qp as a function of Qs.
 
     Args:
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
-        qs (float)
+        qs (numpy.array)
             Quality factor for S wave.
 
     Returns:
@@ -95,40 +101,43 @@ def default_qp(depth, qs):
     return 2.0*qs
 
 
+
+@vectorized
 def upper_mantle(x, y, depth):
     """Rule for elastic properties in the upper mantle.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density (kg/m**3), Vp (m/s), Vs (m/s), Qp, and Qs
     """
-    vp = 7.77e+3 if depth < 20.0e+3 else 7.77e+3 + 0.001*(depth-20.0e+3)
+    vp = numpy.where(depth < 20.0e+3, 7.77e+3, 7.77e+3 + 0.001*(depth-20.0e+3))
 
-    vs = 4.41e+3 if depth < 20.0e+3 else 4.41e+3 + 0.0006*(depth-20.0e+3)
+    vs = numpy.where(depth < 20.0e+3, 4.41e+3, 4.41e+3 + 0.0006*(depth-20.0e+3))
 
     density = 3.3e+3
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def mafic_great_valley_ophiolite(x, y, depth):
     """Rule for elastic properties in Mafic Great Valley Ophiolite rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -136,27 +145,28 @@ def mafic_great_valley_ophiolite(x, y, depth):
     """
     vp0 = 5.9e+3
 
-    vp = vp0 if depth < 10.0e+3 else vp0 + 0.056*(depth-10e+3)
+    vp = numpy.where(depth < 10.0e+3, vp0, vp0 + 0.056*(depth-10e+3))
 
     vs = default_vs(depth, vp)
 
-    vd = vp0 if depth < 10.0e+3 else vp
+    vd = numpy.where(depth < 10.0e+3, vp0, vp)
     density = 227.0 + 1.6612*vd - 0.4721e-3*vd**2 + 0.0671e-6*vd**3 - 0.0043e-9*vd**4 + 0.0001e-12*vd**5
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def franciscan_foothills(x, y, depth):
     """Rule for elastic properties in Franciscan (Foothills variety) rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -164,33 +174,32 @@ def franciscan_foothills(x, y, depth):
     """
     a = 0.13e+3
     vp0 = 5.4e+3 + a
-    density0 = 1.74e+3*(vp0*1.0e-3)**0.25
+    density0 = 1.74e+3 * (vp0*1.0e-3)**0.25
 
-    if depth < 1.0e+3:
-        vp = a + 2.5e+3 + 2.0*depth
-    elif depth < 3.0e+3:
-        vp = a + 4.5e+3 + 0.45*(depth-1.0e+3)
-    else:
-        vp = a + 5.4e+3 + 0.0588*(depth-3.0e+3)
+    vp = numpy.select([depth < 1.0e+3, depth < 3.0e+3], [
+        a + 2.5e+3 + 2.0*depth,
+        a + 4.5e+3 + 0.45*(depth-1.0e+3),
+    ], a + 5.4e+3 + 0.0588*(depth-3.0e+3))
 
     vs = default_vs(depth, vp)
 
-    density = density0 if depth < 3.0e+3 else default_density(depth, vp)
+    density = numpy.where(depth < 3.0e+3, density0, default_density(depth, vp))
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def franciscan_napa_sonoma(x, y, depth):
     """Rule for elastic properties in Franciscan (Napa-Sonoma variety) rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -200,31 +209,30 @@ def franciscan_napa_sonoma(x, y, depth):
     vp0 = 5.4e+3 + a
     density0 = 1.74e+3 * (vp0*1.0e-3)**0.25
 
-    if depth < 1.0e+3:
-        vp = a + 2.5e+3 + 2.0*depth
-    elif depth < 3.0e+3:
-        vp = a + 4.5e+3 + 0.45*(depth-1.0e+3)
-    else:
-        vp = a + 5.4e+3 + 0.0588*(depth-3.0e+3)
+    vp = numpy.select([depth < 1.0e+3, depth < 3.0e+3], [
+        a + 2.5e+3 + 2.0*depth,
+        a + 4.5e+3 + 0.45*(depth-1.0e+3),
+    ], a + 5.4e+3 + 0.0588*(depth-3.0e+3))
 
     vs = default_vs(depth, vp)
 
-    density = density0 if depth < 3.0e+3 else default_density(depth, vp)
+    density = numpy.where(depth < 3.0e+3, density0, default_density(depth, vp))
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def franciscan_berkeley(x, y, depth):
     """Rule for elastic properties in Franciscan (Berkeley variety) rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -234,31 +242,30 @@ def franciscan_berkeley(x, y, depth):
     vp0 = 5.4e+3 + a
     density0 = 1.74e+3 * (vp0*1.0e-3)**0.25
 
-    if depth < 1.0e+3:
-        vp = a + 2.5e+3 + 2.0*depth
-    elif depth < 3.0e+3:
-        vp = a + 4.5e+3 + 0.45*(depth-1.0e+3)
-    else:
-        vp = a + 5.4e+3 + 0.0588*(depth-3.0e+3)
+    vp = numpy.select([depth < 1.0e+3, depth < 3.0e+3], [
+        a + 2.5e+3 + 2.0*depth,
+        a + 4.5e+3 + 0.45*(depth-1.0e+3),
+    ], a + 5.4e+3 + 0.0588*(depth-3.0e+3))
 
     vs = default_vs(depth, vp)
 
-    density = density0 if depth < 3.0e+3 else default_density(depth, vp)
+    density = numpy.where(depth < 3.0e+3, density0, default_density(depth, vp))
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def salinian_granitic(x, y, depth):
     """Rule for elastic properties in Salinian Granitic rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -266,36 +273,33 @@ def salinian_granitic(x, y, depth):
     """
     vp0 = 5.64e+3
 
-    if depth < 0.5e+3:
-        vp = 1.5e+3 + 5.0*depth
-    elif depth < 1.5e+3:
-        vp = 4.0e+3 + 1.3*(depth-0.5e+3)
-    elif depth < 2.5e+3:
-        vp = 5.3e+3 + 0.3*(depth-1.5e+3)
-    elif depth < 5.0e+3:
-        vp = 5.6e+3 + 0.08*(depth-2.5e+3)
-    else:
-        vp = 5.8e+3 + 0.06*(depth-5.0e+3)
+    vp = numpy.select([depth < 0.5e+3, depth < 1.5e+3, depth < 2.5e+3, depth < 5.0e+3], [
+        1.5e+3 + 5.0*depth,
+        4.0e+3 + 1.3*(depth-0.5e+3),
+        5.3e+3 + 0.3*(depth-1.5e+3),
+        5.6e+3 + 0.08*(depth-2.5e+3),
+    ], 5.8e+3 + 0.06*(depth-5.0e+3))
 
     vs = default_vs(depth, vp)
 
-    vd = vp0 if depth < 3.0e+3 else vp
+    vd = numpy.where(depth < 3.0e+3, vp0, vp)
     density = 60.0 + 1.6612*vd - 0.4721e-3*vd**2 + 0.0671e-6*vd**3 - 0.0043e-9*vd**4 + 0.0001e-12*vd**5
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def great_valley_sequence_sedimentary(x, y, depth):
     """Rule for elastic properties in Great Valley sedimentary rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -304,165 +308,155 @@ def great_valley_sequence_sedimentary(x, y, depth):
     vp0 = 4.25e+3
     density0 = 1.74e+3 * (vp0*1.0e-3)**0.25
 
-    if depth < 3.6e+3:
-        vp = 2.5e+3 + 0.5833*depth
-    elif depth < 8.0e+3:
-        vp = 4.6e+3 + 0.18182*(depth-3.6e+3)
-    elif depth < 11.0e+3:
-        vp = 5.4e+3 + 0.166*(depth-8.0e+3)
-    else:
-        vp = 5.9e+3 + 0.0666*(depth-11.0e+3)
-
-    if depth < 1.0e+3:
-        vs = 0.6e+3 + 1.183*depth
-    elif depth < 5.0e+3:
-        vs = 1.5e+3 + 0.2836*depth
-    else:
-        vs = default_vs(depth, vp)
-
-    density = density0 if depth < 3.0e+3 else default_density(depth, vp)
-
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    vp = numpy.select([depth < 3.6e+3, depth < 8.0e+3, depth < 11.0e+3], [
+        2.5e+3 + 0.5833*depth,
+        4.6e+3 + 0.18182*(depth-3.6e+3),
+        5.4e+3 + 0.166*(depth-8.0e+3),
+    ], 5.9e+3 + 0.0666*(depth-11.0e+3))
+
+    vs = numpy.select([depth < 1.0e+3, depth < 5.0e+3], [
+        0.6e+3 + 1.183*depth,
+        1.5e+3 + 0.2836*depth,
+    ], default_vs(depth, vp))
+
+    density = numpy.where(depth < 3.0e+3, density0, default_density(depth, vp))
+
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def quaternary_tertiary_sedimentary(x, y, depth):
     """Rule for elastic properties in Quaternary-Tertiary sedimentary rocks.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density (kg/m**3), Vp (m/s), Vs (m/s), Qp, and Qs
     """
-    if depth < 40.0:
-        vp = 700.0 + 42.968*depth - 575.8e-3*depth**2 + 2931.6e-6*depth**3 - 3977.6e-9*depth**4
-    elif depth < 500.0:
-        vp = 1.5e+3 + 3.735*depth - 3.543e-3*depth**2
-    elif depth < 10.0e+3:
-        vp = 2.24e+3 + 0.6*depth
-    else:
-        vp = 2.24e+3 + 0.6*10.0e+3
-
-    if depth < 25.0:
-        vs = 80.0 + 2.5*depth
-    elif depth < 50.0:
-        vs = (vp-1360.0) / 1.16
-    else:
-        vs = default_vs(depth, vp)
+    vp = numpy.select([depth < 40.0, depth < 500.0, depth < 10.0e+3], [
+        700.0 + 42.968*depth - 575.8e-3*depth**2 + 2931.6e-6*depth**3 - 3977.6e-9*depth**4,
+        1.5e+3 + 3.735*depth - 3.543e-3*depth**2,
+        2.24e+3 + 0.6*depth,
+    ], 2.24e+3 + 0.6*10.0e+3)
+
+    vs = numpy.select([depth < 25.0, depth < 50.0], [
+        80.0 + 2.5*depth,
+        (vp-1360.0) / 1.16,
+    ], default_vs(depth, vp))
 
     density = default_density(depth, vp)
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def tertiary_sedimentary_lahondabasin(x, y, depth):
     """Rule for elastic properties in Tertiary sedimentary rocks (La Honda basin).
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density (kg/m**3), Vp (m/s), Vs (m/s), Qp, and Qs
     """
-    vp = 2.24e+3 + 2.62*depth - 0.74432e-3*depth**2 + 0.0707e-6 * \
-        depth**3 if depth < 3.0e+3 else 5.32e+3 + 0.027*(depth-3.0e+3)
+    vp = numpy.where(depth < 3.0e+3,
+                     2.24e+3 + 2.62*depth - 0.74432e-3*depth**2 + 0.0707e-6*depth**3,
+                     5.32e+3 + 0.027*(depth-3.0e+3))
 
-    vs = 500.0 + 6.633*depth if depth < 50.0 else default_vs(depth, vp)
+    vs = numpy.where(depth < 50.0, 500.0 + 6.633*depth, default_vs(depth, vp))
 
     density = default_density(depth, vp)
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def tertiary_sedimentary_southbay(x, y, depth):
     """Rule for elastic properties in Tertiary sedimentary rocks (South Bay).
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density (kg/m**3), Vp (m/s), Vs (m/s), Qp, and Qs
     """
-    if depth < 750.0:
-        vp = 1.80e+3 + 1.2*depth
-    elif depth < 4.0e+3:
-        vp = 2.70e+3 + 0.597*(depth-750.0)
-    elif depth < 7.0e+3:
-        vp = 4.64e+3 + 0.417*(depth-4.0e+3)
-    else:
-        vp = 5.891e+3 + 0.06*(depth-7.0e+3)
+    vp = numpy.select([depth < 750.0, depth < 4.0e+3, depth < 7.0e+3], [
+        1.80e+3 + 1.2*depth,
+        2.70e+3 + 0.597*(depth-750.0),
+        4.64e+3 + 0.417*(depth-4.0e+3),
+    ], 5.891e+3 + 0.06*(depth-7.0e+3))
 
-    vs = 500.0 + 0.4*depth if depth < 50.0 else default_vs(depth, vp)
+    vs = numpy.where(depth < 50.0, 500.0 + 0.4*depth, default_vs(depth, vp))
 
     density = default_density(depth, vp)
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def cenozoic_sedimentary_halfmoonbay(x, y, depth):
     """Rule for elastic properties in Cenozoic sedimentary rocks (Half Moon Bay region).
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density (kg/m**3), Vp (m/s), Vs (m/s), Qp, and Qs
     """
-    if depth < 50.0:
-        vp = 700.0 + 31.4*depth
-    elif depth < 4.0e+3:
-        vp = 2.24e+3 + 0.6*(depth-50.0)
-    elif depth < 7.0e+3:
-        vp = 4.64e+3 + 0.417*(depth-4.0e+3)
-    else:
-        vp = 5.891e+3 + 0.06*(depth-7.0e+3)
+    vp = numpy.select([depth < 50.0, depth < 4.0e+3, depth < 7.0e+3], [
+        700.0 + 31.4*depth,
+        2.24e+3 + 0.6*(depth-50.0),
+        4.64e+3 + 0.417*(depth-4.0e+3),
+    ], 5.891e+3 + 0.06*(depth-7.0e+3))
 
-    vs = 500.0 + 0.4*depth if depth < 50.0 else default_vs(depth, vp)
+    vs = numpy.where(depth < 50.0, 500.0 + 0.4*depth, default_vs(depth, vp))
 
     density = default_density(depth, vp)
 
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def seawater(x, y, depth):
     """Rule for elastic properties in sea water.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
@@ -477,15 +471,16 @@ def seawater(x, y, depth):
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def outside_model(x, y, depth):
     """Rule for elastic properties outside the model.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
-        depth (float)
+        depth (numpy.array)
             Depth of location in m.
 
     Returns:
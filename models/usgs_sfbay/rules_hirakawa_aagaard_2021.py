@@ -10,10 +10,16 @@ That is, the xy coordinates match the model CRS specified in the model configura
 The rules were originally developed with Vp and Vs in km/s, density in
 g/cm**3, and depth in km. Here all rules have been converted to SI
 base units with Vp and Vs in m/s, density in kg/m**3, and depth in m.
+
+The rules are vectorized; x, y, and depth may be floats or numpy arrays.
 """
 
 import math
+
+import numpy
+
 from geomodelgrids.create.core import NODATA_VALUE
+from geomodelgrids.create.data_srcs.earthvision.rules import (vectorized, where)
 from rules_aagaard_etal_2010 import (
     default_vs,
     default_density,
@@ -49,9 +55,9 @@ def is_along_azimuth(x, y, x0, y0, azimuth):
     """Check if point is along azimuth from reference point.
 
     Args:
-        x (float)
+        x (numpy.array)
             Model x coordinate.
-        y (float)
+        y (numpy.array)
             Model y coordinate.
         x0 (float)
             X coordinate of reference point in model coordinate system.
@@ -59,33 +65,32 @@ def is_along_azimuth(x, y, x0, y0, azimuth):
             Y coordinate of reference point in model coordinate system.
         azimuth (float)
             Azimuth, in degrees CW, from y axis of model coordinate system.
-    Returns: (bool)
+    Returns: (numpy.array of bool)
         True if azimuth \dot (x-x0,y-y0) >= 0, False otherwize
     """
     azRad = azimuth / 180.0 * math.pi
     return (x-x0)*math.sin(azRad) + (y-y0)*math.cos(azRad) >= 0.0
 
 
+@vectorized
 def brocher2008_great_valley_sequence(x, y, depth):
     """Rule for elastic properties in Great Valley Sequence rocks. Brocher 2008.
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
-    if depth < 4.0e+3:
-        vp = 2.75e+3 + 0.4725*depth
-    elif depth < 7.0e+3:
-        vp = 4.64e+3 + 0.3*(depth-4.0e+3)
-    else:
-        vp = 5.54e+3 + 0.06*(depth-7.0e+3)
+    vp = numpy.select([depth < 4.0e+3, depth < 7.0e+3], [
+        2.75e+3 + 0.4725*depth,
+        4.64e+3 + 0.3*(depth-4.0e+3),
+    ], 5.54e+3 + 0.06*(depth-7.0e+3))
 
     vs = default_vs(depth, vp)
     density = default_density(depth, vp)
@@ -94,26 +99,25 @@ def brocher2008_great_valley_sequence(x, y, depth):
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def brocher2005_older_cenozoic_sedimentary(x, y, depth):
     """Rule for elastic properties in older Cenozoic sedimentary rocks. Brocher 2005.
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
-    if depth < 4.0e+3:
-        vp = 2.24e+3 + 0.6*depth
-    elif depth < 7.0e+3:
-        vp = 4.64e+3 + 0.3*(depth-4.0e+3)
-    else:
-        vp = 5.54e+3 + 0.06*(depth-7.0e+3)
+    vp = numpy.select([depth < 4.0e+3, depth < 7.0e+3], [
+        2.24e+3 + 0.6*depth,
+        4.64e+3 + 0.3*(depth-4.0e+3),
+    ], 5.54e+3 + 0.06*(depth-7.0e+3))
 
     vs = default_vs(depth, vp)
     density = default_density(depth, vp)
@@ -122,15 +126,16 @@ def brocher2005_older_cenozoic_sedimentary(x, y, depth):
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def franciscan_napa_sonoma(x, y, depth):
     """Rule for elastic properties in Franciscan(Napa-Sonoma variety) rocks.
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
@@ -140,39 +145,35 @@ def franciscan_napa_sonoma(x, y, depth):
     vp0 = 5.4e+3 + a
     density0 = 1.74e+3 * (vp0*1.0e-3)**0.25
 
-    if depth < 1.0e+3:
-        vp = a + 2.5e+3 + 2.0*depth
-    elif depth < 3.0e+3:
-        vp = a + 4.5e+3 + 0.45*(depth-1.0e+3)
-    else:
-        vp = a + 5.4e+3 + 0.0588*(depth-3.0e+3)
+    vp = numpy.select([depth < 1.0e+3, depth < 3.0e+3], [
+        a + 2.5e+3 + 2.0*depth,
+        a + 4.5e+3 + 0.45*(depth-1.0e+3),
+    ], a + 5.4e+3 + 0.0588*(depth-3.0e+3))
 
     vs = default_vs(depth, vp)
-    density = density0 if depth < 3.0e+3 else default_density(depth, vp)
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    density = numpy.where(depth < 3.0e+3, density0, default_density(depth, vp))
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def quaternary_livermore(x, y, depth):
     """
     Rule for elastic properties in Shallow livermore sediments obtained by trial and error
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
-    if depth < 6444.44:
-        vp = 1.64e+3 + 0.6*depth
-    else:
-        vp = 5.506667e+3 + 0.06*(depth-6444.44)
+    vp = numpy.where(depth < 6444.44, 1.64e+3 + 0.6*depth, 5.506667e+3 + 0.06*(depth-6444.44))
 
     vs = default_vs(depth, vp)
     density = default_density(depth, vp)
@@ -181,6 +182,7 @@ def quaternary_livermore(x, y, depth):
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def cenozoic_walnutcreek(x, y, depth):
     """Rule for elastic properties in southernmost part of Napa Block
 
@@ -188,132 +190,119 @@ def cenozoic_walnutcreek(x, y, depth):
     * below 7km, same as Brocher GVS and OlderCenozoicSeds
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
-    if depth < 750.0:
-        vp = 1.80e+3 + 1.2*depth
-    elif depth < 4.0e+3:
-        vp = 2.70e+3 + 0.597*(depth-750.0)
-    elif depth < 7.0e+3:
-        vp = 4.64e+3 + 0.3*(depth-4.0e+3)
-    else:
-        vp = 5.54e+3 + 0.06*(depth-7.0e+3)
-
-    vs = 500.0 + 0.4*depth if depth < 50.0 else default_vs(depth, vp)
+    vp = numpy.select([depth < 750.0, depth < 4.0e+3, depth < 7.0e+3], [
+        1.80e+3 + 1.2*depth,
+        2.70e+3 + 0.597*(depth-750.0),
+        4.64e+3 + 0.3*(depth-4.0e+3),
+    ], 5.54e+3 + 0.06*(depth-7.0e+3))
+
+    vs = numpy.where(depth < 50.0, 500.0 + 0.4*depth, default_vs(depth, vp))
     density = default_density(depth, vp)
-    qs = 13.0 if vs < 300.0 else default_qs(depth, vs)
+    qs = numpy.where(vs < 300.0, 13.0, default_qs(depth, vs))
     qp = default_qp(depth, qs)
     return (density, vp, vs, qp, qs)
 
 
+@vectorized
 def valley_sequence_sanleandro(x, y, depth):
     """Rule for elastic properties in zone 'Valley Sequence', block 'San Leandro'
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
     (x0, y0) = (92724.2, 285582.4)
-    if is_along_azimuth(x, y, x0, y0, 323.638):
-        return brocher2008_great_valley_sequence(x, y, depth)
-    else:
-        return brocher2005_older_cenozoic_sedimentary(x, y, depth)
+    return where(is_along_azimuth(x, y, x0, y0, 323.638), brocher2008_great_valley_sequence(x, y, depth), brocher2005_older_cenozoic_sedimentary(x, y, depth))
 
 
+@vectorized
 def franciscan_napa(x, y, depth):
     """Rule for elastic properties in Franciscan rock, Napa Block
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
     (x0, y0) = (62999.3, 360755.6)
-    if is_along_azimuth(x, y, x0, y0, 323.638):
-        return franciscan_napa_sonoma(x, y, depth)
-    else:
-        return brocher2008_great_valley_sequence(x, y, depth)
+    return where(is_along_azimuth(x, y, x0, y0, 323.638), franciscan_napa_sonoma(x, y, depth), brocher2008_great_valley_sequence(x, y, depth))
 
 
+@vectorized
 def cenozoic_napa(x, y, depth):
     """Rule for elastic properties in Cenozoic zone, Napa Block
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
     (x0, y0) = (81696.7, 328741.7)
-    if is_along_azimuth(x, y, x0, y0, 323.638):
-        return brocher2005_older_cenozoic_sedimentary(x, y, depth)
-    else:
-        return cenozoic_walnutcreek(x, y, depth)
+    return where(is_along_azimuth(x, y, x0, y0, 323.638), brocher2005_older_cenozoic_sedimentary(x, y, depth), cenozoic_walnutcreek(x, y, depth))
 
 
+@vectorized
 def franciscan_sonoma(x, y, depth):
     """Rule for elastic properties of Franciscan zone, Sonoma Block
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
     (x0, y0) = (47249.3, 360648.4)
-    if is_along_azimuth(x, y, x0, y0, 323.638):
-        return franciscan_napa_sonoma(x, y, depth)
-    else:
-        return brocher2008_great_valley_sequence(x, y, depth)
+    return where(is_along_azimuth(x, y, x0, y0, 323.638), franciscan_napa_sonoma(x, y, depth), brocher2008_great_valley_sequence(x, y, depth))
 
 
+@vectorized
 def cenozoic_sonoma(x, y, depth):
     """Rule for elastic properties of Cenozoic zone, Sonoma Block
 
     Args:
-        x(float)
+        x(numpy.array)
             Model x coordinate.
-        y(float)
+        y(numpy.array)
             Model y coordinate.
-        depth(float)
+        depth(numpy.array)
             Depth of location in m.
 
     Returns:
         Tuple of density(kg/m**3), Vp(m/s), Vs(m/s), Qp, and Qs
     """
     (x0, y0) = (47249.3, 360648.4)
-    if is_along_azimuth(x, y, x0, y0, 323.638):
-        return brocher2008_great_valley_sequence(x, y, depth)
-    else:
-        return brocher2005_older_cenozoic_sedimentary(x, y, depth)
+    return where(is_along_azimuth(x, y, x0, y0, 323.638), brocher2008_great_valley_sequence(x, y, depth), brocher2005_older_cenozoic_sedimentary(x, y, depth))
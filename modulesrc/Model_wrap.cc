@@ -5,6 +5,11 @@ namespace py = pybind11;
 
 #include "geomodelgrids/serial/Model.hh"
 #include "geomodelgrids/serial/ModelInfo.hh"
+#include "geomodelgrids/utils/constants.hh"
+
+#include "PyArrays.hh"
+
+#include <algorithm>
 
 namespace geomodelgrids {
     class PyModel;
@@ -34,106 +39,150 @@ public:
     }
 
     inline
-    py::array_t<double> contains(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
-
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 3)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 3].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
-
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<bool> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
-
-        bool* result = static_cast<bool*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Model::contains(x[0], x[1], x[2]);
-        }
+    py::array_t<double> contains(py::handle pointsArray) {
+        const size_t spaceDim = 3;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+
+        py::array_t<double> resultArray(numPoints);
+        double* result = resultArray.mutable_data();
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            std::vector<double> pointsBuffer(CHUNK_SIZE*spaceDim);
+            std::vector<double> xyzModel(CHUNK_SIZE*spaceDim);
+            for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+                points.read(pointsBuffer.data(), iStart, count);
+                geomodelgrids::serial::Model::toModelXYZ(xyzModel.data(), pointsBuffer.data(), count);
+                for (size_t iPoint = 0; iPoint < count; ++iPoint) {
+                    const double* xyz = &xyzModel[iPoint*spaceDim];
+                    result[iStart+iPoint] = geomodelgrids::serial::Model::containsModelXYZ(xyz[0], xyz[1], xyz[2]);
+                }
+            }
+        } // Query without GIL
 
         return resultArray;
     }
 
     inline
-    py::array_t<double> query_top_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
-
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 2)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 2].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
-
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
-
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Model::queryTopElevation(x[0], x[1]);
-        }
-
-        return resultArray;
+    py::array query_top_elevation(py::handle pointsArray,
+                                  py::object out) {
+        return _query_elevation(pointsArray, out, false);
     }
 
     inline
-    py::array_t<double> query_topobathy_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
+    py::array query_topobathy_elevation(py::handle pointsArray,
+                                        py::object out) {
+        return _query_elevation(pointsArray, out, true);
+    }
 
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 2)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 2].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
+    inline
+    py::array query(py::handle pointsArray,
+                    py::object out,
+                    py::object dtype) {
+        const size_t spaceDim = 3;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+        const size_t numValues = Model::getValueNames().size();
+        geomodelgrids::PyValuesWriter values(out, numPoints, numValues, dtype);
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            if (values.isFloat()) {
+                _query<float>(&values, points);
+            } else {
+                _query<double>(&values, points);
+            }
+        } // Query without GIL
 
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
+        return values.array();
+    }
 
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Model::queryTopoBathyElevation(x[0], x[1]);
-        }
+private:
 
-        return resultArray;
-    }
+    static const size_t CHUNK_SIZE; ///< Number of points copied to and from numpy arrays at a time.
 
+    /** Query for values at points in chunks, with values of type T.
+     *
+     * Does not require the GIL.
+     *
+     * @param[out] values Writer for values at points.
+     * @param[in] points Reader for points.
+     */
+    template<typename T>
     inline
-    py::array_t<double> query(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
-
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 3)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 3].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
+    void _query(geomodelgrids::PyValuesWriter* values,
+                const geomodelgrids::PyPointsReader& points) {
+        const size_t spaceDim = 3;
+        const size_t numPoints = points.numPoints();
         const size_t numValues = Model::getValueNames().size();
 
-        py::array_t<double> resultArray({numPoints, numValues});
-        py::buffer_info resultInfo = resultArray.request();
-
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            const double* values = geomodelgrids::serial::Model::query(x[0], x[1], x[2]);
-            for (size_t iValue = 0; iValue < numValues; ++iValue) {
-                result[iPoint*numValues+iValue] = values[iValue];
+        std::vector<double> pointsBuffer(CHUNK_SIZE*spaceDim);
+        std::vector<double> xyzModel(CHUNK_SIZE*spaceDim);
+        std::vector<T> valuesBuffer(CHUNK_SIZE*std::max(numValues, size_t(1)));
+        for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+            const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+            points.read(pointsBuffer.data(), iStart, count);
+            geomodelgrids::serial::Model::toModelXYZ(xyzModel.data(), pointsBuffer.data(), count);
+            for (size_t iPoint = 0; iPoint < count; ++iPoint) {
+                const double* xyz = &xyzModel[iPoint*spaceDim];
+                T* pointValues = &valuesBuffer[iPoint*numValues];
+                if (geomodelgrids::serial::Model::containsModelXYZ(xyz[0], xyz[1], xyz[2])) {
+                    const double* modelValues = geomodelgrids::serial::Model::queryModelXYZ(xyz[0], xyz[1], xyz[2]);
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        pointValues[iValue] = T(modelValues[iValue]);
+                    }
+                } else {
+                    std::fill(pointValues, pointValues+numValues, T(geomodelgrids::NODATA_VALUE));
+                }
             }
+            values->write(valuesBuffer.data(), iStart, count);
         }
+    }
 
-        return resultArray;
+    inline
+    py::array _query_elevation(py::handle pointsArray,
+                               py::object out,
+                               const bool topoBathy) {
+        const size_t pointsDim = 2;
+        const size_t spaceDim = 3;
+        geomodelgrids::PyPointsReader points(pointsArray, pointsDim);
+        const size_t numPoints = points.numPoints();
+        geomodelgrids::PyValuesWriter elevation(out, numPoints, 0);
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            std::vector<double> pointsBuffer(CHUNK_SIZE*pointsDim);
+            std::vector<double> xyz(CHUNK_SIZE*spaceDim);
+            std::vector<double> xyzModel(CHUNK_SIZE*spaceDim);
+            std::vector<double> elevationBuffer(CHUNK_SIZE);
+            for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+                points.read(pointsBuffer.data(), iStart, count);
+                for (size_t iPoint = 0; iPoint < count; ++iPoint) {
+                    xyz[iPoint*spaceDim+0] = pointsBuffer[iPoint*pointsDim+0];
+                    xyz[iPoint*spaceDim+1] = pointsBuffer[iPoint*pointsDim+1];
+                    xyz[iPoint*spaceDim+2] = 0.0;
+                }
+                geomodelgrids::serial::Model::toModelXYZ(xyzModel.data(), xyz.data(), count);
+                if (topoBathy) {
+                    geomodelgrids::serial::Model::queryTopoBathyElevations(elevationBuffer.data(), xyzModel.data(),
+                                                                           count);
+                } else {
+                    geomodelgrids::serial::Model::queryTopElevations(elevationBuffer.data(), xyzModel.data(), count);
+                }
+                elevation.write(elevationBuffer.data(), iStart, count);
+            }
+        } // Query without GIL
+
+        return elevation.array();
     }
 
 };
 
+const size_t geomodelgrids::PyModel::CHUNK_SIZE = 4096;
+
 void
 init_model(py::module_& m) {
     py::class_<geomodelgrids::PyModel> model(m, "Model");
@@ -199,17 +248,21 @@ init_model(py::module_& m) {
 
     .def("query_top_elevation", &geomodelgrids::PyModel::query_top_elevation,
          "Query for elevation (m) of top of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none()
          )
 
     .def("query_topobathy_elevation", &geomodelgrids::PyModel::query_topobathy_elevation,
          "Query for elevation (m) of topography/bathymetry of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none()
          )
 
     .def("query", &geomodelgrids::PyModel::query,
-         "Query for model values at points using bilinear interpolation.",
-         py::arg("points"))
+         "Query for model values at points using bilinear interpolation (dtype float32 for single precision values).",
+         py::arg("points"),
+         py::arg("out")=py::none(),
+         py::arg("dtype")=py::none())
 
     ;
 }
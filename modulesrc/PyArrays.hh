@@ -0,0 +1,217 @@
+/** Access to numpy arrays of points and values without holding the GIL.
+ *
+ * Arrays of points may have any strides and a dtype of float32 or float64, so they are used in place rather
+ * than copied into C-contiguous float64 arrays. Points are read and values written in small chunks by the
+ * C++ query loops, which run with the GIL released.
+ */
+#pragma once
+
+#include "pybind11/pybind11.h"
+#include "pybind11/numpy.h"
+
+#include <vector> // USES std::vector
+#include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::runtime_error
+
+namespace geomodelgrids {
+    class PyPointsReader;
+    class PyValuesWriter;
+}
+
+class geomodelgrids::PyPointsReader {
+public:
+
+    /** Constructor.
+     *
+     * Arrays with a dtype other than float32 or float64 (and other sequences) are converted to float64.
+     *
+     * @param[in] points Array of points [numPoints, spaceDim].
+     * @param[in] spaceDim Number of coordinates for each point.
+     */
+    inline
+    PyPointsReader(pybind11::handle points,
+                   const size_t spaceDim) :
+        _spaceDim(spaceDim),
+        _isFloat(false) {
+        if (pybind11::isinstance<pybind11::array_t<float> >(points)) {
+            _array = pybind11::reinterpret_borrow<pybind11::array>(points);
+            _isFloat = true;
+        } else if (pybind11::isinstance<pybind11::array_t<double> >(points)) {
+            _array = pybind11::reinterpret_borrow<pybind11::array>(points);
+        } else {
+            _array = pybind11::array_t<double, pybind11::array::forcecast>::ensure(points);
+        }
+        if (!_array || (_array.ndim() != 2) || (size_t(_array.shape(1)) != spaceDim)) {
+            std::ostringstream msg;
+            msg << "Points must be an array with shape [numPoints, " << spaceDim << "].";
+            throw std::runtime_error(msg.str());
+        }
+        _data = static_cast<const char*>(_array.data());
+        _numPoints = _array.shape(0);
+        _strides[0] = _array.strides(0);
+        _strides[1] = _array.strides(1);
+    }
+
+    /** Get number of points.
+     *
+     * @returns Number of points.
+     */
+    inline
+    size_t numPoints(void) const {
+        return _numPoints;
+    }
+
+    /** Copy coordinates of points into buffer.
+     *
+     * Does not require the GIL.
+     *
+     * @param[out] buffer Coordinates of points [count][spaceDim].
+     * @param[in] iStart Index of first point.
+     * @param[in] count Number of points.
+     */
+    inline
+    void read(double* buffer,
+              const size_t iStart,
+              const size_t count) const {
+        for (size_t iPoint = 0; iPoint < count; ++iPoint) {
+            const char* point = _data + (iStart+iPoint)*_strides[0];
+            for (size_t iDim = 0; iDim < _spaceDim; ++iDim) {
+                const char* coord = point + iDim*_strides[1];
+                buffer[iPoint*_spaceDim+iDim] = (_isFloat) ?
+                                                *reinterpret_cast<const float*>(coord) :
+                                                *reinterpret_cast<const double*>(coord);
+            }
+        }
+    }
+
+private:
+
+    pybind11::array _array; ///< Array of points (holds reference while reading).
+    const char* _data; ///< Pointer to first point.
+    pybind11::ssize_t _strides[2]; ///< Strides (bytes) between points and between coordinates.
+    size_t _numPoints; ///< Number of points.
+    size_t _spaceDim; ///< Number of coordinates for each point.
+    bool _isFloat; ///< True if dtype is float32, false if float64.
+
+}; // PyPointsReader
+
+class geomodelgrids::PyValuesWriter {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] out Preallocated float32 or float64 array with any strides (None to create array).
+     * @param[in] numPoints Number of points.
+     * @param[in] numValues Number of values for each point (0 for array with shape [numPoints]).
+     * @param[in] dtype Data type (float32 or float64) of array to create (None for dtype of out or float64).
+     */
+    inline
+    PyValuesWriter(pybind11::object out,
+                   const size_t numPoints,
+                   const size_t numValues,
+                   pybind11::object dtype=pybind11::none()) :
+        _numValues(numValues),
+        _isFloat(false) {
+        std::vector<pybind11::ssize_t> shape(1, pybind11::ssize_t(numPoints));
+        if (numValues) {
+            shape.push_back(pybind11::ssize_t(numValues));
+        }
+        if (!dtype.is_none()) {
+            const pybind11::dtype valuesDtype = pybind11::dtype::from_args(dtype);
+            if ((valuesDtype.kind() != 'f') || ((valuesDtype.itemsize() != 4) && (valuesDtype.itemsize() != 8))) {
+                throw std::runtime_error("Data type of values must be float32 or float64.");
+            }
+            _isFloat = (valuesDtype.itemsize() == 4);
+        }
+        if (out.is_none()) {
+            if (_isFloat) {
+                _array = pybind11::array_t<float>(shape);
+            } else {
+                _array = pybind11::array_t<double>(shape);
+            }
+        } else {
+            const bool isFloat = pybind11::isinstance<pybind11::array_t<float> >(out);
+            bool isValid = isFloat || pybind11::isinstance<pybind11::array_t<double> >(out);
+            if (isValid && !dtype.is_none()) {
+                isValid = (isFloat == _isFloat);
+            }
+            if (isValid) {
+                _array = pybind11::reinterpret_borrow<pybind11::array>(out);
+                isValid = _array.writeable() && (size_t(_array.ndim()) == shape.size());
+                for (size_t i = 0; isValid && (i < shape.size()); ++i) {
+                    isValid = (_array.shape(i) == shape[i]);
+                }
+            }
+            if (!isValid) {
+                std::ostringstream msg;
+                const char* dtypeName = (dtype.is_none()) ? "float32 or float64" : ((_isFloat) ? "float32" : "float64");
+                msg << "Output must be a writeable " << dtypeName << " array with shape [" << numPoints;
+                if (numValues) {
+                    msg << ", " << numValues;
+                }
+                msg << "].";
+                throw std::runtime_error(msg.str());
+            }
+            _isFloat = isFloat;
+        }
+        _data = static_cast<char*>(_array.mutable_data());
+        _strides[0] = _array.strides(0);
+        _strides[1] = (numValues) ? _array.strides(1) : 0;
+    }
+
+    /** Get array.
+     *
+     * @returns Array of values.
+     */
+    inline
+    pybind11::array array(void) const {
+        return _array;
+    }
+
+    /** Check whether array has single precision values.
+     *
+     * @returns True if dtype is float32, false if float64.
+     */
+    inline
+    bool isFloat(void) const {
+        return _isFloat;
+    }
+
+    /** Copy values from buffer into array.
+     *
+     * Does not require the GIL. Values are converted to the dtype of the array.
+     *
+     * @param[in] buffer Values at points [count][max(numValues, 1)].
+     * @param[in] iStart Index of first point.
+     * @param[in] count Number of points.
+     */
+    template<typename T>
+    inline
+    void write(const T* buffer,
+               const size_t iStart,
+               const size_t count) {
+        const size_t numValues = (_numValues) ? _numValues : 1;
+        for (size_t iPoint = 0; iPoint < count; ++iPoint) {
+            char* point = _data + (iStart+iPoint)*_strides[0];
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                char* value = point + iValue*_strides[1];
+                if (_isFloat) {
+                    *reinterpret_cast<float*>(value) = float(buffer[iPoint*numValues+iValue]);
+                } else {
+                    *reinterpret_cast<double*>(value) = double(buffer[iPoint*numValues+iValue]);
+                }
+            }
+        }
+    }
+
+private:
+
+    pybind11::array _array; ///< Array of values (holds reference while writing).
+    char* _data; ///< Pointer to values for first point.
+    pybind11::ssize_t _strides[2]; ///< Strides (bytes) between points and between values.
+    size_t _numValues; ///< Number of values for each point (0 for array with shape [numPoints]).
+    bool _isFloat; ///< True if dtype is float32, false if float64.
+
+}; // PyValuesWriter
+
+// End of file
@@ -0,0 +1,144 @@
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+#include "pybind11/numpy.h"
+namespace py = pybind11;
+
+#include "geomodelgrids/serial/QueryClient.hh"
+#include "geomodelgrids/utils/ErrorHandler.hh"
+
+#include "PyArrays.hh"
+
+#include <algorithm>
+
+namespace geomodelgrids {
+    class PyQueryClient;
+}
+
+class geomodelgrids::PyQueryClient : public geomodelgrids::serial::QueryClient {
+public:
+
+    inline
+    PyQueryClient(void) {}
+
+
+    inline
+    ~PyQueryClient(void) {}
+
+
+    inline
+    py::array query_top_elevation(py::handle pointsArray,
+                                  py::object out) {
+        return _query_elevation(pointsArray, out, false);
+    }
+
+    inline
+    py::array query_topobathy_elevation(py::handle pointsArray,
+                                        py::object out) {
+        return _query_elevation(pointsArray, out, true);
+    }
+
+    inline
+    std::tuple < py::array, py::array_t<int> > query(py::handle pointsArray,
+                                                     py::object out) {
+        const size_t spaceDim = 3;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+        const size_t numValues = geomodelgrids::serial::QueryClient::getValueNames().size();
+        geomodelgrids::PyValuesWriter values(out, numPoints, numValues);
+
+        py::array_t<int> errorArray(numPoints);
+        int* error = errorArray.mutable_data();
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            std::vector<double> pointsBuffer(std::min(CHUNK_SIZE, numPoints)*spaceDim);
+            std::vector<double> valuesBuffer(std::min(CHUNK_SIZE, numPoints)*numValues);
+            for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+                points.read(pointsBuffer.data(), iStart, count);
+                geomodelgrids::serial::QueryClient::queryPoints(valuesBuffer.data(), pointsBuffer.data(), count,
+                                                                &error[iStart]);
+                values.write(valuesBuffer.data(), iStart, count);
+            }
+        } // Query without GIL
+
+        return std::make_tuple(values.array(), errorArray);
+    }
+
+private:
+
+    static const size_t CHUNK_SIZE; ///< Number of points sent to the server in each request.
+
+    inline
+    py::array _query_elevation(py::handle pointsArray,
+                               py::object out,
+                               const bool topoBathy) {
+        const size_t spaceDim = 2;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+        geomodelgrids::PyValuesWriter elevation(out, numPoints, 0);
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            std::vector<double> pointsBuffer(std::min(CHUNK_SIZE, numPoints)*spaceDim);
+            std::vector<double> elevationBuffer(std::min(CHUNK_SIZE, numPoints));
+            for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+                points.read(pointsBuffer.data(), iStart, count);
+                if (topoBathy) {
+                    geomodelgrids::serial::QueryClient::queryTopoBathyElevations(elevationBuffer.data(),
+                                                                                 pointsBuffer.data(), count);
+                } else {
+                    geomodelgrids::serial::QueryClient::queryTopElevations(elevationBuffer.data(),
+                                                                           pointsBuffer.data(), count);
+                }
+                elevation.write(elevationBuffer.data(), iStart, count);
+            }
+        } // Query without GIL
+
+        return elevation.array();
+    }
+
+};
+
+const size_t geomodelgrids::PyQueryClient::CHUNK_SIZE = 65536;
+
+void
+init_queryclient(py::module_& m) {
+    py::class_<geomodelgrids::PyQueryClient>(m, "QueryClient")
+    .def(py::init<>())
+
+    .def("get_error_handler", &geomodelgrids::PyQueryClient::getErrorHandler)
+
+    .def("connect", &geomodelgrids::PyQueryClient::connect,
+         "Connect to query server listening on Unix-domain socket.",
+         py::arg("socket_path"))
+
+    .def("get_value_names", &geomodelgrids::PyQueryClient::getValueNames,
+         "Get names of values returned by queries.")
+
+    .def("query_top_elevation", &geomodelgrids::PyQueryClient::query_top_elevation,
+         "Query server for elevation (m) of top of model at points.",
+         py::arg("points"),
+         py::arg("out")=py::none()
+         )
+
+    .def("query_topobathy_elevation", &geomodelgrids::PyQueryClient::query_topobathy_elevation,
+         "Query server for elevation (m) of topography/bathymetry of model at points.",
+         py::arg("points"),
+         py::arg("out")=py::none()
+         )
+
+    .def("query", &geomodelgrids::PyQueryClient::query,
+         "Query server for model values at points.",
+         py::arg("points"),
+         py::arg("out")=py::none())
+
+    .def("shutdown_server", &geomodelgrids::PyQueryClient::shutdownServer,
+         "Ask query server to shut down and close connection.")
+
+    .def("close", &geomodelgrids::PyQueryClient::close,
+         "Close connection to query server.")
+
+    ;
+}
@@ -4,9 +4,15 @@
 namespace py = pybind11;
 
 #include "geomodelgrids/serial/Query.hh"
+#include "geomodelgrids/serial/QueryStats.hh"
+#include "geomodelgrids/serial/SharedChunkCache.hh"
 #include "geomodelgrids/utils/ErrorHandler.hh"
 #include "geomodelgrids/utils/constants.hh"
 
+#include "PyArrays.hh"
+
+#include <algorithm>
+
 namespace geomodelgrids {
     class PyQuery;
 }
@@ -23,87 +29,153 @@ public:
 
 
     inline
-    py::array_t<double> query_top_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
-
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 2)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 2].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
+    void set_block_hyperslab_dims(const std::vector<size_t>& dims) {
+        geomodelgrids::serial::Query::setBlockHyperslabDims(dims.data(), dims.size());
+    }
 
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
+    inline
+    void set_surface_hyperslab_dims(const std::vector<size_t>& dims) {
+        geomodelgrids::serial::Query::setSurfaceHyperslabDims(dims.data(), dims.size());
+    }
 
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Query::queryTopElevation(x[0], x[1]);
+    inline
+    py::dict get_stats(void) {
+        const geomodelgrids::serial::QueryStats* stats = geomodelgrids::serial::Query::getStats().get();
+        if (!stats) {
+            throw std::runtime_error("Collecting query statistics is off. Call set_stats_on(True) before initialize().");
         }
 
-        return resultArray;
+        py::dict statsDict;
+        statsDict["num_points"] = stats->numPoints;
+        statsDict["num_points_found"] = stats->numPointsFound;
+        statsDict["num_points_outside"] = stats->numPointsOutside;
+        statsDict["num_transforms"] = stats->numTransforms;
+        statsDict["num_surface_queries"] = stats->numSurfaceQueries;
+        statsDict["num_hyperslab_hits"] = stats->numHyperslabHits;
+        statsDict["num_hyperslab_prefetch_hits"] = stats->numHyperslabPrefetchHits;
+        statsDict["num_hyperslab_misses"] = stats->numHyperslabMisses;
+        statsDict["num_bytes_read"] = stats->numBytesRead;
+        statsDict["time_transform"] = stats->timeTransform;
+        statsDict["time_io"] = stats->timeIO;
+        statsDict["time_interpolate"] = stats->timeInterpolate;
+        return statsDict;
     }
 
     inline
-    py::array_t<double> query_topobathy_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
+    py::array query_top_elevation(py::handle pointsArray,
+                                  py::object out) {
+        return _query_elevation(pointsArray, out, false);
+    }
 
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 2)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 2].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
+    inline
+    py::array query_topobathy_elevation(py::handle pointsArray,
+                                        py::object out) {
+        return _query_elevation(pointsArray, out, true);
+    }
 
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
+    inline
+    std::tuple < py::array, py::array_t<int> > query(py::handle pointsArray,
+                                                     py::object out,
+                                                     py::object dtype) {
+        const size_t spaceDim = 3;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+        const size_t numValues = geomodelgrids::serial::Query::getValueNames().size();
+        geomodelgrids::PyValuesWriter values(out, numPoints, numValues, dtype);
 
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Query::queryTopoBathyElevation(x[0], x[1]);
+        py::array_t<int> errorArray(numPoints);
+        int* error = errorArray.mutable_data();
+
+        int errorCode = geomodelgrids::utils::ErrorHandler::OK;
+        { // Query without GIL
+            py::gil_scoped_release release;
+            if (values.isFloat()) {
+                errorCode = _query<float>(&values, points, error);
+            } else {
+                errorCode = _query<double>(&values, points, error);
+            }
+        } // Query without GIL
+        if (errorCode == geomodelgrids::utils::ErrorHandler::ERROR) {
+            throw std::runtime_error(geomodelgrids::serial::Query::getErrorHandler()->getMessage());
         }
 
-        return resultArray;
+        return std::make_tuple(values.array(), errorArray);
     }
 
-    inline
-    std::tuple < py::array_t<double>, py::array_t<int> > query(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
-        py::buffer_info pointsInfo = pointsArray.request();
-        const double* const points = static_cast<const double*>(pointsInfo.ptr);
-
-        if ((pointsInfo.ndim != 2) || (pointsInfo.shape[1] != 3)) {
-            throw std::runtime_error("Points must be an array with shape [numPoints, 3].");
-        }
-        const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
-        const size_t numValues = geomodelgrids::serial::Query::getValueNames().size();
+private:
 
-        py::array_t<double> resultArray({numPoints, numValues});
-        py::buffer_info resultInfo = resultArray.request();
-        double* result = static_cast<double*>(resultInfo.ptr);
+    static const size_t CHUNK_SIZE; ///< Number of points copied to and from numpy arrays at a time.
 
-        py::array_t<int> errorArray(numPoints);
-        py::buffer_info errorInfo = errorArray.request();
-        int* error = static_cast<int*>(errorInfo.ptr);
+    /** Query for values at points in chunks, with values of type T.
+     *
+     * Does not require the GIL.
+     *
+     * @param[out] values Writer for values at points.
+     * @param[in] points Reader for points.
+     * @param[out] error Status for each point.
+     * @returns Status of last chunk queried.
+     */
+    template<typename T>
+    inline
+    int _query(geomodelgrids::PyValuesWriter* values,
+               const geomodelgrids::PyPointsReader& points,
+               int* error) {
+        const size_t spaceDim = 3;
+        const size_t numPoints = points.numPoints();
+        const size_t numValues = geomodelgrids::serial::Query::getValueNames().size();
 
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            const int errorCode = geomodelgrids::serial::Query::query(&result[iPoint*numValues], x[0], x[1], x[2]);
-            error[iPoint] = errorCode;
+        int errorCode = geomodelgrids::utils::ErrorHandler::OK;
+        std::vector<double> pointsBuffer(CHUNK_SIZE*spaceDim);
+        std::vector<T> valuesBuffer(CHUNK_SIZE*std::max(numValues, size_t(1)));
+        for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+            const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+            points.read(pointsBuffer.data(), iStart, count);
+            errorCode = geomodelgrids::serial::Query::queryPoints(valuesBuffer.data(), numValues,
+                                                                  &pointsBuffer[0], &pointsBuffer[1],
+                                                                  &pointsBuffer[2], spaceDim, count,
+                                                                  &error[iStart]);
             if (errorCode == geomodelgrids::utils::ErrorHandler::ERROR) {
-                throw std::runtime_error(geomodelgrids::serial::Query::getErrorHandler()->getMessage());
+                break;
             }
+            values->write(valuesBuffer.data(), iStart, count);
         }
+        return errorCode;
+    }
 
-        return std::make_tuple(resultArray, errorArray);
+    inline
+    py::array _query_elevation(py::handle pointsArray,
+                               py::object out,
+                               const bool topoBathy) {
+        const size_t spaceDim = 2;
+        geomodelgrids::PyPointsReader points(pointsArray, spaceDim);
+        const size_t numPoints = points.numPoints();
+        geomodelgrids::PyValuesWriter elevation(out, numPoints, 0);
+
+        { // Query without GIL
+            py::gil_scoped_release release;
+            std::vector<double> pointsBuffer(CHUNK_SIZE*spaceDim);
+            std::vector<double> elevationBuffer(CHUNK_SIZE);
+            for (size_t iStart = 0; iStart < numPoints; iStart += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, numPoints-iStart);
+                points.read(pointsBuffer.data(), iStart, count);
+                if (topoBathy) {
+                    geomodelgrids::serial::Query::queryTopoBathyElevations(elevationBuffer.data(),
+                                                                           pointsBuffer.data(), count);
+                } else {
+                    geomodelgrids::serial::Query::queryTopElevations(elevationBuffer.data(), pointsBuffer.data(),
+                                                                     count);
+                }
+                elevation.write(elevationBuffer.data(), iStart, count);
+            }
+        } // Query without GIL
+
+        return elevation.array();
     }
 
 };
 
+const size_t geomodelgrids::PyQuery::CHUNK_SIZE = 4096;
+
 void
 init_query(py::module_& m) {
     py::class_<geomodelgrids::PyQuery> query(m, "Query");
@@ -130,6 +202,47 @@ init_query(py::module_& m) {
     .def("finalize", &geomodelgrids::PyQuery::finalize,
          "Clean up after querying the models.")
 
+    .def("set_block_hyperslab_dims", &geomodelgrids::PyQuery::set_block_hyperslab_dims,
+         "Set dimensions [x, y, z] of hyperslabs for blocks (0 for automatic sizing); call before initialize().",
+         py::arg("dims"))
+
+    .def("set_surface_hyperslab_dims", &geomodelgrids::PyQuery::set_surface_hyperslab_dims,
+         "Set dimensions [x, y] of hyperslabs for surfaces (0 for automatic sizing); call before initialize().",
+         py::arg("dims"))
+
+    .def("set_hyperslab_max_bytes", &geomodelgrids::PyQuery::setHyperslabMaxBytes,
+         "Set memory budget (bytes) for automatically sized hyperslabs; call before initialize().",
+         py::arg("max_bytes"))
+
+    .def("set_hyperslab_prefetch", &geomodelgrids::PyQuery::setHyperslabPrefetch,
+         "Turn prefetching of the next hyperslab along the traversal direction on/off; call before initialize().",
+         py::arg("value"))
+
+    .def("set_query_resolution", &geomodelgrids::PyQuery::setQueryResolution,
+         "Set horizontal resolution (m) needed by queries to use coarser pyramid levels; call before initialize().",
+         py::arg("value"))
+
+    .def("set_metadata_cache", &geomodelgrids::PyQuery::setMetadataCache,
+         "Set file used to cache model metadata between runs (empty string to turn off); call before initialize().",
+         py::arg("filename"))
+
+    .def("set_shared_cache", &geomodelgrids::PyQuery::setSharedCache,
+         "Set POSIX shared memory cache of model chunks shared by processes on the node (empty string to turn off); "
+         "call before initialize().",
+         py::arg("name"),
+         py::arg("cache_bytes")=geomodelgrids::serial::SharedChunkCache::DEFAULT_CACHE_BYTES,
+         py::arg("slot_bytes")=geomodelgrids::serial::SharedChunkCache::DEFAULT_SLOT_BYTES)
+
+    .def("set_stats_on", &geomodelgrids::PyQuery::setStatsOn,
+         "Turn collecting query statistics on/off; call before initialize().",
+         py::arg("value"))
+
+    .def("get_stats", &geomodelgrids::PyQuery::get_stats,
+         "Get query statistics as a dictionary.")
+
+    .def("reset_stats", &geomodelgrids::PyQuery::resetStats,
+         "Reset query statistics to zero.")
+
     .def("set_squash_min_elev", &geomodelgrids::PyQuery::setSquashMinElev,
          "Turn on squashing using the top surface and set the minimum elevation for squashing.",
          py::arg("min_elev"))
@@ -140,17 +253,21 @@ init_query(py::module_& m) {
 
     .def("query_top_elevation", &geomodelgrids::PyQuery::query_top_elevation,
          "Query for elevation (m) of top of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none()
          )
 
     .def("query_topobathy_elevation", &geomodelgrids::PyQuery::query_topobathy_elevation,
          "Query for elevation (m) of topography/bathymetry of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none()
          )
 
     .def("query", &geomodelgrids::PyQuery::query,
-         "Query for model values at points using bilinear interpolation.",
-         py::arg("points"))
+         "Query for model values at points using bilinear interpolation (dtype float32 for single precision values).",
+         py::arg("points"),
+         py::arg("out")=py::none(),
+         py::arg("dtype")=py::none())
 
     ;
 }
@@ -7,11 +7,14 @@ void init_modelinfo(py::module_ &);
 
 void init_query(py::module_ &);
 
+void init_queryclient(py::module_ &);
+
 void init_errorhandler(py::module_ &);
 
 PYBIND11_MODULE(_geomodelgrids, m) {
     init_model(m);
     init_modelinfo(m);
     init_query(m);
+    init_queryclient(m);
     init_errorhandler(m);
 }
@@ -0,0 +1,532 @@
+#include <portinfo>
+
+#include "QueryBenchmark.hh" // implementation of class methods
+
+#include "SyntheticModel.hh" // USES SyntheticModel
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Query.hh" // USES Query
+extern "C" {
+#include "geomodelgrids/serial/cquery.h" // USES geomodelgrids_squery_*
+}
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include <getopt.h> // USES getopt_long()
+#include <algorithm> // USES std::sort(), std::min()
+#include <chrono> // USES std::chrono
+#include <cstdio> // USES std::remove()
+#include <cstdlib> // USES std::system()
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <iomanip> // USES std::setprecision()
+#include <iostream> // USES std::cout
+#include <limits> // USES std::numeric_limits
+#include <random> // USES std::mt19937
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <stdexcept> // USES std::runtime_error
+#include <cmath> // USES floor()
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace benchmark {
+        class _QueryBenchmark {
+public:
+
+            /// Number of points in each column for the columnar distribution.
+            static const size_t numPointsColumn = 100;
+
+            /// Number of horizontal tiles along each direction for sorting points.
+            static const size_t numTilesSort = 32;
+
+            /// Split comma separated string into tokens.
+            static
+            std::vector<std::string> split(const char* value) {
+                std::vector<std::string> tokens;
+                std::istringstream tokenStream(value);
+                std::string token;
+                while (std::getline(tokenStream, token, ',')) {
+                    tokens.push_back(token);
+                } // while
+                return tokens;
+            } // split
+
+            /// Get current wall clock time in seconds.
+            static
+            double now(void) {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            } // now
+
+        }; // _QueryBenchmark
+    } // benchmark
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::benchmark::QueryBenchmark::QueryBenchmark(void) :
+    _numBlocks({ 1, 5, 20 }),
+    _resolutions({ "uniform", "variable" }),
+    _topography({ "flat", "topo" }),
+    _distributions({ "random", "sorted", "columnar" }),
+    _interfaces({ "model", "query", "capi", "cli" }),
+    _outputFilename("benchmark.json"),
+    _workDir("."),
+    _cliFilename(""),
+    _numPoints(20000),
+    _numCells(64),
+    _numRepeat(3),
+    _showHelp(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::benchmark::QueryBenchmark::~QueryBenchmark(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Run benchmark application.
+int
+geomodelgrids::benchmark::QueryBenchmark::run(int argc,
+                                              char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    _results.clear();
+    for (size_t iBlocks = 0; iBlocks < _numBlocks.size(); ++iBlocks) {
+        for (size_t iRes = 0; iRes < _resolutions.size(); ++iRes) {
+            for (size_t iTopo = 0; iTopo < _topography.size(); ++iTopo) {
+                std::ostringstream label;
+                label << _resolutions[iRes] << "-" << _topography[iTopo] << "-" << _numBlocks[iBlocks] << "blocks";
+                const std::string filename = _workDir + "/benchmark-" + label.str() + ".h5";
+
+                SyntheticModel model;
+                model.setNumBlocks(_numBlocks[iBlocks]);
+                model.setNumCells(_numCells);
+                model.setVariableResolution("variable" == _resolutions[iRes]);
+                model.setTopography("topo" == _topography[iTopo]);
+                const size_t modelBytes = model.write(filename.c_str());
+                std::cout << "Model " << label.str() << " (" << modelBytes << " bytes)" << std::endl;
+
+                for (size_t iDist = 0; iDist < _distributions.size(); ++iDist) {
+                    std::vector<double> points;
+                    _generatePoints(&points, model, _distributions[iDist]);
+
+                    for (size_t iInterface = 0; iInterface < _interfaces.size(); ++iInterface) {
+                        if (("cli" == _interfaces[iInterface]) && _cliFilename.empty()) {
+                            continue;
+                        } // if
+                        Result result;
+                        result.model = label.str();
+                        result.resolution = _resolutions[iRes];
+                        result.topography = "topo" == _topography[iTopo];
+                        result.numBlocks = _numBlocks[iBlocks];
+                        result.modelBytes = modelBytes;
+                        result.distribution = _distributions[iDist];
+                        result.interface = _interfaces[iInterface];
+                        result.numPoints = points.size() / 3;
+                        result.numFound = 0;
+                        result.time = std::numeric_limits<double>::max();
+                        for (size_t iRepeat = 0; iRepeat < _numRepeat; ++iRepeat) {
+                            const double time = _queryPoints(&result.numFound, _interfaces[iInterface],
+                                                             filename, model.getCRSString(), points);
+                            result.time = std::min(result.time, time);
+                        } // for
+                        _results.push_back(result);
+
+                        std::cout << "    " << std::setw(10) << std::left << result.distribution
+                                  << std::setw(6) << result.interface << std::right
+                                  << std::setw(14) << std::setprecision(4) << result.numPoints / result.time
+                                  << " points/s" << std::endl;
+                    } // for
+                } // for
+                std::remove(filename.c_str());
+            } // for
+        } // for
+    } // for
+
+    std::ofstream sout(_outputFilename);
+    if (!sout.is_open() || !sout.good()) {
+        std::ostringstream msg;
+        msg << "Could not open output file '" << _outputFilename << "' for writing.";
+        throw std::runtime_error(msg.str().c_str());
+    } // if
+    _writeJSON(sout);
+    sout.close();
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::benchmark::QueryBenchmark::_parseArgs(int argc,
+                                                     char* argv[]) {
+    static struct option options[14] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"output", required_argument, nullptr, 'o'},
+        {"workdir", required_argument, nullptr, 'w'},
+        {"num-points", required_argument, nullptr, 'n'},
+        {"num-cells", required_argument, nullptr, 'c'},
+        {"num-blocks", required_argument, nullptr, 'b'},
+        {"resolution", required_argument, nullptr, 'r'},
+        {"topography", required_argument, nullptr, 't'},
+        {"distributions", required_argument, nullptr, 'd'},
+        {"interfaces", required_argument, nullptr, 'i'},
+        {"repeat", required_argument, nullptr, 'p'},
+        {"cli", required_argument, nullptr, 'x'},
+        {0, 0, 0, 0}
+    };
+
+    while (true) {
+        const char c = getopt_long(argc, argv, "ho:w:n:c:b:r:t:d:i:p:x:", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'o': {
+            _outputFilename = optarg;
+            break;
+        } // 'o'
+        case 'w': {
+            _workDir = optarg;
+            break;
+        } // 'w'
+        case 'n': {
+            _numPoints = std::stoul(optarg);
+            break;
+        } // 'n'
+        case 'c': {
+            _numCells = std::stoul(optarg);
+            break;
+        } // 'c'
+        case 'b': {
+            _numBlocks.clear();
+            const std::vector<std::string>& tokens = _QueryBenchmark::split(optarg);
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                _numBlocks.push_back(std::stoul(tokens[i]));
+            } // for
+            break;
+        } // 'b'
+        case 'r': {
+            _resolutions = _QueryBenchmark::split(optarg);
+            break;
+        } // 'r'
+        case 't': {
+            _topography = _QueryBenchmark::split(optarg);
+            break;
+        } // 't'
+        case 'd': {
+            _distributions = _QueryBenchmark::split(optarg);
+            break;
+        } // 'd'
+        case 'i': {
+            _interfaces = _QueryBenchmark::split(optarg);
+            break;
+        } // 'i'
+        case 'p': {
+            _numRepeat = std::max(size_t(1), size_t(std::stoul(optarg)));
+            break;
+        } // 'p'
+        case 'x': {
+            _cliFilename = optarg;
+            break;
+        } // 'x'
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error parsing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+
+    if (!_showHelp) { // Verify arguments.
+        bool optionsOkay = true;
+        std::ostringstream msg;
+        for (size_t i = 0; i < _resolutions.size(); ++i) {
+            if (("uniform" != _resolutions[i]) && ("variable" != _resolutions[i])) {
+                msg << "    - Unknown resolution '" << _resolutions[i] << "'. Use uniform or variable.\n";
+                optionsOkay = false;
+            } // if
+        } // for
+        for (size_t i = 0; i < _topography.size(); ++i) {
+            if (("flat" != _topography[i]) && ("topo" != _topography[i])) {
+                msg << "    - Unknown topography '" << _topography[i] << "'. Use flat or topo.\n";
+                optionsOkay = false;
+            } // if
+        } // for
+        for (size_t i = 0; i < _distributions.size(); ++i) {
+            if (("random" != _distributions[i]) && ("sorted" != _distributions[i]) && ("columnar" != _distributions[i])) {
+                msg << "    - Unknown distribution '" << _distributions[i] << "'. Use random, sorted, or columnar.\n";
+                optionsOkay = false;
+            } // if
+        } // for
+        for (size_t i = 0; i < _interfaces.size(); ++i) {
+            if (("model" != _interfaces[i]) && ("query" != _interfaces[i]) && ("capi" != _interfaces[i]) &&
+                ("cli" != _interfaces[i])) {
+                msg << "    - Unknown interface '" << _interfaces[i] << "'. Use model, query, capi, or cli.\n";
+                optionsOkay = false;
+            } // if
+        } // for
+        for (size_t i = 0; i < _numBlocks.size(); ++i) {
+            if ((_numBlocks[i] < 1) || (_numBlocks[i] > 20)) {
+                msg << "    - Number of blocks (" << _numBlocks[i] << ") must be in the range 1-20.\n";
+                optionsOkay = false;
+            } // if
+        } // for
+        if (!_numPoints) {
+            msg << "    - Number of points must be positive.\n";
+            optionsOkay = false;
+        } // if
+
+        if (!optionsOkay) {
+            throw std::runtime_error(std::string("Error in command line arguments:\n")+ msg.str());
+        } // if
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::benchmark::QueryBenchmark::_printHelp(void) {
+    std::cout << "Usage: benchmark_query "
+              << "[--help] [--output=FILE_OUTPUT] [--workdir=DIR] [--num-points=NUM] [--num-cells=NUM] "
+              << "[--num-blocks=NUM_0,...,NUM_N] [--resolution=uniform,variable] [--topography=flat,topo] "
+              << "[--distributions=random,sorted,columnar] [--interfaces=model,query,capi,cli] [--repeat=NUM] "
+              << "[--cli=FILE_EXECUTABLE]\n\n"
+              << "    --help                           Print help information to stdout and exit.\n"
+              << "    --output=FILE_OUTPUT             Write results as JSON to FILE_OUTPUT (default=benchmark.json).\n"
+              << "    --workdir=DIR                    Directory for temporary model and points files (default=.).\n"
+              << "    --num-points=NUM                 Number of points in each query (default=20000).\n"
+              << "    --num-cells=NUM                  Number of cells along each horizontal direction in top block (default=64).\n"
+              << "    --num-blocks=NUM_0,...,NUM_N     Number of blocks in models, 1-20 (default=1,5,20).\n"
+              << "    --resolution=uniform,variable    Grid resolution of models (default=uniform,variable).\n"
+              << "    --topography=flat,topo           Models without and with topography (default=flat,topo).\n"
+              << "    --distributions=random,sorted,columnar Point distributions (default=random,sorted,columnar).\n"
+              << "    --interfaces=model,query,capi,cli Interfaces to benchmark (default=model,query,capi,cli).\n"
+              << "    --repeat=NUM                     Number of repetitions; best time is reported (default=3).\n"
+              << "    --cli=FILE_EXECUTABLE            Path to geomodelgrids_query (cli interface is skipped if not given)."
+              << std::endl;
+} // _printHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Generate points for distribution.
+void
+geomodelgrids::benchmark::QueryBenchmark::_generatePoints(std::vector<double>* points,
+                                                          const SyntheticModel& model,
+                                                          const std::string& distribution) const {
+    assert(points);
+
+    const double* dims = model.getDims();
+    const double* origin = model.getOrigin();
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<double> randomX(0.0, dims[0]);
+    std::uniform_real_distribution<double> randomY(0.0, dims[1]);
+    std::uniform_real_distribution<double> randomZ(0.0, 1.0);
+
+    points->resize(3*_numPoints);
+    if ("columnar" == distribution) {
+        const size_t numColumn = _QueryBenchmark::numPointsColumn;
+        for (size_t iColumn = 0; iColumn*numColumn < _numPoints; ++iColumn) {
+            const double x = randomX(generator);
+            const double y = randomY(generator);
+            const double zTop = model.computeTopElevation(x, y);
+            const double dz = (zTop + dims[2]) / numColumn;
+            for (size_t i = 0, iPt = iColumn*numColumn; i < numColumn && iPt < _numPoints; ++i, ++iPt) {
+                (*points)[3*iPt+0] = origin[0] + x;
+                (*points)[3*iPt+1] = origin[1] + y;
+                (*points)[3*iPt+2] = zTop - dz * (i + 0.5);
+            } // for
+        } // for
+    } else {
+        for (size_t iPt = 0; iPt < _numPoints; ++iPt) {
+            const double x = randomX(generator);
+            const double y = randomY(generator);
+            const double zTop = model.computeTopElevation(x, y);
+            (*points)[3*iPt+0] = origin[0] + x;
+            (*points)[3*iPt+1] = origin[1] + y;
+            (*points)[3*iPt+2] = zTop - (zTop + dims[2]) * randomZ(generator);
+        } // for
+
+        if ("sorted" == distribution) {
+            // Sort by horizontal tile (row major) and then by decreasing elevation within each tile.
+            const size_t numTiles = _QueryBenchmark::numTilesSort;
+            std::vector<std::pair<std::pair<size_t, double>, size_t> > keys(_numPoints);
+            for (size_t iPt = 0; iPt < _numPoints; ++iPt) {
+                const size_t ix = std::min(numTiles-1, size_t(numTiles * ((*points)[3*iPt+0] - origin[0]) / dims[0]));
+                const size_t iy = std::min(numTiles-1, size_t(numTiles * ((*points)[3*iPt+1] - origin[1]) / dims[1]));
+                keys[iPt] = std::make_pair(std::make_pair(ix*numTiles + iy, -(*points)[3*iPt+2]), iPt);
+            } // for
+            std::sort(keys.begin(), keys.end());
+            std::vector<double> sorted(points->size());
+            for (size_t iPt = 0; iPt < _numPoints; ++iPt) {
+                const size_t iSrc = keys[iPt].second;
+                sorted[3*iPt+0] = (*points)[3*iSrc+0];
+                sorted[3*iPt+1] = (*points)[3*iSrc+1];
+                sorted[3*iPt+2] = (*points)[3*iSrc+2];
+            } // for
+            points->swap(sorted);
+        } // if
+    } // if/else
+} // _generatePoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Query points using interface.
+double
+geomodelgrids::benchmark::QueryBenchmark::_queryPoints(size_t* numFound,
+                                                       const std::string& interface,
+                                                       const std::string& filename,
+                                                       const std::string& crs,
+                                                       const std::vector<double>& points) const {
+    assert(numFound);
+
+    const size_t numPoints = points.size() / 3;
+    const char* const valueNames[2] = { "one", "two" };
+    const size_t numValues = 2;
+    double values[numValues];
+    size_t found = 0;
+    double tStart = 0.0;
+    double tEnd = 0.0;
+
+    if ("model" == interface) {
+        geomodelgrids::serial::Model model;
+        model.setInputCRS(crs);
+        model.open(filename.c_str(), geomodelgrids::serial::Model::READ);
+        model.loadMetadata();
+        model.initialize();
+
+        tStart = _QueryBenchmark::now();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xyz = &points[3*iPt];
+            if (model.contains(xyz[0], xyz[1], xyz[2])) {
+                const double* modelValues = model.query(xyz[0], xyz[1], xyz[2]);
+                values[0] = modelValues[0];
+                ++found;
+            } // if
+        } // for
+        tEnd = _QueryBenchmark::now();
+        model.close();
+    } else if ("query" == interface) {
+        geomodelgrids::serial::Query query;
+        query.initialize(std::vector<std::string>(1, filename),
+                         std::vector<std::string>(valueNames, valueNames+numValues), crs);
+
+        tStart = _QueryBenchmark::now();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xyz = &points[3*iPt];
+            if (!query.query(values, xyz[0], xyz[1], xyz[2])) {
+                ++found;
+            } // if
+        } // for
+        tEnd = _QueryBenchmark::now();
+        query.finalize();
+    } else if ("capi" == interface) {
+        void* handle = geomodelgrids_squery_create();
+        const char* const modelFilenames[1] = { filename.c_str() };
+        int err = geomodelgrids_squery_initialize(handle, modelFilenames, 1, valueNames, numValues, crs.c_str());
+        if (err) {
+            geomodelgrids_squery_destroy(&handle);
+            throw std::runtime_error("Error initializing query with C API.");
+        } // if
+
+        tStart = _QueryBenchmark::now();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xyz = &points[3*iPt];
+            geomodelgrids_squery_query(handle, values, xyz[0], xyz[1], xyz[2]);
+            if (values[0] != geomodelgrids::NODATA_VALUE) {
+                ++found;
+            } // if
+        } // for
+        tEnd = _QueryBenchmark::now();
+        geomodelgrids_squery_finalize(handle);
+        geomodelgrids_squery_destroy(&handle);
+    } else if ("cli" == interface) {
+        const std::string pointsFilename = _workDir + "/benchmark-points.in";
+        const std::string outputFilename = _workDir + "/benchmark-points.out";
+        std::ofstream sout(pointsFilename);
+        sout << std::setprecision(12);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            sout << points[3*iPt+0] << " " << points[3*iPt+1] << " " << points[3*iPt+2] << "\n";
+        } // for
+        sout.close();
+
+        std::ostringstream command;
+        command << _cliFilename << " --models=" << filename << " --values=one,two"
+                << " --points=" << pointsFilename << " --output=" << outputFilename
+                << " --points-coordsys=" << crs;
+        tStart = _QueryBenchmark::now();
+        const int err = std::system(command.str().c_str());
+        tEnd = _QueryBenchmark::now();
+        if (err) {
+            std::ostringstream msg;
+            msg << "Error running '" << command.str() << "'.";
+            throw std::runtime_error(msg.str().c_str());
+        } // if
+
+        std::ifstream sin(outputFilename);
+        std::string line;
+        while (std::getline(sin, line)) {
+            if (line.empty() || ('#' == line[0])) {
+                continue;
+            } // if
+            std::istringstream sline(line);
+            double x, y, z;
+            sline >> x >> y >> z >> values[0] >> values[1];
+            if (values[0] != geomodelgrids::NODATA_VALUE) {
+                ++found;
+            } // if
+        } // while
+        sin.close();
+        std::remove(pointsFilename.c_str());
+        std::remove(outputFilename.c_str());
+    } else {
+        throw std::logic_error("Unknown interface '" + interface + "'.");
+    } // if/else
+
+    *numFound = found;
+    return tEnd - tStart;
+} // _queryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Write results as JSON.
+void
+geomodelgrids::benchmark::QueryBenchmark::_writeJSON(std::ostream& sout) const {
+    sout << std::setprecision(6);
+    sout << "{\n"
+         << "  \"benchmark\": \"query\",\n"
+         << "  \"version\": \"" << GEOMODELGRIDS_VERSION << "\",\n"
+         << "  \"num_points\": " << _numPoints << ",\n"
+         << "  \"num_cells\": " << _numCells << ",\n"
+         << "  \"repeat\": " << _numRepeat << ",\n"
+         << "  \"results\": [";
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const Result& result = _results[i];
+        sout << (i ? "," : "") << "\n    {"
+             << "\"model\": \"" << result.model << "\", "
+             << "\"resolution\": \"" << result.resolution << "\", "
+             << "\"topography\": " << (result.topography ? "true" : "false") << ", "
+             << "\"num_blocks\": " << result.numBlocks << ", "
+             << "\"model_bytes\": " << result.modelBytes << ", "
+             << "\"distribution\": \"" << result.distribution << "\", "
+             << "\"interface\": \"" << result.interface << "\", "
+             << "\"num_points\": " << result.numPoints << ", "
+             << "\"num_found\": " << result.numFound << ", "
+             << "\"time\": " << result.time << ", "
+             << "\"points_per_second\": " << result.numPoints / result.time
+             << "}";
+    } // for
+    sout << "\n  ]\n}\n";
+} // _writeJSON
+
+
+// End of file
@@ -0,0 +1,142 @@
+/** Benchmark for query throughput.
+ *
+ * Generates synthetic models and measures the number of points per second queried through Model::query(),
+ * Query::query(), the C API, and the geomodelgrids_query command line program for random, spatially sorted,
+ * and columnar point distributions. Results are written as JSON so that regressions can be tracked.
+ */
+#pragma once
+
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+#include <iosfwd> // USES std::ostream
+
+namespace geomodelgrids {
+    namespace benchmark {
+        class QueryBenchmark;
+        class SyntheticModel; // USES SyntheticModel
+    } // benchmark
+} // geomodelgrids
+
+class geomodelgrids::benchmark::QueryBenchmark {
+    // PUBLIC STRUCTS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Result of one benchmark case.
+    struct Result {
+        std::string model; ///< Label for model.
+        std::string resolution; ///< "uniform" or "variable".
+        bool topography; ///< True if model has topography.
+        size_t numBlocks; ///< Number of blocks in model.
+        size_t modelBytes; ///< Number of bytes in model values and surfaces.
+        std::string distribution; ///< Point distribution.
+        std::string interface; ///< Interface used to query.
+        size_t numPoints; ///< Number of points queried.
+        size_t numFound; ///< Number of points found in the model.
+        double time; ///< Best wall clock time (s) over repetitions.
+    }; // Result
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    QueryBenchmark(void);
+
+    /// Destructor
+    ~QueryBenchmark(void);
+
+    /**
+     * Run benchmark application.
+     *
+     * Arguments:
+     *   --help
+     *   --output=FILE_OUTPUT
+     *   --workdir=DIR
+     *   --num-points=NUM
+     *   --num-cells=NUM
+     *   --num-blocks=NUM_0,...,NUM_N
+     *   --resolution=uniform,variable
+     *   --topography=flat,topo
+     *   --distributions=random,sorted,columnar
+     *   --interfaces=model,query,capi,cli
+     *   --repeat=NUM
+     *   --cli=FILE_EXECUTABLE
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    /** Generate points for distribution.
+     *
+     * @param[out] points Array of points (x, y, z) in model CRS.
+     * @param[in] model Synthetic model.
+     * @param[in] distribution Name of point distribution.
+     */
+    void _generatePoints(std::vector<double>* points,
+                         const SyntheticModel& model,
+                         const std::string& distribution) const;
+
+    /** Query points using interface.
+     *
+     * @param[out] numFound Number of points found in the model.
+     * @param[in] interface Name of interface.
+     * @param[in] filename Name of model file.
+     * @param[in] crs Coordinate system of points.
+     * @param[in] points Array of points (x, y, z).
+     * @returns Wall clock time (s) for querying the points.
+     */
+    double _queryPoints(size_t* numFound,
+                        const std::string& interface,
+                        const std::string& filename,
+                        const std::string& crs,
+                        const std::vector<double>& points) const;
+
+    /** Write results as JSON.
+     *
+     * @param[out] sout Output stream.
+     */
+    void _writeJSON(std::ostream& sout) const;
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::vector<size_t> _numBlocks;
+    std::vector<std::string> _resolutions;
+    std::vector<std::string> _topography;
+    std::vector<std::string> _distributions;
+    std::vector<std::string> _interfaces;
+    std::vector<Result> _results;
+    std::string _outputFilename;
+    std::string _workDir;
+    std::string _cliFilename;
+    size_t _numPoints;
+    size_t _numCells;
+    size_t _numRepeat;
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    QueryBenchmark(const QueryBenchmark&); ///< Not implemented
+    const QueryBenchmark& operator=(const QueryBenchmark&); ///< Not implemented
+
+}; // QueryBenchmark
+
+// End of file
@@ -0,0 +1,450 @@
+#include <portinfo>
+
+#include "SyntheticModel.hh" // implementation of class methods
+
+#include "hdf5.h" // USES hdf5
+
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::min()
+#include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::runtime_error
+#include <cmath> // USES ceil(), sin(), cos()
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace benchmark {
+        class _SyntheticModel {
+public:
+
+            /// Number of cells in each coarsened block relative to block above.
+            static size_t coarsenFactor(const size_t iBlock) {
+                return (0 == iBlock) ? 1 : (1 == iBlock) ? 2 : 4;
+            } // coarsenFactor
+
+            /** Compute coordinates of grid points.
+             *
+             * @param[in] numCells Number of cells.
+             * @param[in] resolution Nominal resolution.
+             * @param[in] isVariable True for variable resolution.
+             * @param[in] start Coordinate of first point.
+             * @param[in] direction +1.0 for increasing coordinates, -1.0 for decreasing coordinates.
+             */
+            static
+            std::vector<double> coordinates(const size_t numCells,
+                                            const double resolution,
+                                            const bool isVariable,
+                                            const double start,
+                                            const double direction) {
+                std::vector<double> coords(numCells+1);
+                coords[0] = start;
+                for (size_t i = 0; i < numCells; ++i) {
+                    const double dx = (isVariable) ? resolution * ((i % 2) ? 1.5 : 0.5) : resolution;
+                    coords[i+1] = coords[i] + direction*dx;
+                } // for
+                return coords;
+            } // coordinates
+
+            static
+            double computeValueOne(const double x,
+                                   const double y,
+                                   const double z) {
+                return 2.0e+3 + 0.3 * x + 0.4 * y - 4.0 * z;
+            } // computeValueOne
+
+            static
+            double computeValueTwo(const double x,
+                                   const double y,
+                                   const double z) {
+                return -1.2e+3 + 0.1 * x - 0.2 * y - 4.8 * z;
+            } // computeValueTwo
+
+            static
+            void checkError(const herr_t err,
+                            const char* what) {
+                if (err < 0) {
+                    std::ostringstream msg;
+                    msg << "Error writing synthetic model (" << what << ").";
+                    throw std::runtime_error(msg.str().c_str());
+                } // if
+            } // checkError
+
+            static
+            void writeAttribute(hid_t object,
+                                const char* name,
+                                const double value) {
+                hid_t dataspace = H5Screate(H5S_SCALAR);checkError(dataspace, name);
+                hid_t attribute = H5Acreate2(object, name, H5T_NATIVE_DOUBLE, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+                checkError(attribute, name);
+                checkError(H5Awrite(attribute, H5T_NATIVE_DOUBLE, &value), name);
+                H5Aclose(attribute);
+                H5Sclose(dataspace);
+            } // writeAttribute
+
+            static
+            void writeAttribute(hid_t object,
+                                const char* name,
+                                const std::vector<double>& values) {
+                const hsize_t dims[1] = { values.size() };
+                hid_t dataspace = H5Screate_simple(1, dims, nullptr);checkError(dataspace, name);
+                hid_t attribute = H5Acreate2(object, name, H5T_NATIVE_DOUBLE, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+                checkError(attribute, name);
+                checkError(H5Awrite(attribute, H5T_NATIVE_DOUBLE, &values[0]), name);
+                H5Aclose(attribute);
+                H5Sclose(dataspace);
+            } // writeAttribute
+
+            static
+            void writeAttribute(hid_t object,
+                                const char* name,
+                                const std::vector<std::string>& values,
+                                const bool isScalar=false) {
+                assert(!isScalar || 1 == values.size());
+                std::vector<const char*> buffer(values.size());
+                for (size_t i = 0; i < values.size(); ++i) {
+                    buffer[i] = values[i].c_str();
+                } // for
+                const hsize_t dims[1] = { values.size() };
+                hid_t dataspace = (isScalar) ? H5Screate(H5S_SCALAR) : H5Screate_simple(1, dims, nullptr);
+                checkError(dataspace, name);
+                hid_t datatype = H5Tcopy(H5T_C_S1);checkError(datatype, name);
+                checkError(H5Tset_size(datatype, H5T_VARIABLE), name);
+                hid_t attribute = H5Acreate2(object, name, datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+                checkError(attribute, name);
+                checkError(H5Awrite(attribute, datatype, &buffer[0]), name);
+                H5Aclose(attribute);
+                H5Tclose(datatype);
+                H5Sclose(dataspace);
+            } // writeAttribute
+
+            static
+            void writeAttribute(hid_t object,
+                                const char* name,
+                                const char* value) {
+                writeAttribute(object, name, std::vector<std::string>(1, value), true);
+            } // writeAttribute
+
+            /** Create chunked float dataset.
+             *
+             * @returns Handle to dataset.
+             */
+            static
+            hid_t createDataset(hid_t parent,
+                                const char* name,
+                                const hsize_t dims[],
+                                const hsize_t chunk[],
+                                const int ndims) {
+                hid_t dataspace = H5Screate_simple(ndims, dims, nullptr);checkError(dataspace, name);
+                hid_t property = H5Pcreate(H5P_DATASET_CREATE);checkError(property, name);
+                checkError(H5Pset_chunk(property, ndims, chunk), name);
+                hid_t dataset = H5Dcreate2(parent, name, H5T_IEEE_F32LE, dataspace, H5P_DEFAULT, property, H5P_DEFAULT);
+                checkError(dataset, name);
+                H5Pclose(property);
+                H5Sclose(dataspace);
+                return dataset;
+            } // createDataset
+
+            /// Write slab of values with leading index `index` into dataset.
+            static
+            void writeSlab(hid_t dataset,
+                           const hsize_t dims[],
+                           const int ndims,
+                           const hsize_t index,
+                           const std::vector<float>& values) {
+                std::vector<hsize_t> offset(ndims, 0);
+                std::vector<hsize_t> count(dims, dims+ndims);
+                offset[0] = index;
+                count[0] = 1;
+                hid_t filespace = H5Dget_space(dataset);checkError(filespace, "slab");
+                checkError(H5Sselect_hyperslab(filespace, H5S_SELECT_SET, &offset[0], nullptr, &count[0], nullptr), "slab");
+                hid_t memspace = H5Screate_simple(ndims, &count[0], nullptr);checkError(memspace, "slab");
+                checkError(H5Dwrite(dataset, H5T_NATIVE_FLOAT, memspace, filespace, H5P_DEFAULT, &values[0]), "slab");
+                H5Sclose(memspace);
+                H5Sclose(filespace);
+            } // writeSlab
+
+        }; // _SyntheticModel
+    } // benchmark
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::benchmark::SyntheticModel::SyntheticModel(void) :
+    _numBlocks(1),
+    _numCells(64),
+    _horizRes(1.0e+3),
+    _vertRes(250.0),
+    _variableResolution(false),
+    _hasTopography(false) {
+    _dims[0] = 0.0;
+    _dims[1] = 0.0;
+    _dims[2] = 40.0e+3;
+    _origin[0] = 500.0e+3;
+    _origin[1] = 3800.0e+3;
+    _updateDims();
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::benchmark::SyntheticModel::~SyntheticModel(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of blocks.
+void
+geomodelgrids::benchmark::SyntheticModel::setNumBlocks(const size_t value) {
+    if ((value < 1) || (value > 20)) {
+        std::ostringstream msg;
+        msg << "Number of blocks (" << value << ") must be in the range 1-20.";
+        throw std::invalid_argument(msg.str().c_str());
+    } // if
+    _numBlocks = value;
+    _updateDims();
+} // setNumBlocks
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of cells along each horizontal direction in the top block.
+void
+geomodelgrids::benchmark::SyntheticModel::setNumCells(const size_t value) {
+    if (!value) {
+        throw std::invalid_argument("Number of cells must be positive.");
+    } // if
+    _numCells = value;
+    _updateDims();
+} // setNumCells
+
+
+// ------------------------------------------------------------------------------------------------
+// Set nominal resolution of the top block.
+void
+geomodelgrids::benchmark::SyntheticModel::setResolution(const double horizRes,
+                                                        const double vertRes) {
+    if ((horizRes <= 0.0) || (vertRes <= 0.0)) {
+        throw std::invalid_argument("Resolution must be positive.");
+    } // if
+    _horizRes = horizRes;
+    _vertRes = vertRes;
+    _updateDims();
+} // setResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Set vertical dimension of model.
+void
+geomodelgrids::benchmark::SyntheticModel::setDimZ(const double value) {
+    if (value <= 0.0) {
+        throw std::invalid_argument("Vertical dimension of model must be positive.");
+    } // if
+    _dims[2] = value;
+    _updateDims();
+} // setDimZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn variable resolution on/off.
+void
+geomodelgrids::benchmark::SyntheticModel::setVariableResolution(const bool value) {
+    _variableResolution = value;
+} // setVariableResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Turn topography on/off.
+void
+geomodelgrids::benchmark::SyntheticModel::setTopography(const bool value) {
+    _hasTopography = value;
+} // setTopography
+
+
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of model.
+const double*
+geomodelgrids::benchmark::SyntheticModel::getDims(void) const {
+    return _dims;
+} // getDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Get origin of model.
+const double*
+geomodelgrids::benchmark::SyntheticModel::getOrigin(void) const {
+    return _origin;
+} // getOrigin
+
+
+// ------------------------------------------------------------------------------------------------
+// Get model CRS.
+const char*
+geomodelgrids::benchmark::SyntheticModel::getCRSString(void) const {
+    return "EPSG:26911";
+} // getCRSString
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute elevation of top surface.
+double
+geomodelgrids::benchmark::SyntheticModel::computeTopElevation(const double x,
+                                                              const double y) const {
+    if (!_hasTopography) {
+        return 0.0;
+    } // if
+    const double wavelength = 0.5 * _dims[0];
+    return 500.0 + 400.0 * sin(2.0*M_PI*x/wavelength) * cos(2.0*M_PI*y/wavelength);
+} // computeTopElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Write model to HDF5 file.
+size_t
+geomodelgrids::benchmark::SyntheticModel::write(const char* filename) {
+    typedef _SyntheticModel _SM;
+
+    hid_t h5 = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (h5 < 0) {
+        std::ostringstream msg;
+        msg << "Could not create synthetic model '" << filename << "'.";
+        throw std::runtime_error(msg.str().c_str());
+    } // if
+
+    std::ostringstream title;
+    title << "Synthetic model with " << _numBlocks << " block(s), "
+          << (_variableResolution ? "variable" : "uniform") << " resolution, and "
+          << (_hasTopography ? "topography" : "no topography");
+    const std::vector<std::string> keywords = { "benchmark", "synthetic" };
+    const std::vector<std::string> names = { "one", "two" };
+    const std::vector<std::string> units = { "m", "m/s" };
+
+    _SM::writeAttribute(h5, "title", title.str().c_str());
+    _SM::writeAttribute(h5, "id", "synthetic-benchmark");
+    _SM::writeAttribute(h5, "description", title.str().c_str());
+    _SM::writeAttribute(h5, "keywords", keywords);
+    _SM::writeAttribute(h5, "history", "Generated by benchmark_query");
+    _SM::writeAttribute(h5, "comment", "Synthetic model for benchmarking queries.");
+    _SM::writeAttribute(h5, "creator_name", "geomodelgrids");
+    _SM::writeAttribute(h5, "creator_institution", "geomodelgrids");
+    _SM::writeAttribute(h5, "creator_email", "none");
+    _SM::writeAttribute(h5, "acknowledgement", "none");
+    _SM::writeAttribute(h5, "authors", std::vector<std::string>(1, "geomodelgrids"));
+    _SM::writeAttribute(h5, "references", std::vector<std::string>(1, "none"));
+    _SM::writeAttribute(h5, "repository_name", "none");
+    _SM::writeAttribute(h5, "repository_url", "none");
+    _SM::writeAttribute(h5, "repository_doi", "none");
+    _SM::writeAttribute(h5, "license", "CC0");
+    _SM::writeAttribute(h5, "version", "1.0.0");
+    _SM::writeAttribute(h5, "data_values", names);
+    _SM::writeAttribute(h5, "data_units", units);
+    _SM::writeAttribute(h5, "data_layout", "vertex");
+    _SM::writeAttribute(h5, "crs", getCRSString());
+    _SM::writeAttribute(h5, "origin_x", _origin[0]);
+    _SM::writeAttribute(h5, "origin_y", _origin[1]);
+    _SM::writeAttribute(h5, "y_azimuth", 0.0);
+    _SM::writeAttribute(h5, "dim_x", _dims[0]);
+    _SM::writeAttribute(h5, "dim_y", _dims[1]);
+    _SM::writeAttribute(h5, "dim_z", _dims[2]);
+
+    size_t numBytes = 0;
+    const size_t numValues = names.size();
+
+    hid_t group = H5Gcreate2(h5, "surfaces", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);_SM::checkError(group, "surfaces");
+    if (_hasTopography) {
+        const std::vector<double>& xCoords = _SM::coordinates(_numCells, _horizRes, _variableResolution, 0.0, +1.0);
+        const std::vector<double>& yCoords = _SM::coordinates(_numCells, _horizRes, _variableResolution, 0.0, +1.0);
+        const hsize_t dims[3] = { xCoords.size(), yCoords.size(), 1 };
+        const hsize_t chunk[3] = { std::min(dims[0], hsize_t(64)), std::min(dims[1], hsize_t(64)), 1 };
+        const char* const surfaceNames[2] = { "top_surface", "topography_bathymetry" };
+        for (size_t iSurface = 0; iSurface < 2; ++iSurface) {
+            hid_t dataset = _SM::createDataset(group, surfaceNames[iSurface], dims, chunk, 3);
+            std::vector<float> values(dims[1]);
+            for (size_t ix = 0; ix < dims[0]; ++ix) {
+                for (size_t iy = 0; iy < dims[1]; ++iy) {
+                    values[iy] = computeTopElevation(xCoords[ix], yCoords[iy]);
+                } // for
+                _SM::writeSlab(dataset, dims, 3, ix, values);
+            } // for
+            if (_variableResolution) {
+                _SM::writeAttribute(dataset, "x_coordinates", xCoords);
+                _SM::writeAttribute(dataset, "y_coordinates", yCoords);
+            } else {
+                _SM::writeAttribute(dataset, "x_resolution", _horizRes);
+                _SM::writeAttribute(dataset, "y_resolution", _horizRes);
+            } // if/else
+            H5Dclose(dataset);
+            numBytes += dims[0] * dims[1] * sizeof(float);
+        } // for
+    } // if
+    H5Gclose(group);
+
+    group = H5Gcreate2(h5, "blocks", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);_SM::checkError(group, "blocks");
+    const double blockThickness = _dims[2] / _numBlocks;
+    for (size_t iBlock = 0; iBlock < _numBlocks; ++iBlock) {
+        const size_t factor = _SM::coarsenFactor(iBlock);
+        const double horizRes = _horizRes * factor;
+        const double vertRes = _vertRes * factor;
+        const size_t numCellsXY = _numCells / factor;
+        const size_t numCellsZ = size_t(blockThickness / vertRes + 0.5);
+        const double zTop = -blockThickness * iBlock;
+
+        const std::vector<double>& xCoords = _SM::coordinates(numCellsXY, horizRes, _variableResolution, 0.0, +1.0);
+        const std::vector<double>& yCoords = _SM::coordinates(numCellsXY, horizRes, _variableResolution, 0.0, +1.0);
+        const std::vector<double>& zCoords = _SM::coordinates(numCellsZ, vertRes, _variableResolution, zTop, -1.0);
+        const hsize_t dims[4] = { xCoords.size(), yCoords.size(), zCoords.size(), numValues };
+        const hsize_t chunk[4] = {
+            std::min(dims[0], hsize_t(32)),
+            std::min(dims[1], hsize_t(32)),
+            std::min(dims[2], hsize_t(32)),
+            numValues,
+        };
+
+        std::ostringstream blockName;
+        blockName << "block_" << (iBlock < 10 ? "0" : "") << iBlock;
+        hid_t dataset = _SM::createDataset(group, blockName.str().c_str(), dims, chunk, 4);
+        std::vector<float> values(dims[1]*dims[2]*dims[3]);
+        for (size_t ix = 0; ix < dims[0]; ++ix) {
+            for (size_t iy = 0; iy < dims[1]; ++iy) {
+                for (size_t iz = 0; iz < dims[2]; ++iz) {
+                    const size_t offset = (iy*dims[2] + iz)*numValues;
+                    values[offset+0] = _SM::computeValueOne(xCoords[ix], yCoords[iy], zCoords[iz]);
+                    values[offset+1] = _SM::computeValueTwo(xCoords[ix], yCoords[iy], zCoords[iz]);
+                } // for
+            } // for
+            _SM::writeSlab(dataset, dims, 4, ix, values);
+        } // for
+        if (_variableResolution) {
+            _SM::writeAttribute(dataset, "x_coordinates", xCoords);
+            _SM::writeAttribute(dataset, "y_coordinates", yCoords);
+            _SM::writeAttribute(dataset, "z_coordinates", zCoords);
+        } else {
+            _SM::writeAttribute(dataset, "x_resolution", horizRes);
+            _SM::writeAttribute(dataset, "y_resolution", horizRes);
+            _SM::writeAttribute(dataset, "z_resolution", vertRes);
+            _SM::writeAttribute(dataset, "z_top", zTop);
+        } // if/else
+        H5Dclose(dataset);
+        numBytes += dims[0] * dims[1] * dims[2] * dims[3] * sizeof(float);
+    } // for
+    H5Gclose(group);
+
+    H5Fclose(h5);
+
+    return numBytes;
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Adjust dimensions so that all blocks have an integer number of cells.
+void
+geomodelgrids::benchmark::SyntheticModel::_updateDims(void) {
+    // Coarsest blocks have 4x the resolution and variable resolution requires an even number of cells.
+    const size_t multiple = 8;
+    _numCells = multiple * size_t(ceil(double(_numCells) / multiple));
+    _dims[0] = _numCells * _horizRes;
+    _dims[1] = _numCells * _horizRes;
+
+    const double blockMultiple = multiple * _vertRes;
+    const double blockThickness = blockMultiple * ceil(_dims[2] / _numBlocks / blockMultiple);
+    _dims[2] = blockThickness * _numBlocks;
+} // _updateDims
+
+
+// End of file
@@ -0,0 +1,128 @@
+/** Synthetic model of configurable size for benchmarking queries.
+ *
+ * The model has `numBlocks` blocks stacked vertically that span the entire horizontal domain. Each block is
+ * coarser than the one above it (factors of 1, 2, and 4 for the first, second, and remaining blocks). With
+ * variable resolution, the grid spacing alternates between 0.5 and 1.5 times the nominal resolution so that
+ * lookups use the variable resolution indexing. With topography, the model includes top surface and
+ * topography/bathymetry datasets.
+ */
+#pragma once
+
+#include <cstddef> // USES size_t
+#include <string> // HASA std::string
+
+namespace geomodelgrids {
+    namespace benchmark {
+        class SyntheticModel;
+    } // benchmark
+} // geomodelgrids
+
+class geomodelgrids::benchmark::SyntheticModel {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor.
+    SyntheticModel(void);
+
+    /// Destructor.
+    ~SyntheticModel(void);
+
+    /** Set number of blocks.
+     *
+     * @param[in] value Number of blocks (1-20).
+     */
+    void setNumBlocks(const size_t value);
+
+    /** Set number of cells along each horizontal direction in the top block.
+     *
+     * @param[in] value Number of cells (rounded up to a multiple of 8).
+     */
+    void setNumCells(const size_t value);
+
+    /** Set nominal resolution of the top block.
+     *
+     * @param[in] horizRes Horizontal resolution (m).
+     * @param[in] vertRes Vertical resolution (m).
+     */
+    void setResolution(const double horizRes,
+                       const double vertRes);
+
+    /** Set vertical dimension of model.
+     *
+     * @param[in] value Vertical dimension (m) (rounded up to give each block an integer number of cells).
+     */
+    void setDimZ(const double value);
+
+    /** Turn variable resolution on/off.
+     *
+     * @param[in] value True for variable resolution, false for uniform resolution.
+     */
+    void setVariableResolution(const bool value);
+
+    /** Turn topography on/off.
+     *
+     * @param[in] value True if model has topography, false otherwise.
+     */
+    void setTopography(const bool value);
+
+    /** Get dimensions of model.
+     *
+     * @returns Dimensions of model [x, y, z] (m).
+     */
+    const double* getDims(void) const;
+
+    /** Get origin of model.
+     *
+     * @returns Coordinates of origin in model CRS.
+     */
+    const double* getOrigin(void) const;
+
+    /** Get model CRS.
+     *
+     * @returns Model CRS as string.
+     */
+    const char* getCRSString(void) const;
+
+    /** Write model to HDF5 file.
+     *
+     * @param[in] filename Name of HDF5 file.
+     * @returns Number of bytes in model values and surfaces.
+     */
+    size_t write(const char* filename);
+
+    /** Compute elevation of top surface.
+     *
+     * @param[in] x X coordinate in model coordinate system.
+     * @param[in] y Y coordinate in model coordinate system.
+     * @returns Elevation (m) of top surface.
+     */
+    double computeTopElevation(const double x,
+                               const double y) const;
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /// Adjust dimensions so that all blocks have an integer number of cells.
+    void _updateDims(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    size_t _numBlocks; ///< Number of blocks.
+    size_t _numCells; ///< Number of cells along each horizontal direction in top block.
+    double _horizRes; ///< Nominal horizontal resolution of top block.
+    double _vertRes; ///< Nominal vertical resolution of top block.
+    double _dims[3]; ///< Dimensions of model.
+    double _origin[2]; ///< Origin of model in model CRS.
+    bool _variableResolution; ///< True if using variable resolution.
+    bool _hasTopography; ///< True if model has topography.
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    SyntheticModel(const SyntheticModel&); ///< Not implemented
+    const SyntheticModel& operator=(const SyntheticModel&); ///< Not implemented
+
+}; // SyntheticModel
+
+// End of file
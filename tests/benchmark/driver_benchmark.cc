@@ -0,0 +1,30 @@
+// C++ driver for query benchmark.
+
+#include <portinfo>
+
+#include "QueryBenchmark.hh" // USES QueryBenchmark
+
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+
+int
+main(int argc,
+     char* argv[]) {
+    geomodelgrids::benchmark::QueryBenchmark benchmark;
+
+    int err = 0;
+    try {
+        err = benchmark.run(argc, argv);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        err = 1;
+    } catch (...) {
+        std::cerr << "Caught unknown exception." << std::endl;
+        err = 2;
+    } // try/catch
+
+    return err;
+} // main
+
+
+// End of file
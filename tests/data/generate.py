@@ -641,6 +641,17 @@ class ThreeBlocksTopo(TestData):
         with h5py.File(self.filename, "a") as h5:
             h5.attrs["data_units"] = ["km", "km/s"]
 
+    def pyramid(self):
+        from geomodelgrids.create.io.hdf5 import HDF5Storage
+
+        self.filename = "three-blocks-topo-pyramid.h5"
+        self.create()
+        storage = HDF5Storage(self.filename)
+        for surface_name in ("top_surface", "topography_bathymetry"):
+            storage.save_pyramid("surfaces", surface_name, num_levels=2)
+        for block in self.blocks:
+            storage.save_pyramid("blocks", block["name"], num_levels=2)
+
 
 class ThreeBlocksTopoVarXYZ(TestData):
     filename = "three-blocks-topo-varxyz.h5"
@@ -746,6 +757,7 @@ if __name__ == "__main__":
     ThreeBlocksTopo().bad_block_metadata()
     ThreeBlocksTopo().missing_metadata()
     ThreeBlocksTopo().inconsistent_units()
+    ThreeBlocksTopo().pyramid()
 
 
 # End of file
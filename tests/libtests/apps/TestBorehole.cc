@@ -162,6 +162,7 @@ geomodelgrids::apps::TestBorehole::testConstructor(void) {
     CHECK(std::string("EPSG:4326") == borehole._pointsCRS);
     CHECK(5000.0 == borehole._maxDepth);
     CHECK(10.0 == borehole._dz);
+    CHECK(false == borehole._showStats);
     CHECK(false == borehole._showHelp);
 } // testConstructor
 
@@ -283,7 +284,7 @@ geomodelgrids::apps::TestBorehole::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestBorehole::testParseArgsAll(void) {
-    const int nargs = 9;
+    const int nargs = 10;
     const char* const args[nargs] = {
         "test",
         "--models=A",
@@ -294,6 +295,7 @@ geomodelgrids::apps::TestBorehole::testParseArgsAll(void) {
         "--dz=100.0",
         "--values=one,two,three",
         "--log=error.log",
+        "--stats",
     };
     const size_t numValues = 3;
     const char* const valueNamesE[numValues] = { "one", "two", "three" };
@@ -313,6 +315,7 @@ geomodelgrids::apps::TestBorehole::testParseArgsAll(void) {
     CHECK(300.0 == borehole._maxDepth);
     CHECK(100.0 == borehole._dz);
     CHECK(std::string("error.log") == borehole._logFilename);
+    CHECK(borehole._showStats);
     CHECK(!borehole._showHelp);
 } // testParseArgsAll
 
@@ -328,7 +331,7 @@ geomodelgrids::apps::TestBorehole::testPrintHelp(void) {
     Borehole borehole;
     borehole._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1144) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -349,7 +352,7 @@ geomodelgrids::apps::TestBorehole::testRunHelp(void) {
     borehole.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1144) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -84,6 +84,12 @@ public:
     /// Test run() wth three-blocks-topo.
     void testRunThreeBlocksTopo(void);
 
+    /// Test run() wth three-blocks-topo using multiple threads.
+    void testRunThreeBlocksTopoThreads(void);
+
+    /// Test run() wth three-blocks-topo using column search.
+    void testRunThreeBlocksTopoColumn(void);
+
     /// Test run() wth bad output file.
     void testRunBadOutput(void);
 
@@ -141,6 +147,12 @@ TEST_CASE("TestIsosurface::testRunOneBlockFlat", "[TestIsosurface]") {
 TEST_CASE("TestIsosurface::testRunThreeBlocksTopo", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunThreeBlocksTopo();
 }
+TEST_CASE("TestIsosurface::testRunThreeBlocksTopoThreads", "[TestIsosurface]") {
+    geomodelgrids::apps::TestIsosurface().testRunThreeBlocksTopoThreads();
+}
+TEST_CASE("TestIsosurface::testRunThreeBlocksTopoColumn", "[TestIsosurface]") {
+    geomodelgrids::apps::TestIsosurface().testRunThreeBlocksTopoColumn();
+}
 TEST_CASE("TestIsosurface::testRunBadOutput", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunBadOutput();
 }
@@ -183,8 +195,12 @@ geomodelgrids::apps::TestIsosurface::testConstructor(void) {
     CHECK(10.0 == isosurface._vertRes);
     CHECK(0.0 == isosurface._maxDepth);
     CHECK(10 == isosurface._numSearchPoints);
+    CHECK(1 == isosurface._numThreads);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == isosurface._depthSurface);
     CHECK(true == isosurface._preferShallow);
+    CHECK(false == isosurface._columnSearch);
+    CHECK(false == isosurface._prefetch);
+    CHECK(false == isosurface._showStats);
 
     CHECK(size_t(2) == isosurface._isosurfaces.size());
     CHECK(std::string("Vs") == isosurface._isosurfaces[0].first);
@@ -340,7 +356,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsNoOutput(void) {
 // Test _parseArgs() with bad values.
 void
 geomodelgrids::apps::TestIsosurface::testParseArgsBadValues(void) {
-    const int nargs = 9;
+    const int nargs = 10;
     const char* const args[nargs] = {
         "test",
         "--bbox=-1.0,0.0,1.0,-3.0",
@@ -351,6 +367,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsBadValues(void) {
         "--num-search-points=0",
         "--depth-reference=none",
         "--models=one.h5",
+        "--threads=0",
     };
 
     Isosurface isosurface;
@@ -404,6 +421,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsMinimal(void) {
     CHECK(10.0 == isosurface._vertRes);
     CHECK(2.0 == isosurface._maxDepth);
     CHECK(10 == isosurface._numSearchPoints);
+    CHECK(1 == isosurface._numThreads);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == isosurface._depthSurface);
     CHECK(true == isosurface._preferShallow);
 
@@ -418,7 +436,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
-    const int nargs = 14;
+    const int nargs = 18;
     const char* const args[nargs] = {
         "test",
         "--log=my.log",
@@ -434,6 +452,10 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
         "--output=iso.tiff",
         "--prefer-deep",
         "--bbox-coordsys=EPSG:3311",
+        "--prefetch",
+        "--stats",
+        "--threads=2",
+        "--column-search",
     };
 
     Isosurface isosurface;
@@ -456,6 +478,10 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
     CHECK(5 == isosurface._numSearchPoints);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == isosurface._depthSurface);
     CHECK(false == isosurface._preferShallow);
+    CHECK(isosurface._columnSearch);
+    CHECK(isosurface._prefetch);
+    CHECK(isosurface._showStats);
+    CHECK(2 == isosurface._numThreads);
 
     CHECK(size_t(2) == isosurface._modelFilenames.size());
     CHECK(std::string("one.h5") == isosurface._modelFilenames[0]);
@@ -476,7 +502,7 @@ geomodelgrids::apps::TestIsosurface::testPrintHelp(void) {
     Isosurface isosurface;
     isosurface._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(1942) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -497,7 +523,7 @@ geomodelgrids::apps::TestIsosurface::testRunHelp(void) {
     isosurface.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(1942) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -559,6 +585,67 @@ geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopo(void) {
 } // testRunThreeBlocksTopo
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo using multiple threads.
+void
+geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopoThreads(void) {
+    const int nargs = 14;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/three-blocks-topo.h5",
+        "--bbox=34.6,34.8,-117.7,-117.3",
+        "--hresolution=0.1",
+        "--vresolution=500.0",
+        "--isosurface=one,12.0e+4",
+        "--isosurface=two,40.0e+3",
+        "--max-depth=45.0e+3",
+        "--depth-reference=topography_bathymetry",
+        "--prefer-deep",
+        "--output=three-blocks-topo-isosurface-threads.tiff",
+        "--bbox-coordsys=EPSG:4326",
+        "--log=error.log",
+        "--threads=3",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoIsosurface isosurfaceThree;
+
+    Isosurface isosurface;
+    isosurface.run(nargs, const_cast<char**>(args));
+
+    _TestIsosurface::checkIsosurface("three-blocks-topo-isosurface-threads.tiff", 12.0e+4, 40.0e+3, isosurfaceThree);
+    std::ifstream slog("error.log");assert(slog.is_open() && slog.good());
+} // testRunThreeBlocksTopoThreads
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo using column search.
+void
+geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopoColumn(void) {
+    const int nargs = 13;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/three-blocks-topo.h5",
+        "--bbox=34.6,34.8,-117.7,-117.3",
+        "--hresolution=0.1",
+        "--isosurface=one,12.0e+4",
+        "--isosurface=two,40.0e+3",
+        "--max-depth=45.0e+3",
+        "--depth-reference=topography_bathymetry",
+        "--prefer-deep",
+        "--output=three-blocks-topo-isosurface-column.tiff",
+        "--bbox-coordsys=EPSG:4326",
+        "--log=error.log",
+        "--column-search",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoIsosurface isosurfaceThree;
+
+    Isosurface isosurface;
+    isosurface.run(nargs, const_cast<char**>(args));
+
+    _TestIsosurface::checkIsosurface("three-blocks-topo-isosurface-column.tiff", 12.0e+4, 40.0e+3, isosurfaceThree);
+    std::ifstream slog("error.log");assert(slog.is_open() && slog.good());
+} // testRunThreeBlocksTopoColumn
+
+
 // ------------------------------------------------------------------------------------------------
 // Test run() with bad output specification.
 void
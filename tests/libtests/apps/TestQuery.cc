@@ -194,6 +194,8 @@ geomodelgrids::apps::TestQuery::testConstructor(void) {
     CHECK(std::string("EPSG:4326") == query._pointsCRS);
     CHECK(-10.0e+3 == query._squashMinElev);
     CHECK(geomodelgrids::serial::Query::SQUASH_NONE == query._squash);
+    CHECK(false == query._prefetch);
+    CHECK(false == query._showStats);
     CHECK(false == query._showHelp);
 } // testConstructor
 
@@ -314,7 +316,7 @@ geomodelgrids::apps::TestQuery::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
-    const int nargs = 9;
+    const int nargs = 12;
     const char* const args[nargs] = {
         "test",
         "--values=one,two,three",
@@ -325,6 +327,9 @@ geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
         "--squash-min-elev=-2.0e+3",
         "--squash-surface=top_surface",
         "--log=error.log",
+        "--prefetch",
+        "--stats",
+        "--shared-cache=/geomodelgrids-cache",
     };
     const size_t numValues = 3;
     const char* const valueNamesE[numValues] = { "one", "two", "three" };
@@ -343,6 +348,9 @@ geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
     CHECK(-2.0e+3 == query._squashMinElev);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == query._squash);
     CHECK(std::string("error.log") == query._logFilename);
+    CHECK(query._prefetch);
+    CHECK(query._showStats);
+    CHECK(std::string("/geomodelgrids-cache") == query._sharedCacheName);
     CHECK(!query._showHelp);
 } // testParseArgsAll
 
@@ -358,7 +366,7 @@ geomodelgrids::apps::TestQuery::testPrintHelp(void) {
     Query query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(1806) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -379,7 +387,7 @@ geomodelgrids::apps::TestQuery::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(1806) == coutHelp.str().length());
 } // testRunHelp
 
 
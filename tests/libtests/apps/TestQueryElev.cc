@@ -169,6 +169,7 @@ geomodelgrids::apps::TestQueryElev::testConstructor(void) {
     QueryElev query;
 
     CHECK(std::string("EPSG:4326") == query._pointsCRS);
+    CHECK(false == query._showStats);
     CHECK(false == query._showHelp);
 } // testConstructor
 
@@ -273,7 +274,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
-    const int nargs = 7;
+    const int nargs = 8;
     const char* const args[nargs] = {
         "test",
         "--models=A",
@@ -282,6 +283,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
         "--points-coordsys=EPSG:26910",
         "--surface=topography_bathymetry",
         "--log=error.log",
+        "--stats",
     };
 
     QueryElev query;
@@ -293,6 +295,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
     CHECK(std::string("EPSG:26910") == query._pointsCRS);
     CHECK(true == query._useTopoBathy);
     CHECK(std::string("error.log") == query._logFilename);
+    CHECK(query._showStats);
     CHECK(!query._showHelp);
 } // testParseArgsAll
 
@@ -308,7 +311,7 @@ geomodelgrids::apps::TestQueryElev::testPrintHelp(void) {
     QueryElev query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(849) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -329,7 +332,7 @@ geomodelgrids::apps::TestQueryElev::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(849) == coutHelp.str().length());
 } // testRunHelp
 
 
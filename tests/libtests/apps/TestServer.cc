@@ -0,0 +1,325 @@
+/**
+ * C++ unit testing of geomodelgrids::apps::Server.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/apps/Server.hh" // USES Server
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryClient.hh" // USES QueryClient
+
+#include "tests/data/ModelPoints.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <iostream> // USES std::cout
+#include <sstream> // USES std::ostringstream
+#include <getopt.h> // USES optind
+#include <unistd.h> // USES usleep()
+#include <thread> // USES std::thread
+
+namespace geomodelgrids {
+    namespace apps {
+        class TestServer;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::TestServer {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestServer(void);
+
+    /// Test constructor.
+    void testConstructor(void);
+
+    /// Test _parseArgs() with no args.
+    void testParseNoArgs(void);
+
+    /// Test _parseArgs() with --help.
+    void testParseArgsHelp(void);
+
+    /// Test _parseArgs() missing --values.
+    void testParseArgsNoValues(void);
+
+    /// Test _parseArgs() missing --models.
+    void testParseArgsNoModels(void);
+
+    /// Test _parseArgs() missing --socket.
+    void testParseArgsNoSocket(void);
+
+    /// Test _parseArgs() with wrong arguments.
+    void testParseArgsWrong(void);
+
+    /// Test _parseArgs() with all arguments.
+    void testParseArgsAll(void);
+
+    /// Test _printHelp().
+    void testPrintHelp(void);
+
+    /// Test run() with help.
+    void testRunHelp(void);
+
+    /// Test run() with three-blocks-topo.
+    void testRunThreeBlocks(void);
+
+}; // class TestServer
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestServer::testConstructor", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testConstructor();
+}
+TEST_CASE("TestServer::testParseNoArgs", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseNoArgs();
+}
+TEST_CASE("TestServer::testParseArgsHelp", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsHelp();
+}
+TEST_CASE("TestServer::testParseArgsNoValues", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsNoValues();
+}
+TEST_CASE("TestServer::testParseArgsNoModels", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsNoModels();
+}
+TEST_CASE("TestServer::testParseArgsNoSocket", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsNoSocket();
+}
+TEST_CASE("TestServer::testParseArgsWrong", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsWrong();
+}
+TEST_CASE("TestServer::testParseArgsAll", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testParseArgsAll();
+}
+TEST_CASE("TestServer::testPrintHelp", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testPrintHelp();
+}
+TEST_CASE("TestServer::testRunHelp", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testRunHelp();
+}
+TEST_CASE("TestServer::testRunThreeBlocks", "[TestServer]") {
+    geomodelgrids::apps::TestServer().testRunThreeBlocks();
+}
+
+// ------------------------------------------------------------------------------------------------
+geomodelgrids::apps::TestServer::TestServer(void) {
+    optind = 1; // reset parsing of argc and argv
+} // setUp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::apps::TestServer::testConstructor(void) {
+    Server server;
+
+    CHECK(std::string("EPSG:4326") == server._pointsCRS);
+    CHECK(server._socketPath.empty());
+    CHECK(geomodelgrids::serial::Query::SQUASH_NONE == server._squash);
+    CHECK(false == server._prefetch);
+    CHECK(false == server._showHelp);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with no args.
+void
+geomodelgrids::apps::TestServer::testParseNoArgs(void) {
+    const int nargs = 1;
+    const char* const args[nargs] = { "test" };
+
+    Server server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(server._showHelp);
+} // testParseNoArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with --help.
+void
+geomodelgrids::apps::TestServer::testParseArgsHelp(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--help" };
+
+    Server server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(server._showHelp);
+} // testParseArgsHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() without --values.
+void
+geomodelgrids::apps::TestServer::testParseArgsNoValues(void) {
+    const int nargs = 3;
+    const char* const args[nargs] = { "test", "--models=A", "--socket=B" };
+
+    Server server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+} // testParseArgsNoValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() without --models.
+void
+geomodelgrids::apps::TestServer::testParseArgsNoModels(void) {
+    const int nargs = 3;
+    const char* const args[nargs] = { "test", "--values=one", "--socket=B" };
+
+    Server server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+} // testParseArgsNoModels
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() without --socket.
+void
+geomodelgrids::apps::TestServer::testParseArgsNoSocket(void) {
+    const int nargs = 3;
+    const char* const args[nargs] = { "test", "--values=one", "--models=A" };
+
+    Server server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+} // testParseArgsNoSocket
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with wrong arguments.
+void
+geomodelgrids::apps::TestServer::testParseArgsWrong(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--blah" };
+
+    Server server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+} // testParseArgsWrong
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with all arguments.
+void
+geomodelgrids::apps::TestServer::testParseArgsAll(void) {
+    const int nargs = 12;
+    const char* const args[nargs] = {
+        "test",
+        "--values=one,two",
+        "--models=A,B",
+        "--socket=server.sock",
+        "--squash-min-elev=-2.0e+3",
+        "--squash-surface=topography_bathymetry",
+        "--points-coordsys=EPSG:26910",
+        "--log=error.log",
+        "--prefetch",
+        "--resolution=500.0",
+        "--metadata-cache=models.cache",
+        "--help",
+    };
+
+    Server server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    REQUIRE(size_t(2) == server._valueNames.size());
+    CHECK(std::string("one") == server._valueNames[0]);
+    CHECK(std::string("two") == server._valueNames[1]);
+    REQUIRE(size_t(2) == server._modelFilenames.size());
+    CHECK(std::string("A") == server._modelFilenames[0]);
+    CHECK(std::string("B") == server._modelFilenames[1]);
+    CHECK(std::string("server.sock") == server._socketPath);
+    CHECK(-2.0e+3 == server._squashMinElev);
+    CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == server._squash);
+    CHECK(std::string("EPSG:26910") == server._pointsCRS);
+    CHECK(std::string("error.log") == server._logFilename);
+    CHECK(server._prefetch);
+    CHECK(500.0 == server._resolution);
+    CHECK(std::string("models.cache") == server._metadataCacheFilename);
+    CHECK(server._showHelp);
+} // testParseArgsAll
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _printHelp().
+void
+geomodelgrids::apps::TestServer::testPrintHelp(void) {
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutHelp;
+    std::cout.rdbuf(coutHelp.rdbuf() );
+
+    Server server;
+    server._printHelp();
+    std::cout.rdbuf(coutOrig);
+    CHECK(size_t(1598) == coutHelp.str().length());
+} // testPrintHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with help.
+void
+geomodelgrids::apps::TestServer::testRunHelp(void) {
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutHelp;
+    std::cout.rdbuf(coutHelp.rdbuf() );
+
+    Server server;
+    const int nargs = 2;
+    const char* const args[nargs] = {
+        "test",
+        "--help",
+    };
+    server.run(nargs, const_cast<char**>(args));
+
+    std::cout.rdbuf(coutOrig);
+    CHECK(size_t(1598) == coutHelp.str().length());
+} // testRunHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo.
+void
+geomodelgrids::apps::TestServer::testRunThreeBlocks(void) {
+    const int nargs = 6;
+    const char* const args[nargs] = {
+        "test",
+        "--values=two,one",
+        "--models=../../data/three-blocks-topo.h5",
+        "--socket=three-blocks-topo.sock",
+        "--points-coordsys=EPSG:4326",
+        "--log=error.log",
+    };
+
+    Server server;
+    std::thread serverThread(&Server::run, &server, nargs, const_cast<char**>(args));
+
+    geomodelgrids::serial::QueryClient client;
+    for (size_t i = 0; i < 100; ++i) { // Wait for server to start listening.
+        try {
+            client.connect("three-blocks-topo.sock");
+            break;
+        } catch (const std::runtime_error&) {
+            usleep(100000);
+        } // try/catch
+    } // for
+    REQUIRE(size_t(2) == client.getValueNames().size());
+    CHECK(std::string("two") == client.getValueNames()[0]);
+    CHECK(std::string("one") == client.getValueNames()[1]);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t numValues = 2;
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    geomodelgrids::serial::Query query;
+    query.initialize(server._modelFilenames, server._valueNames, server._pointsCRS);
+    const double* xyz = points.getLatLonElev();
+    query.queryPoints(valuesE.data(), numValues, &xyz[0], &xyz[1], &xyz[2], 3, numPoints, statusE.data());
+
+    std::vector<double> values(numPoints*numValues);
+    std::vector<int> status(numPoints);
+    client.queryPoints(values.data(), xyz, numPoints, status.data());
+    CHECK(valuesE == values);
+    CHECK(statusE == status);
+
+    client.shutdownServer();
+    serverThread.join();
+} // testRunThreeBlocks
+
+
+// End of file
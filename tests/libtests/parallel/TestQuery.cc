@@ -0,0 +1,346 @@
+/**
+ * C++ unit testing of geomodelgrids::parallel::Query.
+ *
+ * Run with any number of MPI processes.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/parallel/Query.hh" // Test subject
+
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <fstream> // USES std::ifstream
+#include <iterator> // USES std::istreambuf_iterator
+#include <algorithm> // USES std::max_element()
+#include <cstring> // USES memcmp()
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace parallel {
+        class TestQuery;
+    } // parallel
+} // geomodelgrids
+
+class geomodelgrids::parallel::TestQuery {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test initialize() and finalize().
+    static
+    void testInitialize(void);
+
+    /// Test queryPoints().
+    static
+    void testQueryPoints(void);
+
+    /// Test queryPoints() with errors.
+    static
+    void testQueryPointsErrors(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Create points in model coordinates, distributed unevenly across processes.
+     *
+     * @param[out] xyz Coordinates of points on this process.
+     * @param[in] comm MPI communicator.
+     */
+    static
+    void _createPoints(std::vector<double>* xyz,
+                       MPI_Comm comm);
+
+}; // class TestQuery
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestQuery::testConstructor", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testConstructor();
+}
+TEST_CASE("TestQuery::testInitialize", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testInitialize();
+}
+TEST_CASE("TestQuery::testQueryPoints", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testQueryPoints();
+}
+TEST_CASE("TestQuery::testQueryPointsErrors", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testQueryPointsErrors();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::parallel::TestQuery::testConstructor(void) {
+    Query query;
+    CHECK(MPI_COMM_WORLD == query.getComm());
+    CHECK(MPI_COMM_NULL == query._nodeComm);
+    CHECK(MPI_COMM_NULL == query._nodeLeadersComm);
+    CHECK(&query._query == &query.getSerialQuery());
+    CHECK(Query::DECOMPOSE_POINTS == query.getDecomposition());
+    CHECK(query.getMaxSharedBytes() > size_t(0));
+
+    query.setDecomposition(Query::DECOMPOSE_MODEL);
+    CHECK(Query::DECOMPOSE_MODEL == query.getDecomposition());
+    query.setMaxSharedBytes(1024);
+    CHECK(size_t(1024) == query.getMaxSharedBytes());
+
+    Query querySelf(MPI_COMM_SELF);
+    CHECK(MPI_COMM_SELF == querySelf.getComm());
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize() and finalize().
+void
+geomodelgrids::parallel::TestQuery::testInitialize(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    Query query;
+    query.initialize(filenames, valueNames, "EPSG:3311");
+    CHECK(MPI_COMM_NULL != query._nodeComm);
+    REQUIRE(numModels == query._modelImages.size());
+    for (size_t iModel = 0; iModel < numModels; ++iModel) {
+        INFO("Model '" << filenames[iModel] << "'.");
+        std::ifstream fin(filenames[iModel].c_str(), std::ios::binary);
+        const std::vector<char> bytesE((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+        MPI_Aint numBytes = 0;
+        int dispUnit = 0;
+        void* image = nullptr;
+        MPI_Win_shared_query(query._modelImages[iModel], 0, &numBytes, &dispUnit, &image);
+        REQUIRE(bytesE.size() == size_t(numBytes));
+        CHECK(0 == memcmp(bytesE.data(), image, numBytes));
+    } // for
+    CHECK(valueNames == query.getSerialQuery().getValueNames());
+
+    query.finalize();
+    CHECK(query._modelImages.empty());
+    CHECK(MPI_COMM_NULL == query._nodeComm);
+    CHECK(MPI_COMM_NULL == query._nodeLeadersComm);
+
+    // Only models that fit in the shared memory budget are shared; the others are read from the files.
+    std::ifstream fin(filenames[0].c_str(), std::ios::binary | std::ios::ate);
+    const size_t firstBytes = size_t(fin.tellg());
+    fin.close();
+    query.setMaxSharedBytes(firstBytes);
+    query.initialize(filenames, valueNames, "EPSG:3311");
+    CHECK(size_t(1) == query._modelImages.size());
+    CHECK(valueNames == query.getSerialQuery().getValueNames());
+    query.finalize();
+    CHECK(query._modelImages.empty());
+
+    query.setMaxSharedBytes(0);
+    query.initialize(filenames, valueNames, "EPSG:3311");
+    CHECK(query._modelImages.empty());
+    query.finalize();
+
+    // Missing file is an error on all processes.
+    filenames[1] = "../../data/does-not-exist.h5";
+    CHECK_THROWS_AS(query.initialize(filenames, valueNames, "EPSG:3311"), std::runtime_error);
+    query.finalize();
+
+    // Domain of first model is divided among processes and models are read from files.
+    int numProcs = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+    filenames[1] = filenamesArray[1];
+    query.setDecomposition(Query::DECOMPOSE_MODEL);
+    query.initialize(filenames, valueNames, "EPSG:3311");
+    CHECK(query._modelImages.empty());
+    CHECK(MPI_COMM_NULL == query._nodeComm);
+    REQUIRE(query._domainTransformer);
+    CHECK(numProcs == query._procGrid[0]*query._procGrid[1]);
+    for (size_t iDim = 0; iDim < 2; ++iDim) {
+        CHECK(query._domainDims[iDim] > 0.0);
+        CHECK(query._tileDims[iDim] > 0.0);
+        CHECK(query._numTiles[iDim] > size_t(0));
+        CHECK(query._numTiles[iDim]*query._tileDims[iDim] >= query._domainDims[iDim]);
+    } // for
+    CHECK(valueNames == query.getSerialQuery().getValueNames());
+    query.finalize();
+    CHECK(!query._domainTransformer);
+
+    filenames[0] = "../../data/does-not-exist.h5";
+    CHECK_THROWS_AS(query.initialize(filenames, valueNames, "EPSG:3311"), std::runtime_error);
+    query.finalize();
+} // testInitialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryPoints().
+void
+geomodelgrids::parallel::TestQuery::testQueryPoints(void) {
+    // First model is in the CRS of the points, so DECOMPOSE_MODEL divides its domain among processes.
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+        "../../data/one-block-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    const char* const crs = "EPSG:3311";
+    std::vector<double> xyz;
+    _createPoints(&xyz, MPI_COMM_WORLD);
+    const size_t numPoints = xyz.size() / 3;
+
+    // Values from serial query on this process.
+    geomodelgrids::serial::Query querySerial;
+    querySerial.setSquashMinElev(-4.0e+3);
+    querySerial.setSquashing(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+    querySerial.initialize(filenames, valueNames, crs);
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    size_t numOutsideE = 0;
+    const int errE = querySerial.queryPoints(valuesE.data(), numValues, xyz.data(), xyz.data()+1, xyz.data()+2, 3,
+                                             numPoints, statusE.data(), &numOutsideE);
+    querySerial.finalize();
+
+    // Last case reads the models from the files because they do not fit in the shared memory budget.
+    const size_t numCases = 3;
+    const Query::DecompositionEnum decompositions[numCases] = {
+        Query::DECOMPOSE_POINTS, Query::DECOMPOSE_MODEL, Query::DECOMPOSE_POINTS,
+    };
+    const size_t maxSharedBytes[numCases] = { Query().getMaxSharedBytes(), 0, 0 };
+    for (size_t iDecomp = 0; iDecomp < numCases; ++iDecomp) {
+        INFO("Decomposition " << decompositions[iDecomp] << ", shared bytes " << maxSharedBytes[iDecomp] << ".");
+        Query query;
+        query.setDecomposition(decompositions[iDecomp]);
+        query.setMaxSharedBytes(maxSharedBytes[iDecomp]);
+        query.getSerialQuery().setSquashMinElev(-4.0e+3);
+        query.getSerialQuery().setSquashing(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+        query.getSerialQuery().setStatsOn(true);
+        query.initialize(filenames, valueNames, crs);
+
+        const size_t valuesStride = numValues + 1;
+        const double sentinel = 1.0e+30;
+        std::vector<double> values(numPoints*valuesStride, sentinel);
+        std::vector<int> status(numPoints);
+        size_t numOutside = 0;
+        const int err = query.queryPoints(values.data(), valuesStride, xyz.data(), xyz.data()+1, xyz.data()+2, 3,
+                                          numPoints, status.data(), &numOutside);
+        CHECK(errE == err);
+        CHECK(numOutsideE == numOutside);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Point (" << xyz[iPt*3+0] << ", " << xyz[iPt*3+1] << ", " << xyz[iPt*3+2] << ").");
+            CHECK(statusE[iPt] == status[iPt]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                CHECK(valuesE[iPt*numValues+iValue] == values[iPt*valuesStride+iValue]);
+            } // for
+            CHECK(sentinel == values[iPt*valuesStride+numValues]);
+        } // for
+
+        // All points are queried once; with DECOMPOSE_POINTS, processes query about the same number of points.
+        int numProcs = 1;
+        MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+        const unsigned long numPointsLocal = numPoints;
+        unsigned long numPointsTotal = 0;
+        MPI_Allreduce(&numPointsLocal, &numPointsTotal, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+        const unsigned long numQueried = query.getSerialQuery().getStats()->numPoints;
+        std::vector<unsigned long> numQueriedAll(numProcs);
+        MPI_Allgather(&numQueried, 1, MPI_UNSIGNED_LONG, numQueriedAll.data(), 1, MPI_UNSIGNED_LONG,
+                      MPI_COMM_WORLD);
+        unsigned long numQueriedTotal = 0;
+        for (int i = 0; i < numProcs; ++i) {
+            numQueriedTotal += numQueriedAll[i];
+        } // for
+        CHECK(numPointsTotal == numQueriedTotal);
+        if (Query::DECOMPOSE_POINTS == decompositions[iDecomp]) {
+            const unsigned long numQueriedMax = *std::max_element(numQueriedAll.begin(), numQueriedAll.end());
+            CHECK(double(numQueriedMax) <= 1.1 * numPointsTotal / numProcs);
+        } // if
+
+        query.finalize();
+    } // for
+} // testQueryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryPoints() with errors.
+void
+geomodelgrids::parallel::TestQuery::testQueryPointsErrors(void) {
+    std::vector<std::string> filenames(1, "../../data/one-block-topo.h5");
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    Query query;
+    query.initialize(filenames, valueNames, "EPSG:3311");
+    std::vector<double> xyz;
+    _createPoints(&xyz, MPI_COMM_WORLD);
+    const size_t numPoints = xyz.size() / 3;
+    std::vector<double> values(numPoints*numValues);
+
+    // Error on one process is reported on all processes.
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    const size_t valuesStride = (0 == rank) ? numValues-1 : numValues;
+    int err = query.queryPoints(values.data(), valuesStride, xyz.data(), xyz.data()+1, xyz.data()+2, 3, numPoints);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+    if (0 == rank) {
+        CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.getSerialQuery().getErrorHandler()->getStatus());
+        query.getSerialQuery().getErrorHandler()->resetStatus();
+    } // if
+
+    err = query.queryPoints(values.data(), numValues, xyz.data(), xyz.data()+1, xyz.data()+2, 3, numPoints);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR != err);
+
+    query.finalize();
+} // testQueryPointsErrors
+
+
+// ------------------------------------------------------------------------------------------------
+// Create points in model coordinates, distributed unevenly across processes.
+void
+geomodelgrids::parallel::TestQuery::_createPoints(std::vector<double>* xyz,
+                                                  MPI_Comm comm) {
+    assert(xyz);
+
+    int numProcs = 1;
+    int rank = 0;
+    MPI_Comm_size(comm, &numProcs);
+    MPI_Comm_rank(comm, &rank);
+
+    // Grid of points around the domains of the models (some outside); process 0 has no points if there is more
+    // than one process, and the last process has points in only one corner of the grid.
+    size_t iPt = 0;
+    xyz->clear();
+    xyz->reserve(3); // Coordinate pointers are valid even without points.
+    for (double x = 140.0e+3; x < 290.0e+3; x += 5.0e+3) {
+        for (double y = -430.0e+3; y < -260.0e+3; y += 5.0e+3) {
+            for (double z = 2.0e+3; z > -50.0e+3; z -= 4.0e+3, ++iPt) {
+                int owner = 0;
+                if (numProcs > 2) {
+                    owner = ((x < 180.0e+3) && (y < -400.0e+3)) ? numProcs-1 : 1 + (iPt / 7) % (numProcs-2);
+                } else if (numProcs > 1) {
+                    owner = 1;
+                } // if/else
+                if (owner == rank) {
+                    xyz->push_back(x);
+                    xyz->push_back(y);
+                    xyz->push_back(z);
+                } // if
+            } // for
+        } // for
+    } // for
+} // _createPoints
+
+
+// End of file
@@ -8,6 +8,7 @@
 
 #include "geomodelgrids/serial/Block.hh" // USES Block
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
 #include "geomodelgrids/utils/Indexing.hh" // USES Indexing
 
 #include "catch2/catch_test_macros.hpp"
@@ -63,10 +64,12 @@ geomodelgrids::serial::TestBlock::testSetHyperslabDims(void) {
     Block block(blockName.c_str());
 
     const size_t ndims = 4;
-    const size_t dimsDefault[ndims] = { 64, 64, 0, 0 };
+    const size_t dimsDefault[ndims] = { 0, 0, 0, 0 };
     for (size_t i = 0; i < ndims; ++i) {
         CHECK(dimsDefault[i] == block._hyperslabDims[i]);
     } // for
+    CHECK(Hyperslab::DEFAULT_MAX_BYTES == block._hyperslabMaxBytes);
+    CHECK(!block._hyperslabPrefetch);
 
     const size_t dims[ndims] = { 12, 12, 4, 0 };
     block.setHyperslabDims(dims, ndims-1);
@@ -75,6 +78,13 @@ geomodelgrids::serial::TestBlock::testSetHyperslabDims(void) {
     } // for
 
     CHECK_THROWS_AS(block.setHyperslabDims(dims, 5), std::length_error);
+
+    const size_t maxBytes = 4096;
+    block.setHyperslabMaxBytes(maxBytes);
+    CHECK(maxBytes == block._hyperslabMaxBytes);
+
+    block.setHyperslabPrefetch(true);
+    CHECK(block._hyperslabPrefetch);
 } // testSetHyperslabDims
 
 
@@ -10,6 +10,8 @@ extern "C" {
 #include "geomodelgrids/serial/cquery.h"
 }
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
+#include "geomodelgrids/serial/SharedChunkCache.hh" // USES SharedChunkCache
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
@@ -17,6 +19,8 @@ extern "C" {
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
 namespace geomodelgrids {
     namespace serial {
@@ -64,6 +68,10 @@ public:
     static
     void testQuerySquashTopoBathy(void);
 
+    /// Test query_points(), query_points_strided(), and single precision variants.
+    static
+    void testQueryPoints(void);
+
 }; // class TestCQuery
 
 // ------------------------------------------------------------------------------------------------
@@ -94,6 +102,9 @@ TEST_CASE("TestCQuery::testQuerySquashTop", "[TestCQuery]") {
 TEST_CASE("TestCQuery::testQuerySquashTopoBathy", "[TestCQuery]") {
     geomodelgrids::serial::TestCQuery().testQuerySquashTopoBathy();
 }
+TEST_CASE("TestCQuery::testQueryPoints", "[TestCQuery]") {
+    geomodelgrids::serial::TestCQuery().testQueryPoints();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -130,6 +141,53 @@ geomodelgrids::serial::TestCQuery::testAccessors(void) {
     err = geomodelgrids_squery_setSquashing(handle, GEOMODELGRIDS_SQUASH_TOP_SURFACE);REQUIRE(!err);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == query->_squash);
 
+    const size_t blockDims[3] = { 8, 0, 4 };
+    err = geomodelgrids_squery_setBlockHyperslabDims(handle, blockDims, 3);REQUIRE(!err);
+    REQUIRE(3 == query->_blockHyperslabDims.size());
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(blockDims[i] == query->_blockHyperslabDims[i]);
+    } // for
+    err = geomodelgrids_squery_setBlockHyperslabDims(handle, blockDims, 2);
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
+    query->getErrorHandler()->resetStatus();
+
+    const size_t surfaceDims[2] = { 0, 16 };
+    err = geomodelgrids_squery_setSurfaceHyperslabDims(handle, surfaceDims, 2);REQUIRE(!err);
+    REQUIRE(2 == query->_surfaceHyperslabDims.size());
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK(surfaceDims[i] == query->_surfaceHyperslabDims[i]);
+    } // for
+
+    const size_t maxBytes = 1048576;
+    err = geomodelgrids_squery_setHyperslabMaxBytes(handle, maxBytes);REQUIRE(!err);
+    CHECK(maxBytes == query->_hyperslabMaxBytes);
+
+    err = geomodelgrids_squery_setHyperslabPrefetch(handle, 1);REQUIRE(!err);
+    CHECK(query->_hyperslabPrefetch);
+
+    err = geomodelgrids_squery_setMetadataCache(handle, "metadata-cache.txt");REQUIRE(!err);
+    CHECK(std::string("metadata-cache.txt") == query->_metadataCacheFilename);
+
+    err = geomodelgrids_squery_setSharedCache(handle, "/geomodelgrids-cache", 0, 4096);REQUIRE(!err);
+    CHECK(std::string("/geomodelgrids-cache") == query->_sharedCacheName);
+    CHECK(SharedChunkCache::DEFAULT_CACHE_BYTES == query->_sharedCacheBytes);
+    CHECK(size_t(4096) == query->_sharedCacheSlotBytes);
+
+    struct GeomodelgridsQueryStats stats;
+    err = geomodelgrids_squery_getStats(handle, &stats);
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
+    query->getErrorHandler()->resetStatus();
+
+    err = geomodelgrids_squery_setStatsOn(handle, 1);REQUIRE(!err);
+    REQUIRE(query->_stats);
+    query->_stats->numPoints = 3;
+    query->_stats->timeIO = 0.5;
+    err = geomodelgrids_squery_getStats(handle, &stats);REQUIRE(!err);
+    CHECK(size_t(3) == stats.numPoints);
+    CHECK(0.5 == stats.timeIO);
+    err = geomodelgrids_squery_resetStats(handle);REQUIRE(!err);
+    CHECK(size_t(0) == query->_stats->numPoints);
+
     // Bad handles
     err = geomodelgrids_squery_setSquashMinElev(nullptr, minElev);
     CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
@@ -793,4 +851,156 @@ geomodelgrids::serial::TestCQuery::testQuerySquashTopoBathy(void) {
 } // testQuerySquashTopoBathy
 
 
+// ------------------------------------------------------------------------------------------------
+// Test query_points(), query_points_strided(), and single precision variants.
+void
+geomodelgrids::serial::TestCQuery::testQueryPoints(void) {
+    const size_t numModels = 2;
+    const char* const filenames[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+
+    const size_t numValues = 2;
+    const char* const valueNames[numValues] = { "two", "one" };
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Points in model followed by points outside domain.
+    const size_t numPointsIn = pointsThree.getNumPoints();
+    const size_t numPointsOut = pointsOutside.getNumPoints();
+    const size_t numPoints = numPointsIn + numPointsOut;
+    std::vector<double> points(numPoints*spaceDim);
+    std::copy(pointsThree.getLatLonElev(), pointsThree.getLatLonElev()+numPointsIn*spaceDim, &points[0]);
+    std::copy(pointsOutside.getLatLonElev(), pointsOutside.getLatLonElev()+numPointsOut*spaceDim,
+              &points[numPointsIn*spaceDim]);
+
+    void* handle = geomodelgrids_squery_create();REQUIRE(handle);
+    int err = geomodelgrids_squery_initialize(handle, filenames, numModels, valueNames, numValues, crs.c_str());
+    REQUIRE(!err);
+
+    const double tolerance = 1.0e-5;
+    const double* pointsXYZ = pointsThree.getXYZ();
+    { // Interleaved coordinates
+        std::vector<double> values(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        err = geomodelgrids_squery_query_points(handle, &values[0], &points[0], numPoints, &status[0]);
+        CHECK(1 == err);
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            double valuesE[numValues];
+            if (iPt < numPointsIn) {
+                const double x = pointsXYZ[iPt*spaceDim+0];
+                const double y = pointsXYZ[iPt*spaceDim+1];
+                const double z = pointsXYZ[iPt*spaceDim+2];
+                valuesE[0] = pointsThree.computeValueTwo(x, y, z);
+                valuesE[1] = pointsThree.computeValueOne(x, y, z);
+                CHECK(0 == status[iPt]);
+            } else {
+                valuesE[0] = NODATA_VALUE;
+                valuesE[1] = NODATA_VALUE;
+                CHECK(1 == status[iPt]);
+            } // if/else
+
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch at point (" << points[iPt*spaceDim+0] << ", " << points[iPt*spaceDim+1]
+                                           << ", " << points[iPt*spaceDim+2] << ") for value '"
+                                           << valueNames[iValue] << "'.");
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+            } // for
+        } // for
+    } // Interleaved coordinates
+
+    { // Separate coordinate arrays, values in Fortran order
+        std::vector<double> x(numPointsIn);
+        std::vector<double> y(numPointsIn);
+        std::vector<double> z(numPointsIn);
+        for (size_t iPt = 0; iPt < numPointsIn; ++iPt) {
+            x[iPt] = points[iPt*spaceDim+0];
+            y[iPt] = points[iPt*spaceDim+1];
+            z[iPt] = points[iPt*spaceDim+2];
+        } // for
+
+        geomodelgrids::utils::ErrorHandler* errorHandler =
+            (geomodelgrids::utils::ErrorHandler*)geomodelgrids_squery_getErrorHandler(handle);REQUIRE(errorHandler);
+        errorHandler->resetStatus();
+
+        const size_t valuesStride = numValues + 1;
+        std::vector<double> values(numPointsIn*valuesStride, 0.0);
+        err = geomodelgrids_squery_query_points_strided(handle, &values[0], valuesStride, &x[0], &y[0], &z[0], 1,
+                                                        numPointsIn, NULL);
+        CHECK(0 == err);
+
+        for (size_t iPt = 0; iPt < numPointsIn; ++iPt) {
+            const double xModel = pointsXYZ[iPt*spaceDim+0];
+            const double yModel = pointsXYZ[iPt*spaceDim+1];
+            const double zModel = pointsXYZ[iPt*spaceDim+2];
+            double valuesE[numValues];
+            valuesE[0] = pointsThree.computeValueTwo(xModel, yModel, zModel);
+            valuesE[1] = pointsThree.computeValueOne(xModel, yModel, zModel);
+
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch at point (" << x[iPt] << ", " << y[iPt] << ", " << z[iPt] << ") for value '"
+                                           << valueNames[iValue] << "'.");
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                CHECK_THAT(values[iPt*valuesStride+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+            } // for
+            CHECK(0.0 == values[iPt*valuesStride+numValues]);
+        } // for
+    } // Separate coordinate arrays, values in Fortran order
+
+    { // Single precision values
+        geomodelgrids::utils::ErrorHandler* errorHandler =
+            (geomodelgrids::utils::ErrorHandler*)geomodelgrids_squery_getErrorHandler(handle);REQUIRE(errorHandler);
+        errorHandler->resetStatus();
+
+        std::vector<double> values(numPoints*numValues);
+        err = geomodelgrids_squery_query_points(handle, &values[0], &points[0], numPoints, NULL);
+        CHECK(1 == err);
+        errorHandler->resetStatus();
+
+        std::vector<float> valuesFloat(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        err = geomodelgrids_squery_query_points_float(handle, &valuesFloat[0], &points[0], numPoints, &status[0]);
+        CHECK(1 == err);
+        errorHandler->resetStatus();
+
+        std::vector<float> valuesStrided(numPoints*numValues);
+        err = geomodelgrids_squery_query_points_strided_float(handle, &valuesStrided[0], numValues, &points[0],
+                                                              &points[1], &points[2], spaceDim, numPoints, NULL);
+        CHECK(1 == err);
+        errorHandler->resetStatus();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            CHECK(int(iPt >= numPointsIn) == status[iPt]);
+            float valuesPt[numValues];
+            err = geomodelgrids_squery_query_float(handle, valuesPt, points[iPt*spaceDim+0], points[iPt*spaceDim+1],
+                                                   points[iPt*spaceDim+2]);
+            CHECK(status[iPt] == err);
+            errorHandler->resetStatus();
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                const float valueE = float(values[iPt*numValues+iValue]);
+                CHECK(valueE == valuesFloat[iPt*numValues+iValue]);
+                CHECK(valueE == valuesStrided[iPt*numValues+iValue]);
+                CHECK(valueE == valuesPt[iValue]);
+            } // for
+        } // for
+
+        err = geomodelgrids_squery_query_points_float(NULL, NULL, &points[0], numPoints, NULL);
+        CHECK(2 == err);
+        err = geomodelgrids_squery_query_float(NULL, NULL, 0.0, 0.0, 0.0);
+        CHECK(2 == err);
+    } // Single precision values
+
+    err = geomodelgrids_squery_query_points(NULL, NULL, &points[0], numPoints, NULL);
+    CHECK(2 == err);
+
+    geomodelgrids_squery_destroy(&handle);REQUIRE(!handle);
+} // testQueryPoints
+
+
 // End of file
@@ -12,6 +12,10 @@
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <fstream> // USES std::ifstream
+#include <iterator> // USES std::istreambuf_iterator
+#include <thread> // USES std::thread
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace serial {
@@ -36,12 +40,18 @@ public:
     /// Test open(), isOpen(), close().
     void testOpenClose(void);
 
+    /// Test opening file from image in memory.
+    void testFileImage(void);
+
     /// Test getters.
     void testAccessors(void);
 
     /// Test getDatasetDims().
     void testGetDatasetDims(void);
 
+    /// Test getDatasetChunk().
+    void testGetDatasetChunk(void);
+
     /// Test getGroupDatasets().
     void testGetGroupDatasets(void);
 
@@ -60,6 +70,9 @@ public:
     /// Test readDatasetHyperslab().
     void testReadDatasetHyperslab(void);
 
+    /// Test reading metadata while another thread reads a hyperslab.
+    void testConcurrentAccess(void);
+
 private:
 
     H5E_auto2_t _errFunc;
@@ -75,12 +88,18 @@ TEST_CASE("TestHDF5::testConstructor", "[TestHDF5]") {
 TEST_CASE("TestHDF5::testOpenClose", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testOpenClose();
 }
+TEST_CASE("TestHDF5::testFileImage", "[TestHDF5]") {
+    geomodelgrids::serial::TestHDF5().testFileImage();
+}
 TEST_CASE("TestHDF5::testAccessors", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testAccessors();
 }
 TEST_CASE("TestHDF5::testGetDatasetDims", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testGetDatasetDims();
 }
+TEST_CASE("TestHDF5::testGetDatasetChunk", "[TestHDF5]") {
+    geomodelgrids::serial::TestHDF5().testGetDatasetChunk();
+}
 TEST_CASE("TestHDF5::testGetGroupDatasets", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testGetGroupDatasets();
 }
@@ -99,6 +118,9 @@ TEST_CASE("TestHDF5::testReadAttributeStringArray", "[TestHDF5]") {
 TEST_CASE("TestHDF5::testReadDatasetHyperslab", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testReadDatasetHyperslab();
 }
+TEST_CASE("TestHDF5::testConcurrentAccess", "[TestHDF5]") {
+    geomodelgrids::serial::TestHDF5().testConcurrentAccess();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor.
@@ -162,6 +184,35 @@ geomodelgrids::serial::TestHDF5::testOpenClose(void) {
 } // testOpenClose
 
 
+// ------------------------------------------------------------------------------------------------
+// Test opening file from image in memory.
+void
+geomodelgrids::serial::TestHDF5::testFileImage(void) {
+    const char* filename = "../../data/three-blocks-flat.h5";
+    std::ifstream fin(filename, std::ios::binary);
+    const std::vector<char> image((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    REQUIRE(image.size() > 0);
+
+    HDF5 h5;
+    h5.setFileImage(image.data(), image.size());
+    CHECK_THROWS_AS(h5.open(filename, H5F_ACC_RDWR), std::logic_error);
+    REQUIRE(!h5.isOpen());
+
+    h5.open(filename, H5F_ACC_RDONLY);REQUIRE(h5.isOpen());
+    CHECK(h5.hasGroup("blocks"));
+    CHECK(h5.hasDataset("/blocks/bottom"));
+    h5.close();REQUIRE(!h5.isOpen());
+
+    // Image does not need to correspond to a file.
+    h5.open("abc", H5F_ACC_RDONLY);REQUIRE(h5.isOpen());
+    CHECK(h5.hasDataset("/blocks/bottom"));
+    h5.close();
+
+    h5.setFileImage(nullptr, 0);
+    CHECK_THROWS_AS(h5.open("abc", H5F_ACC_RDONLY), std::runtime_error);
+} // testFileImage
+
+
 // ------------------------------------------------------------------------------------------------
 // Test getters.
 void
@@ -204,6 +255,30 @@ geomodelgrids::serial::TestHDF5::testGetDatasetDims(void) {
 } // testGetDatasetDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Test getDatasetChunk().
+void
+geomodelgrids::serial::TestHDF5::testGetDatasetChunk(void) {
+    HDF5 h5;
+    h5.open("../../data/three-blocks-flat.h5", H5F_ACC_RDONLY);
+
+    const int ndimsE = 4;
+    const hsize_t dimsE[ndimsE] = { 2, 2, 3, 2 };
+    hsize_t* dims = nullptr;
+    int ndims = 0;
+    h5.getDatasetChunk(&dims, &ndims, "/blocks/middle");
+    REQUIRE(ndimsE == ndims);
+    for (int i = 0; i < ndimsE; ++i) {
+        CHECK(dimsE[i] == dims[i]);
+    } // for
+    delete[] dims;dims = nullptr;
+
+    CHECK_THROWS_AS(h5.getDatasetChunk(&dims, &ndims, "blah"), std::runtime_error);
+
+    h5.close();
+} // testGetDatasetChunk
+
+
 // ------------------------------------------------------------------------------------------------
 // Test getGroupDatasets().
 void
@@ -372,4 +447,56 @@ geomodelgrids::serial::TestHDF5::testReadDatasetHyperslab(void) {
 } // testReadDatasetHyperslab
 
 
+// ------------------------------------------------------------------------------------------------
+// Test reading metadata while another thread reads a hyperslab.
+void
+geomodelgrids::serial::TestHDF5::testConcurrentAccess(void) {
+    const char* dataset = "/blocks/top";
+    const int ndims = 4;
+    const hsize_t origin[ndims] = { 0, 0, 0, 0 };
+    const hsize_t dims[ndims] = { 4, 4, 2, 2 };
+    const size_t numValues = 4*4*2*2;
+    const size_t numReads = 200;
+
+    HDF5 h5Data;
+    h5Data.open("../../data/three-blocks-flat.h5", H5F_ACC_RDONLY);
+    std::vector<double> valuesE(numValues);
+    h5Data.readDatasetHyperslab(valuesE.data(), dataset, origin, dims, ndims, H5T_NATIVE_DOUBLE);
+
+    // Background thread reads data, as a hyperslab prefetch does, while the foreground reads metadata.
+    size_t numMismatches = 0;
+    std::thread reader([&]() {
+        std::vector<double> values(numValues);
+        for (size_t i = 0; i < numReads; ++i) {
+            h5Data.readDatasetHyperslab(values.data(), dataset, origin, dims, ndims, H5T_NATIVE_DOUBLE);
+            numMismatches += (values != valuesE) ? 1 : 0;
+        } // for
+    });
+
+    HDF5 h5Metadata;
+    h5Metadata.open("../../data/three-blocks-topo.h5", H5F_ACC_RDONLY);
+    for (size_t i = 0; i < numReads; ++i) {
+        CHECK(h5Metadata.hasGroup("blocks"));
+        CHECK(h5Metadata.hasDataset("/blocks/middle"));
+        CHECK(h5Metadata.hasAttribute("/", "title"));
+        hsize_t* dimsMetadata = nullptr;
+        int ndimsMetadata = 0;
+        h5Metadata.getDatasetChunk(&dimsMetadata, &ndimsMetadata, "/blocks/middle");
+        delete[] dimsMetadata;dimsMetadata = nullptr;
+        h5Metadata.getDatasetDims(&dimsMetadata, &ndimsMetadata, "/blocks/middle");
+        CHECK(4 == ndimsMetadata);
+        delete[] dimsMetadata;dimsMetadata = nullptr;
+        std::vector<std::string> names;
+        h5Metadata.getGroupDatasets(&names, "blocks");
+        CHECK(size_t(3) == names.size());
+        CHECK(!h5Metadata.readAttribute("/", "title").empty());
+    } // for
+    h5Metadata.close();
+
+    reader.join();
+    CHECK(size_t(0) == numMismatches);
+    h5Data.close();
+} // testConcurrentAccess
+
+
 // End of file
@@ -9,11 +9,13 @@
 #include "geomodelgrids/serial/Hyperslab.hh" // Test subject
 
 #include "geomodelgrids/serial/HDF5.hh" // HASA HDF5
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace serial {
@@ -40,6 +42,9 @@ public:
     /// Test constructor with oversize dims in 3D.
     void testConstructorOversize3D(void);
 
+    /// Test constructor with automatic sizing from chunk layout.
+    void testConstructorAutoDims(void);
+
     /// Test constructor bad dimensions.
     void testConstructorBadDims(void);
 
@@ -49,6 +54,12 @@ public:
     /// Test interpolate in 2D.
     void testInterpolate3D(void);
 
+    /// Test interpolate with prefetching while traversing dataset.
+    void testInterpolatePrefetch(void);
+
+    /// Test interpolate at last index of dataset does not reread hyperslab.
+    void testInterpolateLastIndex(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -66,6 +77,9 @@ TEST_CASE("TestHyperslab::testConstructor3D", "[TestHyperslab]") {
 TEST_CASE("TestHyperslab::testConstructorOversize3D", "[TestHyperslab]") {
     geomodelgrids::serial::TestHyperslab().testConstructorOversize3D();
 }
+TEST_CASE("TestHyperslab::testConstructorAutoDims", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testConstructorAutoDims();
+}
 TEST_CASE("TestHyperslab::testConstructorBadDims", "[TestHyperslab]") {
     geomodelgrids::serial::TestHyperslab().testConstructorBadDims();
 }
@@ -76,6 +90,12 @@ TEST_CASE("TestHyperslab::testInterpolate2D", "[TestHyperslab]") {
 TEST_CASE("TestHyperslab::testInterpolate3D", "[TestHyperslab]") {
     geomodelgrids::serial::TestHyperslab().testInterpolate3D();
 }
+TEST_CASE("TestHyperslab::testInterpolatePrefetch", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testInterpolatePrefetch();
+}
+TEST_CASE("TestHyperslab::testInterpolateLastIndex", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testInterpolateLastIndex();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor.
@@ -178,6 +198,47 @@ geomodelgrids::serial::TestHyperslab::testConstructorOversize3D(void) {
 } // testConstructorOversize3D
 
 
+// ------------------------------------------------------------------------------------------------
+// Test constructor with automatic sizing from chunk layout.
+void
+geomodelgrids::serial::TestHyperslab::testConstructorAutoDims(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 0, 0, 0, 0 };
+    const hsize_t chunkDimsE[ndims] = { 1, 1, 2, 2 };
+
+    { // Budget large enough for entire dataset.
+        const hsize_t dimsE[ndims] = { 4, 5, 2, 2 };
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+
+        REQUIRE(hyperslab._chunkDims);
+        for (size_t i = 0; i < ndims; ++i) {
+            CHECK(chunkDimsE[i] == hyperslab._chunkDims[i]);
+            CHECK(dimsE[i] == hyperslab._dims[i]);
+        } // for
+    } // Budget large enough
+
+    { // Budget limits hyperslab to a few chunks.
+        const size_t maxBytes = 2*2*2*2*sizeof(double);
+        const hsize_t dimsE[ndims] = { 2, 2, 2, 2 };
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims, maxBytes);
+
+        for (size_t i = 0; i < ndims; ++i) {
+            CHECK(dimsE[i] == hyperslab._dims[i]);
+        } // for
+    } // Budget limits hyperslab
+
+    { // Budget smaller than a chunk.
+        const hsize_t dimsE[ndims] = { 1, 1, 2, 2 };
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims, 1);
+
+        for (size_t i = 0; i < ndims; ++i) {
+            CHECK(dimsE[i] == hyperslab._dims[i]);
+        } // for
+    } // Budget smaller than a chunk
+} // testConstructorAutoDims
+
+
 // ------------------------------------------------------------------------------------------------
 // Test constructor with bad dims.
 void
@@ -292,4 +353,104 @@ geomodelgrids::serial::TestHyperslab::testInterpolate3D(void) {
 } // testInterplate3D
 
 
+// ------------------------------------------------------------------------------------------------
+// Test interpolate with prefetching while traversing dataset.
+void
+geomodelgrids::serial::TestHyperslab::testInterpolatePrefetch(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+
+    // Traverse along y, then back along x, then along y in the opposite direction.
+    const size_t spaceDim = 3;
+    std::vector<double> index;
+    for (double y = 0.0; y <= 4.0; y += 0.2) {
+        index.push_back(0.6);index.push_back(y);index.push_back(0.3);
+    } // for
+    for (double x = 3.0; x >= 0.0; x -= 0.3) {
+        index.push_back(x);index.push_back(2.5);index.push_back(0.7);
+    } // for
+    for (double y = 4.0; y >= 0.0; y -= 0.35) {
+        index.push_back(2.2);index.push_back(y);index.push_back(0.9);
+    } // for
+    const size_t npoints = index.size() / spaceDim;
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+    hyperslab.setPrefetch(true);
+    QueryStats stats;
+    hyperslab.setStats(&stats);
+
+    double dx = 0.0;
+    double dz = 0.0;
+    double zTop = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    _h5.readAttribute(dataset.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+
+    double values[2] = { -999.0, -999.0 };
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < npoints; ++i) {
+        hyperslab.interpolate(values, &index[i*spaceDim]);
+
+        const double x = dx * index[i*spaceDim + 0];
+        const double y = dx * index[i*spaceDim + 1];
+        const double z = zTop - dz * index[i*spaceDim + 2];
+
+        { // Value 0
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueOne(x, y, z);
+            INFO("Mismatch in value 'one' for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1]
+                                                       << ", " << index[i*spaceDim+2] << ").");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z);
+            INFO("Mismatch in value 'two' for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1]
+                                                       << ", " << index[i*spaceDim+2] << ").");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 1
+    } // for
+
+    CHECK(npoints == stats.numHyperslabHits + stats.numHyperslabPrefetchHits + stats.numHyperslabMisses);
+    CHECK(stats.numHyperslabMisses > 0);
+    CHECK(stats.numHyperslabPrefetchHits > 0);
+    size_t slabBytes = sizeof(double);
+    for (size_t i = 0; i < hyperslab._ndims; ++i) {
+        slabBytes *= hyperslab._dims[i];
+    } // for
+    CHECK((stats.numHyperslabPrefetchHits + stats.numHyperslabMisses) * slabBytes == stats.numBytesRead);
+
+    hyperslab.setPrefetch(false);
+    const double indexLast[spaceDim] = { 1.5, 1.5, 0.5 };
+    CHECK_NOTHROW(hyperslab.interpolate(values, indexLast));
+} // testInterpolatePrefetch
+
+
+// ------------------------------------------------------------------------------------------------
+// Test interpolate at last index of dataset does not reread hyperslab.
+void
+geomodelgrids::serial::TestHyperslab::testInterpolateLastIndex(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 4, 5, 2, 2 };
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+    QueryStats stats;
+    hyperslab.setStats(&stats);
+
+    const size_t spaceDim = 3;
+    const double indexLast[spaceDim] = { 3.0, 4.0, 1.0 };
+    const double indexFirst[spaceDim] = { 0.0, 0.0, 0.0 };
+    double values[2] = { -999.0, -999.0 };
+    for (size_t i = 0; i < 3; ++i) {
+        hyperslab.interpolate(values, indexLast);
+        hyperslab.interpolate(values, indexFirst);
+    } // for
+    CHECK(size_t(1) == stats.numHyperslabMisses);
+    CHECK(size_t(5) == stats.numHyperslabHits);
+} // testInterpolateLastIndex
+
+
 // End of file
@@ -0,0 +1,249 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::MetadataCache.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/MetadataCache.hh" // USES MetadataCache
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <fstream> // USES std::ofstream
+#include <cstdio> // USES std::remove()
+#include <cmath> // USES HUGE_VAL
+#include <string> // USES std::to_string()
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestMetadataCache;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestMetadataCache {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test save() and load().
+    static
+    void testSaveLoad(void);
+
+    /// Test touch() and dropping least recently used entries in save().
+    static
+    void testMaxEntries(void);
+
+    /// Test load() with missing and malformed cache files.
+    static
+    void testLoadBad(void);
+
+    /// Test createKey().
+    static
+    void testCreateKey(void);
+
+}; // class TestMetadataCache
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestMetadataCache::testConstructor", "[TestMetadataCache]") {
+    geomodelgrids::serial::TestMetadataCache::testConstructor();
+}
+TEST_CASE("TestMetadataCache::testSaveLoad", "[TestMetadataCache]") {
+    geomodelgrids::serial::TestMetadataCache::testSaveLoad();
+}
+TEST_CASE("TestMetadataCache::testMaxEntries", "[TestMetadataCache]") {
+    geomodelgrids::serial::TestMetadataCache::testMaxEntries();
+}
+TEST_CASE("TestMetadataCache::testLoadBad", "[TestMetadataCache]") {
+    geomodelgrids::serial::TestMetadataCache::testLoadBad();
+}
+TEST_CASE("TestMetadataCache::testCreateKey", "[TestMetadataCache]") {
+    geomodelgrids::serial::TestMetadataCache::testCreateKey();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestMetadataCache::testConstructor(void) {
+    MetadataCache cache;
+
+    CHECK(cache._filename.empty());
+    CHECK(cache._entries.empty());
+    CHECK(cache._recent.empty());
+    CHECK_FALSE(cache._isModified);
+    CHECK_FALSE(cache.find("abc"));
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test save() and load().
+void
+geomodelgrids::serial::TestMetadataCache::testSaveLoad(void) {
+    const char* const filename = "metadata-cache.txt";
+    std::remove(filename);
+
+    MetadataCache::Entry entryA;
+    entryA.title = "Model A: with\nnewline";
+    entryA.valueNames = { "Vp", "Vs", "density" };
+    entryA.valueUnits = { "m/s", "m/s", "" };
+    entryA.bbox[0] = -122.25;entryA.bbox[1] = -120.0;entryA.bbox[2] = 0.1+0.2;entryA.bbox[3] = 38.0;
+
+    MetadataCache::Entry entryB;
+    entryB.title = "";
+    entryB.valueNames = { "one" };
+    entryB.valueUnits = { "m" };
+    entryB.bbox[0] = -HUGE_VAL;entryB.bbox[1] = +HUGE_VAL;entryB.bbox[2] = -HUGE_VAL;entryB.bbox[3] = +HUGE_VAL;
+
+    { // Save
+        MetadataCache cache;
+        cache.load(filename);
+        CHECK(cache._entries.empty());
+        cache.insert("a", entryA);
+        cache.insert("b", entryB);
+        CHECK(cache._isModified);
+        cache.save();
+        CHECK_FALSE(cache._isModified);
+    } // Save
+
+    { // Load
+        MetadataCache cache;
+        cache.load(filename);
+        CHECK(size_t(2) == cache._entries.size());
+        CHECK_FALSE(cache.find("c"));
+
+        const MetadataCache::Entry* entries[2] = { cache.find("a"), cache.find("b") };
+        const MetadataCache::Entry* entriesE[2] = { &entryA, &entryB };
+        for (size_t i = 0; i < 2; ++i) {
+            REQUIRE(entries[i]);
+            CHECK(entriesE[i]->title == entries[i]->title);
+            CHECK(entriesE[i]->valueNames == entries[i]->valueNames);
+            CHECK(entriesE[i]->valueUnits == entries[i]->valueUnits);
+            for (size_t j = 0; j < 4; ++j) {
+                CHECK(entriesE[i]->bbox[j] == entries[i]->bbox[j]);
+            } // for
+        } // for
+    } // Load
+
+    std::remove(filename);
+} // testSaveLoad
+
+
+// ------------------------------------------------------------------------------------------------
+// Test touch() and dropping least recently used entries in save().
+void
+geomodelgrids::serial::TestMetadataCache::testMaxEntries(void) {
+    const char* const filename = "metadata-cache-max.txt";
+    std::remove(filename);
+
+    MetadataCache::Entry entry;
+    entry.title = "Model";
+    entry.valueNames = { "one" };
+    entry.valueUnits = { "m" };
+    entry.bbox[0] = 0.0;entry.bbox[1] = 1.0;entry.bbox[2] = 0.0;entry.bbox[3] = 1.0;
+
+    const size_t numEntries = MetadataCache::MAX_ENTRIES + 2;
+    { // Fill cache beyond maximum number of entries.
+        MetadataCache cache;
+        cache.load(filename);
+        for (size_t i = 0; i < numEntries; ++i) {
+            cache.insert(std::to_string(i), entry);
+        } // for
+        cache.touch("0");
+        cache.touch("missing");
+        CHECK(numEntries == cache._recent.size());
+        CHECK_FALSE(cache.find("missing"));
+        cache.save();
+        CHECK(MetadataCache::MAX_ENTRIES == cache._entries.size());
+    } // Fill cache
+
+    { // Least recently used entries are dropped.
+        MetadataCache cache;
+        cache.load(filename);
+        CHECK(MetadataCache::MAX_ENTRIES == cache._entries.size());
+        CHECK(MetadataCache::MAX_ENTRIES == cache._recent.size());
+        CHECK(std::string("0") == cache._recent[0]);
+        CHECK(cache.find("0"));
+        CHECK_FALSE(cache.find("1"));
+        CHECK_FALSE(cache.find("2"));
+        CHECK(cache.find("3"));
+        CHECK(cache.find(std::to_string(numEntries-1)));
+        CHECK(cache._savedRecent == cache._recent);
+
+        // Using entries in the order of the file does not change the order.
+        cache.touch(std::to_string(numEntries-1));
+        cache.touch("0");
+        CHECK(cache._savedRecent == cache._recent);
+
+        // Using another entry changes the order, which is written to the file.
+        cache.touch("3");
+        CHECK_FALSE(cache._savedRecent == cache._recent);
+        cache.save();
+        CHECK(cache._savedRecent == cache._recent);
+    } // Least recently used
+
+    { // Order of entries used without changing them is saved.
+        MetadataCache cache;
+        cache.load(filename);
+        REQUIRE(MetadataCache::MAX_ENTRIES == cache._recent.size());
+        CHECK(std::string("3") == cache._recent[0]);
+        CHECK(std::string("0") == cache._recent[1]);
+    } // Order saved
+
+    std::remove(filename);
+} // testMaxEntries
+
+
+// ------------------------------------------------------------------------------------------------
+// Test load() with missing and malformed cache files.
+void
+geomodelgrids::serial::TestMetadataCache::testLoadBad(void) {
+    const char* const filename = "metadata-cache-bad.txt";
+    std::remove(filename);
+
+    MetadataCache cache;
+    cache.load(filename);
+    CHECK(cache._entries.empty());
+
+    { // Wrong header
+        std::ofstream sout(filename);
+        sout << "some-other-file 1\n0\n";
+    } // Wrong header
+    cache.load(filename);
+    CHECK(cache._entries.empty());
+
+    { // Old version
+        std::ofstream sout(filename);
+        sout << "geomodelgrids-metadata-cache 1\n0\n";
+    } // Old version
+    cache.load(filename);
+    CHECK(cache._entries.empty());
+
+    { // Truncated entry
+        std::ofstream sout(filename);
+        sout << "geomodelgrids-metadata-cache 2\n1\n1:a\n5:Model\n1\n3:one\n";
+    } // Truncated entry
+    cache.load(filename);
+    CHECK(cache._entries.empty());
+
+    std::remove(filename);
+} // testLoadBad
+
+
+// ------------------------------------------------------------------------------------------------
+// Test createKey().
+void
+geomodelgrids::serial::TestMetadataCache::testCreateKey(void) {
+    const char* const modelFilename = "../../data/one-block-flat.h5";
+
+    const std::string key = MetadataCache::createKey(modelFilename, "EPSG:4326");
+    CHECK(size_t(16) == key.size());
+    CHECK(key == MetadataCache::createKey(modelFilename, "EPSG:4326"));
+    CHECK(key != MetadataCache::createKey(modelFilename, "EPSG:3311"));
+    CHECK(key != MetadataCache::createKey("../../data/one-block-topo.h5", "EPSG:4326"));
+
+    CHECK(MetadataCache::createKey("../../data/does-not-exist.h5", "EPSG:4326").empty());
+} // testCreateKey
+
+
+// End of file
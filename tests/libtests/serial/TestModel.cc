@@ -10,12 +10,14 @@
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
+#include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
 #include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
-#include <cmath> // USES fabs()
+#include <cmath> // USES fabs(), M_PI, cos(), sin()
 
 namespace geomodelgrids {
     namespace serial {
@@ -59,6 +61,10 @@ public:
     static
     void testContains(void);
 
+    /// Test inBoundingBox().
+    static
+    void testInBoundingBox(void);
+
     /// Test queryTopElevation().
     static
     void testQueryTopElevation(void);
@@ -75,6 +81,10 @@ public:
     static
     void testQueryVarXYZ(void);
 
+    /// Test query() with levels of multi-resolution pyramid selected by query resolution.
+    static
+    void testQueryResolution(void);
+
 }; // class TestModel
 
 // ------------------------------------------------------------------------------------------------
@@ -102,6 +112,9 @@ TEST_CASE("TestModel::testToModelXYZTopo", "[TestModel]") {
 TEST_CASE("TestModel::testContains", "[TestModel]") {
     geomodelgrids::serial::TestModel::testContains();
 }
+TEST_CASE("TestModel::testInBoundingBox", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testInBoundingBox();
+}
 TEST_CASE("TestModel::testQueryTopElevation", "[TestModel]") {
     geomodelgrids::serial::TestModel::testQueryTopElevation();
 }
@@ -114,6 +127,9 @@ TEST_CASE("TestModel::testQuery", "[TestModel]") {
 TEST_CASE("TestModel::testQueryVarXYZ", "[TestModel]") {
     geomodelgrids::serial::TestModel::testQueryVarXYZ();
 }
+TEST_CASE("TestModel::testQueryResolution", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testQueryResolution();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -130,6 +146,10 @@ geomodelgrids::serial::TestModel::testConstructor(void) {
     CHECK(0.0 == model._dims[0]);
     CHECK(0.0 == model._dims[1]);
     CHECK(0.0 == model._dims[2]);
+    CHECK(-HUGE_VAL == model._bbox[0]);
+    CHECK(+HUGE_VAL == model._bbox[1]);
+    CHECK(-HUGE_VAL == model._bbox[2]);
+    CHECK(+HUGE_VAL == model._bbox[3]);
     CHECK(nullptr == model._h5.get());
     CHECK(nullptr == model._info.get());
     CHECK(nullptr == model._surfaceTop.get());
@@ -467,6 +487,76 @@ geomodelgrids::serial::TestModel::testContains(void) {
 } // testContains
 
 
+// ------------------------------------------------------------------------------------------------
+// Test inBoundingBox().
+void
+geomodelgrids::serial::TestModel::testInBoundingBox(void) {
+    QueryStats stats;
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.setStats(&stats);
+    model.loadMetadata();
+    model.initialize();
+
+    { // inside domain
+        geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+        const size_t numPoints = points.getNumPoints();
+        const size_t spaceDim = 3;
+        const double* pointsLLE = points.getLatLonElev();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1] << ").");
+            CHECK(model.inBoundingBox(pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1]));
+        } // for
+    } // inside domain
+
+    { // densely sampled edges of domain
+        const size_t numSamples = 1001;
+        const size_t spaceDim = 3;
+        const double yazimuthRad = model._yazimuth * M_PI / 180.0;
+        std::vector<double> xyz;
+        for (size_t i = 0; i < numSamples; ++i) {
+            const double xModel = model._dims[0] * i / (numSamples-1);
+            const double yModel = model._dims[1] * i / (numSamples-1);
+            const double edgesModel[4][2] = {
+                { xModel, 0.0 }, { xModel, model._dims[1] }, { 0.0, yModel }, { model._dims[0], yModel },
+            };
+            for (size_t iEdge = 0; iEdge < 4; ++iEdge) {
+                xyz.push_back(+edgesModel[iEdge][0]*cos(yazimuthRad) + edgesModel[iEdge][1]*sin(yazimuthRad) +
+                              model._origin[0]);
+                xyz.push_back(-edgesModel[iEdge][0]*sin(yazimuthRad) + edgesModel[iEdge][1]*cos(yazimuthRad) +
+                              model._origin[1]);
+                xyz.push_back(0.0);
+            } // for
+        } // for
+        const size_t numPoints = xyz.size() / spaceDim;
+        model._crsTransformer->inverse_transform(xyz.data(), numPoints);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for point (" << xyz[iPt*spaceDim+0] << ", " << xyz[iPt*spaceDim+1] << ").");
+            CHECK(model.inBoundingBox(xyz[iPt*spaceDim+0], xyz[iPt*spaceDim+1]));
+        } // for
+    } // densely sampled edges of domain
+
+    { // far outside domain
+        const size_t numPoints = 3;
+        const double pointsLL[numPoints*2] = {
+            0.0, 0.0,
+            -35.0, 118.0,
+            35.0, -100.0,
+        };
+
+        stats.reset();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for point (" << pointsLL[iPt*2+0] << ", " << pointsLL[iPt*2+1] << ").");
+            CHECK(!model.inBoundingBox(pointsLL[iPt*2+0], pointsLL[iPt*2+1]));
+            CHECK(!model.contains(pointsLL[iPt*2+0], pointsLL[iPt*2+1], 0.0));
+            CHECK(!model.containsIn(pointsLL[iPt*2+0], pointsLL[iPt*2+1]));
+        } // for
+        CHECK(size_t(0) == stats.numTransforms);
+    } // far outside domain
+} // testInBoundingBox
+
+
 // ------------------------------------------------------------------------------------------------
 // Test queryTopElevation().
 void
@@ -611,4 +701,84 @@ geomodelgrids::serial::TestModel::testQueryVarXYZ(void) {
 } // testQueryVarXYZ
 
 
+// ------------------------------------------------------------------------------------------------
+// Test query() with levels of multi-resolution pyramid selected by query resolution.
+void
+geomodelgrids::serial::TestModel::testQueryResolution(void) {
+    Model model;
+    CHECK(0.0 == model.getQueryResolution());
+    CHECK_THROWS_AS(model.setQueryResolution(-1.0), std::invalid_argument);
+
+    const double resolution = 30.0e+3;
+    model.setQueryResolution(resolution);
+    CHECK(resolution == model.getQueryResolution());
+
+    model.open("../../data/three-blocks-topo-pyramid.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+
+    // Surfaces: 5 km -> 10 km (level 1) -> 20 km (level 2)
+    const std::shared_ptr<Surface>& surfaceTop = model.getTopSurface();
+    REQUIRE(surfaceTop);
+    CHECK(size_t(2) == surfaceTop->getLevel());
+    CHECK(std::string("pyramid/level_2/surfaces/top_surface") == surfaceTop->getPath());
+    CHECK(20.0e+3 == surfaceTop->getResolutionX());
+    CHECK(size_t(4) == surfaceTop->getDims()[0]);
+    CHECK(size_t(7) == surfaceTop->getDims()[1]);
+    REQUIRE(model.getTopoBathy());
+    CHECK(size_t(2) == model.getTopoBathy()->getLevel());
+
+    // Blocks (sorted by z_top): top 10 km -> 20 km (level 1) -> 40 km (level 2); middle 20 km -> 40 km (level
+    // 1); bottom 30 km -> 60 km (level 1).
+    const size_t numBlocks = 3;
+    const char* const namesE[numBlocks] = { "top", "middle", "bottom" };
+    const size_t levelsE[numBlocks] = { 1, 0, 0 };
+    const double resolutionE[numBlocks] = { 20.0e+3, 20.0e+3, 30.0e+3 };
+    const std::vector<std::shared_ptr<Block> >& blocks = model.getBlocks();
+    REQUIRE(numBlocks == blocks.size());
+    for (size_t i = 0; i < numBlocks; ++i) {
+        INFO("Mismatch for block " << namesE[i] << ".");
+        REQUIRE(blocks[i]);
+        CHECK(std::string(namesE[i]) == blocks[i]->getName());
+        CHECK(levelsE[i] == blocks[i]->getLevel());
+        CHECK(resolutionE[i] == blocks[i]->getResolutionX());
+        CHECK(resolutionE[i] == blocks[i]->getResolutionY());
+    } // for
+
+    // Values are linear, so interpolation on coarser levels is exact.
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* values = model.query(pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+
+        const double tolerance = 1.0e-5;
+        { // Value 0
+            const double valueE = points.computeValueOne(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 0.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = points.computeValueTwo(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 1.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 1
+    } // for
+} // testQueryResolution
+
+
 // End of file
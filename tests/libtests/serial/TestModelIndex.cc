@@ -0,0 +1,144 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::ModelIndex.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/ModelIndex.hh" // USES ModelIndex
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm> // USES std::find(), std::is_sorted()
+#include <cmath> // USES HUGE_VAL
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestModelIndex;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestModelIndex {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test initialize() and getCandidates().
+    static
+    void testGetCandidates(void);
+
+    /// Test getCandidates() with model with unbounded bounding box.
+    static
+    void testUnbounded(void);
+
+}; // class TestModelIndex
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestModelIndex::testConstructor", "[TestModelIndex]") {
+    geomodelgrids::serial::TestModelIndex::testConstructor();
+}
+TEST_CASE("TestModelIndex::testGetCandidates", "[TestModelIndex]") {
+    geomodelgrids::serial::TestModelIndex::testGetCandidates();
+}
+TEST_CASE("TestModelIndex::testUnbounded", "[TestModelIndex]") {
+    geomodelgrids::serial::TestModelIndex::testUnbounded();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestModelIndex::testConstructor(void) {
+    ModelIndex index;
+
+    CHECK(size_t(0) == index._numCells[0]);
+    CHECK(size_t(0) == index._numCells[1]);
+    CHECK(index._cells.empty());
+    CHECK(index._unbounded.empty());
+    CHECK(index.getCandidates(0.0, 0.0).empty());
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize() and getCandidates().
+void
+geomodelgrids::serial::TestModelIndex::testGetCandidates(void) {
+    // Tiles on a 4x3 grid with a regional model (highest priority) overlapping several tiles.
+    const size_t numTilesX = 4;
+    const size_t numTilesY = 3;
+    const size_t numModels = 1 + numTilesX*numTilesY;
+    std::vector<double> bboxes(numModels*4);
+    bboxes[0] = -118.5;bboxes[1] = -116.2;bboxes[2] = 33.4;bboxes[3] = 35.1;
+    for (size_t iX = 0; iX < numTilesX; ++iX) {
+        for (size_t iY = 0; iY < numTilesY; ++iY) {
+            double* bbox = &bboxes[(1+iX*numTilesY+iY)*4];
+            bbox[0] = -122.0 + 2.0*iX;
+            bbox[1] = -120.0 + 2.0*iX;
+            bbox[2] = 32.0 + 1.5*iY;
+            bbox[3] = 33.5 + 1.5*iY;
+        } // for
+    } // for
+
+    ModelIndex index;
+    index.initialize(bboxes.data(), numModels);
+    CHECK(index._numCells[0]*index._numCells[1] > size_t(1));
+
+    // Candidates include every model with a bounding box containing the point, in priority order.
+    const size_t numPointsX = 101;
+    const size_t numPointsY = 87;
+    for (size_t iPtX = 0; iPtX < numPointsX; ++iPtX) {
+        const double x = -123.0 + 10.0*iPtX/(numPointsX-1);
+        for (size_t iPtY = 0; iPtY < numPointsY; ++iPtY) {
+            const double y = 31.0 + 6.5*iPtY/(numPointsY-1);
+            const std::vector<size_t>& candidates = index.getCandidates(x, y);
+            INFO("Mismatch for point (" << x << ", " << y << ").");
+            CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+            for (size_t iModel = 0; iModel < numModels; ++iModel) {
+                const double* bbox = &bboxes[iModel*4];
+                if ((x >= bbox[0]) && (x <= bbox[1]) && (y >= bbox[2]) && (y <= bbox[3])) {
+                    INFO("Missing model " << iModel << ".");
+                    CHECK(candidates.end() != std::find(candidates.begin(), candidates.end(), iModel));
+                } // if
+            } // for
+        } // for
+    } // for
+
+    // Points outside all models.
+    CHECK(index.getCandidates(-125.0, 34.0).empty());
+    CHECK(index.getCandidates(-120.0, 40.0).empty());
+    CHECK(index.getCandidates(NAN, 34.0).empty());
+} // testGetCandidates
+
+
+// ------------------------------------------------------------------------------------------------
+// Test getCandidates() with model with unbounded bounding box.
+void
+geomodelgrids::serial::TestModelIndex::testUnbounded(void) {
+    const size_t numModels = 3;
+    const double bboxes[numModels*4] = {
+        0.0, 10.0, 0.0, 10.0,
+        -HUGE_VAL, +HUGE_VAL, -HUGE_VAL, +HUGE_VAL,
+        5.0, 20.0, 5.0, 20.0,
+    };
+
+    ModelIndex index;
+    index.initialize(bboxes, numModels);
+
+    { // Point in first and last models.
+        const std::vector<size_t>& candidates = index.getCandidates(7.0, 7.0);
+        REQUIRE(size_t(3) == candidates.size());
+        CHECK(size_t(0) == candidates[0]);
+        CHECK(size_t(1) == candidates[1]);
+        CHECK(size_t(2) == candidates[2]);
+    } // Point in first and last models.
+
+    { // Point only in unbounded model.
+        const std::vector<size_t>& candidates = index.getCandidates(-100.0, 50.0);
+        REQUIRE(size_t(1) == candidates.size());
+        CHECK(size_t(1) == candidates[0]);
+    } // Point only in unbounded model.
+} // testUnbounded
+
+
+// End of file
@@ -0,0 +1,487 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::ModelWriter.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/ModelWriter.hh" // USES ModelWriter
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm> // USES std::min()
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestModelWriter;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestModelWriter {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test accessors.
+    static
+    void testAccessors(void);
+
+    /// Test writing model with uniform resolution one hyperslab at a time without threads.
+    static
+    void testWriteSerial(void);
+
+    /// Test writing model with variable resolution one hyperslab at a time without threads.
+    static
+    void testWriteVarXYZ(void);
+
+    /// Test writing model with chunks compressed in parallel.
+    static
+    void testWriteParallel(void);
+
+    /// Test writing model with threads and hyperslabs not aligned with chunks.
+    static
+    void testWriteParallelUnaligned(void);
+
+    /// Test errors.
+    static
+    void testErrors(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Copy model by reading it with Model and writing it with ModelWriter.
+     *
+     * @param[in] filenameIn Name of model to copy.
+     * @param[in] filenameOut Name of copy.
+     * @param[in] numThreads Number of threads used to compress chunks.
+     * @param[in] slabSize Number of points along x axis in each hyperslab.
+     */
+    static
+    void _copyModel(const char* filenameIn,
+                    const char* filenameOut,
+                    const size_t numThreads,
+                    const size_t slabSize);
+
+    /** Check that metadata and values in copy match the original model.
+     *
+     * @param[in] filenameIn Name of original model.
+     * @param[in] filenameOut Name of copy.
+     */
+    static
+    void _checkCopy(const char* filenameIn,
+                    const char* filenameOut);
+
+    /** Check that values in datasets match.
+     *
+     * @param[in] h5In Original model.
+     * @param[in] h5Out Copy.
+     * @param[in] path Full path to dataset.
+     */
+    static
+    void _checkDataset(HDF5& h5In,
+                       HDF5& h5Out,
+                       const char* path);
+
+    /** Create axis from grid spacing or coordinates.
+     *
+     * @param[in] numPoints Number of points along axis.
+     * @param[in] resolution Grid spacing.
+     * @param[in] coordinates Coordinates of points (nullptr for uniform grid spacing).
+     * @returns Axis.
+     */
+    static
+    ModelWriter::Axis _axis(const size_t numPoints,
+                            const double resolution,
+                            const double* coordinates);
+
+}; // class TestModelWriter
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestModelWriter::testConstructor", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testConstructor();
+}
+TEST_CASE("TestModelWriter::testAccessors", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testAccessors();
+}
+TEST_CASE("TestModelWriter::testWriteSerial", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testWriteSerial();
+}
+TEST_CASE("TestModelWriter::testWriteVarXYZ", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testWriteVarXYZ();
+}
+TEST_CASE("TestModelWriter::testWriteParallel", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testWriteParallel();
+}
+TEST_CASE("TestModelWriter::testWriteParallelUnaligned", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testWriteParallelUnaligned();
+}
+TEST_CASE("TestModelWriter::testErrors", "[TestModelWriter]") {
+    geomodelgrids::serial::TestModelWriter::testErrors();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestModelWriter::testConstructor(void) {
+    ModelWriter writer;
+
+    CHECK(nullptr == writer._h5.get());
+    CHECK(writer._datasets.empty());
+    CHECK(size_t(0) == writer._numValues);
+    CHECK(size_t(1) == writer._numThreads);
+    CHECK(4 == writer._compression);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test accessors.
+void
+geomodelgrids::serial::TestModelWriter::testAccessors(void) {
+    ModelWriter writer;
+
+    writer.setCompression(0);
+    CHECK(0 == writer._compression);
+    writer.setCompression(9);
+    CHECK(9 == writer._compression);
+    CHECK_THROWS_AS(writer.setCompression(10), std::invalid_argument);
+    CHECK_THROWS_AS(writer.setCompression(-1), std::invalid_argument);
+
+    writer.setNumThreads(4);
+    CHECK(size_t(4) == writer._numThreads);
+    writer.setNumThreads(0);
+    CHECK(size_t(1) == writer._numThreads);
+
+    const ModelWriter::Axis uniform = ModelWriter::Axis::uniform(5, 2.0);
+    CHECK(size_t(5) == uniform.numPoints);
+    CHECK(2.0 == uniform.resolution);
+    CHECK(uniform.coordinates.empty());
+
+    const std::vector<double> coordinates = { 0.0, 1.0, 3.0 };
+    const ModelWriter::Axis variable = ModelWriter::Axis::variable(coordinates);
+    CHECK(size_t(3) == variable.numPoints);
+    CHECK(0.0 == variable.resolution);
+    CHECK(coordinates == variable.coordinates);
+} // testAccessors
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing model with uniform resolution one hyperslab at a time without threads.
+void
+geomodelgrids::serial::TestModelWriter::testWriteSerial(void) {
+    const char* const filenameIn = "../../data/three-blocks-topo.h5";
+    const char* const filenameOut = "modelwriter-serial.h5";
+
+    _copyModel(filenameIn, filenameOut, 1, 2);
+    _checkCopy(filenameIn, filenameOut);
+} // testWriteSerial
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing model with variable resolution one hyperslab at a time without threads.
+void
+geomodelgrids::serial::TestModelWriter::testWriteVarXYZ(void) {
+    const char* const filenameIn = "../../data/three-blocks-topo-varxyz.h5";
+    const char* const filenameOut = "modelwriter-varxyz.h5";
+
+    _copyModel(filenameIn, filenameOut, 1, 3);
+    _checkCopy(filenameIn, filenameOut);
+} // testWriteVarXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing model with chunks compressed in parallel.
+void
+geomodelgrids::serial::TestModelWriter::testWriteParallel(void) {
+    const char* const filenameIn = "../../data/three-blocks-topo.h5";
+    const char* const filenameOut = "modelwriter-parallel.h5";
+
+    _copyModel(filenameIn, filenameOut, 4, 4);
+    _checkCopy(filenameIn, filenameOut);
+
+    if (HDF5::canWriteChunks()) {
+        HDF5 h5;
+        h5.open(filenameOut, H5F_ACC_RDONLY);
+        hsize_t* chunk = nullptr;
+        int ndims = 0;
+        h5.getDatasetChunk(&chunk, &ndims, "blocks/top");
+        REQUIRE(4 == ndims);
+        CHECK(hsize_t(2) == chunk[0]);
+        delete[] chunk;chunk = nullptr;
+        h5.close();
+    } // if
+} // testWriteParallel
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing model with threads and hyperslabs not aligned with chunks.
+void
+geomodelgrids::serial::TestModelWriter::testWriteParallelUnaligned(void) {
+    const char* const filenameIn = "../../data/one-block-topo.h5";
+    const char* const filenameOut = "modelwriter-unaligned.h5";
+
+    _copyModel(filenameIn, filenameOut, 3, 3);
+    _checkCopy(filenameIn, filenameOut);
+} // testWriteParallelUnaligned
+
+
+// ------------------------------------------------------------------------------------------------
+// Test errors.
+void
+geomodelgrids::serial::TestModelWriter::testErrors(void) {
+    ModelWriter writer;
+
+    ModelInfo info;
+    const ModelWriter::Axis axis = ModelWriter::Axis::uniform(3, 1.0);
+    CHECK_THROWS_AS(writer.writeInfo(info), std::logic_error);
+    CHECK_THROWS_AS(writer.createSurface("top_surface", axis, axis), std::logic_error);
+
+    writer.open("modelwriter-errors.h5");
+    CHECK_THROWS_AS(writer.createBlock("block", axis, axis, axis, 0.0), std::logic_error);
+
+    const std::vector<std::string> names = { "one", "two" };
+    const std::vector<std::string> units = { "m" };
+    const double origin[2] = { 0.0, 0.0 };
+    const double dims[3] = { 2.0, 2.0, 2.0 };
+    CHECK_THROWS_AS(writer.writeDomain(names, units, "EPSG:26910", origin, 0.0, dims), std::invalid_argument);
+
+    const std::vector<std::string> unitsOkay = { "m", "m/s" };
+    writer.writeDomain(names, unitsOkay, "EPSG:26910", origin, 0.0, dims);
+    CHECK_THROWS_AS(writer.createBlock("block", ModelWriter::Axis::uniform(3, 0.0), axis, axis, 0.0),
+                    std::invalid_argument);
+
+    const float values[3*3*3*2] = { 0.0 };
+    const size_t sliceOrigin[3] = { 0, 0, 0 };
+    const size_t sliceDims[3] = { 3, 3, 3 };
+    CHECK_THROWS_AS(writer.writeBlock("missing", values, sliceOrigin, sliceDims), std::logic_error);
+
+    writer.createBlock("block", axis, axis, axis, 0.0);
+    const size_t sliceOriginBad[3] = { 1, 0, 0 };
+    CHECK_THROWS_AS(writer.writeBlock("block", values, sliceOriginBad, sliceDims), std::length_error);
+    writer.close();
+} // testErrors
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy model by reading it with Model and writing it with ModelWriter.
+void
+geomodelgrids::serial::TestModelWriter::_copyModel(const char* filenameIn,
+                                                   const char* filenameOut,
+                                                   const size_t numThreads,
+                                                   const size_t slabSize) {
+    Model model;
+    model.open(filenameIn, Model::READ);
+    model.loadMetadata();
+
+    HDF5 h5;
+    h5.open(filenameIn, H5F_ACC_RDONLY);
+
+    ModelWriter writer;
+    writer.setNumThreads(numThreads);
+    writer.setCompression(6);
+    writer.open(filenameOut);
+    writer.writeInfo(*model.getInfo());
+    writer.writeDomain(model.getValueNames(), model.getValueUnits(), model.getCRSString(),
+                       model.getOrigin(), model.getYAzimuth(), model.getDims());
+
+    const size_t chunkSurface[2] = { 2, 2 };
+    const std::shared_ptr<Surface> surfaces[2] = { model.getTopSurface(), model.getTopoBathy() };
+    const char* const surfaceNames[2] = { "top_surface", "topography_bathymetry" };
+    for (size_t iSurface = 0; iSurface < 2; ++iSurface) {
+        const std::shared_ptr<Surface>& surface = surfaces[iSurface];
+        if (!surface) { continue; }
+
+        const size_t* dims = surface->getDims();
+        writer.createSurface(surfaceNames[iSurface],
+                             _axis(dims[0], surface->getResolutionX(), surface->getCoordinatesX()),
+                             _axis(dims[1], surface->getResolutionY(), surface->getCoordinatesY()),
+                             chunkSurface);
+
+        const std::string path = std::string("surfaces/") + surfaceNames[iSurface];
+        for (size_t ix = 0; ix < dims[0]; ix += slabSize) {
+            const hsize_t origin[3] = { ix, 0, 0 };
+            const hsize_t count[3] = { std::min(slabSize, dims[0]-ix), dims[1], 1 };
+            std::vector<float> elevation(count[0]*count[1]);
+            h5.readDatasetHyperslab(&elevation[0], path.c_str(), origin, count, 3, H5T_NATIVE_FLOAT);
+
+            const size_t sliceOrigin[2] = { ix, 0 };
+            const size_t sliceDims[2] = { count[0], count[1] };
+            writer.writeSurface(surfaceNames[iSurface], &elevation[0], sliceOrigin, sliceDims);
+        } // for
+    } // for
+
+    const size_t chunkBlock[3] = { 2, 2, 2 };
+    const std::vector<std::shared_ptr<Block> >& blocks = model.getBlocks();
+    for (size_t iBlock = 0; iBlock < blocks.size(); ++iBlock) {
+        const Block& block = *blocks[iBlock];
+        const size_t* dims = block.getDims();
+        const size_t numValues = block.getNumValues();
+        writer.createBlock(block.getName().c_str(),
+                           _axis(dims[0], block.getResolutionX(), block.getCoordinatesX()),
+                           _axis(dims[1], block.getResolutionY(), block.getCoordinatesY()),
+                           _axis(dims[2], block.getResolutionZ(), block.getCoordinatesZ()),
+                           block.getZTop(), chunkBlock);
+
+        const std::string path = std::string("blocks/") + block.getName();
+        for (size_t ix = 0; ix < dims[0]; ix += slabSize) {
+            const hsize_t origin[4] = { ix, 0, 0, 0 };
+            const hsize_t count[4] = { std::min(slabSize, dims[0]-ix), dims[1], dims[2], numValues };
+            std::vector<float> values(count[0]*count[1]*count[2]*count[3]);
+            h5.readDatasetHyperslab(&values[0], path.c_str(), origin, count, 4, H5T_NATIVE_FLOAT);
+
+            const size_t sliceOrigin[3] = { ix, 0, 0 };
+            const size_t sliceDims[3] = { count[0], count[1], count[2] };
+            writer.writeBlock(block.getName().c_str(), &values[0], sliceOrigin, sliceDims);
+        } // for
+    } // for
+
+    writer.close();
+    h5.close();
+    model.close();
+} // _copyModel
+
+
+// ------------------------------------------------------------------------------------------------
+// Check that metadata and values in copy match the original model.
+void
+geomodelgrids::serial::TestModelWriter::_checkCopy(const char* filenameIn,
+                                                   const char* filenameOut) {
+    Model modelE;
+    modelE.open(filenameIn, Model::READ);
+    modelE.loadMetadata();
+
+    Model model;
+    model.open(filenameOut, Model::READ);
+    model.loadMetadata();
+
+    const ModelInfo& infoE = *modelE.getInfo();
+    const ModelInfo& info = *model.getInfo();
+    CHECK(infoE.getTitle() == info.getTitle());
+    CHECK(infoE.getId() == info.getId());
+    CHECK(infoE.getDescription() == info.getDescription());
+    CHECK(infoE.getKeywords() == info.getKeywords());
+    CHECK(infoE.getHistory() == info.getHistory());
+    CHECK(infoE.getComment() == info.getComment());
+    CHECK(infoE.getCreatorName() == info.getCreatorName());
+    CHECK(infoE.getCreatorInstitution() == info.getCreatorInstitution());
+    CHECK(infoE.getCreatorEmail() == info.getCreatorEmail());
+    CHECK(infoE.getAcknowledgement() == info.getAcknowledgement());
+    CHECK(infoE.getAuthors() == info.getAuthors());
+    CHECK(infoE.getReferences() == info.getReferences());
+    CHECK(infoE.getRepositoryName() == info.getRepositoryName());
+    CHECK(infoE.getRepositoryURL() == info.getRepositoryURL());
+    CHECK(infoE.getRepositoryDOI() == info.getRepositoryDOI());
+    CHECK(infoE.getVersion() == info.getVersion());
+    CHECK(infoE.getLicense() == info.getLicense());
+    CHECK(infoE.getAuxiliary() == info.getAuxiliary());
+
+    CHECK(modelE.getValueNames() == model.getValueNames());
+    CHECK(modelE.getValueUnits() == model.getValueUnits());
+    CHECK(modelE.getCRSString() == model.getCRSString());
+    CHECK(modelE.getYAzimuth() == model.getYAzimuth());
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK(modelE.getOrigin()[i] == model.getOrigin()[i]);
+    } // for
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(modelE.getDims()[i] == model.getDims()[i]);
+    } // for
+
+    HDF5 h5E;
+    h5E.open(filenameIn, H5F_ACC_RDONLY);
+    HDF5 h5;
+    h5.open(filenameOut, H5F_ACC_RDONLY);
+
+    CHECK(bool(modelE.getTopSurface()) == bool(model.getTopSurface()));
+    if (modelE.getTopSurface()) {
+        CHECK(modelE.getTopSurface()->getResolutionX() == model.getTopSurface()->getResolutionX());
+        CHECK(modelE.getTopSurface()->getResolutionY() == model.getTopSurface()->getResolutionY());
+        _checkDataset(h5E, h5, "surfaces/top_surface");
+    } // if
+    CHECK(bool(modelE.getTopoBathy()) == bool(model.getTopoBathy()));
+    if (modelE.getTopoBathy()) {
+        _checkDataset(h5E, h5, "surfaces/topography_bathymetry");
+    } // if
+
+    const std::vector<std::shared_ptr<Block> >& blocksE = modelE.getBlocks();
+    const std::vector<std::shared_ptr<Block> >& blocks = model.getBlocks();
+    REQUIRE(blocksE.size() == blocks.size());
+    for (size_t iBlock = 0; iBlock < blocksE.size(); ++iBlock) {
+        INFO("Checking block " << blocksE[iBlock]->getName());
+        CHECK(blocksE[iBlock]->getName() == blocks[iBlock]->getName());
+        CHECK(blocksE[iBlock]->getResolutionX() == blocks[iBlock]->getResolutionX());
+        CHECK(blocksE[iBlock]->getResolutionY() == blocks[iBlock]->getResolutionY());
+        CHECK(blocksE[iBlock]->getResolutionZ() == blocks[iBlock]->getResolutionZ());
+        CHECK(blocksE[iBlock]->getZTop() == blocks[iBlock]->getZTop());
+        CHECK(blocksE[iBlock]->getZBottom() == blocks[iBlock]->getZBottom());
+        const size_t* dims = blocksE[iBlock]->getDims();
+        if (blocksE[iBlock]->getCoordinatesZ()) {
+            REQUIRE(blocks[iBlock]->getCoordinatesZ());
+            for (size_t i = 0; i < dims[2]; ++i) {
+                CHECK(blocksE[iBlock]->getCoordinatesZ()[i] == blocks[iBlock]->getCoordinatesZ()[i]);
+            } // for
+        } // if
+        _checkDataset(h5E, h5, (std::string("blocks/") + blocksE[iBlock]->getName()).c_str());
+    } // for
+
+    h5.close();
+    h5E.close();
+    model.close();
+    modelE.close();
+} // _checkCopy
+
+
+// ------------------------------------------------------------------------------------------------
+// Check that values in datasets match.
+void
+geomodelgrids::serial::TestModelWriter::_checkDataset(HDF5& h5In,
+                                                      HDF5& h5Out,
+                                                      const char* path) {
+    INFO("Checking dataset " << path);
+
+    hsize_t* dimsE = nullptr;
+    int ndimsE = 0;
+    h5In.getDatasetDims(&dimsE, &ndimsE, path);
+    hsize_t* dims = nullptr;
+    int ndims = 0;
+    h5Out.getDatasetDims(&dims, &ndims, path);
+    REQUIRE(ndimsE == ndims);
+
+    size_t size = 1;
+    for (int i = 0; i < ndims; ++i) {
+        CHECK(dimsE[i] == dims[i]);
+        size *= dims[i];
+    } // for
+
+    const std::vector<hsize_t> origin(ndims, 0);
+    std::vector<float> valuesE(size);
+    h5In.readDatasetHyperslab(&valuesE[0], path, &origin[0], dimsE, ndims, H5T_NATIVE_FLOAT);
+    std::vector<float> values(size);
+    h5Out.readDatasetHyperslab(&values[0], path, &origin[0], dims, ndims, H5T_NATIVE_FLOAT);
+    for (size_t i = 0; i < size; ++i) {
+        CHECK(valuesE[i] == values[i]);
+    } // for
+
+    delete[] dimsE;dimsE = nullptr;
+    delete[] dims;dims = nullptr;
+} // _checkDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Create axis from grid spacing or coordinates.
+geomodelgrids::serial::ModelWriter::Axis
+geomodelgrids::serial::TestModelWriter::_axis(const size_t numPoints,
+                                              const double resolution,
+                                              const double* coordinates) {
+    return (coordinates) ?
+           ModelWriter::Axis::variable(std::vector<double>(coordinates, coordinates+numPoints)) :
+           ModelWriter::Axis::uniform(numPoints, resolution);
+} // _axis
+
+
+// End of file
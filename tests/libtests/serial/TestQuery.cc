@@ -7,12 +7,21 @@
 #include "tests/data/ModelPoints.hh"
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
+#include "geomodelgrids/serial/MetadataCache.hh" // USES MetadataCache
+#include "geomodelgrids/serial/ModelIndex.hh" // USES ModelIndex
+#include "geomodelgrids/serial/QueryStats.hh" // USES QueryStats
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath>
+#include <stdexcept> // USES std::length_error
+#include <cstdio> // USES std::remove()
+#include <thread> // USES std::thread
 
 namespace geomodelgrids {
     namespace serial {
@@ -60,6 +69,26 @@ public:
     static
     void testQuerySquashTopoBathy(void);
 
+    /// Test queryColumn().
+    static
+    void testQueryColumn(void);
+
+    /// Test queryPoints().
+    static
+    void testQueryPoints(void);
+
+    /// Test queryTopElevations() and queryTopoBathyElevations().
+    static
+    void testQueryElevations(void);
+
+    /// Test lazy opening of models and setMetadataCache().
+    static
+    void testMetadataCache(void);
+
+    /// Test opening models lazily from queries on multiple threads.
+    static
+    void testConcurrentQueries(void);
+
 }; // class TestQuery
 
 // ------------------------------------------------------------------------------------------------
@@ -90,6 +119,21 @@ TEST_CASE("TestQuery::testQuerySquashTop", "[TestQuery]") {
 TEST_CASE("TestQuery::testQuerySquashTopoBathy", "[TestQuery]") {
     geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy();
 }
+TEST_CASE("TestQuery::testQueryColumn", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryColumn();
+}
+TEST_CASE("TestQuery::testQueryPoints", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryPoints();
+}
+TEST_CASE("TestQuery::testQueryElevations", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryElevations();
+}
+TEST_CASE("TestQuery::testMetadataCache", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testMetadataCache();
+}
+TEST_CASE("TestQuery::testConcurrentQueries", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testConcurrentQueries();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -115,6 +159,43 @@ geomodelgrids::serial::TestQuery::testAccessors(void) {
 
     query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
     CHECK(Query::SQUASH_TOPOGRAPHY_BATHYMETRY == query._squash);
+
+    const size_t blockDims[3] = { 8, 0, 4 };
+    query.setBlockHyperslabDims(blockDims, 3);
+    REQUIRE(3 == query._blockHyperslabDims.size());
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(blockDims[i] == query._blockHyperslabDims[i]);
+    } // for
+    CHECK_THROWS_AS(query.setBlockHyperslabDims(blockDims, 2), std::length_error);
+
+    const size_t surfaceDims[2] = { 0, 16 };
+    query.setSurfaceHyperslabDims(surfaceDims, 2);
+    REQUIRE(2 == query._surfaceHyperslabDims.size());
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK(surfaceDims[i] == query._surfaceHyperslabDims[i]);
+    } // for
+    CHECK_THROWS_AS(query.setSurfaceHyperslabDims(surfaceDims, 3), std::length_error);
+
+    const size_t maxBytes = 1048576;
+    query.setHyperslabMaxBytes(maxBytes);
+    CHECK(maxBytes == query._hyperslabMaxBytes);
+
+    query.setHyperslabPrefetch(true);
+    CHECK(query._hyperslabPrefetch);
+
+    query.setSharedCache("/geomodelgrids-cache", 65536, 1024);
+    CHECK(std::string("/geomodelgrids-cache") == query._sharedCacheName);
+    CHECK(size_t(65536) == query._sharedCacheBytes);
+    CHECK(size_t(1024) == query._sharedCacheSlotBytes);
+
+    CHECK(!query.getStats());
+    query.setStatsOn(true);
+    REQUIRE(query.getStats());
+    query.getStats()->numPoints = 4;
+    query.resetStats();
+    CHECK(size_t(0) == query.getStats()->numPoints);
+    query.setStatsOn(false);
+    CHECK(!query.getStats());
 } // testAccessors
 
 
@@ -695,4 +776,467 @@ geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy(void) {
 } // TestQuerySquash
 
 
+// ------------------------------------------------------------------------------------------------
+// Test queryColumn().
+void
+geomodelgrids::serial::TestQuery::testQueryColumn(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+    query.setSquashMinElev(geomodelgrids::testdata::ModelPoints::squashMinElev);
+    query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+
+    std::vector<double> elevations;
+    std::vector<double> values;
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryColumn(nullptr, &values, 0.0, 0.0, 0.0, -1.0));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryColumn(&elevations, &values, 0.0, 0.0, 0.0, 1.0));
+
+    const double tolerance = 1.0e-5;
+    { // Three Block Topo
+        const size_t numPoints = pointsThree.getNumPoints();
+        const double* pointsLLE = pointsThree.getLatLonElev();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double x = pointsLLE[iPt*spaceDim+0];
+            const double y = pointsLLE[iPt*spaceDim+1];
+            const double zTop = query.queryTopoBathyElevation(x, y) - 1.0;
+            const double zBottom = zTop - 40.0e+3;
+            const int err = query.queryColumn(&elevations, &values, x, y, zTop, zBottom);
+            REQUIRE(!err);
+
+            const size_t numColumnPoints = elevations.size();
+            REQUIRE(numColumnPoints >= 2);
+            REQUIRE(numColumnPoints*numValues == values.size());
+            CHECK(zTop == elevations.front());
+            CHECK(zBottom == elevations.back());
+
+            // Values between points in the column match querying the points individually.
+            for (size_t iSeg = 0; iSeg+1 < numColumnPoints; ++iSeg) {
+                REQUIRE(elevations[iSeg] >= elevations[iSeg+1]);
+                if (elevations[iSeg] == elevations[iSeg+1]) {
+                    continue;
+                } // if
+                for (double wt = 0.25; wt < 1.0; wt += 0.25) {
+                    const double z = elevations[iSeg] + wt * (elevations[iSeg+1] - elevations[iSeg]);
+                    double valuesE[numValues];
+                    // Points in the column outside the models have NODATA_VALUE in both the column and query().
+                    REQUIRE(geomodelgrids::utils::ErrorHandler::ERROR != query.query(valuesE, x, y, z));
+
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        const double vTop = values[iSeg*numValues+iValue];
+                        const double vBot = values[(iSeg+1)*numValues+iValue];
+                        const double value = vTop + wt * (vBot - vTop);
+                        INFO("Mismatch at point (" << x << ", " << y << ", " << z << ") for value '"
+                                                   << valueNames[iValue] << "' in three-blocks-topo.");
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                        CHECK_THAT(value, Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // Three Block Topo
+
+    { // Outside domain
+        geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+        const size_t numPoints = pointsOutside.getNumPoints();
+        const double* pointsLLE = pointsOutside.getLatLonElev();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double x = pointsLLE[iPt*spaceDim+0];
+            const double y = pointsLLE[iPt*spaceDim+1];
+            if (query.queryModelContains(x, y) >= 0) {
+                continue;
+            } // if
+            const int err = query.queryColumn(&elevations, &values, x, y, 0.0, -1.0e+3);
+            CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+            for (size_t i = 0; i < values.size(); ++i) {
+                CHECK(NODATA_VALUE == values[i]);
+            } // for
+        } // for
+    } // Outside domain
+} // testQueryColumn
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryPoints().
+void
+geomodelgrids::serial::TestQuery::testQueryPoints(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksSquashTopoBathyPoints pointsThree;
+    geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Points in and outside the models, interleaved as [numPoints][3].
+    std::vector<double> points;
+    points.insert(points.end(), pointsThree.getLatLonElev(),
+                  pointsThree.getLatLonElev()+pointsThree.getNumPoints()*spaceDim);
+    points.insert(points.end(), pointsOutside.getLatLonElev(),
+                  pointsOutside.getLatLonElev()+pointsOutside.getNumPoints()*spaceDim);
+    const size_t numPoints = points.size() / spaceDim;
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+    query.setSquashMinElev(geomodelgrids::testdata::ModelPoints::squashMinElev);
+    query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+
+    // Values with padding between points.
+    const size_t valuesStride = numValues + 1;
+    const double padding = 1.2345;
+    std::vector<double> values(numPoints*valuesStride, padding);
+    std::vector<int> status(numPoints);
+    size_t numOutside = 0;
+
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryPoints((double*)nullptr, valuesStride,
+                                                                         &points[0], &points[1], &points[2], spaceDim,
+                                                                         numPoints));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryPoints(&values[0], numValues-1, &points[0],
+                                                                         &points[1], &points[2], spaceDim,
+                                                                         numPoints));
+
+    const int err = query.queryPoints(&values[0], valuesStride, &points[0], &points[1], &points[2], spaceDim,
+                                      numPoints, &status[0], &numOutside);
+
+    // Points match querying the points individually.
+    const double tolerance = 1.0e-10;
+    size_t numOutsideE = 0;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double x = points[iPt*spaceDim+0];
+        const double y = points[iPt*spaceDim+1];
+        const double z = points[iPt*spaceDim+2];
+        double valuesE[numValues];
+        const int statusE = query.query(valuesE, x, y, z);
+        numOutsideE += (statusE) ? 1 : 0;
+        CHECK(statusE == status[iPt]);
+
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            INFO("Mismatch at point (" << x << ", " << y << ", " << z << ") for value '"
+                                       << valueNames[iValue] << "'.");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+            CHECK_THAT(values[iPt*valuesStride+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+        } // for
+        CHECK(padding == values[iPt*valuesStride+numValues]);
+    } // for
+    REQUIRE(numOutsideE > 0);
+    CHECK(numOutsideE == numOutside);
+    CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+
+    // Coordinates in separate arrays.
+    std::vector<double> x(numPoints);
+    std::vector<double> y(numPoints);
+    std::vector<double> z(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        x[iPt] = points[iPt*spaceDim+0];
+        y[iPt] = points[iPt*spaceDim+1];
+        z[iPt] = points[iPt*spaceDim+2];
+    } // for
+    std::vector<double> valuesSeparate(numPoints*numValues);
+    CHECK(geomodelgrids::utils::ErrorHandler::WARNING == query.queryPoints(&valuesSeparate[0], numValues, &x[0],
+                                                                           &y[0], &z[0], 1, numPoints));
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            CHECK(values[iPt*valuesStride+iValue] == valuesSeparate[iPt*numValues+iValue]);
+        } // for
+    } // for
+
+    // Single precision values are the double precision values rounded to single precision.
+    std::vector<float> valuesFloat(numPoints*numValues);
+    std::vector<int> statusFloat(numPoints);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryPoints((float*)nullptr, numValues, &x[0],
+                                                                         &y[0], &z[0], 1, numPoints));
+    CHECK(geomodelgrids::utils::ErrorHandler::WARNING == query.queryPoints(&valuesFloat[0], numValues, &x[0],
+                                                                           &y[0], &z[0], 1, numPoints,
+                                                                           &statusFloat[0]));
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        CHECK(status[iPt] == statusFloat[iPt]);
+        float valuesPt[numValues];
+        CHECK(status[iPt] == query.query(valuesPt, x[iPt], y[iPt], z[iPt]));
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            const float valueE = float(values[iPt*valuesStride+iValue]);
+            CHECK(valueE == valuesFloat[iPt*numValues+iValue]);
+            CHECK(valueE == valuesPt[iValue]);
+        } // for
+    } // for
+} // testQueryPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryTopElevations() and queryTopoBathyElevations().
+void
+geomodelgrids::serial::TestQuery::testQueryElevations(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 1;
+    const char* const valueNamesArray[numValues] = { "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Horizontal coordinates of points in and outside the models as [numPoints][2].
+    std::vector<double> points;
+    const geomodelgrids::testdata::ModelPoints* pointsAll[3] = { &pointsOne, &pointsThree, &pointsOutside };
+    for (size_t i = 0; i < 3; ++i) {
+        const double* xyz = pointsAll[i]->getLatLonElev();
+        for (size_t iPt = 0; iPt < pointsAll[i]->getNumPoints(); ++iPt) {
+            points.push_back(xyz[iPt*spaceDim+0]);
+            points.push_back(xyz[iPt*spaceDim+1]);
+        } // for
+    } // for
+    const size_t numPoints = points.size() / 2;
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+
+    std::vector<double> elevations(numPoints);
+    query.queryTopElevations(&elevations[0], &points[0], numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double elevationE = query.queryTopElevation(points[iPt*2+0], points[iPt*2+1]);
+        INFO("Mismatch in top elevation at point (" << points[iPt*2+0] << ", " << points[iPt*2+1] << ").");
+        CHECK(elevationE == elevations[iPt]);
+    } // for
+
+    query.queryTopoBathyElevations(&elevations[0], &points[0], numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double elevationE = query.queryTopoBathyElevation(points[iPt*2+0], points[iPt*2+1]);
+        INFO("Mismatch in topography/bathymetry elevation at point (" << points[iPt*2+0] << ", "
+                                                                       << points[iPt*2+1] << ").");
+        CHECK(elevationE == elevations[iPt]);
+    } // for
+} // testQueryElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Test lazy opening of models and setMetadataCache().
+void
+geomodelgrids::serial::TestQuery::testMetadataCache(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t numPoints = pointsThree.getNumPoints();
+    const double* xyz = pointsThree.getLatLonElev();
+    const size_t spaceDim = 3;
+
+    const char* const cacheFilename = "query-metadata-cache.txt";
+    std::remove(cacheFilename);
+
+    // Without cache entries, models are opened but not initialized for querying.
+    std::vector<double> valuesE(numPoints*numValues);
+    { // Populate cache
+        Query query;
+        query.setMetadataCache(cacheFilename);
+        query.initialize(filenames, valueNames, crs);
+        REQUIRE(numModels == query._modelsInitialized.size());
+        for (size_t iModel = 0; iModel < numModels; ++iModel) {
+            CHECK(query._models[iModel]);
+            CHECK_FALSE(query._modelsInitialized[iModel]);
+        } // for
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* pt = &xyz[iPt*spaceDim];
+            query.query(&valuesE[iPt*numValues], pt[0], pt[1], pt[2]);
+        } // for
+        query.finalize();
+    } // Populate cache
+
+    { // Use cache
+        Query query;
+        query.setMetadataCache(cacheFilename);
+        query.initialize(filenames, valueNames, crs);
+        for (size_t iModel = 0; iModel < numModels; ++iModel) {
+            CHECK_FALSE(query._models[iModel]);
+            CHECK_FALSE(query._modelsInitialized[iModel]);
+        } // for
+
+        std::vector<double> values(numValues);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* pt = &xyz[iPt*spaceDim];
+            query.query(&values[0], pt[0], pt[1], pt[2]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch for value " << iValue << " at point " << iPt << ".");
+                CHECK(valuesE[iPt*numValues+iValue] == values[iValue]);
+            } // for
+        } // for
+        CHECK((query._modelsInitialized[0] || query._modelsInitialized[1]));
+        for (size_t iModel = 0; iModel < numModels; ++iModel) {
+            CHECK(query._modelsInitialized[iModel] == bool(query._models[iModel]));
+        } // for
+        query.finalize();
+    } // Use cache
+
+    { // Missing model file is detected by initialize() even with a cache.
+        std::vector<std::string> filenamesBad(filenames);
+        filenamesBad.push_back("../../data/missing-model.h5");
+        Query query;
+        query.setMetadataCache(cacheFilename);
+        CHECK_THROWS_AS(query.initialize(filenamesBad, valueNames, crs), std::runtime_error);
+    } // Missing model
+
+    { // Cache entry with wrong title is replaced when the model is opened for querying.
+        MetadataCache cache;
+        cache.load(cacheFilename);
+        const std::string& key = MetadataCache::createKey(filenames[1].c_str(), crs);
+        REQUIRE(cache.find(key));
+        MetadataCache::Entry entry = *cache.find(key);
+        entry.title = "Wrong title";
+        cache.insert(key, entry);
+        cache.save();
+
+        Query query;
+        query.setMetadataCache(cacheFilename);
+        query.initialize(std::vector<std::string>(1, filenames[1]), valueNames, crs);
+        CHECK_FALSE(query._models[0]);
+        std::vector<double> values(numValues);
+        query.query(&values[0], 0.5*(entry.bbox[0]+entry.bbox[1]), 0.5*(entry.bbox[2]+entry.bbox[3]), 0.0);
+        REQUIRE(query._models[0]);
+        query.finalize();
+
+        cache.load(cacheFilename);
+        REQUIRE(cache.find(key));
+        CHECK(query._models[0]->getInfo()->getTitle() == cache.find(key)->title);
+        CHECK(query._models[0]->getInfo()->getTitle() == query._metadata[0].title);
+    } // Wrong title
+
+    { // Cache entry with wrong bounding box is replaced when model is opened for querying.
+        MetadataCache cache;
+        cache.load(cacheFilename);
+        const std::string& key = MetadataCache::createKey(filenames[1].c_str(), crs);
+        REQUIRE(cache.find(key));
+        MetadataCache::Entry entry = *cache.find(key);
+        double bboxE[4];
+        std::copy(entry.bbox, entry.bbox+4, bboxE);
+        const double xMid = 0.5 * (bboxE[0] + bboxE[1]);
+        const double y = 0.5 * (bboxE[2] + bboxE[3]);
+        entry.bbox[1] = xMid;
+        cache.insert(key, entry);
+        cache.save();
+
+        Query query;
+        query.setMetadataCache(cacheFilename);
+        query.initialize(std::vector<std::string>(1, filenames[1]), valueNames, crs);
+        const double xRight = 0.5 * (xMid + bboxE[1]);
+        CHECK_FALSE(query._modelIndex->inBoundingBox(0, xRight, y));
+
+        std::vector<double> values(numValues);
+        query.query(&values[0], 0.5*(bboxE[0]+xMid), y, 0.0);
+        for (size_t i = 0; i < 4; ++i) {
+            CHECK(bboxE[i] == query._bboxes[i]);
+        } // for
+        CHECK(query._modelIndex->inBoundingBox(0, xRight, y));
+        query.finalize();
+
+        cache.load(cacheFilename);
+        REQUIRE(cache.find(key));
+        for (size_t i = 0; i < 4; ++i) {
+            CHECK(bboxE[i] == cache.find(key)->bbox[i]);
+        } // for
+    } // Wrong bounding box
+
+    std::remove(cacheFilename);
+} // testMetadataCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Test opening models lazily from queries on multiple threads.
+void
+geomodelgrids::serial::TestQuery::testConcurrentQueries(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t numPoints = pointsThree.getNumPoints();
+    const double* xyz = pointsThree.getLatLonElev();
+    const size_t spaceDim = 3;
+
+    std::vector<double> valuesE(numPoints*numValues);
+    { // Serial
+        Query query;
+        query.initialize(filenames, valueNames, crs);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* pt = &xyz[iPt*spaceDim];
+            query.query(&valuesE[iPt*numValues], pt[0], pt[1], pt[2]);
+        } // for
+        query.finalize();
+    } // Serial
+
+    // Each thread has its own query, so models are opened for querying on all threads at the same time.
+    const size_t numThreads = 4;
+    std::vector<std::unique_ptr<Query> > queries(numThreads);
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        queries[iThread].reset(new Query());
+        queries[iThread]->setHyperslabPrefetch(true);
+        queries[iThread]->initialize(filenames, valueNames, crs);
+    } // for
+    std::vector<std::vector<double> > values(numThreads, std::vector<double>(numPoints*numValues));
+    std::vector<std::thread> threads;
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads.push_back(std::thread([&, iThread](void) {
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                const double* pt = &xyz[iPt*spaceDim];
+                queries[iThread]->query(&values[iThread][iPt*numValues], pt[0], pt[1], pt[2]);
+            } // for
+        }));
+    } // for
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads[iThread].join();
+        queries[iThread]->finalize();
+        for (size_t i = 0; i < numPoints*numValues; ++i) {
+            INFO("Mismatch for thread " << iThread << " at value " << i << ".");
+            CHECK(valuesE[i] == values[iThread][i]);
+        } // for
+    } // for
+} // testConcurrentQueries
+
+
 // End of file
@@ -0,0 +1,443 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::QueryServer and geomodelgrids::serial::QueryClient.
+ */
+
+#include <portinfo>
+
+#include "tests/data/ModelPoints.hh"
+
+#include "geomodelgrids/serial/QueryServer.hh" // USES QueryServer
+#include "geomodelgrids/serial/QueryClient.hh" // USES QueryClient
+#include "geomodelgrids/serial/QueryProtocol.hh" // USES QueryProtocol
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+extern "C" {
+#include "geomodelgrids/serial/cqueryclient.h"
+}
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <sys/socket.h> // USES socket(), bind()
+#include <sys/un.h> // USES sockaddr_un
+#include <unistd.h> // USES close()
+#include <cstring> // USES strncpy()
+#include <thread> // USES std::thread
+#include <chrono> // USES std::chrono
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestQueryServer;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestQueryServer {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructors.
+    static
+    void testConstructor(void);
+
+    /// Test open() and close().
+    static
+    void testOpen(void);
+
+    /// Test queries through QueryClient.
+    static
+    void testQuery(void);
+
+    /// Test stop().
+    static
+    void testStop(void);
+
+    /// Test clients that stop or close in the middle of a request.
+    static
+    void testBrokenClients(void);
+
+    /// Test QueryClient errors.
+    static
+    void testClientErrors(void);
+
+    /// Test C API for QueryClient.
+    static
+    void testCQueryClient(void);
+
+}; // class TestQueryServer
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestQueryServer::testConstructor", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testConstructor();
+}
+TEST_CASE("TestQueryServer::testOpen", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testOpen();
+}
+TEST_CASE("TestQueryServer::testQuery", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testQuery();
+}
+TEST_CASE("TestQueryServer::testStop", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testStop();
+}
+TEST_CASE("TestQueryServer::testBrokenClients", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testBrokenClients();
+}
+TEST_CASE("TestQueryServer::testClientErrors", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testClientErrors();
+}
+TEST_CASE("TestQueryServer::testCQueryClient", "[TestQueryServer]") {
+    geomodelgrids::serial::TestQueryServer::testCQueryClient();
+}
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _TestQueryServer;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_TestQueryServer {
+public:
+
+    static const char* const socketPath; ///< Path of server socket.
+
+    /** Initialize query with test models.
+     *
+     * @param[out] query Query to initialize.
+     * @param[in] crs CRS of input points.
+     */
+    static
+    void initialize(Query* query,
+                    const std::string& crs) {
+        const size_t numModels = 2;
+        const char* const filenamesArray[numModels] = {
+            "../../data/one-block-topo.h5",
+            "../../data/three-blocks-topo.h5",
+        };
+        std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+        const size_t numValues = 2;
+        const char* const valueNamesArray[numValues] = { "two", "one" };
+        std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+        query->initialize(filenames, valueNames, crs);
+    } // initialize
+
+    /** Get coordinates of points in and outside the test models.
+     *
+     * @param[out] points Coordinates of points [numPoints][3].
+     * @param[out] crs CRS of points.
+     */
+    static
+    void getPoints(std::vector<double>* points,
+                   std::string* crs) {
+        geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+        geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+        geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+        const geomodelgrids::testdata::ModelPoints* pointsAll[3] = { &pointsOne, &pointsThree, &pointsOutside };
+        const size_t spaceDim = 3;
+        points->clear();
+        for (size_t i = 0; i < 3; ++i) {
+            const double* xyz = pointsAll[i]->getLatLonElev();
+            points->insert(points->end(), xyz, xyz+pointsAll[i]->getNumPoints()*spaceDim);
+        } // for
+        *crs = pointsThree.getCRSLatLonElev();
+    } // getPoints
+
+    /** Connect raw socket to server.
+     *
+     * @returns Socket connected to server.
+     */
+    static
+    int connect(void) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socketPath, sizeof(address.sun_path)-1);
+        if ((fd >= 0) && ::connect(fd, (const sockaddr*)&address, sizeof(address))) {
+            close(fd);
+            return -1;
+        } // if
+        return fd;
+    } // connect
+
+}; // _TestQueryServer
+
+const char* const geomodelgrids::serial::_TestQueryServer::socketPath = "queryserver.sock";
+
+// ------------------------------------------------------------------------------------------------
+// Test constructors.
+void
+geomodelgrids::serial::TestQueryServer::testConstructor(void) {
+    QueryServer server;
+    CHECK(!server._query);
+    CHECK(-1 == server._listenSocket);
+    CHECK(size_t(0) == server.getNumRequests());
+
+    QueryClient client;
+    CHECK(-1 == client._socket);
+    CHECK(client.getValueNames().empty());
+    CHECK(client.getErrorHandler());
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test open() and close().
+void
+geomodelgrids::serial::TestQueryServer::testOpen(void) {
+    Query query;
+    QueryServer server;
+
+    CHECK_THROWS_AS(server.open(_TestQueryServer::socketPath, nullptr), std::invalid_argument);
+    const std::string longPath(256, 'a');
+    CHECK_THROWS_AS(server.open(longPath.c_str(), &query), std::invalid_argument);
+    CHECK_THROWS_AS(server.run(), std::logic_error);
+
+    // Socket file left behind by a server that exited without cleaning up.
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);REQUIRE(fd >= 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, _TestQueryServer::socketPath, sizeof(address.sun_path)-1);
+    REQUIRE(0 == bind(fd, (const sockaddr*)&address, sizeof(address)));
+    close(fd);
+    REQUIRE(0 == access(_TestQueryServer::socketPath, F_OK));
+
+    server.open(_TestQueryServer::socketPath, &query);
+    CHECK(&query == server._query);
+    CHECK(server._listenSocket >= 0);
+    CHECK_THROWS_AS(server.open(_TestQueryServer::socketPath, &query), std::logic_error);
+
+    // Another server cannot take over the socket of a running server.
+    QueryServer serverOther;
+    CHECK_THROWS_AS(serverOther.open(_TestQueryServer::socketPath, &query), std::runtime_error);
+
+    server.close();
+    CHECK(-1 == server._listenSocket);
+    CHECK(0 != access(_TestQueryServer::socketPath, F_OK));
+} // testOpen
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queries through QueryClient.
+void
+geomodelgrids::serial::TestQueryServer::testQuery(void) {
+    std::vector<double> points;
+    std::string crs;
+    _TestQueryServer::getPoints(&points, &crs);
+    const size_t spaceDim = 3;
+    const size_t numPoints = points.size() / spaceDim;
+    std::vector<double> points2(numPoints*2);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        points2[iPt*2+0] = points[iPt*spaceDim+0];
+        points2[iPt*2+1] = points[iPt*spaceDim+1];
+    } // for
+
+    // Expected values from a query in this process.
+    Query queryE;
+    _TestQueryServer::initialize(&queryE, crs);
+    const size_t numValues = queryE.getValueNames().size();
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    const int errE = queryE.queryPoints(valuesE.data(), numValues, &points[0], &points[1], &points[2], spaceDim,
+                                        numPoints, statusE.data());
+    std::vector<double> topElevE(numPoints);
+    queryE.queryTopElevations(topElevE.data(), points2.data(), numPoints);
+    std::vector<double> topoBathyElevE(numPoints);
+    queryE.queryTopoBathyElevations(topoBathyElevE.data(), points2.data(), numPoints);
+
+    Query query;
+    _TestQueryServer::initialize(&query, crs);
+    QueryServer server;
+    server.open(_TestQueryServer::socketPath, &query);
+    std::thread serverThread(&QueryServer::run, &server);
+
+    QueryClient client;
+    client.connect(_TestQueryServer::socketPath);
+    CHECK(queryE.getValueNames() == client.getValueNames());
+
+    std::vector<double> values(numPoints*numValues);
+    std::vector<int> status(numPoints);
+    CHECK(errE == client.queryPoints(values.data(), points.data(), numPoints, status.data()));
+    CHECK(valuesE == values);
+    CHECK(statusE == status);
+
+    // Second client shares the resident query.
+    QueryClient clientOther;
+    clientOther.connect(_TestQueryServer::socketPath);
+    std::vector<double> elevations(numPoints);
+    clientOther.queryTopElevations(elevations.data(), points2.data(), numPoints);
+    CHECK(topElevE == elevations);
+    client.queryTopoBathyElevations(elevations.data(), points2.data(), numPoints);
+    CHECK(topoBathyElevE == elevations);
+    clientOther.close();
+
+    CHECK(0 == client.queryPoints(nullptr, nullptr, 0));
+
+    client.shutdownServer();
+    serverThread.join();
+    CHECK(size_t(6) == server.getNumRequests()); // info (2), values, top, topobathy, shutdown
+    server.close();
+} // testQuery
+
+
+// ------------------------------------------------------------------------------------------------
+// Test stop().
+void
+geomodelgrids::serial::TestQueryServer::testStop(void) {
+    Query query;
+    QueryServer server;
+    server.stop(); // Not open
+    server.open(_TestQueryServer::socketPath, &query);
+    std::thread serverThread(&QueryServer::run, &server);
+
+    server.stop();
+    serverThread.join();
+    server.close();
+} // testStop
+
+
+// ------------------------------------------------------------------------------------------------
+// Test clients that stop or close in the middle of a request.
+void
+geomodelgrids::serial::TestQueryServer::testBrokenClients(void) {
+    std::vector<double> points;
+    std::string crs;
+    _TestQueryServer::getPoints(&points, &crs);
+    const size_t numPoints = points.size() / 3;
+
+    Query query;
+    _TestQueryServer::initialize(&query, crs);
+    const size_t numValues = query.getValueNames().size();
+    QueryServer server;
+    server.open(_TestQueryServer::socketPath, &query);
+    std::thread serverThread(&QueryServer::run, &server);
+
+    // Client that sends the header and part of the points and then stalls.
+    const int stalled = _TestQueryServer::connect();REQUIRE(stalled >= 0);
+    QueryProtocol::writeHeader(stalled, QueryProtocol::REQUEST_VALUES, numPoints);
+    QueryProtocol::writeBytes(stalled, points.data(), sizeof(double)+3);
+
+    // Client that closes the connection in the middle of a request.
+    const int closed = _TestQueryServer::connect();REQUIRE(closed >= 0);
+    QueryProtocol::writeHeader(closed, QueryProtocol::REQUEST_TOP_ELEVATION, numPoints);
+    QueryProtocol::writeBytes(closed, points.data(), sizeof(double));
+    close(closed);
+
+    // Client that does not use the protocol is dropped.
+    const int other = _TestQueryServer::connect();REQUIRE(other >= 0);
+    std::vector<char> garbage(sizeof(QueryProtocol::Header), 'x');
+    QueryProtocol::writeBytes(other, garbage.data(), garbage.size());
+    char byte = 0;
+    CHECK(!QueryProtocol::readBytes(other, &byte, 1));
+    close(other);
+
+    // Other clients are answered without waiting for the stalled client.
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    QueryClient client;
+    client.connect(_TestQueryServer::socketPath);
+    std::vector<double> values(numPoints*numValues);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR != client.queryPoints(values.data(), points.data(), numPoints));
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+
+    // Stalled client gets its answer once it sends the rest of the request.
+    const size_t numBytes = points.size()*sizeof(double);
+    QueryProtocol::writeBytes(stalled, reinterpret_cast<const char*>(points.data())+sizeof(double)+3,
+                              numBytes-sizeof(double)-3);
+    QueryProtocol::Header header;
+    REQUIRE(QueryProtocol::readHeader(stalled, &header));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR != header.type);
+    CHECK(numPoints == header.count);
+    std::vector<double> valuesStalled(numPoints*numValues);
+    REQUIRE(QueryProtocol::readBytes(stalled, valuesStalled.data(), valuesStalled.size()*sizeof(double)));
+    CHECK(values == valuesStalled);
+    std::vector<int32_t> status(numPoints);
+    REQUIRE(QueryProtocol::readBytes(stalled, status.data(), status.size()*sizeof(int32_t)));
+    close(stalled);
+
+    client.shutdownServer();
+    serverThread.join();
+    CHECK(size_t(4) == server.getNumRequests()); // info, values (2), shutdown
+    server.close();
+} // testBrokenClients
+
+
+// ------------------------------------------------------------------------------------------------
+// Test QueryClient errors.
+void
+geomodelgrids::serial::TestQueryServer::testClientErrors(void) {
+    QueryClient client;
+    CHECK_THROWS_AS(client.connect("no-such-server.sock"), std::runtime_error);
+    CHECK_THROWS_AS(client.connect(""), std::invalid_argument);
+    CHECK_THROWS_AS(client.shutdownServer(), std::logic_error);
+
+    std::vector<double> points(3);
+    std::vector<double> values(2);
+    CHECK_THROWS_AS(client.queryPoints(values.data(), points.data(), 1), std::logic_error);
+} // testClientErrors
+
+
+// ------------------------------------------------------------------------------------------------
+// Test C API for QueryClient.
+void
+geomodelgrids::serial::TestQueryServer::testCQueryClient(void) {
+    std::vector<double> points;
+    std::string crs;
+    _TestQueryServer::getPoints(&points, &crs);
+    const size_t spaceDim = 3;
+    const size_t numPoints = points.size() / spaceDim;
+
+    Query query;
+    _TestQueryServer::initialize(&query, crs);
+    const size_t numValues = query.getValueNames().size();
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    query.queryPoints(valuesE.data(), numValues, &points[0], &points[1], &points[2], spaceDim, numPoints,
+                      statusE.data());
+
+    QueryServer server;
+    server.open(_TestQueryServer::socketPath, &query);
+    std::thread serverThread(&QueryServer::run, &server);
+
+    void* handle = geomodelgrids_squeryclient_create();REQUIRE(handle);
+    CHECK(geomodelgrids_squeryclient_getErrorHandler(handle));
+
+    int err = geomodelgrids_squeryclient_connect(handle, _TestQueryServer::socketPath);REQUIRE(!err);
+    CHECK(numValues == geomodelgrids_squeryclient_getNumValues(handle));
+
+    std::vector<double> values(numPoints*numValues);
+    std::vector<int> status(numPoints);
+    err = geomodelgrids_squeryclient_query_points(handle, values.data(), points.data(), numPoints, status.data());
+    CHECK(err != geomodelgrids::utils::ErrorHandler::ERROR);
+    CHECK(valuesE == values);
+    CHECK(statusE == status);
+
+    std::vector<double> points2(numPoints*2);
+    std::vector<double> elevations(numPoints);
+    err = geomodelgrids_squeryclient_query_top_elevations(handle, elevations.data(), points2.data(), numPoints);
+    CHECK(err != geomodelgrids::utils::ErrorHandler::ERROR);
+    err = geomodelgrids_squeryclient_query_topobathy_elevations(handle, elevations.data(), points2.data(),
+                                                                numPoints);
+    CHECK(err != geomodelgrids::utils::ErrorHandler::ERROR);
+
+    err = geomodelgrids_squeryclient_shutdownServer(handle);
+    CHECK(err != geomodelgrids::utils::ErrorHandler::ERROR);
+    serverThread.join();
+    server.close();
+
+    err = geomodelgrids_squeryclient_close(handle);
+    CHECK(err != geomodelgrids::utils::ErrorHandler::ERROR);
+    CHECK(0 == geomodelgrids_squeryclient_getNumValues(handle));
+
+    err = geomodelgrids_squeryclient_connect(handle, _TestQueryServer::socketPath);
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
+
+    geomodelgrids_squeryclient_destroy(&handle);
+    CHECK(!handle);
+
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == geomodelgrids_squeryclient_connect(NULL, "a"));
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == geomodelgrids_squeryclient_close(NULL));
+} // testCQueryClient
+
+
+// End of file
@@ -0,0 +1,240 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::SharedChunkCache.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/SharedChunkCache.hh" // Test subject
+
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <unistd.h> // USES getpid()
+#include <cstring> // USES strlen()
+#include <sstream> // USES std::ostringstream
+#include <vector> // USES std::vector
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestSharedChunkCache;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestSharedChunkCache {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestSharedChunkCache(void);
+
+    /// Destructor.
+    ~TestSharedChunkCache(void);
+
+    /// Test open() and close().
+    void testOpen(void);
+
+    /// Test get() and put().
+    void testGetPut(void);
+
+    /// Test hyperslabs assembled from shared chunks.
+    void testHyperslab(void);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::string _name; ///< Name of shared memory for cache.
+
+}; // class TestSharedChunkCache
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestSharedChunkCache::testOpen", "[TestSharedChunkCache]") {
+    geomodelgrids::serial::TestSharedChunkCache().testOpen();
+}
+TEST_CASE("TestSharedChunkCache::testGetPut", "[TestSharedChunkCache]") {
+    geomodelgrids::serial::TestSharedChunkCache().testGetPut();
+}
+TEST_CASE("TestSharedChunkCache::testHyperslab", "[TestSharedChunkCache]") {
+    geomodelgrids::serial::TestSharedChunkCache().testHyperslab();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::TestSharedChunkCache::TestSharedChunkCache(void) {
+    std::ostringstream name;
+    name << "/geomodelgrids-test-" << getpid();
+    _name = name.str();
+    SharedChunkCache::remove(_name.c_str());
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::TestSharedChunkCache::~TestSharedChunkCache(void) {
+    SharedChunkCache::remove(_name.c_str());
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test open() and close().
+void
+geomodelgrids::serial::TestSharedChunkCache::testOpen(void) {
+    SharedChunkCache cache;
+    CHECK(!cache.isOpen());
+    CHECK(size_t(0) == cache.getNumSlots());
+
+    CHECK_THROWS_AS(cache.open(""), std::invalid_argument);
+    CHECK_THROWS_AS(cache.open(_name.c_str(), 16, 1024), std::invalid_argument);
+
+    const size_t slotBytes = 1000;
+    cache.open(_name.c_str(), 64*1024, slotBytes);
+    CHECK(cache.isOpen());
+    CHECK(slotBytes == cache.getSlotBytes());
+    CHECK(cache.getNumSlots() > size_t(50));
+    CHECK_THROWS_AS(cache.open(_name.c_str()), std::logic_error);
+
+    // Other processes use the size of the existing cache; leading slash is optional.
+    SharedChunkCache cacheOther;
+    cacheOther.open(_name.c_str()+1, 1024*1024, 2*slotBytes);
+    CHECK(cache.getNumSlots() == cacheOther.getNumSlots());
+    CHECK(slotBytes == cacheOther.getSlotBytes());
+
+    cache.close();
+    CHECK(!cache.isOpen());
+    CHECK(size_t(0) == cache.getSlotBytes());
+} // testOpen
+
+
+// ------------------------------------------------------------------------------------------------
+// Test get() and put().
+void
+geomodelgrids::serial::TestSharedChunkCache::testGetPut(void) {
+    const size_t slotBytes = 8*sizeof(double);
+    SharedChunkCache cache;
+    cache.open(_name.c_str(), 16*1024, slotBytes);
+    SharedChunkCache cacheOther;
+    cacheOther.open(_name.c_str());
+
+    const size_t numValues = 8;
+    std::vector<double> values(numValues);
+    for (size_t i = 0; i < numValues; ++i) {
+        values[i] = 1.5 * i;
+    } // for
+    const size_t numBytes = numValues * sizeof(double);
+
+    std::vector<double> buffer(2*numValues);
+    const uint64_t key = SharedChunkCache::hash("abc", 3);
+    CHECK(!cache.get(buffer.data(), key, numBytes));
+    CHECK(!cache.put(key, buffer.data(), 2*numBytes)); // Larger than slot
+    CHECK(cache.put(key, values.data(), numBytes));
+    CHECK(!cache.put(key, values.data(), numBytes)); // Already in cache
+
+    // Chunk is visible through other mapping of cache.
+    REQUIRE(cacheOther.get(buffer.data(), key, numBytes));
+    for (size_t i = 0; i < numValues; ++i) {
+        CHECK(values[i] == buffer[i]);
+    } // for
+    CHECK(!cacheOther.get(buffer.data(), key, numBytes-sizeof(double)));
+    CHECK(!cacheOther.get(buffer.data(), key+1, numBytes));
+
+    // Key 0 is valid.
+    CHECK(cache.put(0, values.data(), sizeof(double)));
+    CHECK(cache.get(buffer.data(), 0, sizeof(double)));
+
+    // Filling the cache evicts chunks without failing.
+    const size_t numKeys = 4 * cache.getNumSlots();
+    for (size_t i = 0; i < numKeys; ++i) {
+        values[0] = double(i);
+        cache.put(SharedChunkCache::hash(&i, sizeof(i)), values.data(), numBytes);
+    } // for
+    const size_t iLast = numKeys - 1;
+    REQUIRE(cacheOther.get(buffer.data(), SharedChunkCache::hash(&iLast, sizeof(iLast)), numBytes));
+    CHECK(double(iLast) == buffer[0]);
+} // testGetPut
+
+
+// ------------------------------------------------------------------------------------------------
+// Test hyperslabs assembled from shared chunks.
+void
+geomodelgrids::serial::TestSharedChunkCache::testHyperslab(void) {
+    const char* filename = "sharedchunkcache.h5";
+    const char* path = "/values";
+    const size_t ndims = 3;
+    const hsize_t dimsAll[ndims] = { 7, 9, 2 };
+    const hsize_t chunkDims[ndims] = { 3, 4, 2 };
+    { // Create dataset with chunks that do not align with hyperslabs.
+        std::vector<double> values(dimsAll[0]*dimsAll[1]*dimsAll[2]);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = 0.25 * i;
+        } // for
+        const hsize_t origin[ndims] = { 0, 0, 0 };
+        HDF5 h5;
+        h5.open(filename, H5F_ACC_TRUNC);
+        h5.createDataset(path, dimsAll, chunkDims, ndims, H5T_NATIVE_DOUBLE, 0);
+        h5.writeDatasetHyperslab(values.data(), path, origin, dimsAll, ndims, H5T_NATIVE_DOUBLE);
+        h5.close();
+    } // Create dataset
+
+    SharedChunkCache cache;
+    cache.open(_name.c_str(), 1024*1024, 1024);
+
+    HDF5 h5;
+    h5.open(filename, H5F_ACC_RDONLY);
+    CHECK(!h5.getSharedCache());
+    CHECK(uint64_t(0) == h5.getFileKey());
+    HDF5 h5Shared;
+    h5Shared.setSharedCache(&cache);
+    h5Shared.open(filename, H5F_ACC_RDONLY);
+    CHECK(&cache == h5Shared.getSharedCache());
+    CHECK(h5Shared.getFileKey());
+
+    const hsize_t dims[ndims] = { 4, 5, 2 };
+    Hyperslab hyperslab(&h5, path, dims, ndims);
+    Hyperslab hyperslabShared(&h5Shared, path, dims, ndims);
+    CHECK(!hyperslab._sharedCache);
+    CHECK(&cache == hyperslabShared._sharedCache);
+
+    // Read same hyperslabs twice, second time from the cache.
+    const size_t spaceDim = 2;
+    const double index[5*spaceDim] = {
+        0.0, 0.0,
+        5.5, 7.5,
+        2.9, 4.1,
+        6.0, 0.2,
+        0.1, 8.0,
+    };
+    const size_t numValues = dimsAll[ndims-1];
+    std::vector<double> values(numValues);
+    std::vector<double> valuesShared(numValues);
+    for (size_t iPass = 0; iPass < 2; ++iPass) {
+        for (size_t i = 0; i < 5; ++i) {
+            INFO("Pass " << iPass << ", index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ").");
+            hyperslab.nearest(values.data(), &index[i*spaceDim]);
+            hyperslabShared.nearest(valuesShared.data(), &index[i*spaceDim]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                CHECK(values[iValue] == valuesShared[iValue]);
+            } // for
+
+            const size_t numValuesSlab = dims[0]*dims[1]*dims[2];
+            for (size_t iValue = 0; iValue < numValuesSlab; ++iValue) {
+                CHECK(hyperslab._values[iValue] == hyperslabShared._values[iValue]);
+            } // for
+        } // for
+    } // for
+
+    // First chunk is in the cache.
+    const hsize_t chunkIndex[spaceDim] = { 0, 0 };
+    const uint64_t datasetKey = SharedChunkCache::hash(path, strlen(path), h5Shared.getFileKey());
+    const uint64_t key = SharedChunkCache::hash(chunkIndex, sizeof(chunkIndex), datasetKey);
+    std::vector<double> chunk(chunkDims[0]*chunkDims[1]*chunkDims[2]);
+    REQUIRE(cache.get(chunk.data(), key, chunk.size()*sizeof(double)));
+    CHECK(0.25*dimsAll[2] == chunk[dimsAll[2]]);
+    CHECK(0.25*dimsAll[1]*dimsAll[2] == chunk[chunkDims[1]*chunkDims[2]]);
+
+    h5.close();
+    h5Shared.close();
+} // testHyperslab
+
+
+// End of file
@@ -10,6 +10,7 @@
 
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
 #include "geomodelgrids/utils/Indexing.hh" // USES Indexing
 
 #include "catch2/catch_test_macros.hpp"
@@ -57,10 +58,12 @@ geomodelgrids::serial::TestSurface::testSetHyperslabDims(void) {
     Surface topo("top_surface");
 
     const size_t ndims = 3;
-    const size_t dimsDefault[ndims] = { 128, 128, 1 };
+    const size_t dimsDefault[ndims] = { 0, 0, 1 };
     for (size_t i = 0; i < ndims; ++i) {
         CHECK(dimsDefault[i] == topo._hyperslabDims[i]);
     } // for
+    CHECK(Hyperslab::DEFAULT_MAX_BYTES == topo._hyperslabMaxBytes);
+    CHECK(!topo._hyperslabPrefetch);
 
     const size_t dims[ndims] = { 12, 12, 1 };
     topo.setHyperslabDims(dims, ndims-1);
@@ -69,6 +72,13 @@ geomodelgrids::serial::TestSurface::testSetHyperslabDims(void) {
     } // for
 
     CHECK_THROWS_AS(topo.setHyperslabDims(dims, 5), std::length_error);
+
+    const size_t maxBytes = 4096;
+    topo.setHyperslabMaxBytes(maxBytes);
+    CHECK(maxBytes == topo._hyperslabMaxBytes);
+
+    topo.setHyperslabPrefetch(true);
+    CHECK(topo._hyperslabPrefetch);
 } // testSetHyperslabDims
 
 
@@ -55,6 +55,7 @@ class TestBatchGenerator2D(unittest.TestCase):
         self._check_batches(BATCHES, genbatch)
 
     def _check_batches(self, batchesE, genbatch):
+        self.assertEqual(len(batchesE), len(genbatch))
         count = 0
         for bE, b in zip(batchesE, genbatch):
             self.assertEqual(f"Batch2D [{bE[0][0]}:{bE[0][1]}, {bE[1][0]}:{bE[1][1]}]", str(b))
@@ -171,6 +172,7 @@ class TestBatchGenerator3D(unittest.TestCase):
         self._check_batches(BATCHES, genbatch)
 
     def _check_batches(self, batchesE, genbatch):
+        self.assertEqual(len(batchesE), len(genbatch))
         count = 0
         for bE, b in zip(batchesE, genbatch):
             self.assertEqual(f"Batch3D [{bE[0][0]}:{bE[0][1]}, {bE[1][0]}:{bE[1][1]}, {bE[2][0]}:{bE[2][1]}]", str(b))
@@ -181,8 +183,23 @@ class TestBatchGenerator3D(unittest.TestCase):
         self.assertEqual(len(batchesE), count)
 
 
+class TestCheckpoint(unittest.TestCase):
+
+    def test_is_complete(self):
+        checkpoint = batch.Checkpoint("abc", 1000, 3)
+        self.assertFalse(checkpoint.is_complete())
+        checkpoint.num_done = 3
+        self.assertTrue(checkpoint.is_complete())
+
+    def test_can_resume(self):
+        checkpoint = batch.Checkpoint("abc", 1000, 3)
+        self.assertTrue(checkpoint.can_resume(batch.Checkpoint("abc", 1000, 3, num_done=2)))
+        self.assertFalse(checkpoint.can_resume(batch.Checkpoint("xyz", 1000, 3, num_done=2)))
+        self.assertFalse(checkpoint.can_resume(batch.Checkpoint("abc", 2000, 2, num_done=1)))
+
+
 def load_tests(loader, tests, pattern):
-    TEST_CLASSES = [TestBatchGenerator2D, TestBatchGenerator3D]
+    TEST_CLASSES = [TestBatchGenerator2D, TestBatchGenerator3D, TestCheckpoint]
 
     suite = unittest.TestSuite()
     for cls in TEST_CLASSES:
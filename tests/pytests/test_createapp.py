@@ -249,6 +249,81 @@ class TestAppBatch(TestApp):
     CONFIG_FILENAME = "test_createapp_batch.cfg"
 
 
+class TestAppWorkers(TestApp):
+    CONFIG_FILENAME = "test_createapp_workers.cfg"
+
+
+class TestAppResume(TestApp):
+    CONFIG_FILENAME = "test_createapp_resume.cfg"
+    SENTINEL = -999.0
+
+    def test_resume(self):
+        ARGS = {
+            "config_filenames": self.CONFIG_FILENAME,
+            "all_steps": True,
+        }
+        app = App(show_progress=False, debug=True)
+        app.main(**ARGS)
+
+        # Simulate run that stopped after writing the first batch of block 'top'.
+        with h5py.File(self.metadata["filename"], "a") as h5:
+            self.assertEqual(h5["blocks"]["top"].attrs["checkpoint_num_batches"],
+                             h5["blocks"]["top"].attrs["checkpoint_num_done"])
+            self.assertGreater(h5["blocks"]["top"].attrs["checkpoint_num_batches"], 1)
+            h5["blocks"]["top"].attrs["checkpoint_num_done"] = 1
+            h5["blocks"]["top"][:] = self.SENTINEL
+            h5["blocks"]["bottom"].attrs["checkpoint_num_done"] = 0
+            h5["surfaces"]["top_surface"].attrs["marker"] = 1
+
+        app.main(resume=True, **ARGS)
+
+        with h5py.File(self.metadata["filename"], "r") as h5:
+            # Complete surface is skipped (creating the dataset again would remove the marker).
+            self.assertIn("marker", h5["surfaces"]["top_surface"].attrs)
+            # First batch of block 'top' is skipped, remaining batches are generated.
+            block = h5["blocks"]["top"]
+            self.assertEqual(block.attrs["checkpoint_num_batches"], block.attrs["checkpoint_num_done"])
+            values = block[:]
+            self.assertGreater(numpy.sum(values == self.SENTINEL), 0)
+            self.assertLess(numpy.sum(values == self.SENTINEL), values.size)
+        self._check_block_values(["bottom"])
+
+    def test_incremental(self):
+        ARGS = {
+            "config_filenames": self.CONFIG_FILENAME,
+            "all_steps": True,
+        }
+        app = App(show_progress=False, debug=True)
+        app.main(**ARGS)
+
+        # Mark block 'bottom' as generated with a different configuration.
+        with h5py.File(self.metadata["filename"], "a") as h5:
+            h5["blocks"]["top"].attrs["marker"] = 1
+            h5["blocks"]["bottom"][:] = self.SENTINEL
+            h5["blocks"]["bottom"].attrs["checkpoint_signature"] = numpy.string_("stale")
+
+        app.main(incremental=True, **ARGS)
+
+        with h5py.File(self.metadata["filename"], "r") as h5:
+            self.assertIn("marker", h5["blocks"]["top"].attrs)
+            self.assertNotEqual(b"stale", h5["blocks"]["bottom"].attrs["checkpoint_signature"])
+        self._check_block_values(["bottom"])
+
+    def _check_block_values(self, blocks):
+        """Check values in blocks without regenerating the model.
+        """
+        h5 = h5py.File(self.metadata["filename"], "r")
+        for block in blocks:
+            points = self._get_block_xyz(block)
+            npts = points.shape
+            valuesE = numpy.zeros((npts[0], npts[1], npts[2], 2), dtype=numpy.float32)
+            valuesE[:, :, :, 0] = AnalyticDataSrc._get_values_one(points)
+            valuesE[:, :, :, 1] = AnalyticDataSrc._get_values_two(points)
+            values = h5["blocks"][block][:]
+            numpy.testing.assert_allclose(values, valuesE, rtol=self.TOLERANCE, atol=self.TOLERANCE)
+        h5.close()
+
+
 class TestAppVarZ(TestApp):
     CONFIG_FILENAME = "test_createapp_varz.cfg"
 
@@ -279,8 +354,63 @@ class TestAppVarXYZ(TestApp):
         self._check_attributes(model_metadata.keys(), model_metadata, h5.attrs)
 
 
+class TestAppPyramid(TestApp):
+    CONFIG_FILENAME = "test_createapp_pyramid.cfg"
+
+    def test_pyramid(self):
+        ARGS = {
+            "config_filenames": self.CONFIG_FILENAME,
+            "all_steps": True,
+        }
+        app = App(show_progress=False, debug=True)
+        app.main(**ARGS)
+
+        datasets = (
+            ("surfaces", "top_surface"),
+            ("surfaces", "topography_bathymetry"),
+            ("blocks", "top"),
+            ("blocks", "bottom"),
+        )
+        with h5py.File(self.metadata["filename"], "r") as h5:
+            for group, name in datasets:
+                dataset = h5[group][name]
+                values = dataset[:]
+                x = self._get_coordinates(dataset.attrs, "x", values.shape[0])
+                y = self._get_coordinates(dataset.attrs, "y", values.shape[1])
+                for level in (1, 2):
+                    level_dataset = h5[f"pyramid/level_{level}/{group}/{name}"]
+                    level_attrs = level_dataset.attrs
+                    x_level = self._get_coordinates(level_attrs, "x", level_dataset.shape[0])
+                    y_level = self._get_coordinates(level_attrs, "y", level_dataset.shape[1])
+                    self.assertEqual(x[-1], x_level[-1])
+                    self.assertEqual(y[-1], y_level[-1])
+                    self.assertEqual((len(x) + 2) // 2, len(x_level))
+                    self.assertEqual((len(y) + 2) // 2, len(y_level))
+                    x_indices = numpy.searchsorted(x, x_level)
+                    y_indices = numpy.searchsorted(y, y_level)
+                    numpy.testing.assert_array_equal(x[x_indices], x_level)
+                    numpy.testing.assert_array_equal(y[y_indices], y_level)
+                    numpy.testing.assert_array_equal(values[x_indices][:, y_indices], level_dataset[:])
+                    for attr_name in ("z_resolution", "z_top"):
+                        if attr_name in dataset.attrs:
+                            self.assertEqual(dataset.attrs[attr_name], level_attrs[attr_name])
+                    self.assertNotIn("checkpoint_signature", level_attrs)
+
+                    dataset = level_dataset
+                    values = level_dataset[:]
+                    x = x_level
+                    y = y_level
+
+    @staticmethod
+    def _get_coordinates(attrs, axis, num_points):
+        if f"{axis}_resolution" in attrs:
+            return attrs[f"{axis}_resolution"] * numpy.arange(num_points)
+        return numpy.array(attrs[f"{axis}_coordinates"])
+
+
 def load_tests(loader, tests, pattern):
-    TEST_CLASSES = [TestApp, TestAppBatch, TestAppVarZ, TestAppVarXYZ]
+    TEST_CLASSES = [TestApp, TestAppBatch, TestAppWorkers, TestAppResume, TestAppVarZ, TestAppVarXYZ,
+                    TestAppPyramid]
 
     suite = unittest.TestSuite()
     for cls in TEST_CLASSES:
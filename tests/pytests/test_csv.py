@@ -0,0 +1,139 @@
+"""Test create.data_srcs.csv.datasrc.
+
+The CSV files use the model CRS, so no coordinate transformation is required.
+"""
+
+import os
+import sys
+import types
+import unittest
+import unittest.mock
+
+import numpy
+
+from geomodelgrids.create.core import NODATA_VALUE
+from geomodelgrids.create.core.model import Block
+from geomodelgrids.create.data_srcs.csv.datasrc import CSVFile
+from geomodelgrids.create.utils import batch
+
+
+class TestCSVFile(unittest.TestCase):
+
+    FILENAME = "test-csv.txt"
+    ORIGIN = (1000.0, 2000.0)
+    Y_AZIMUTH = 30.0
+
+    def setUp(self):
+        self.metadata = types.SimpleNamespace(dim_x=3.0e+3, dim_y=2.0e+3, dim_z=2.0e+3)
+
+    def tearDown(self):
+        if os.path.exists(self.FILENAME):
+            os.remove(self.FILENAME)
+
+    def test_uniform(self):
+        block = Block("block", self.metadata, {
+            "x_resolution": 1.0e+3,
+            "y_resolution": 0.5e+3,
+            "z_resolution": 0.5e+3,
+            "z_top": 0.0,
+            "z_bot": -2.0e+3,
+            "z_top_offset": 0.0,
+            "chunk_size": "(2, 2, 2, 2)",
+        })
+        self._check(block)
+
+    def test_variable(self):
+        block = Block("block", self.metadata, {
+            "x_coordinates": "[0.0, 500.0, 2000.0, 3000.0]",
+            "y_coordinates": "[0.0, 1500.0, 2000.0]",
+            "z_coordinates": "[0.0, -250.0, -1000.0, -2000.0]",
+            "z_top_offset": 0.0,
+            "chunk_size": "(2, 2, 2, 2)",
+        })
+        self._check(block)
+
+    def _check(self, block):
+        nx, ny, nz = block.get_dims()
+        x = numpy.array(block.x_coordinates) if block.x_coordinates else block.x_resolution * numpy.arange(nx)
+        y = numpy.array(block.y_coordinates) if block.y_coordinates else block.y_resolution * numpy.arange(ny)
+        z = numpy.array(block.z_coordinates) if block.z_coordinates else block.z_top - \
+            block.z_resolution * numpy.arange(nz)
+        xx, yy, zz = numpy.meshgrid(x, y, z, indexing="ij")
+        values_e = numpy.stack((xx + 0.5*yy, zz - 0.1*xx), axis=3).astype(numpy.float32)
+        values_e[-1, -1, -1, :] = NODATA_VALUE  # Missing point
+
+        az_rad = self.Y_AZIMUTH / 180.0 * numpy.pi
+        x_csv = self.ORIGIN[0] + xx*numpy.cos(az_rad) + yy*numpy.sin(az_rad)
+        y_csv = self.ORIGIN[1] - xx*numpy.sin(az_rad) + yy*numpy.cos(az_rad)
+        rows = numpy.stack((y_csv, x_csv, zz, values_e[:, :, :, 1], values_e[:, :, :, 0]), axis=3).reshape((-1, 5))
+        rows = rows[:-1]
+        order = numpy.random.default_rng(1).permutation(rows.shape[0])
+        with open(self.FILENAME, "w") as fout:
+            fout.write("# y x z two one\n")
+            for i, row in enumerate(rows[order]):
+                if i % 7 == 0:
+                    fout.write("# comment\n")
+                fout.write(" ".join([f"{v:.6f}" for v in row]) + "\n")
+
+        for use_pandas in [True, False]:
+            with open(self.FILENAME, "r") as fin:
+                csv_text = fin.read()
+            with unittest.mock.patch.dict(sys.modules, {} if use_pandas else {"pandas": None}):
+                datasrc = CSVFile(self._config())
+                values = datasrc.get_values(block, None, None)
+            numpy.testing.assert_allclose(values_e, values, rtol=1.0e-6, atol=1.0e-3)
+
+            # The CSV file is parsed only once.
+            os.remove(self.FILENAME)
+            for batch_size in [nx*ny*nz, 8, 3]:
+                batches = batch.BatchGenerator3D(nx, ny, nz, batch_size)
+                for bt in batches:
+                    values = datasrc.get_values(block, None, None, bt)
+                    (x0, x1), (y0, y1), (z0, z1) = bt.x_range, bt.y_range, bt.z_range
+                    numpy.testing.assert_allclose(values_e[x0:x1, y0:y1, z0:z1], values, rtol=1.0e-6, atol=1.0e-3)
+
+            spill_dir = datasrc._spill_dir
+            self.assertTrue(os.path.isdir(spill_dir))
+            del datasrc
+            self.assertFalse(os.path.exists(spill_dir))
+            with open(self.FILENAME, "w") as fout:
+                fout.write(csv_text)
+
+    def _config(self):
+        return {
+            "data": {
+                "values": "[one, two]",
+            },
+            "coordsys": {
+                "crs": "EPSG:3311",
+                "origin_x": str(self.ORIGIN[0]),
+                "origin_y": str(self.ORIGIN[1]),
+                "y_azimuth": str(self.Y_AZIMUTH),
+            },
+            "csv": {
+                "filename": self.FILENAME,
+                "crs": "EPSG:3311",
+                "chunk_size": "5",
+            },
+            "csv.columns": {
+                "x": "1",
+                "y": "0",
+                "z": "2",
+                "one": "4",
+                "two": "3",
+            },
+        }
+
+
+def test_classes():
+    return [TestCSVFile]
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    for cls in test_classes():
+        suite.addTest(unittest.makeSuite(cls))
+    unittest.TextTestRunner(verbosity=2).run(suite)
+
+
+# End of file
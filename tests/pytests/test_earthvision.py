@@ -0,0 +1,125 @@
+"""Test create.data_srcs.earthvision rules evaluation and data exchange.
+
+These tests do not require EarthVision.
+"""
+
+import io
+import unittest
+
+import numpy
+
+from geomodelgrids.create.data_srcs.earthvision import api
+from geomodelgrids.create.data_srcs.earthvision import rules
+
+
+def rule_point(x, y, depth):
+    return (x + y, 2.0 * depth if depth < 100.0 else depth, -1.0)
+
+
+@rules.vectorized
+def rule_array(x, y, depth):
+    return (x - y, numpy.where(depth < 100.0, 3.0 * depth, depth), -2.0)
+
+
+def rules_fn(fault_block, zone):
+    return rule_array if zone == "zone_b" else rule_point
+
+
+class TestRules(unittest.TestCase):
+
+    FAULT_BLOCK = numpy.array(["block_a", "block_b", "block_a", "block_a", "block_b"])
+    ZONE = numpy.array(["zone_a", "zone_b", "zone_b", "zone_a", "zone_b"])
+
+    def test_group_points(self):
+        groups = rules.group_points(self.FAULT_BLOCK, self.ZONE)
+        groups_e = [
+            ("block_a", "zone_a", [0, 3]),
+            ("block_a", "zone_b", [2]),
+            ("block_b", "zone_b", [1, 4]),
+        ]
+        self.assertEqual(len(groups_e), len(groups))
+        for (fb_e, zone_e, indices_e), (fb, zone, indices) in zip(groups_e, groups):
+            self.assertEqual(fb_e, fb)
+            self.assertEqual(zone_e, zone)
+            numpy.testing.assert_equal(indices_e, indices)
+
+    def test_apply_rules(self):
+        x = numpy.array([1.0, 2.0, 3.0, 4.0, 5.0])
+        y = numpy.array([10.0, 20.0, 30.0, 40.0, 50.0])
+        depth = numpy.array([50.0, 150.0, 20.0, 200.0, 0.0])
+        values = rules.apply_rules(rules_fn, self.FAULT_BLOCK, self.ZONE, x, y, depth)
+
+        values_e = numpy.array([
+            [11.0, -18.0, -27.0, 44.0, -45.0],
+            [100.0, 150.0, 60.0, 200.0, 0.0],
+            [-1.0, -2.0, -2.0, -1.0, -2.0],
+        ])
+        self.assertEqual((3, 5), values.shape)
+        numpy.testing.assert_allclose(values_e, values)
+        self.assertTrue(rules.is_vectorized(rule_array))
+        self.assertFalse(rules.is_vectorized(rule_point))
+
+    def test_as_vectorized(self):
+        self.assertIs(rule_array, rules.as_vectorized(rule_array))
+
+        x = numpy.array([1.0, 2.0])
+        y = numpy.array([10.0, 20.0])
+        depth = numpy.array([50.0, 150.0])
+        rule = rules.as_vectorized(rule_point)
+        self.assertTrue(rules.is_vectorized(rule))
+        values = rule(x, y, depth)
+        values_e = ([11.0, 22.0], [100.0, 150.0], [-1.0, -1.0])
+        self.assertEqual(len(values_e), len(values))
+        for value_e, value in zip(values_e, values):
+            numpy.testing.assert_allclose(value_e, value)
+
+    def test_where(self):
+        depth = numpy.array([50.0, 150.0, 20.0])
+        x = numpy.array([1.0, 2.0, 3.0])
+        y = numpy.array([10.0, 20.0, 30.0])
+        values = rules.where(x > 1.5, rule_array(x, y, depth), rule_point(x[0], y[0], depth[0]))
+        values_e = ([11.0, -18.0, -27.0], [100.0, 150.0, 60.0], [-1.0, -2.0, -2.0])
+        for value_e, value in zip(values_e, values):
+            numpy.testing.assert_allclose(value_e, value)
+
+
+class TestAPI(unittest.TestCase):
+
+    def test_write_points(self):
+        points = numpy.array([[1.0, -2.5e+3, 3.25e-2], [4.0e+5, 5.0, -6.0]])
+        fout = io.StringIO()
+        save_block = api.WRITE_BLOCK_SIZE
+        api.WRITE_BLOCK_SIZE = 1
+        try:
+            api.write_points(fout, points)
+        finally:
+            api.WRITE_BLOCK_SIZE = save_block
+        fout_e = io.StringIO()
+        numpy.savetxt(fout_e, points, fmt="%16.8e")
+        self.assertEqual(fout_e.getvalue(), fout.getvalue())
+
+    def test_read_labels(self):
+        DTYPE = {
+            "names": ("x", "y", "z", "fault_block", "zone"),
+            "formats": ("f4", "f4", "f4", "<U32", "<U32")
+        }
+        fin = io.StringIO('1.0\t2.0\t-3.0\t"Block A"\t"Zone 1"\n4.0\t5.0\t-6.0\t""\t""\n')
+        data = api.read_labels(fin, DTYPE)
+        numpy.testing.assert_allclose([1.0, 4.0], data["x"])
+        numpy.testing.assert_allclose([-3.0, -6.0], data["z"])
+        self.assertEqual(["Block A", ""], data["fault_block"].tolist())
+        self.assertEqual(["Zone 1", ""], data["zone"].tolist())
+
+
+def test_classes():
+    return [TestRules, TestAPI]
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    for cls in test_classes():
+        suite.addTest(unittest.makeSuite(cls))
+    unittest.TextTestRunner(verbosity=2).run(suite)
+
+
+# End of file
@@ -19,6 +19,8 @@ def create_coverage():
             "geomodelgrids",
             "geomodelgrids.create.apps",
             "geomodelgrids.create.core",
+            "geomodelgrids.create.data_srcs.csv",
+            "geomodelgrids.create.data_srcs.earthvision",
             "geomodelgrids.create.io",
             "geomodelgrids.create.testing",
             "geomodelgrids.create.utils",
@@ -46,8 +48,12 @@ def load_tests(loader, tests, pattern):
     import test_createapp
     import test_query
     import test_model
+    import test_queryclient
     import test_modelinfo
     import test_errorhandler
+    import test_synthetic
+    import test_earthvision
+    import test_csv
 
     _suite = unittest.TestSuite()
     for mod in [
@@ -56,8 +62,12 @@ def load_tests(loader, tests, pattern):
         test_createapp,
         test_query,
         test_model,
+        test_queryclient,
         test_modelinfo,
         test_errorhandler,
+        test_synthetic,
+        test_earthvision,
+        test_csv,
     ]:
         _suite.addTests(loader.loadTestsFromModule(mod))
     return _suite
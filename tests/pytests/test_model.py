@@ -125,6 +125,39 @@ class TestModel(unittest.TestCase):
 
         self.assertRaises(RuntimeError, self.model.query, numpy.array([0]))
 
+    def test_query_arrays(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 8.0],
+            [37.479, -121.734, -5.0e+3],
+            [37.381, -121.581, -3.0e+3],
+            [34.7, -117.8, 1.0e+4],
+        ])
+        values = self.model.query(POINTS)
+        self.assertTrue(numpy.all(values[3,:] == geomodelgrids.Query.NODATA_VALUE))
+
+        points_big = numpy.zeros((2*POINTS.shape[0], 4), dtype=numpy.float32)
+        points_big[::2,1:4] = POINTS
+        values32 = self.model.query(points_big[::2,1:4])
+        values64 = self.model.query(points_big[::2,1:4].astype(numpy.float64))
+        self.assertTrue(numpy.array_equal(values32, values64))
+
+        out = numpy.zeros(values.shape)
+        values_out = self.model.query(POINTS, out=out)
+        self.assertIs(values_out, out)
+        self.assertTrue(numpy.array_equal(values, out))
+        self.assertRaises(RuntimeError, self.model.query, POINTS, out=numpy.zeros((1, 2)))
+
+        # Single precision values
+        values_float = self.model.query(POINTS, dtype=numpy.float32)
+        self.assertEqual(numpy.float32, values_float.dtype)
+        self.assertTrue(numpy.array_equal(values.astype(numpy.float32), values_float))
+        out = numpy.zeros(values.shape, dtype=numpy.float32)
+        values_out = self.model.query(POINTS, out=out)
+        self.assertIs(values_out, out)
+        self.assertTrue(numpy.array_equal(values_float, out))
+        self.assertRaises(RuntimeError, self.model.query, POINTS, out=out, dtype=numpy.float64)
+        self.assertRaises(RuntimeError, self.model.query, POINTS, dtype=numpy.int32)
+
 
 def load_tests(loader, tests, pattern):
     TEST_CLASSES = [TestModel]
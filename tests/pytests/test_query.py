@@ -161,6 +161,101 @@ class TestQuery(unittest.TestCase):
         self.assertLess(diff, 1.0e-6)
         assert numpy.sum(err) == 0
 
+    def test_query_arrays(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 8.0],
+            [37.479, -121.734, -5.0e+3],
+            [35.3, -118.2, 10.0],
+            [35.5, -117.9, -45.0e+3],
+            [34.7, -117.5, 43.0],
+        ])
+        values, err = self.query.query(POINTS)
+        elev = self.query.query_top_elevation(POINTS[:,0:2])
+
+        # Non-contiguous views of a larger array
+        points_big = numpy.zeros((2*POINTS.shape[0], 4))
+        points_big[::2,1:4] = POINTS
+        values_view, err_view = self.query.query(points_big[::2,1:4])
+        self.assertTrue(numpy.array_equal(values, values_view))
+        self.assertTrue(numpy.array_equal(err, err_view))
+        elev_view = self.query.query_top_elevation(points_big[::2,1:3])
+        self.assertTrue(numpy.array_equal(elev, elev_view))
+        values_view, err_view = self.query.query(numpy.asfortranarray(POINTS))
+        self.assertTrue(numpy.array_equal(values, values_view))
+
+        # float32 points
+        points32 = POINTS.astype(numpy.float32)
+        values64, err64 = self.query.query(points32.astype(numpy.float64))
+        values32, err32 = self.query.query(points32)
+        self.assertTrue(numpy.array_equal(values64, values32))
+        self.assertTrue(numpy.array_equal(err64, err32))
+
+        # Preallocated output
+        out = numpy.zeros((POINTS.shape[0], len(self.VALUES)))
+        values_out, err_out = self.query.query(POINTS, out=out)
+        self.assertIs(values_out, out)
+        self.assertTrue(numpy.array_equal(values, out))
+        out = numpy.zeros(POINTS.shape[0])
+        elev_out = self.query.query_top_elevation(POINTS[:,0:2], out=out)
+        self.assertIs(elev_out, out)
+        self.assertTrue(numpy.array_equal(elev, out))
+
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=numpy.zeros((POINTS.shape[0], 1)))
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=numpy.zeros((POINTS.shape[0], 2), dtype=numpy.int32))
+        self.assertRaises(RuntimeError, self.query.query_top_elevation, POINTS[:,0:2], out=numpy.zeros(1))
+
+        # Single precision values
+        values_float, err_float = self.query.query(POINTS, dtype=numpy.float32)
+        self.assertEqual(numpy.float32, values_float.dtype)
+        self.assertTrue(numpy.array_equal(values.astype(numpy.float32), values_float))
+        self.assertTrue(numpy.array_equal(err, err_float))
+        out = numpy.zeros((POINTS.shape[0], len(self.VALUES)), dtype=numpy.float32)
+        values_out, err_out = self.query.query(POINTS, out=out)
+        self.assertIs(values_out, out)
+        self.assertTrue(numpy.array_equal(values_float, out))
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=out, dtype=numpy.float64)
+        self.assertRaises(RuntimeError, self.query.query, POINTS, dtype=numpy.int32)
+
+        # Non-contiguous and read-only output
+        out_big = numpy.zeros((2*POINTS.shape[0], 3*len(self.VALUES)), dtype=numpy.float32)
+        values_out, err_out = self.query.query(POINTS, out=out_big[::2,::3])
+        self.assertTrue(numpy.array_equal(values_float, out_big[::2,::3]))
+        self.assertEqual(0, numpy.count_nonzero(out_big[1::2,:]))
+        out = numpy.zeros(values.shape)
+        out.flags.writeable = False
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=out)
+        self.assertTrue(numpy.all(out == 0))
+
+        # Other sequences and dtypes are converted to float64
+        values_list, err_list = self.query.query(POINTS.tolist())
+        self.assertTrue(numpy.array_equal(values, values_list))
+        values_be, err_be = self.query.query(POINTS.astype(">f8"))
+        self.assertTrue(numpy.array_equal(values, values_be))
+
+    def test_query_chunks(self):
+        """Query more points than are copied to and from numpy arrays at a time."""
+        POINTS = numpy.array([
+            [37.455, -121.941, 8.0],
+            [37.479, -121.734, -5.0e+3],
+            [35.3, -118.2, 10.0],
+            [34.7, -117.8, 1.0e+4],
+        ])
+        num_points = 3*4096 + 7
+        points = numpy.tile(POINTS, (num_points // POINTS.shape[0] + 1, 1))[:num_points]
+        values_small, err_small = self.query.query(POINTS)
+        values, err = self.query.query(numpy.asfortranarray(points.astype(numpy.float32)))
+        self.assertEqual((num_points, len(self.VALUES)), values.shape)
+        values_small32, err_small32 = self.query.query(POINTS.astype(numpy.float32))
+        for i in range(POINTS.shape[0]):
+            self.assertTrue(numpy.all(values[i::POINTS.shape[0]] == values_small32[i]))
+            self.assertTrue(numpy.all(err[i::POINTS.shape[0]] == err_small32[i]))
+        self.assertEqual(num_points // POINTS.shape[0] + (3 < num_points % POINTS.shape[0]), numpy.sum(err))
+
+        elev = self.query.query_top_elevation(points[:,0:2])
+        elev_small = self.query.query_top_elevation(POINTS[:,0:2])
+        for i in range(POINTS.shape[0]):
+            self.assertTrue(numpy.all(elev[i::POINTS.shape[0]] == elev_small[i]))
+
     def test_query_squashed(self):
         POINTS = numpy.array([
             # one-block-squashed
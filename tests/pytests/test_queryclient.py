@@ -0,0 +1,99 @@
+"""Test _geomodelgrids.QueryClient.
+
+Queries against a running server require `geomodelgrids_server` in the PATH.
+"""
+
+import os
+import shutil
+import subprocess
+import time
+import unittest
+import numpy
+
+import geomodelgrids
+
+
+class TestQueryClient(unittest.TestCase):
+
+    FILENAMES = (
+        "../data/one-block-topo.h5",
+        "../data/three-blocks-topo.h5",
+    )
+    VALUES = ("two", "one")
+    SOCKET = "test-queryclient.sock"
+    POINTS = numpy.array([
+        [37.455, -121.941, 8.0],
+        [37.479, -121.734, -5.0e+3],
+        [35.3, -118.2, 10.0],
+        [34.7, -117.8, 1.0e+4],
+    ])
+
+    def test_unconnected(self):
+        client = geomodelgrids.QueryClient()
+        self.assertRaises(RuntimeError, client.query, self.POINTS)
+        self.assertRaises(RuntimeError, client.query_top_elevation, self.POINTS[:,0:2])
+        self.assertRaises(RuntimeError, client.connect, "no-such-server.sock")
+        self.assertRaises(ValueError, client.connect, "x" * 200)
+        client.close()
+
+    @unittest.skipUnless(shutil.which("geomodelgrids_server"), "geomodelgrids_server not found")
+    def test_query(self):
+        server = subprocess.Popen(["geomodelgrids_server", "--models=" + ",".join(self.FILENAMES),
+                                   "--values=" + ",".join(self.VALUES), "--socket=" + self.SOCKET])
+        try:
+            client = geomodelgrids.QueryClient()
+            for _ in range(100):
+                try:
+                    client.connect(self.SOCKET)
+                    break
+                except RuntimeError:
+                    time.sleep(0.05)
+            self.assertEqual(list(self.VALUES), client.get_value_names())
+
+            query = geomodelgrids.Query()
+            query.initialize(self.FILENAMES, self.VALUES, "EPSG:4326")
+            values_query, err_query = query.query(self.POINTS)
+            elev_query = query.query_top_elevation(self.POINTS[:,0:2])
+            query.finalize()
+
+            values, err = client.query(self.POINTS)
+            self.assertTrue(numpy.array_equal(values_query, values))
+            self.assertTrue(numpy.array_equal(err_query, err))
+
+            points_big = numpy.zeros((2*self.POINTS.shape[0], 4), dtype=numpy.float32)
+            points_big[::2,1:4] = self.POINTS
+            out = numpy.zeros((2*self.POINTS.shape[0], len(self.VALUES)), dtype=numpy.float32)
+            values_out, err_out = client.query(points_big[::2,1:4], out=out[::2])
+            values32, err32 = client.query(points_big[::2,1:4].astype(numpy.float64))
+            self.assertTrue(numpy.array_equal(values32.astype(numpy.float32), out[::2]))
+            self.assertRaises(RuntimeError, client.query, self.POINTS, out=numpy.zeros((1, 2)))
+
+            elev = client.query_top_elevation(self.POINTS[:,0:2])
+            self.assertTrue(numpy.array_equal(elev_query, elev))
+            elev = client.query_topobathy_elevation(self.POINTS[:,0:2])
+            self.assertEqual((self.POINTS.shape[0],), elev.shape)
+
+            client.shutdown_server()
+            self.assertEqual(0, server.wait(timeout=10))
+        finally:
+            if server.poll() is None:
+                server.kill()
+                server.wait()
+            if os.path.exists(self.SOCKET):
+                os.remove(self.SOCKET)
+
+
+def load_tests(loader, tests, pattern):
+    TEST_CLASSES = [TestQueryClient]
+
+    suite = unittest.TestSuite()
+    for cls in TEST_CLASSES:
+        suite.addTests(loader.loadTestsFromTestCase(cls))
+    return suite
+
+
+if __name__ == "__main__":
+    unittest.main(verbosity=2)
+
+
+# End of file
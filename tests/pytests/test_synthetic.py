@@ -0,0 +1,62 @@
+"""Test geomodelgrids.create.testing.synthetic.
+"""
+
+import unittest
+import numpy
+
+import geomodelgrids
+from geomodelgrids.create.testing.synthetic import SyntheticModel, SyntheticDataSrc
+
+
+class TestSynthetic(unittest.TestCase):
+
+    FILENAME = "test-synthetic.h5"
+    VALUES = ("two", "one")
+    NUM_POINTS = 500
+
+    def test_size(self):
+        model = SyntheticModel.from_size(self.FILENAME, 10 * 2**20, num_blocks=5)
+        self.assertEqual(0, model.num_cells % 8)
+        self.assertGreaterEqual(model.get_nbytes(), 10 * 2**20)
+        self.assertEqual(5, len(model.get_config()["domain"]["blocks"]))
+
+    def test_uniform_flat(self):
+        self._check_query(variable=False, topography=False)
+
+    def test_uniform_topo(self):
+        self._check_query(variable=False, topography=True)
+
+    def test_variable_flat(self):
+        self._check_query(variable=True, topography=False)
+
+    def test_variable_topo(self):
+        self._check_query(variable=True, topography=True)
+
+    def _check_query(self, variable, topography):
+        model = SyntheticModel(self.FILENAME, num_cells=16, num_cells_z=8, num_blocks=3, dim_z=12.0e+3,
+                               variable=variable, topography=topography, chunk_size=4, batch_size=500)
+        datasrc = model.generate()
+
+        rng = numpy.random.default_rng(seed=1)
+        x = rng.uniform(0.0, model.dim_x, self.NUM_POINTS)
+        y = rng.uniform(0.0, model.dim_y, self.NUM_POINTS)
+        z_top = SyntheticDataSrc.compute_top_elevation(x, y) if topography else numpy.zeros(x.shape)
+        z = z_top - rng.uniform(0.0, 1.0, self.NUM_POINTS) * (z_top + model.dim_z)
+        x_crs, y_crs = datasrc.local_to_crs(x, y)
+
+        query = geomodelgrids.Query()
+        query.initialize([self.FILENAME], self.VALUES, model.crs)
+        values, err = query.query(numpy.stack((x_crs, y_crs, z), axis=1))
+        query.finalize()
+
+        values_e = SyntheticDataSrc.compute_values(
+            numpy.stack((x, y, z), axis=1), self.VALUES, model.dim_z, topography)
+        numpy.testing.assert_allclose(numpy.array(values), values_e, rtol=1.0e-6)
+        self.assertEqual(0, numpy.sum(err))
+
+
+if __name__ == "__main__":
+    unittest.main()
+
+
+# End of file